@@ -192,7 +192,11 @@ void core_callback_device_to_speed(void) {}
 void core_callback_t_before_exec(void) {}
 void core_callback_t_after_exec(void) {}
 void core_callback_t_new_second(void) {}
-void core_callback_t_500us(void) {}
+void core_callback_t_500us(void)
+{
+   /* Send REG_PLAY_SOUND_AT_TIME to the PIC32 when it's close enough */
+   app_check_scheduled_sound();
+}
 void core_callback_t_1ms(void)
 {
    /* Read ADC0 */
@@ -16,8 +16,8 @@ void (*app_func_rd_pointer[])(void) = {
 	&app_read_REG_ATTENUATION_RIGHT,
 	&app_read_REG_ATTENUATION_BOTH,
 	&app_read_REG_SET_ATTENUATION_AND_PLAY_SOUND_OR_FREQ,
-	&app_read_REG_RESERVED0,
-	&app_read_REG_RESERVED1,
+	&app_read_REG_SET_ATTENUATION_AND_MIX_SOUND,
+	&app_read_REG_PLAY_SOUND_AT_TIME,
 	&app_read_REG_DIGITAL_INPUTS,
 	&app_read_REG_DI0_CONF,
 	&app_read_REG_DI1_CONF,
@@ -40,16 +40,16 @@ void (*app_func_rd_pointer[])(void) = {
 	&app_read_REG_DI0_ATTENUATION_AND_FREQUENCY,
 	&app_read_REG_DI1_ATTENUATION_AND_FREQUENCY,
 	&app_read_REG_DI2_ATTENUATION_AND_FReQUENCY,
-	&app_read_REG_RESERVED2,
-	&app_read_REG_RESERVED3,
-	&app_read_REG_RESERVED4,
+	&app_read_REG_PLAY_STEREO_TONE,
+	&app_read_REG_PLAY_SWEEP,
+	&app_read_REG_NOISE_SETTINGS,
 	&app_read_REG_DO0_CONF,
 	&app_read_REG_DO1_CONF,
 	&app_read_REG_DO2_CONF,
 	&app_read_REG_DO0_PULSE,
 	&app_read_REG_DO1_PULSE,
 	&app_read_REG_DO2_PULSE,
-	&app_read_REG_RESERVED5,
+	&app_read_REG_PLAY_STIMULUS,
 	&app_read_REG_RESERVED6,
 	&app_read_REG_RESERVED7,
 	&app_read_REG_DO_SET,
@@ -74,8 +74,8 @@ bool (*app_func_wr_pointer[])(void*) = {
 	&app_write_REG_ATTENUATION_RIGHT,
 	&app_write_REG_ATTENUATION_BOTH,
 	&app_write_REG_SET_ATTENUATION_AND_PLAY_SOUND_OR_FREQ,
-	&app_write_REG_RESERVED0,
-	&app_write_REG_RESERVED1,
+	&app_write_REG_SET_ATTENUATION_AND_MIX_SOUND,
+	&app_write_REG_PLAY_SOUND_AT_TIME,
 	&app_write_REG_DIGITAL_INPUTS,
 	&app_write_REG_DI0_CONF,
 	&app_write_REG_DI1_CONF,
@@ -98,16 +98,16 @@ bool (*app_func_wr_pointer[])(void*) = {
 	&app_write_REG_DI0_ATTENUATION_AND_FREQUENCY,
 	&app_write_REG_DI1_ATTENUATION_AND_FREQUENCY,
 	&app_write_REG_DI2_ATTENUATION_AND_FReQUENCY,
-	&app_write_REG_RESERVED2,
-	&app_write_REG_RESERVED3,
-	&app_write_REG_RESERVED4,
+	&app_write_REG_PLAY_STEREO_TONE,
+	&app_write_REG_PLAY_SWEEP,
+	&app_write_REG_NOISE_SETTINGS,
 	&app_write_REG_DO0_CONF,
 	&app_write_REG_DO1_CONF,
 	&app_write_REG_DO2_CONF,
 	&app_write_REG_DO0_PULSE,
 	&app_write_REG_DO1_PULSE,
 	&app_write_REG_DO2_PULSE,
-	&app_write_REG_RESERVED5,
+	&app_write_REG_PLAY_STIMULUS,
 	&app_write_REG_RESERVED6,
 	&app_write_REG_RESERVED7,
 	&app_write_REG_DO_SET,
@@ -130,13 +130,14 @@ bool (*app_func_wr_pointer[])(void*) = {
 /* REG_PLAY_SOUND_OR_FREQ                                               */
 /************************************************************************/
 uint16_t last_sound_triggered = 0;	// 0 means it's stopped
+bool sound_scheduled = false;			// REG_PLAY_SOUND_AT_TIME is waiting
 
 void app_read_REG_PLAY_SOUND_OR_FREQ(void) {}
 bool app_write_REG_PLAY_SOUND_OR_FREQ(void *a)
 {
 	uint16_t reg = *((uint16_t*)a);
    
-   if (reg <= 1 || reg > 40000)
+   if (reg <= 1 || reg > NOISE_BAND_PASS || (reg >= 40000 && reg < NOISE_WHITE))
       return false;
 
    if (last_sound_triggered != 0)
@@ -169,6 +170,7 @@ bool app_write_REG_STOP(void *a)
 	{
         par_cmd_stop();
 		last_sound_triggered = 0;
+		sound_scheduled = false;
 	}
 
 	app_regs.REG_STOP = reg;
@@ -245,7 +247,7 @@ bool app_write_REG_SET_ATTENUATION_AND_PLAY_SOUND_OR_FREQ(void *a)
 {
 	uint16_t *reg = ((uint16_t*)a);
 	
-	if (reg[0] <= 1 || reg[0] > 40000)
+	if (reg[0] <= 1 || reg[0] > NOISE_BAND_PASS || (reg[0] >= 40000 && reg[0] < NOISE_WHITE))
 		return false;
 
 	if (last_sound_triggered != 0)
@@ -272,38 +274,90 @@ bool app_write_REG_SET_ATTENUATION_AND_PLAY_SOUND_OR_FREQ(void *a)
 
 
 /************************************************************************/
-/* REG_RESERVED0                                                        */
+/* REG_SET_ATTENUATION_AND_MIX_SOUND                                    */
 /************************************************************************/
-void app_read_REG_RESERVED0(void)
+void app_read_REG_SET_ATTENUATION_AND_MIX_SOUND(void) {}
+bool app_write_REG_SET_ATTENUATION_AND_MIX_SOUND(void *a)
 {
-	//app_regs.REG_RESERVED0 = 0;
-
-}
-
-bool app_write_REG_RESERVED0(void *a)
-{
-	uint8_t reg = *((uint8_t*)a);
-
-	app_regs.REG_RESERVED0 = reg;
+	uint16_t *reg = ((uint16_t*)a);
+	
+	/* Only sounds can be mixed */
+	if (reg[0] <= 1 || reg[0] >= SOUNDS_MAX)
+		return false;
+	
+	app_regs.REG_SET_ATTENUATION_AND_MIX_SOUND[0] = reg[0];
+	app_regs.REG_SET_ATTENUATION_AND_MIX_SOUND[1] = reg[1];
+	app_regs.REG_SET_ATTENUATION_AND_MIX_SOUND[2] = reg[2];
+	
+	/* The attenuation is applied only to this sound */
+	par_cmd_start_sound_mixed(reg[0], reg[1], reg[2]);
+	
 	return true;
 }
 
 
 /************************************************************************/
-/* REG_RESERVED1                                                        */
+/* REG_PLAY_SOUND_AT_TIME                                               */
 /************************************************************************/
-void app_read_REG_RESERVED1(void)
-{
-	//app_regs.REG_RESERVED1 = 0;
+/* The command is sent to the PIC32 when the sound is this close so it can
+ * preload the first buffer and pad it up to the exact sample
+ */
+#define SCHEDULE_LEAD_US 10000
 
+void app_read_REG_PLAY_SOUND_AT_TIME(void) {}
+bool app_write_REG_PLAY_SOUND_AT_TIME(void *a)
+{
+	uint32_t *reg = ((uint32_t*)a);
+	
+	/* Only sounds can be scheduled */
+	if (reg[0] <= 1 || reg[0] >= SOUNDS_MAX || reg[2] >= 1000000)
+		return false;
+	
+	if (sound_scheduled)
+      /* Previous schedule is still waiting */ 
+      return false;
+	
+	/* Up to ~35 minutes in the future */
+	if (reg[1] < core_func_read_R_TIMESTAMP_SECOND() || reg[1] - core_func_read_R_TIMESTAMP_SECOND() > 2100)
+		return false;
+	
+	if (par_us_until(reg[1], reg[2]) <= 0)
+		return false;
+	
+	app_regs.REG_PLAY_SOUND_AT_TIME[0] = reg[0];
+	app_regs.REG_PLAY_SOUND_AT_TIME[1] = reg[1];
+	app_regs.REG_PLAY_SOUND_AT_TIME[2] = reg[2];
+	
+	/* REG_PLAY_SOUND_OR_FREQ is only updated when the sound starts */
+	sound_scheduled = true;
+	
+	app_check_scheduled_sound();
+	
+	return true;
 }
 
-bool app_write_REG_RESERVED1(void *a)
-{
-	uint8_t reg = *((uint8_t*)a);
+extern bool command_available;
 
-	app_regs.REG_RESERVED1 = reg;
-	return true;
+void app_check_scheduled_sound(void)
+{
+	if (sound_scheduled == false || command_available)
+		return;
+	
+	if (par_us_until(app_regs.REG_PLAY_SOUND_AT_TIME[1], app_regs.REG_PLAY_SOUND_AT_TIME[2]) > SCHEDULE_LEAD_US)
+		return;
+	
+	sound_scheduled = false;
+	
+	/* Its event is sent when SOUND_IS_ON rises */
+	last_sound_triggered = app_regs.REG_PLAY_SOUND_AT_TIME[0];
+	
+	par_cmd_start_sound_scheduled(
+		app_regs.REG_PLAY_SOUND_AT_TIME[0],
+		app_regs.REG_ATTNUATION_LEFT,
+		app_regs.REG_ATTENUATION_RIGHT,
+		app_regs.REG_PLAY_SOUND_AT_TIME[1],
+		app_regs.REG_PLAY_SOUND_AT_TIME[2]
+	);
 }
 
 
@@ -710,55 +764,107 @@ bool app_write_REG_DI2_ATTENUATION_AND_FReQUENCY(void *a)
 
 
 /************************************************************************/
-/* REG_RESERVED2                                                        */
+/* REG_PLAY_STEREO_TONE                                                 */
 /************************************************************************/
-void app_read_REG_RESERVED2(void)
-{
-	//app_regs.REG_RESERVED2 = 0;
+/* Frequencies in mHz, up to 40 KHz */
+#define TONE_FREQUENCY_MAX 40000000
 
-}
+/* Phase offsets in 0.01 degrees */
+#define TONE_PHASE_MAX 36000
 
-bool app_write_REG_RESERVED2(void *a)
+void app_read_REG_PLAY_STEREO_TONE(void) {}
+bool app_write_REG_PLAY_STEREO_TONE(void *a)
 {
-	uint8_t reg = *((uint8_t*)a);
-
-	app_regs.REG_RESERVED2 = reg;
+	uint32_t *reg = ((uint32_t*)a);
+	
+	if (reg[0] > TONE_FREQUENCY_MAX || reg[1] > TONE_FREQUENCY_MAX || reg[2] >= TONE_PHASE_MAX)
+		return false;
+	
+	/* At least one of the channels must be playing */
+	if (reg[0] == 0 && reg[1] == 0)
+		return false;
+	
+	if (reg[3] > 0xFFFF || reg[4] > 0xFFFF)
+		return false;
+	
+	app_regs.REG_ATTNUATION_LEFT    = reg[3];
+	app_regs.REG_ATTENUATION_RIGHT  = reg[4];
+	app_regs.REG_ATTENUATION_BOTH[0] = reg[3];
+	app_regs.REG_ATTENUATION_BOTH[1] = reg[4];
+	
+	app_regs.REG_PLAY_STEREO_TONE[0] = reg[0];
+	app_regs.REG_PLAY_STEREO_TONE[1] = reg[1];
+	app_regs.REG_PLAY_STEREO_TONE[2] = reg[2];
+	app_regs.REG_PLAY_STEREO_TONE[3] = reg[3];
+	app_regs.REG_PLAY_STEREO_TONE[4] = reg[4];
+	
+	par_cmd_start_tone(reg[0], reg[1], reg[2], reg[3], reg[4]);
+	
 	return true;
 }
 
 
 /************************************************************************/
-/* REG_RESERVED3                                                        */
+/* REG_PLAY_SWEEP                                                       */
 /************************************************************************/
-void app_read_REG_RESERVED3(void)
-{
-	//app_regs.REG_RESERVED3 = 0;
+/* Durations in ms, up to 10 minutes */
+#define SWEEP_DURATION_MAX 600000
 
-}
+/* Modes: bit 0 is logarithmic, bit 1 holds the end frequency (glide) */
+#define SWEEP_MODE_MAX 3
 
-bool app_write_REG_RESERVED3(void *a)
+void app_read_REG_PLAY_SWEEP(void) {}
+bool app_write_REG_PLAY_SWEEP(void *a)
 {
-	uint8_t reg = *((uint8_t*)a);
-
-	app_regs.REG_RESERVED3 = reg;
+	uint32_t *reg = ((uint32_t*)a);
+	
+	if (reg[0] == 0 || reg[0] > TONE_FREQUENCY_MAX || reg[1] == 0 || reg[1] > TONE_FREQUENCY_MAX)
+		return false;
+	
+	if (reg[2] == 0 || reg[2] > SWEEP_DURATION_MAX || reg[3] > SWEEP_MODE_MAX)
+		return false;
+	
+	if (reg[4] > 0xFFFF || reg[5] > 0xFFFF)
+		return false;
+	
+	app_regs.REG_ATTNUATION_LEFT    = reg[4];
+	app_regs.REG_ATTENUATION_RIGHT  = reg[5];
+	app_regs.REG_ATTENUATION_BOTH[0] = reg[4];
+	app_regs.REG_ATTENUATION_BOTH[1] = reg[5];
+	
+	for (uint8_t i = 0; i < 6; i++)
+		app_regs.REG_PLAY_SWEEP[i] = reg[i];
+	
+	par_cmd_start_sweep(reg[0], reg[1], reg[2], reg[3], reg[4], reg[5]);
+	
 	return true;
 }
 
 
 /************************************************************************/
-/* REG_RESERVED4                                                        */
+/* REG_NOISE_SETTINGS                                                   */
 /************************************************************************/
-void app_read_REG_RESERVED4(void)
-{
-	//app_regs.REG_RESERVED4 = 0;
+/* Band edges in Hz, up to 40 KHz */
+#define NOISE_FREQUENCY_MAX 40000
 
-}
-
-bool app_write_REG_RESERVED4(void *a)
+void app_read_REG_NOISE_SETTINGS(void) {}
+bool app_write_REG_NOISE_SETTINGS(void *a)
 {
-	uint8_t reg = *((uint8_t*)a);
-
-	app_regs.REG_RESERVED4 = reg;
+	uint32_t *reg = ((uint32_t*)a);
+	
+	if (reg[1] > NOISE_FREQUENCY_MAX || reg[2] > NOISE_FREQUENCY_MAX)
+		return false;
+	
+	/* The high edge is 0 if the band has no low-pass */
+	if (reg[2] != 0 && reg[1] >= reg[2])
+		return false;
+	
+	app_regs.REG_NOISE_SETTINGS[0] = reg[0];
+	app_regs.REG_NOISE_SETTINGS[1] = reg[1];
+	app_regs.REG_NOISE_SETTINGS[2] = reg[2];
+	
+	par_cmd_noise_settings(reg[0], reg[1], reg[2]);
+	
 	return true;
 }
 
@@ -872,19 +978,42 @@ bool app_write_REG_DO2_PULSE(void *a)
 
 
 /************************************************************************/
-/* REG_RESERVED5                                                        */
+/* REG_PLAY_STIMULUS                                                    */
 /************************************************************************/
-void app_read_REG_RESERVED5(void)
-{
-	//app_regs.REG_RESERVED5 = 0;
+/* Times in us, up to 10 minutes */
+#define STIMULUS_TIME_MAX 600000000
 
-}
+/* Modulation depths in 0.1% */
+#define STIMULUS_DEPTH_MAX 1000
 
-bool app_write_REG_RESERVED5(void *a)
+void app_read_REG_PLAY_STIMULUS(void) {}
+bool app_write_REG_PLAY_STIMULUS(void *a)
 {
-	uint8_t reg = *((uint8_t*)a);
-
-	app_regs.REG_RESERVED5 = reg;
+	uint32_t *reg = ((uint32_t*)a);
+	
+	if (reg[0] > TONE_FREQUENCY_MAX || reg[1] > TONE_FREQUENCY_MAX || reg[2] > STIMULUS_DEPTH_MAX)
+		return false;
+	
+	if (reg[3] == 0 || reg[3] > STIMULUS_TIME_MAX || reg[4] > reg[3] / 2 || reg[5] > STIMULUS_TIME_MAX)
+		return false;
+	
+	/* The bursts can't overlap, unless there's only one */
+	if (reg[5] < reg[3] && reg[6] != 1)
+		return false;
+	
+	if (reg[6] > 0x7FFFFFFF || reg[7] > 0xFFFF || reg[8] > 0xFFFF)
+		return false;
+	
+	app_regs.REG_ATTNUATION_LEFT    = reg[7];
+	app_regs.REG_ATTENUATION_RIGHT  = reg[8];
+	app_regs.REG_ATTENUATION_BOTH[0] = reg[7];
+	app_regs.REG_ATTENUATION_BOTH[1] = reg[8];
+	
+	for (uint8_t i = 0; i < 9; i++)
+		app_regs.REG_PLAY_STIMULUS[i] = reg[i];
+	
+	par_cmd_start_stimulus(reg[0], reg[1], reg[2], reg[3], reg[4], reg[5], reg[6], reg[7], reg[8]);
+	
 	return true;
 }
 
@@ -1098,7 +1227,7 @@ bool app_write_REG_COMMANDS(void *a)
    if (reg == GM_DEL_ALL_SOUNDS)
        par_cmd_delete_sound(0, true);
    
-   if (reg >= 0+2+2 && reg <= 32+2)
+   if (reg >= 0+2+2 && reg < SOUNDS_MAX+2)
        par_cmd_delete_sound(reg-2, false);   
       
    return true;
@@ -26,8 +26,8 @@ void app_read_REG_ATTNUATION_LEFT(void);
 void app_read_REG_ATTENUATION_RIGHT(void);
 void app_read_REG_ATTENUATION_BOTH(void);
 void app_read_REG_SET_ATTENUATION_AND_PLAY_SOUND_OR_FREQ(void);
-void app_read_REG_RESERVED0(void);
-void app_read_REG_RESERVED1(void);
+void app_read_REG_SET_ATTENUATION_AND_MIX_SOUND(void);
+void app_read_REG_PLAY_SOUND_AT_TIME(void);
 void app_read_REG_DIGITAL_INPUTS(void);
 void app_read_REG_DI0_CONF(void);
 void app_read_REG_DI1_CONF(void);
@@ -50,16 +50,16 @@ void app_read_REG_DI2_ATTENUATION_AND_SOUND_INDEX(void);
 void app_read_REG_DI0_ATTENUATION_AND_FREQUENCY(void);
 void app_read_REG_DI1_ATTENUATION_AND_FREQUENCY(void);
 void app_read_REG_DI2_ATTENUATION_AND_FReQUENCY(void);
-void app_read_REG_RESERVED2(void);
-void app_read_REG_RESERVED3(void);
-void app_read_REG_RESERVED4(void);
+void app_read_REG_PLAY_STEREO_TONE(void);
+void app_read_REG_PLAY_SWEEP(void);
+void app_read_REG_NOISE_SETTINGS(void);
 void app_read_REG_DO0_CONF(void);
 void app_read_REG_DO1_CONF(void);
 void app_read_REG_DO2_CONF(void);
 void app_read_REG_DO0_PULSE(void);
 void app_read_REG_DO1_PULSE(void);
 void app_read_REG_DO2_PULSE(void);
-void app_read_REG_RESERVED5(void);
+void app_read_REG_PLAY_STIMULUS(void);
 void app_read_REG_RESERVED6(void);
 void app_read_REG_RESERVED7(void);
 void app_read_REG_DO_SET(void);
@@ -82,8 +82,8 @@ bool app_write_REG_ATTNUATION_LEFT(void *a);
 bool app_write_REG_ATTENUATION_RIGHT(void *a);
 bool app_write_REG_ATTENUATION_BOTH(void *a);
 bool app_write_REG_SET_ATTENUATION_AND_PLAY_SOUND_OR_FREQ(void *a);
-bool app_write_REG_RESERVED0(void *a);
-bool app_write_REG_RESERVED1(void *a);
+bool app_write_REG_SET_ATTENUATION_AND_MIX_SOUND(void *a);
+bool app_write_REG_PLAY_SOUND_AT_TIME(void *a);
 bool app_write_REG_DIGITAL_INPUTS(void *a);
 bool app_write_REG_DI0_CONF(void *a);
 bool app_write_REG_DI1_CONF(void *a);
@@ -106,16 +106,16 @@ bool app_write_REG_DI2_ATTENUATION_AND_SOUND_INDEX(void *a);
 bool app_write_REG_DI0_ATTENUATION_AND_FREQUENCY(void *a);
 bool app_write_REG_DI1_ATTENUATION_AND_FREQUENCY(void *a);
 bool app_write_REG_DI2_ATTENUATION_AND_FReQUENCY(void *a);
-bool app_write_REG_RESERVED2(void *a);
-bool app_write_REG_RESERVED3(void *a);
-bool app_write_REG_RESERVED4(void *a);
+bool app_write_REG_PLAY_STEREO_TONE(void *a);
+bool app_write_REG_PLAY_SWEEP(void *a);
+bool app_write_REG_NOISE_SETTINGS(void *a);
 bool app_write_REG_DO0_CONF(void *a);
 bool app_write_REG_DO1_CONF(void *a);
 bool app_write_REG_DO2_CONF(void *a);
 bool app_write_REG_DO0_PULSE(void *a);
 bool app_write_REG_DO1_PULSE(void *a);
 bool app_write_REG_DO2_PULSE(void *a);
-bool app_write_REG_RESERVED5(void *a);
+bool app_write_REG_PLAY_STIMULUS(void *a);
 bool app_write_REG_RESERVED6(void *a);
 bool app_write_REG_RESERVED7(void *a);
 bool app_write_REG_DO_SET(void *a);
@@ -132,5 +132,7 @@ bool app_write_REG_RESERVED11(void *a);
 bool app_write_REG_RESERVED12(void *a);
 bool app_write_REG_EVNT_ENABLE(void *a);
 
+void app_check_scheduled_sound(void);
+
 
 #endif /* _APP_FUNCTIONS_H_ */
\ No newline at end of file
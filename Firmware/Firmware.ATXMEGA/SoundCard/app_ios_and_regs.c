@@ -64,8 +64,8 @@ uint8_t app_regs_type[] = {
 	TYPE_U16,
 	TYPE_U16,
 	TYPE_U16,
-	TYPE_U8,
-	TYPE_U8,
+	TYPE_U16,
+	TYPE_U32,
 	TYPE_U8,
 	TYPE_U8,
 	TYPE_U8,
@@ -88,16 +88,16 @@ uint8_t app_regs_type[] = {
 	TYPE_U16,
 	TYPE_U16,
 	TYPE_U16,
+	TYPE_U32,
+	TYPE_U32,
+	TYPE_U32,
 	TYPE_U8,
 	TYPE_U8,
 	TYPE_U8,
 	TYPE_U8,
 	TYPE_U8,
 	TYPE_U8,
-	TYPE_U8,
-	TYPE_U8,
-	TYPE_U8,
-	TYPE_U8,
+	TYPE_U32,
 	TYPE_U8,
 	TYPE_U8,
 	TYPE_U8,
@@ -122,8 +122,8 @@ uint16_t app_regs_n_elements[] = {
 	1,
 	2,
 	3,
-	1,
-	1,
+	3,
+	3,
 	1,
 	1,
 	1,
@@ -146,16 +146,16 @@ uint16_t app_regs_n_elements[] = {
 	2,
 	2,
 	2,
+	5,
+	6,
+	3,
 	1,
 	1,
 	1,
 	1,
 	1,
 	1,
-	1,
-	1,
-	1,
-	1,
+	9,
 	1,
 	1,
 	1,
@@ -180,8 +180,8 @@ uint8_t *app_regs_pointer[] = {
 	(uint8_t*)(&app_regs.REG_ATTENUATION_RIGHT),
 	(uint8_t*)(app_regs.REG_ATTENUATION_BOTH),
 	(uint8_t*)(app_regs.REG_SET_ATTENUATION_AND_PLAY_SOUND_OR_FREQ),
-	(uint8_t*)(&app_regs.REG_RESERVED0),
-	(uint8_t*)(&app_regs.REG_RESERVED1),
+	(uint8_t*)(app_regs.REG_SET_ATTENUATION_AND_MIX_SOUND),
+	(uint8_t*)(app_regs.REG_PLAY_SOUND_AT_TIME),
 	(uint8_t*)(&app_regs.REG_DIGITAL_INPUTS),
 	(uint8_t*)(&app_regs.REG_DI0_CONF),
 	(uint8_t*)(&app_regs.REG_DI1_CONF),
@@ -204,16 +204,16 @@ uint8_t *app_regs_pointer[] = {
 	(uint8_t*)(app_regs.REG_DI0_ATTENUATION_AND_FREQUENCY),
 	(uint8_t*)(app_regs.REG_DI1_ATTENUATION_AND_FREQUENCY),
 	(uint8_t*)(app_regs.REG_DI2_ATTENUATION_AND_FReQUENCY),
-	(uint8_t*)(&app_regs.REG_RESERVED2),
-	(uint8_t*)(&app_regs.REG_RESERVED3),
-	(uint8_t*)(&app_regs.REG_RESERVED4),
+	(uint8_t*)(app_regs.REG_PLAY_STEREO_TONE),
+	(uint8_t*)(app_regs.REG_PLAY_SWEEP),
+	(uint8_t*)(app_regs.REG_NOISE_SETTINGS),
 	(uint8_t*)(&app_regs.REG_DO0_CONF),
 	(uint8_t*)(&app_regs.REG_DO1_CONF),
 	(uint8_t*)(&app_regs.REG_DO2_CONF),
 	(uint8_t*)(&app_regs.REG_DO0_PULSE),
 	(uint8_t*)(&app_regs.REG_DO1_PULSE),
 	(uint8_t*)(&app_regs.REG_DO2_PULSE),
-	(uint8_t*)(&app_regs.REG_RESERVED5),
+	(uint8_t*)(app_regs.REG_PLAY_STIMULUS),
 	(uint8_t*)(&app_regs.REG_RESERVED6),
 	(uint8_t*)(&app_regs.REG_RESERVED7),
 	(uint8_t*)(&app_regs.REG_DO_SET),
@@ -127,8 +127,8 @@ typedef struct
 	uint16_t REG_ATTENUATION_RIGHT;
 	uint16_t REG_ATTENUATION_BOTH[2];
 	uint16_t REG_SET_ATTENUATION_AND_PLAY_SOUND_OR_FREQ[3];
-	uint8_t REG_RESERVED0;
-	uint8_t REG_RESERVED1;
+	uint16_t REG_SET_ATTENUATION_AND_MIX_SOUND[3];
+	uint32_t REG_PLAY_SOUND_AT_TIME[3];
 	uint8_t REG_DIGITAL_INPUTS;
 	uint8_t REG_DI0_CONF;
 	uint8_t REG_DI1_CONF;
@@ -151,16 +151,16 @@ typedef struct
 	uint16_t REG_DI0_ATTENUATION_AND_FREQUENCY[2];
 	uint16_t REG_DI1_ATTENUATION_AND_FREQUENCY[2];
 	uint16_t REG_DI2_ATTENUATION_AND_FReQUENCY[2];
-	uint8_t REG_RESERVED2;
-	uint8_t REG_RESERVED3;
-	uint8_t REG_RESERVED4;
+	uint32_t REG_PLAY_STEREO_TONE[5];
+	uint32_t REG_PLAY_SWEEP[6];
+	uint32_t REG_NOISE_SETTINGS[3];
 	uint8_t REG_DO0_CONF;
 	uint8_t REG_DO1_CONF;
 	uint8_t REG_DO2_CONF;
 	uint8_t REG_DO0_PULSE;
 	uint8_t REG_DO1_PULSE;
 	uint8_t REG_DO2_PULSE;
-	uint8_t REG_RESERVED5;
+	uint32_t REG_PLAY_STIMULUS[9];
 	uint8_t REG_RESERVED6;
 	uint8_t REG_RESERVED7;
 	uint8_t REG_DO_SET;
@@ -182,14 +182,14 @@ typedef struct
 /* Registers' address                                                   */
 /************************************************************************/
 /* Registers */
-#define ADD_REG_PLAY_SOUND_OR_FREQ          32 // U16    Starts the sound index (if < 32) or frequency (if >= 32)
+#define ADD_REG_PLAY_SOUND_OR_FREQ          32 // U16    Starts the sound index (if < 32, or < 64 on the 4 Gb memory) or frequency (otherwise)
 #define ADD_REG_STOP                        33 // U8     Any value will stops the current sound
 #define ADD_REG_ATTNUATION_LEFT             34 // U16    Configure left channel's attenuation (1 LSB is 0.1dB)
 #define ADD_REG_ATTENUATION_RIGHT           35 // U16    Configure right channel's attenuation (1 LSB is 0.1dB)
 #define ADD_REG_ATTENUATION_BOTH            36 // U16    Configures both attenuation on right and left channels [Att R] [Att L]
 #define ADD_REG_SET_ATTENUATION_AND_PLAY_SOUND_OR_FREQ 37 // U16    Configures attenuation and plays sound index [Att R] [Att L] [Index]
-#define ADD_REG_RESERVED0                   38 // U8     Reserved for future purposes
-#define ADD_REG_RESERVED1                   39 // U8     Reserved for future purposes
+#define ADD_REG_SET_ATTENUATION_AND_MIX_SOUND 38 // U16    Configures attenuation and mixes sound index with the current sound [Index] [Att L] [Att R]
+#define ADD_REG_PLAY_SOUND_AT_TIME          39 // U32    Plays sound index at a Harp timestamp with the current attenuation [Index] [Seconds] [Microseconds]
 #define ADD_REG_DIGITAL_INPUTS              40 // U8     State of the digital inputs
 #define ADD_REG_DI0_CONF                    41 // U8     Configuration of the digital input 0 (DI0)
 #define ADD_REG_DI1_CONF                    42 // U8     Configuration of the digital input 1 (DI1)
@@ -212,16 +212,16 @@ typedef struct
 #define ADD_REG_DI0_ATTENUATION_AND_FREQUENCY 59 // U16    Sound index and attenuation to be played when triggering DI0 [Att BOTH] [Frequency]
 #define ADD_REG_DI1_ATTENUATION_AND_FREQUENCY 60 // U16    Sound index and attenuation to be played when triggering DI0 [Att BOTH] [Frequency]
 #define ADD_REG_DI2_ATTENUATION_AND_FReQUENCY 61 // U16    Sound index and attenuation to be played when triggering DI0 [Att BOTH] [Frequency]
-#define ADD_REG_RESERVED2                   62 // U8     Reserved for future purposes
-#define ADD_REG_RESERVED3                   63 // U8     Reserved for future purposes
-#define ADD_REG_RESERVED4                   64 // U8     Reserved for future purposes
+#define ADD_REG_PLAY_STEREO_TONE            62 // U32    Plays a tone on each channel [Freq L] [Freq R] [Phase L] [Att L] [Att R] Frequencies in mHz, phase in 0.01 degrees
+#define ADD_REG_PLAY_SWEEP                  63 // U32    Plays a frequency sweep [Freq start] [Freq end] [Duration] [Mode] [Att L] [Att R] Frequencies in mHz, duration in ms
+#define ADD_REG_NOISE_SETTINGS              64 // U32    Settings of the noises played as indexes [Seed] [Freq low] [Freq high] Frequencies in Hz, 0 to skip the edge
 #define ADD_REG_DO0_CONF                    65 // U8     Configuration of the digital output 0 (DO0)
 #define ADD_REG_DO1_CONF                    66 // U8     Configuration of the digital output 1 (DO1)
 #define ADD_REG_DO2_CONF                    67 // U8     Configuration of the digital output 1 (DO1)
 #define ADD_REG_DO0_PULSE                   68 // U8     Pulse for the digital output 0 (DO0) [1:255]
 #define ADD_REG_DO1_PULSE                   69 // U8     Pulse for the digital output 1 (DO1) [1:255]
 #define ADD_REG_DO2_PULSE                   70 // U8     Pulse for the digital output 2 (DO2) [1:255]
-#define ADD_REG_RESERVED5                   71 // U8     Reserved for future purposes
+#define ADD_REG_PLAY_STIMULUS               71 // U32    Plays a train of tone pips, AM tones or clicks [Freq carrier] [Freq mod] [Depth] [Duration] [Ramp] [Period] [Count] [Att L] [Att R] Frequencies in mHz, times in us
 #define ADD_REG_RESERVED6                   72 // U8     Reserved for future purposes
 #define ADD_REG_RESERVED7                   73 // U8     Reserved for future purposes
 #define ADD_REG_DO_SET                      74 // U8     Set the digital outputs
@@ -247,7 +247,7 @@ typedef struct
 /* Memory limits */
 #define APP_REGS_ADD_MIN                    0x20
 #define APP_REGS_ADD_MAX                    0x56
-#define APP_NBYTES_OF_REG_BANK              108
+#define APP_NBYTES_OF_REG_BANK              212
 
 /************************************************************************/
 /* Registers' bits                                                      */
@@ -12,26 +12,44 @@ extern AppRegs app_regs;
 /* DONE STOP                 11110000                                             checksum(1)
  * DONE START                11110001  index(1)   A_left(2)  A_right(2)           checksum(1)
  * X    START W/ FREQUENCY   11110010             A_left(2)  A_right(2)  Freq(2)  checksum(1)
- * DONE DELETE_SOUND         11110100  index(1)                                   checksum(1)
+ * DONE DELETE_SOUND         11110111  index(1)                                   checksum(1)
  * TODO UPDATE AMP           11111001             A_left(2)  A_right(2)           checksum(1)
  * X    UPDATE AMP. & FREQ.  11111010             A_left(2)  A_right(2)  Freq(2)  checksum(1)
- * TODO UPDATE FREQUENCY     11110011                                    Freq(2)  checksum(1)
+ * TODO UPDATE FREQUENCY     11111011                                    Freq(2)  checksum(1)
  * TODO UPDATE AMP LEFT      11111100             A_left(2)                       checksum(1)
  * TODO UPDATE AMP RIGHT     11111101                        A_right(2)           checksum(1)
+ * DONE START MIXED          11110101  index(2)   A_left(2)  A_right(2)           checksum(1)
+ * DONE START SCHEDULED      11110110  index(2)   A_left(2)  A_right(2)  Delay(2) checksum(1)
+ * DONE START TONE           11111000  F_left(4)  F_right(4) Phase(2) A_left(2)  A_right(2)  checksum(1)
+ * DONE START SWEEP          11111110  F_start(4) F_end(4)   Duration(4) Mode(1) A_left(2) A_right(2) checksum(1)
+ * DONE NOISE SETTINGS       11110100  Seed(4)    F_low(2)   F_high(2)            checksum(1)
+ * DONE START STIMULUS       11110011  F_carrier(4) F_mod(4) Depth(2) Duration(4) Ramp(4) Period(4) Count(4) A_left(2) A_right(2) checksum(1)
  */
 #define CMD_STOP 0xF0
 #define CMD_START 0xF1
 #define CMD_START_W_FREQUENCY 0xF2
+#define CMD_START_STIMULUS 0xF3
+#define CMD_NOISE_SETTINGS 0xF4
+#define CMD_START_MIXED 0xF5
+#define CMD_START_SCHEDULED 0xF6
 #define CMD_DELETE_SOUND 0xF7
+#define CMD_START_TONE 0xF8
 #define CMD_UPDATE_AMPLITUDE 0xF9
 #define CMD_UPDATE_AMPLITUDE_AND_FREQUENCY 0xFA
 #define CMD_UPDATE_FREQUENCY 0xFB
 #define CMD_UPDATE_AMPLITUDE_LEFT 0xFC
 #define CMD_UPDATE_AMPLITUDE_RIGHT 0xFD
+#define CMD_START_SWEEP 0xFE
 
 #define CMD_STOP_LEN 2
 #define CMD_DELETE_SOUND_LEN 3
 #define CMD_START_LEN 8
+#define CMD_START_MIXED_LEN 8
+#define CMD_START_SCHEDULED_LEN 10
+#define CMD_START_TONE_LEN 16
+#define CMD_START_SWEEP_LEN 19
+#define CMD_NOISE_SETTINGS_LEN 10
+#define CMD_START_STIMULUS_LEN 32
 #define CMD_UPDATE_AMPLITUDE_LEN 6
 #define CMD_UPDATE_FREQUENCY_LEN 4
 #define CMD_UPDATE_AMPLITUDE_LEFT_LEN 4
@@ -39,6 +57,12 @@ extern AppRegs app_regs;
 
 uint8_t cmd_stop[CMD_STOP_LEN]                                     = {CMD_STOP, 0};
 uint8_t cmd_start[CMD_START_LEN]                                   = {CMD_START, 0, 0, 0, 0, 0, 0, 0};
+uint8_t cmd_start_mixed[CMD_START_MIXED_LEN]                       = {CMD_START_MIXED, 0, 0, 0, 0, 0, 0, 0};
+uint8_t cmd_start_scheduled[CMD_START_SCHEDULED_LEN]               = {CMD_START_SCHEDULED, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+uint8_t cmd_start_tone[CMD_START_TONE_LEN]                         = {CMD_START_TONE, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+uint8_t cmd_start_sweep[CMD_START_SWEEP_LEN]                       = {CMD_START_SWEEP, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+uint8_t cmd_noise_settings[CMD_NOISE_SETTINGS_LEN]                 = {CMD_NOISE_SETTINGS, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+uint8_t cmd_start_stimulus[CMD_START_STIMULUS_LEN]                 = {CMD_START_STIMULUS, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
 uint8_t cmd_delete_sound[CMD_DELETE_SOUND_LEN]                     = {CMD_DELETE_SOUND, 0, 0};
 uint8_t cmd_update_amplitude[CMD_UPDATE_AMPLITUDE_LEN]             = {CMD_UPDATE_AMPLITUDE, 0, 0, 0, 0, 0};
 uint8_t cmd_update_frequency[CMD_UPDATE_FREQUENCY_LEN]             = {CMD_UPDATE_FREQUENCY, 0, 0, 0};
@@ -93,6 +117,34 @@ ISR(PORTC_INT1_vect, ISR_NAKED)
 			      
                break;
                
+            case CMD_START_MIXED:
+               par_cmd_start_sound_mixed_callback();
+               break;
+               
+            case CMD_START_SCHEDULED:
+               if (par_cmd_start_sound_scheduled_callback() == false)
+                  
+                  /* If command wasn't accepted by PIC32 */
+                  last_sound_triggered = 0;
+                  
+               break;
+               
+            case CMD_START_TONE:
+               par_cmd_start_tone_callback();
+               break;
+               
+            case CMD_START_SWEEP:
+               par_cmd_start_sweep_callback();
+               break;
+               
+            case CMD_NOISE_SETTINGS:
+               par_cmd_noise_settings_callback();
+               break;
+               
+            case CMD_START_STIMULUS:
+               par_cmd_start_stimulus_callback();
+               break;
+               
             case CMD_DELETE_SOUND:
                par_cmd_delete_sound_callback();
                break;
@@ -225,6 +277,321 @@ bool par_cmd_start_sound_callback (void)
 	send_last_byte(cmd_start[7]);
 }
 
+/************************************************************************/
+/* COMMAND: START_MIXED                                                 */
+/************************************************************************/
+void par_cmd_start_sound_mixed(uint16_t sound_index, int16_t amplitude_left, int16_t amplitude_right)
+{
+	/* Prepare command */
+	cmd_start_mixed[1] = *(((uint8_t*)(&sound_index)) + 0);
+	cmd_start_mixed[2] = *(((uint8_t*)(&sound_index)) + 1);
+	cmd_start_mixed[3] = *(((uint8_t*)(&amplitude_left)) + 0);
+	cmd_start_mixed[4] = *(((uint8_t*)(&amplitude_left)) + 1);
+	cmd_start_mixed[5] = *(((uint8_t*)(&amplitude_right)) + 0);
+	cmd_start_mixed[6] = *(((uint8_t*)(&amplitude_right)) + 1);
+	
+	/* Calculate checksum */
+	cmd_start_mixed[CMD_START_MIXED_LEN - 1] = cmd_start_mixed[0];
+	for (uint8_t i = CMD_START_MIXED_LEN - 1; i != 1; i--)
+	{
+		cmd_start_mixed[CMD_START_MIXED_LEN - 1] += cmd_start_mixed[i-1];
+	}
+	
+	/* Update globals */
+	command_available = true;
+	command_to_send = CMD_START_MIXED;
+	
+	/* Create an interrupt to be addressed as soon as possible */
+	timer_type0_enable(&TCD0, TIMER_PRESCALER_DIV1, 1, INT_LEVEL_LOW);
+}
+
+bool par_cmd_start_sound_mixed_callback (void)
+{
+	send_byte(cmd_start_mixed[1]);
+	send_byte(cmd_start_mixed[2]);
+	send_byte(cmd_start_mixed[3]);
+	send_byte(cmd_start_mixed[4]);
+	send_byte(cmd_start_mixed[5]);
+	send_byte(cmd_start_mixed[6]);
+	send_last_byte(cmd_start_mixed[7]);
+}
+
+/************************************************************************/
+/* COMMAND: START_SCHEDULED                                             */
+/************************************************************************/
+/* R_TIMESTAMP_MICRO counts 32 us and wraps every second */
+#define TIMESTAMP_MICRO_PER_SECOND 31250
+
+static uint16_t scheduled_delay_us;		// Delay calculated at scheduled_micro
+static uint16_t scheduled_micro;
+
+/* Microseconds from now until the timestamp (negative if it's gone) */
+int32_t par_us_until(uint32_t second, uint32_t usecond)
+{
+	uint32_t now_second;
+	uint16_t now_micro;
+	int64_t us;
+	
+	/* Make sure the second didn't change in between */
+	do
+	{
+		now_micro = core_func_read_R_TIMESTAMP_MICRO();
+		now_second = core_func_read_R_TIMESTAMP_SECOND();
+	} while (core_func_read_R_TIMESTAMP_MICRO() < now_micro);
+	
+	us = (int64_t)(int32_t)(second - now_second) * 1000000 + (int32_t)usecond - (int32_t)now_micro * 32;
+	
+	if (us > INT32_MAX)
+		return INT32_MAX;
+	if (us < INT32_MIN)
+		return INT32_MIN;
+	
+	return (int32_t)us;
+}
+
+void par_cmd_start_sound_scheduled(uint16_t sound_index, int16_t amplitude_left, int16_t amplitude_right, uint32_t second, uint32_t usecond)
+{
+	/* Prepare command */
+	cmd_start_scheduled[1] = *(((uint8_t*)(&sound_index)) + 0);
+	cmd_start_scheduled[2] = *(((uint8_t*)(&sound_index)) + 1);
+	cmd_start_scheduled[3] = *(((uint8_t*)(&amplitude_left)) + 0);
+	cmd_start_scheduled[4] = *(((uint8_t*)(&amplitude_left)) + 1);
+	cmd_start_scheduled[5] = *(((uint8_t*)(&amplitude_right)) + 0);
+	cmd_start_scheduled[6] = *(((uint8_t*)(&amplitude_right)) + 1);
+	
+	/* The delay is calculated here and only corrected by the time elapsed
+	 * until the PIC32 latches the command, since it counts from there
+	 */
+	int32_t delay = par_us_until(second, usecond);
+	
+	scheduled_micro = core_func_read_R_TIMESTAMP_MICRO();
+	scheduled_delay_us = (delay < 0) ? 0 : ((delay > 65535) ? 65535 : delay);
+	
+	/* Update globals */
+	command_available = true;
+	command_to_send = CMD_START_SCHEDULED;
+	
+	/* Create an interrupt to be addressed as soon as possible */
+	timer_type0_enable(&TCD0, TIMER_PRESCALER_DIV1, 1, INT_LEVEL_LOW);
+}
+
+bool par_cmd_start_sound_scheduled_callback (void)
+{
+	/* The PIC32 counts the delay from the moment it latched the command */
+	uint16_t elapsed = core_func_read_R_TIMESTAMP_MICRO() - scheduled_micro;
+	uint16_t delay_us = 0;
+	
+	/* The second changed in between */
+	if (elapsed >= TIMESTAMP_MICRO_PER_SECOND)
+		elapsed += TIMESTAMP_MICRO_PER_SECOND;
+	
+	if (elapsed < scheduled_delay_us / 32)
+		delay_us = scheduled_delay_us - elapsed * 32;
+	
+	cmd_start_scheduled[7] = *(((uint8_t*)(&delay_us)) + 0);
+	cmd_start_scheduled[8] = *(((uint8_t*)(&delay_us)) + 1);
+	
+	/* Calculate checksum */
+	cmd_start_scheduled[CMD_START_SCHEDULED_LEN - 1] = cmd_start_scheduled[0];
+	for (uint8_t i = CMD_START_SCHEDULED_LEN - 1; i != 1; i--)
+	{
+		cmd_start_scheduled[CMD_START_SCHEDULED_LEN - 1] += cmd_start_scheduled[i-1];
+	}
+	
+	send_byte(cmd_start_scheduled[1]);
+	send_byte(cmd_start_scheduled[2]);
+	send_byte(cmd_start_scheduled[3]);
+	send_byte(cmd_start_scheduled[4]);
+	send_byte(cmd_start_scheduled[5]);
+	send_byte(cmd_start_scheduled[6]);
+	send_byte(cmd_start_scheduled[7]);
+	send_byte(cmd_start_scheduled[8]);
+	send_last_byte(cmd_start_scheduled[9]);
+}
+
+/************************************************************************/
+/* COMMAND: START_TONE                                                  */
+/************************************************************************/
+void par_cmd_start_tone(uint32_t frequency_left, uint32_t frequency_right, uint16_t phase_left, int16_t amplitude_left, int16_t amplitude_right)
+{
+	/* Prepare command */
+	cmd_start_tone[1] = *(((uint8_t*)(&frequency_left)) + 0);
+	cmd_start_tone[2] = *(((uint8_t*)(&frequency_left)) + 1);
+	cmd_start_tone[3] = *(((uint8_t*)(&frequency_left)) + 2);
+	cmd_start_tone[4] = *(((uint8_t*)(&frequency_left)) + 3);
+	cmd_start_tone[5] = *(((uint8_t*)(&frequency_right)) + 0);
+	cmd_start_tone[6] = *(((uint8_t*)(&frequency_right)) + 1);
+	cmd_start_tone[7] = *(((uint8_t*)(&frequency_right)) + 2);
+	cmd_start_tone[8] = *(((uint8_t*)(&frequency_right)) + 3);
+	cmd_start_tone[9] = *(((uint8_t*)(&phase_left)) + 0);
+	cmd_start_tone[10] = *(((uint8_t*)(&phase_left)) + 1);
+	cmd_start_tone[11] = *(((uint8_t*)(&amplitude_left)) + 0);
+	cmd_start_tone[12] = *(((uint8_t*)(&amplitude_left)) + 1);
+	cmd_start_tone[13] = *(((uint8_t*)(&amplitude_right)) + 0);
+	cmd_start_tone[14] = *(((uint8_t*)(&amplitude_right)) + 1);
+	
+	/* Calculate checksum */
+	cmd_start_tone[CMD_START_TONE_LEN - 1] = cmd_start_tone[0];
+	for (uint8_t i = CMD_START_TONE_LEN - 1; i != 1; i--)
+	{
+		cmd_start_tone[CMD_START_TONE_LEN - 1] += cmd_start_tone[i-1];
+	}
+	
+	/* Update globals */
+	command_available = true;
+	command_to_send = CMD_START_TONE;
+	
+	/* Create an interrupt to be addressed as soon as possible */
+	timer_type0_enable(&TCD0, TIMER_PRESCALER_DIV1, 1, INT_LEVEL_LOW);
+}
+
+bool par_cmd_start_tone_callback (void)
+{
+	for (uint8_t i = 1; i < CMD_START_TONE_LEN - 1; i++)
+	{
+		send_byte(cmd_start_tone[i]);
+	}
+	send_last_byte(cmd_start_tone[CMD_START_TONE_LEN - 1]);
+}
+
+/************************************************************************/
+/* COMMAND: START_SWEEP                                                 */
+/************************************************************************/
+void par_cmd_start_sweep(uint32_t frequency_start, uint32_t frequency_end, uint32_t duration, uint8_t mode, int16_t amplitude_left, int16_t amplitude_right)
+{
+	/* Prepare command */
+	cmd_start_sweep[1] = *(((uint8_t*)(&frequency_start)) + 0);
+	cmd_start_sweep[2] = *(((uint8_t*)(&frequency_start)) + 1);
+	cmd_start_sweep[3] = *(((uint8_t*)(&frequency_start)) + 2);
+	cmd_start_sweep[4] = *(((uint8_t*)(&frequency_start)) + 3);
+	cmd_start_sweep[5] = *(((uint8_t*)(&frequency_end)) + 0);
+	cmd_start_sweep[6] = *(((uint8_t*)(&frequency_end)) + 1);
+	cmd_start_sweep[7] = *(((uint8_t*)(&frequency_end)) + 2);
+	cmd_start_sweep[8] = *(((uint8_t*)(&frequency_end)) + 3);
+	cmd_start_sweep[9] = *(((uint8_t*)(&duration)) + 0);
+	cmd_start_sweep[10] = *(((uint8_t*)(&duration)) + 1);
+	cmd_start_sweep[11] = *(((uint8_t*)(&duration)) + 2);
+	cmd_start_sweep[12] = *(((uint8_t*)(&duration)) + 3);
+	cmd_start_sweep[13] = mode;
+	cmd_start_sweep[14] = *(((uint8_t*)(&amplitude_left)) + 0);
+	cmd_start_sweep[15] = *(((uint8_t*)(&amplitude_left)) + 1);
+	cmd_start_sweep[16] = *(((uint8_t*)(&amplitude_right)) + 0);
+	cmd_start_sweep[17] = *(((uint8_t*)(&amplitude_right)) + 1);
+	
+	/* Calculate checksum */
+	cmd_start_sweep[CMD_START_SWEEP_LEN - 1] = cmd_start_sweep[0];
+	for (uint8_t i = CMD_START_SWEEP_LEN - 1; i != 1; i--)
+	{
+		cmd_start_sweep[CMD_START_SWEEP_LEN - 1] += cmd_start_sweep[i-1];
+	}
+	
+	/* Update globals */
+	command_available = true;
+	command_to_send = CMD_START_SWEEP;
+	
+	/* Create an interrupt to be addressed as soon as possible */
+	timer_type0_enable(&TCD0, TIMER_PRESCALER_DIV1, 1, INT_LEVEL_LOW);
+}
+
+bool par_cmd_start_sweep_callback (void)
+{
+	for (uint8_t i = 1; i < CMD_START_SWEEP_LEN - 1; i++)
+	{
+		send_byte(cmd_start_sweep[i]);
+	}
+	send_last_byte(cmd_start_sweep[CMD_START_SWEEP_LEN - 1]);
+}
+
+/************************************************************************/
+/* COMMAND: START_STIMULUS                                              */
+/************************************************************************/
+static void par_cmd_set_uint32(uint8_t *bytes, uint32_t value)
+{
+	bytes[0] = *(((uint8_t*)(&value)) + 0);
+	bytes[1] = *(((uint8_t*)(&value)) + 1);
+	bytes[2] = *(((uint8_t*)(&value)) + 2);
+	bytes[3] = *(((uint8_t*)(&value)) + 3);
+}
+
+void par_cmd_start_stimulus(uint32_t frequency_carrier, uint32_t frequency_modulation, uint16_t depth, uint32_t duration, uint32_t ramp, uint32_t period, uint32_t count, int16_t amplitude_left, int16_t amplitude_right)
+{
+	/* Prepare command */
+	par_cmd_set_uint32(&cmd_start_stimulus[1], frequency_carrier);
+	par_cmd_set_uint32(&cmd_start_stimulus[5], frequency_modulation);
+	cmd_start_stimulus[9] = *(((uint8_t*)(&depth)) + 0);
+	cmd_start_stimulus[10] = *(((uint8_t*)(&depth)) + 1);
+	par_cmd_set_uint32(&cmd_start_stimulus[11], duration);
+	par_cmd_set_uint32(&cmd_start_stimulus[15], ramp);
+	par_cmd_set_uint32(&cmd_start_stimulus[19], period);
+	par_cmd_set_uint32(&cmd_start_stimulus[23], count);
+	cmd_start_stimulus[27] = *(((uint8_t*)(&amplitude_left)) + 0);
+	cmd_start_stimulus[28] = *(((uint8_t*)(&amplitude_left)) + 1);
+	cmd_start_stimulus[29] = *(((uint8_t*)(&amplitude_right)) + 0);
+	cmd_start_stimulus[30] = *(((uint8_t*)(&amplitude_right)) + 1);
+	
+	/* Calculate checksum */
+	cmd_start_stimulus[CMD_START_STIMULUS_LEN - 1] = cmd_start_stimulus[0];
+	for (uint8_t i = CMD_START_STIMULUS_LEN - 1; i != 1; i--)
+	{
+		cmd_start_stimulus[CMD_START_STIMULUS_LEN - 1] += cmd_start_stimulus[i-1];
+	}
+	
+	/* Update globals */
+	command_available = true;
+	command_to_send = CMD_START_STIMULUS;
+	
+	/* Create an interrupt to be addressed as soon as possible */
+	timer_type0_enable(&TCD0, TIMER_PRESCALER_DIV1, 1, INT_LEVEL_LOW);
+}
+
+bool par_cmd_start_stimulus_callback (void)
+{
+	for (uint8_t i = 1; i < CMD_START_STIMULUS_LEN - 1; i++)
+	{
+		send_byte(cmd_start_stimulus[i]);
+	}
+	send_last_byte(cmd_start_stimulus[CMD_START_STIMULUS_LEN - 1]);
+}
+
+/************************************************************************/
+/* COMMAND: NOISE_SETTINGS                                              */
+/************************************************************************/
+void par_cmd_noise_settings(uint32_t seed, uint16_t frequency_low, uint16_t frequency_high)
+{
+	/* Prepare command */
+	cmd_noise_settings[1] = *(((uint8_t*)(&seed)) + 0);
+	cmd_noise_settings[2] = *(((uint8_t*)(&seed)) + 1);
+	cmd_noise_settings[3] = *(((uint8_t*)(&seed)) + 2);
+	cmd_noise_settings[4] = *(((uint8_t*)(&seed)) + 3);
+	cmd_noise_settings[5] = *(((uint8_t*)(&frequency_low)) + 0);
+	cmd_noise_settings[6] = *(((uint8_t*)(&frequency_low)) + 1);
+	cmd_noise_settings[7] = *(((uint8_t*)(&frequency_high)) + 0);
+	cmd_noise_settings[8] = *(((uint8_t*)(&frequency_high)) + 1);
+	
+	/* Calculate checksum */
+	cmd_noise_settings[CMD_NOISE_SETTINGS_LEN - 1] = cmd_noise_settings[0];
+	for (uint8_t i = CMD_NOISE_SETTINGS_LEN - 1; i != 1; i--)
+	{
+		cmd_noise_settings[CMD_NOISE_SETTINGS_LEN - 1] += cmd_noise_settings[i-1];
+	}
+	
+	/* Update globals */
+	command_available = true;
+	command_to_send = CMD_NOISE_SETTINGS;
+	
+	/* Create an interrupt to be addressed as soon as possible */
+	timer_type0_enable(&TCD0, TIMER_PRESCALER_DIV1, 1, INT_LEVEL_LOW);
+}
+
+bool par_cmd_noise_settings_callback (void)
+{
+	for (uint8_t i = 1; i < CMD_NOISE_SETTINGS_LEN - 1; i++)
+	{
+		send_byte(cmd_noise_settings[i]);
+	}
+	send_last_byte(cmd_noise_settings[CMD_NOISE_SETTINGS_LEN - 1]);
+}
+
 /************************************************************************/
 /* COMMAND: DELETE_SOUND                                                */
 /************************************************************************/
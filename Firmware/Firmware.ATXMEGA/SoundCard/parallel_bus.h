@@ -17,6 +17,18 @@
 #endif
 
 
+/************************************************************************/
+/* Sounds                                                               */
+/************************************************************************/
+/* Indexes below 32, or SOUNDS_MAX on the 4 Gb memory, are sounds, the
+ * others are frequencies up to 40000 Hz, followed by the noises
+ */
+#define SOUNDS_MAX 64
+#define NOISE_WHITE 40001
+#define NOISE_PINK 40002
+#define NOISE_BAND_PASS 40003
+
+
 /************************************************************************/
 /* Prototypes                                                           */
 /************************************************************************/
@@ -26,6 +38,25 @@ bool par_cmd_stop_callback (void);
 void par_cmd_start_sound(uint16_t sound_index, int16_t amplitude_left, int16_t amplitude_right);
 bool par_cmd_start_sound_callback (void);
 
+void par_cmd_start_sound_mixed(uint16_t sound_index, int16_t amplitude_left, int16_t amplitude_right);
+bool par_cmd_start_sound_mixed_callback (void);
+
+int32_t par_us_until(uint32_t second, uint32_t usecond);
+void par_cmd_start_sound_scheduled(uint16_t sound_index, int16_t amplitude_left, int16_t amplitude_right, uint32_t second, uint32_t usecond);
+bool par_cmd_start_sound_scheduled_callback (void);
+
+void par_cmd_start_tone(uint32_t frequency_left, uint32_t frequency_right, uint16_t phase_left, int16_t amplitude_left, int16_t amplitude_right);
+bool par_cmd_start_tone_callback (void);
+
+void par_cmd_start_sweep(uint32_t frequency_start, uint32_t frequency_end, uint32_t duration, uint8_t mode, int16_t amplitude_left, int16_t amplitude_right);
+bool par_cmd_start_sweep_callback (void);
+
+void par_cmd_noise_settings(uint32_t seed, uint16_t frequency_low, uint16_t frequency_high);
+bool par_cmd_noise_settings_callback (void);
+
+void par_cmd_start_stimulus(uint32_t frequency_carrier, uint32_t frequency_modulation, uint16_t depth, uint32_t duration, uint32_t ramp, uint32_t period, uint32_t count, int16_t amplitude_left, int16_t amplitude_right);
+bool par_cmd_start_stimulus_callback (void);
+
 void par_cmd_delete_sound(uint8_t sound_index, bool delete_all);
 bool par_cmd_delete_sound_callback (void);
 
@@ -15,73 +15,194 @@
 // *****************************************************************************
 DRV_HANDLE i2sDriverHandle;
 DRV_I2S_BUFFER_EVENT_HANDLER i2sBufferEventHandler;
-DRV_I2S_BUFFER_HANDLE i2sBufferHandle0;
-DRV_I2S_BUFFER_HANDLE i2sBufferHandle1;
 
 /* Allocate memory for the envelopes.
  * 32KBytes -> ~167 ms @ 192KHz
  * 32KBytes -> ~334 ms @ 96KHz
  */
-#define ENVELOPE_LENGTH 1024*32
 uint16_t envelope_internal[ENVELOPE_LENGTH];
 uint16_t envelope_user[ENVELOPE_LENGTH];
 
 
-#define AUDIO_BUFFER_LEN 2048/4
+#define AUDIO_BUFFER_LEN (2048/4)
 int audio_first_buffer[AUDIO_BUFFER_LEN] __attribute__((coherent));
-int audio_buffer0[AUDIO_BUFFER_LEN] __attribute__((coherent));
-int audio_buffer1[AUDIO_BUFFER_LEN] __attribute__((coherent));
-int audio_buffer0_length;
-int audio_buffer1_length;
 //int audio_buffer0_zeros[AUDIO_BUFFER_LEN] __attribute__((coherent));
 //int audio_buffer1_zeros[AUDIO_BUFFER_LEN] __attribute__((coherent));
 int audio_buffer_zeros[AUDIO_BUFFER_LEN] __attribute__((coherent));
 
-int audio_sinewave[AUDIO_BUFFER_LEN] __attribute__((coherent));
-float right_tetha = 0;
-float left_tetha = 0;
+Sound_Metadata audio_all_metadata[SOUNDS_MAX];
+bool audio_sound_exists[SOUNDS_MAX];
+unsigned long long audio_sound_exists_bitmask = 0;
+
+/* Head-of-sound cache.
+ * The first page of the most recently used sounds is kept on RAM so they
+ * start without waiting for the memory. On a miss, the page is read when the
+ * sound starts and replaces the least recently used entry. The following
+ * pages are read when needed, the second one while the first is being played.
+ *   16 entries x 2 KB = 32 KB
+ * The cache is warmed on boot with the first sounds and filled when a sound
+ * is uploaded.
+ * The user metadata is read from the memory when requested.
+ */
+#define SOUND_CACHE_ENTRIES 16
+
+typedef struct
+{
+    int sound_index;
+    unsigned int last_use;                      // 0 if the entry is free
+    int page[AUDIO_BUFFER_LEN];
+} Sound_Cache_Entry;
+
+Sound_Cache_Entry sound_cache[SOUND_CACHE_ENTRIES];
+unsigned int sound_cache_use = 0;
+unsigned int perf_sound_cache_hits = 0;
+unsigned int perf_sound_cache_misses = 0;
+
+/* Ring of buffers queued on the I2S DMA.
+ * While a sound is playing, AUDIO_RING_DEPTH buffers are kept in flight so a
+ * NAND read, a block erase or a USB command can stall the main loop up to
+ * (AUDIO_RING_DEPTH - 1) buffers without starving the I2S.
+ *   4 x 256 stereo samples -> ~5.3 ms @ 192KHz, ~10.7 ms @ 96KHz
+ * While idle, only AUDIO_RING_IDLE_DEPTH buffers are queued so a new sound
+ * doesn't wait behind a long queue.
+ * QUEUE_SIZE_TX_IDX0 in system_config.h must be at least AUDIO_RING_DEPTH.
+ */
+#define AUDIO_RING_DEPTH 4
+#define AUDIO_RING_IDLE_DEPTH 2
 
-int audio_all_first_buffers[32][AUDIO_BUFFER_LEN];
-int audio_all_second_buffers[32][AUDIO_BUFFER_LEN];
-Sound_Metadata audio_all_metadata[32];
-bool audio_sound_exists[32];
-unsigned int audio_sound_exists_bitmask = 0;
-unsigned char audio_user_metadata[32][2048];
+#if AUDIO_RING_DEPTH > QUEUE_SIZE_TX_IDX0
+#error "QUEUE_SIZE_TX_IDX0 must be at least AUDIO_RING_DEPTH"
+#endif
 
 #define AUDIO_BUFFER_IS_EMPTY 0
 #define AUDIO_BUFFER_HAS_DATA 1
-volatile int audio_buffer0_state = AUDIO_BUFFER_IS_EMPTY;
-volatile int audio_buffer1_state = AUDIO_BUFFER_IS_EMPTY;
+
+/* Events executed when the buffer finishes, i.e., when the next one starts.
+ * The SOUND_IS_ON edges are placed at a frame of the next buffer, counted from
+ * its start, so they match the first and last non-zero samples.
+ */
+#define AUDIO_RING_EVENT_SET_SOUND_IS_ON (1<<0)
+#define AUDIO_RING_EVENT_CLR_SOUND_IS_ON (1<<1)
+#define AUDIO_RING_EVENT_PULSE_SOUND_IS_ON (1<<2)
+
+int audio_ring_buffers[AUDIO_RING_DEPTH][AUDIO_BUFFER_LEN] __attribute__((coherent));
+int *audio_ring_buffer[AUDIO_RING_DEPTH];   // Buffer queued on each slot
+DRV_I2S_BUFFER_HANDLE i2sBufferHandle[AUDIO_RING_DEPTH];
+volatile int audio_ring_state[AUDIO_RING_DEPTH];
+volatile int audio_ring_event[AUDIO_RING_DEPTH];
+int audio_ring_set_frame[AUDIO_RING_DEPTH];
+int audio_ring_clr_frame[AUDIO_RING_DEPTH];
+int audio_ring_num_samples[AUDIO_RING_DEPTH];
+int audio_ring_head = 0;            // Next buffer to be queued
+volatile unsigned int audio_ring_tick;  // Core timer when the buffer being played started
+
+/* Stop.
+ * The queued buffers are cut AUDIO_STOP_MARGIN frames after the frame being
+ * played, the margin covers the I2S FIFO and the estimate of the DMA position.
+ * The sound ramps down along the envelope in AUDIO_STOP_RAMP_LENGTH frames.
+ *   16 + 64 frames -> ~0.42 ms @ 192KHz, ~0.83 ms @ 96KHz
+ */
+#define AUDIO_STOP_MARGIN 16
+#define AUDIO_STOP_RAMP_LENGTH 64
+
+/* Mixer voices.
+ * Up to AUDIO_MIX_VOICES sounds are summed on top of the sound being played,
+ * each one with its own attenuation applied digitally (Q30 gains).
+ * The voices play at the current sample rate and start on the next buffer.
+ * Each voice costs a NAND page read (~200 us) and a mix (~25 us) per buffer:
+ *   256 stereo samples -> ~1.33 ms @ 192KHz, ~2.67 ms @ 96KHz
+ * The pages are read ahead by prefetch_voice_pages(), one per main loop.
+ */
+#define AUDIO_MIX_VOICES 3
+
+typedef struct {
+    bool active;
+    int sound_index;
+    int sound_length;
+    int sound_length_produced;
+    int gain_left;      // Q30, AUDIO_GAIN_UNITY is 0 dB
+    int gain_right;     // Q30, AUDIO_GAIN_UNITY is 0 dB
+    int fade_length;
+    int page[AUDIO_BUFFER_LEN];
+    int page_index;     // Page on page[], -1 if none
+} Audio_Voice;
+
+Audio_Voice audio_voices[AUDIO_MIX_VOICES];
+int audio_voices_active = 0;
+int audio_mix_page[AUDIO_BUFFER_LEN];
 
 #define NEW_SOUND_STATE_STANDBY 0
 #define NEW_SOUND_STATE_IS_AVAILABLE 1
-#define NEW_SOUND_STATE_FIRST_BUFFER_DONE 2
 Sound_Metadata play_metadata;
 int sound_length_produced;
 bool sound_is_playing = false;
 int new_sound_to_start = NEW_SOUND_STATE_STANDBY;
 int new_sound_index;
-
-#define SET_SOUND_IS_ON_WHEN_POSSIBLE 0
-#define SET_SOUND_IS_ON_DONE 1
-int set_sound_is_on_when_possible = SET_SOUND_IS_ON_DONE;
-#define CLR_SOUND_IS_ON_WHEN_POSSIBLE 0
-#define CLR_SOUND_IS_ON_DONE 1
-int clr_sound_is_on_when_possible = CLR_SOUND_IS_ON_DONE;
-int clr_sound_is_on_num_samples;
+int new_sound_att_left = -1;        // Applied with the first buffer of the sound, -1 keeps the current one
+int new_sound_att_right = -1;
+bool sound_marker_pending = false;  // SOUND_IS_ON waits for the first non-zero sample
+bool sound_marker_is_on = false;
+int sound_marker_slot;              // Last chunk queued with a non-zero sample
+int sound_marker_clr_frame;         // Frame after its last non-zero sample
+int sound_marker_silent_chunks;     // Chunks queued after it
+
+/* Sound waiting for a core timer tick to start.
+ * Zeros are queued until the exact sample slot of that tick.
+ */
+bool sound_scheduled = false;
+int sound_scheduled_index;
+unsigned int sound_scheduled_tick;
+int sound_scheduled_att_left;
+int sound_scheduled_att_right;
+
+/* Sound streamed from USB.
+ * The host pushes chunks of 32 KB into a RAM FIFO that feeds the I2S directly.
+ * A chunk is only acknowledged when it fits in the FIFO, so the host is
+ * throttled by the replies. The playback starts when the FIFO is full or the
+ * host ends the stream with a shorter chunk.
+ *   2 x 8192 samples -> ~85 ms @ 96KHz, ~43 ms @ 192KHz
+ * The stored sounds take over the DAC and the stream resumes when they end.
+ */
+#define STREAM_CHUNK_LEN (32768/4)
+#define STREAM_FIFO_CHUNKS 2
+#define STREAM_FIFO_LEN (STREAM_FIFO_CHUNKS * STREAM_CHUNK_LEN)   // Must be a power of 2
+
+#define STREAM_STATE_IDLE 0
+#define STREAM_STATE_FILLING 1
+#define STREAM_STATE_PLAYING 2
+
+int stream_fifo[STREAM_FIFO_LEN];
+int stream_fifo_read = 0;
+int stream_fifo_write = 0;
+int stream_fifo_count = 0;
+int stream_state = STREAM_STATE_IDLE;
+int stream_sample_rate;
+bool stream_ended;
+bool stream_first_buffer;
+bool stream_marker_is_on;
+unsigned int stream_underruns = 0;  // Buffers of silence played because the FIFO was empty
 
 /* Receive data buffer */
 uint8_t receivedDataBuffer[APP_READ_BUFFER_SIZE] APP_MAKE_BUFFER_DMA_READY;
 /* Transmit data buffer */
-uint8_t  transmitDataBuffer[APP_READ_BUFFER_SIZE] APP_MAKE_BUFFER_DMA_READY;
+uint8_t  transmitDataBuffer[APP_WRITE_BUFFER_SIZE] APP_MAKE_BUFFER_DMA_READY;
 /* The endpoint size is 64 for FS and 512 for HS */
 uint16_t endpointSize;
 
 int sound_index_to_write;
+int sound_data_type_to_write;
 int max_sound_data_index;
 
-volatile int dma_i2s_handle0_timeout = 0;
-volatile int dma_i2s_handle1_timeout = 0;
+/* Data commands are pipelined.
+ * The 32 KB of a data command are copied here and acknowledged right away, so
+ * the host transfers the next command while this one is being programmed.
+ * The next command waits in receivedDataBuffer until this one is programmed,
+ * and the reply to the last command of the sound is only sent once it is on
+ * the NAND.
+ */
+uint8_t dataCmd_buffer[32768];
+
+volatile int dma_i2s_timeout = 0;
 
 bool metadataCmd_received = false;
 bool dataCmd_received = false;
@@ -95,6 +216,32 @@ void prepare_dataCmd(void);
 
 int current_sample_rate = 96000;
 
+/* Performance counters.
+ * All values are core timer ticks (CPU_CT_HZ, 10 ns per tick).
+ * Read them with the debugger to measure latency without the rig.
+ *   perf_trigger_latency: start command received -> first sample on I2S
+ *                         (scheduled start tick -> first sample on I2S)
+ *   perf_underruns: buffers completed with no other buffer queued while playing
+ *   perf_schedule_late: scheduled sounds that couldn't start on time
+ *   perf_loop_*: time between consecutive calls of APP_Tasks()
+ *   perf_boot_memory: time to load the sounds' table and to warm the
+ *                     head-of-sound cache on APP_Initialize()
+ *   perf_stop_tick: core timer when the last stop reaches silence
+ *   perf_stop_latency: stop command received -> silence on I2S
+ */
+unsigned int perf_trigger_tick;
+volatile unsigned int perf_trigger_latency = 0;
+volatile unsigned int perf_trigger_latency_max = 0;
+volatile unsigned int perf_underruns = 0;
+unsigned int perf_schedule_late = 0;
+unsigned int perf_loop_tick;
+unsigned int perf_loop_last = 0;
+unsigned int perf_loop_max = 0;
+unsigned int perf_boot_memory = 0;
+unsigned int perf_stop_tick = 0;
+unsigned int perf_stop_latency = 0;
+unsigned int perf_stop_latency_max = 0;
+
 
 // *****************************************************************************
 /* Application Data
@@ -118,56 +265,59 @@ APP_DATA appData;
 // Section: Application Callback Functions
 // *****************************************************************************
 // *****************************************************************************
+/* The first sample of the new sound starts when the previous buffer completes */
+static void update_perf_trigger_latency(void)
+{
+    perf_trigger_latency = _CP0_GET_COUNT() - perf_trigger_tick;
+    
+    if (perf_trigger_latency > perf_trigger_latency_max)
+        perf_trigger_latency_max = perf_trigger_latency;
+}
+
 void I2SBufferEventHandler( DRV_I2S_BUFFER_EVENT event,
                             DRV_I2S_BUFFER_HANDLE bufferHandle,
                             uintptr_t context )
 {
+    int slot = 0;
+    
     switch (event)
     {
         case DRV_I2S_BUFFER_EVENT_COMPLETE:
         {
-            if (bufferHandle == i2sBufferHandle0)
+            for (; slot < AUDIO_RING_DEPTH; slot++)
+                if (bufferHandle == i2sBufferHandle[slot])
+                    break;
+            
+            if (slot == AUDIO_RING_DEPTH)
+                break;
+            
+            audio_ring_state[slot] = AUDIO_BUFFER_IS_EMPTY;
+            audio_ring_tick = _CP0_GET_COUNT();
+            
+            if (sound_is_playing && audio_ring_state[(slot + 1) % AUDIO_RING_DEPTH] == AUDIO_BUFFER_IS_EMPTY)
+                perf_underruns++;
+            
+            if (audio_ring_event[slot] & AUDIO_RING_EVENT_SET_SOUND_IS_ON)
             {
-                if (audio_buffer0_state == AUDIO_BUFFER_HAS_DATA)
-                    audio_buffer0_state = AUDIO_BUFFER_IS_EMPTY;
-                
-                if (set_sound_is_on_when_possible == SET_SOUND_IS_ON_WHEN_POSSIBLE)
-                {
-                    clr_SOUND_IS_ON;
-                    set_sound_is_on_when_possible = SET_SOUND_IS_ON_DONE;
-                    trigger_pin_sound_is_on(current_sample_rate);
-                }
-                
-                if (clr_sound_is_on_when_possible == CLR_SOUND_IS_ON_WHEN_POSSIBLE)
-                {
-                    clr_sound_is_on_when_possible = CLR_SOUND_IS_ON_DONE;
-                    tgl_TP0;
-                    trigger_pin_sound_is_off(current_sample_rate, clr_sound_is_on_num_samples);
-                }
-
-                dma_i2s_handle0_timeout = 0;
+                update_perf_trigger_latency();
+                clr_SOUND_IS_ON;
+                trigger_pin_sound_is_on(current_sample_rate, audio_ring_set_frame[slot]);
             }
-            if (bufferHandle == i2sBufferHandle1)
+            
+            if (audio_ring_event[slot] & AUDIO_RING_EVENT_PULSE_SOUND_IS_ON)
             {
-                if (audio_buffer1_state == AUDIO_BUFFER_HAS_DATA)
-                    audio_buffer1_state = AUDIO_BUFFER_IS_EMPTY;
-                
-                if (set_sound_is_on_when_possible == SET_SOUND_IS_ON_WHEN_POSSIBLE)
-                {
-                    clr_SOUND_IS_ON;
-                    set_sound_is_on_when_possible = SET_SOUND_IS_ON_DONE;
-                    trigger_pin_sound_is_on(current_sample_rate);
-                }
-                
-                if (clr_sound_is_on_when_possible == CLR_SOUND_IS_ON_WHEN_POSSIBLE)
-                {
-                    clr_sound_is_on_when_possible = CLR_SOUND_IS_ON_DONE;
-                    tgl_TP0;
-                    trigger_pin_sound_is_off(current_sample_rate, clr_sound_is_on_num_samples);
-                }
-                
-                dma_i2s_handle1_timeout = 0;
+                trigger_pin_sinewave_is_on(current_sample_rate, audio_ring_set_frame[slot]);
             }
+            
+            if (audio_ring_event[slot] & AUDIO_RING_EVENT_CLR_SOUND_IS_ON)
+            {
+                tgl_TP0;
+                trigger_pin_sound_is_off(current_sample_rate, audio_ring_clr_frame[slot]);
+            }
+            
+            audio_ring_event[slot] = 0;
+            
+            dma_i2s_timeout = 0;
         }
     }
 }
@@ -329,462 +479,1686 @@ int launch_sound_v3(void/*int index*/)
 }
 
 
-//http://www.dcs.gla.ac.uk/~jhw/cordic/
-
-//Cordic in 32 bit signed fixed point math
-//Function is valid for arguments in range -pi/2 -- pi/2
-//for values pi/2--pi: value = half_pi-(theta-half_pi) and similarly for values -pi---pi/2
-//
-// 1.0 = 1073741824
-// 1/k = 0.6072529350088812561694
-// pi = 3.1415926535897932384626
-//Constants
-#define cordic_1K 0x26DD3B6A
-#define half_pi 0x6487ED51
-#define MUL 1073741824.000000
-#define CORDIC_NTAB 32
-int cordic_ctab [] = {0x3243F6A8, 0x1DAC6705, 0x0FADBAFC, 0x07F56EA6, 0x03FEAB76, 0x01FFD55B, 
-0x00FFFAAA, 0x007FFF55, 0x003FFFEA, 0x001FFFFD, 0x000FFFFF, 0x0007FFFF, 0x0003FFFF, 
-0x0001FFFF, 0x0000FFFF, 0x00007FFF, 0x00003FFF, 0x00001FFF, 0x00000FFF, 0x000007FF, 
-0x000003FF, 0x000001FF, 0x000000FF, 0x0000007F, 0x0000003F, 0x0000001F, 0x0000000F, 
-0x00000008, 0x00000004, 0x00000002, 0x00000001, 0x00000000, };
-
-int cordic(int theta, /*int *s, */ /*int *c, */int n)
-{
-  int k, d, tx, ty, tz;
-  int x=cordic_1K,y=0,z=theta;
-  // n = (n>CORDIC_NTAB) ? CORDIC_NTAB : n;
-  for (k=0; k<n; ++k)
-  {
-    d = z>>31;
-    //get sign. for other architectures, you might want to use the more portable version
-    //d = z>=0 ? 0 : -1;
-    tx = x - (((y>>k) ^ d) - d);
-    ty = y + (((x>>k) ^ d) - d);
-    tz = z - ((cordic_ctab[k] ^ d) - d);
-    x = tx; y = ty; z = tz;
-  }  
- /*c = x;*/ /**s = y;*/
-            return y;   // sine
-}
-
-int right_sinewave_freq = 0;
-int left_sinewave_freq = 0;
-
-int new_right_sinewave_freq;
+/* Sine generator.
+ * Direct digital synthesis: a 32-bit phase accumulator per channel reads a
+ * quarter-wave table, interpolating linearly between its entries.
+ *   Resolution: sample rate / 2^32 -> ~22 uHz @ 96KHz, ~45 uHz @ 192KHz
+ *   Error: ~-130 dB of the amplitude
+ * The channels run independent oscillators, each with its own frequency in
+ * mHz, and the left one may lead the right one by a phase offset. A channel
+ * with a frequency of 0 is silent.
+ * A new tone starts at a rising zero crossing of the reference channel (the
+ * right one, or the left one if the right is silent), where the marker pulse
+ * is placed. The reference keeps its phase, so it has no discontinuity, and
+ * the other channel is realigned to the new phase offset.
+ * A tone may also sweep both channels from its frequency to another one,
+ * changing the phase increment on every frame: by a constant step on linear
+ * sweeps or by a constant ratio on logarithmic ones. A chirp stops at the end
+ * of the sweep, on the next zero crossing, and a glide stays at the end
+ * frequency.
+ */
+#define SINE_TABLE_BITS 10
+#define SINE_TABLE_LENGTH (1 << SINE_TABLE_BITS)
+#define SINE_AMPLITUDE (1 << 30)            // -6 dBFS
+
+typedef struct {
+    unsigned int phase;
+    unsigned int increment;     // Phase step per frame, 2^32 is a cycle
+    int frequency;              // mHz, 0 if the channel is silent
+} Sine_Oscillator;
+
+#define SINE_SWEEP_LOGARITHMIC (1 << 0)
+#define SINE_SWEEP_GLIDE (1 << 1)
+
+typedef struct {
+    int frames;                     // Frames left, 0 if not sweeping
+    int mode;
+    long long step;                 // Linear: increment step, Q32.32
+    int ratio;                      // Logarithmic: increment ratio - 1, Q0.32
+    unsigned long long increment;   // Q32.32
+    int end_frequency;              // mHz
+} Sine_Sweep;
+
+int sine_table[SINE_TABLE_LENGTH + 2];     // sin(0) to sin(pi/2), the last entry is repeated
+Sine_Oscillator sine_left;
+Sine_Oscillator sine_right;
+Sine_Sweep sine_sweep;
+unsigned int sine_gen_phase_left;           // Offset of the left channel to the right one
+bool sine_gen_is_on = false;
+int sine_gen_sample_rate;
+bool sine_gen_cycle_start;                  // The next frame starts a cycle of the reference channel
+
+int new_sine_gen_frequency_left;
+int new_sine_gen_frequency_right;
+unsigned int new_sine_gen_phase_left;
+int new_sine_gen_sweep_frequency;           // End frequency in mHz
+int new_sine_gen_sweep_duration;            // ms, 0 for a constant tone
+int new_sine_gen_sweep_mode;
 bool new_sine_gen_frequency_is_available = false;
 bool stop_sine_gen = false;
+int sinewave_marker_frame = -1;     // Frame of the buffer where the marker pulse starts
 
-int right_mult = 1;
-int left_mult = 1;
-
-bool right_positive = true;
-bool left_positive = true;
+#define SINEWAVE_GEN_96KHZ_LOAD_SAMPLE_N 64
+#define SINEWAVE_GEN_192KHZ_LOAD_SAMPLE_N 128
 
+void populate_sine_table(void)
+{
+    int i = 0;
+    
+    for (; i <= SINE_TABLE_LENGTH; i++)
+        sine_table[i] = SINE_AMPLITUDE * sin(1.5707963267948966 * i / SINE_TABLE_LENGTH) + 0.5;
+    
+    sine_table[SINE_TABLE_LENGTH + 1] = sine_table[SINE_TABLE_LENGTH];
+}
 
-#define SINEWAVE_GEN_96KHZ_LOAD_SAMPLE_N 64
-#define CORDIC_ITERACTIONS 12
+static unsigned int sine_increment(int frequency, int sample_rate)
+{
+    return ((unsigned long long)frequency << 32) / ((unsigned long long)sample_rate * 1000);
+}
 
-int freqs[4] = {1000, 1234, 1000, 1234};
-int freqs_index = 0;
-int counter = 0;
+static inline int sine_sample(unsigned int phase)
+{
+    unsigned int position = phase & 0x3FFFFFFF;
+    unsigned int index;
+    int fraction;
+    int sample;
+    
+    /* The second and fourth quadrants read the table backwards */
+    if (phase & 0x40000000)
+        position = 0x40000000 - position;
+    
+    index = position >> (30 - SINE_TABLE_BITS);
+    fraction = (position >> (30 - SINE_TABLE_BITS - 16)) & 0xFFFF;
+    sample = sine_table[index] + (((long long)(sine_table[index + 1] - sine_table[index]) * fraction) >> 16);
+    
+    return (phase & 0x80000000) ? -sample : sample;
+}
 
-void proc_sinewave_generator(void)
+static void set_sine_oscillator(Sine_Oscillator *oscillator, int frequency)
 {
-    int i = 0;
+    oscillator->frequency = frequency;
+    oscillator->increment = sine_increment(frequency, current_sample_rate);
     
-    if (new_sine_gen_frequency_is_available)
-        if (right_sinewave_freq == 0)
-        {
-            new_sine_gen_frequency_is_available = false;
+    /* Keeps a silent channel at zero */
+    if (frequency == 0)
+        oscillator->phase = 0;
+}
 
-            right_sinewave_freq = new_right_sinewave_freq;
-            
-            //set_SOUND_IS_ON;
-            trigger_pin_sinewave_is_on(96000, 0);
-        }
+/* Applies the new tone.
+ * The reference channel keeps its phase and the other one is aligned to it.
+ */
+static void set_sine_gen_tone(void)
+{
+    set_sine_oscillator(&sine_left, new_sine_gen_frequency_left);
+    set_sine_oscillator(&sine_right, new_sine_gen_frequency_right);
+    sine_gen_phase_left = new_sine_gen_phase_left;
+    sine_gen_sample_rate = current_sample_rate;
+    
+    if (sine_right.frequency != 0 && sine_left.frequency != 0)
+        sine_left.phase = sine_right.phase + sine_gen_phase_left;
+    
+    sine_sweep.frames = 0;
     
-    if (right_sinewave_freq != 0)
+    if (new_sine_gen_sweep_duration != 0)
     {
-        set_LED_AUDIO;
-            
-        for (; i < SINEWAVE_GEN_96KHZ_LOAD_SAMPLE_N/2; i++)
-        {                
-            right_tetha = right_tetha + (right_mult)*(half_pi/(96000.0/(right_sinewave_freq<<2)));
+        sine_sweep.frames = (long long)new_sine_gen_sweep_duration * current_sample_rate / 1000;
+        sine_sweep.mode = new_sine_gen_sweep_mode;
+        sine_sweep.end_frequency = new_sine_gen_sweep_frequency;
+        sine_sweep.increment = (unsigned long long)sine_right.increment << 32;
+        
+        if (sine_sweep.mode & SINE_SWEEP_LOGARITHMIC)
+            sine_sweep.ratio = (exp(log((double)sine_sweep.end_frequency / sine_right.frequency) / sine_sweep.frames) - 1) * 4294967296.0;
+        else
+            sine_sweep.step = ((long long)sine_increment(sine_sweep.end_frequency, current_sample_rate) - sine_right.increment) * 4294967296LL / sine_sweep.frames;
+    }
+}
 
-            if (right_tetha > half_pi)
-            {
-                right_mult = -1;
-                right_tetha = half_pi - (right_tetha - half_pi);
-            }
-            if (right_tetha < -half_pi)
-            {
-                right_mult = 1;
-                right_tetha = -half_pi - (right_tetha + half_pi);
-            }
+static void end_sine_sweep(void)
+{
+    sine_sweep.frames = 0;
+    set_sine_oscillator(&sine_left, sine_sweep.end_frequency);
+    set_sine_oscillator(&sine_right, sine_sweep.end_frequency);
+    
+    /* A chirp stops on the next zero crossing */
+    if (!(sine_sweep.mode & SINE_SWEEP_GLIDE))
+        stop_sine_gen = true;
+}
 
-            audio_sinewave[i*2+1] = cordic((int)(right_tetha), CORDIC_ITERACTIONS);
-            
-            if (right_tetha > 0)
-            {   
-                //clr_SOUND_IS_ON;
-                
-                if (right_positive == false)
-                {
-                    if (new_sine_gen_frequency_is_available)
-                    {
-                        new_sine_gen_frequency_is_available = false;
-                        
-                        if (right_sinewave_freq != new_right_sinewave_freq)
-                        {
-                            /* Update only if the new frequency is different */
-                            right_sinewave_freq = new_right_sinewave_freq;
-
-                            //set_SOUND_IS_ON;
-                            trigger_pin_sinewave_is_on(96000, i);
-                        }
-                    }
-                    
-                    if (stop_sine_gen)
-                    {
-                        right_sinewave_freq = 0;
-                    }
-                }
-                
-                right_positive = true;
-            }
-            else
-            {
-                right_positive = false;
-            }
-        }
+/* Moves the sweep one frame */
+static inline void update_sine_sweep(void)
+{
+    if (--sine_sweep.frames == 0)
+    {
+        end_sine_sweep();
+        return;
     }
-    else
+    
+    if (sine_sweep.mode & SINE_SWEEP_LOGARITHMIC)
     {
-        if (new_sine_gen_frequency_is_available)
-        {
-            new_sine_gen_frequency_is_available = false;
-
-            right_sinewave_freq = new_sound_index;
-        }
+        unsigned int integer = sine_sweep.increment >> 32;
+        unsigned int fraction = sine_sweep.increment;
         
-        if (stop_sine_gen)
-        {
-            stop_sine_gen = false;
-            
-            clr_LED_AUDIO;
-
-            for (; i < SINEWAVE_GEN_96KHZ_LOAD_SAMPLE_N/2; i++)
-            {
-                audio_sinewave[i*2+1] = 0;
-            }
-
-            right_tetha = 0;
-            right_mult = 1;
-        }
+        sine_sweep.increment += (long long)integer * sine_sweep.ratio + (((long long)fraction * sine_sweep.ratio) >> 32);
     }
+    else
+        sine_sweep.increment += sine_sweep.step;
+    
+    sine_left.increment = sine_sweep.increment >> 32;
+    sine_right.increment = sine_left.increment;
 }
 
-void update_sound_buffers (void)
+void stop_sinewave_generator(void)
+{
+    if (sine_gen_is_on)
+        clr_LED_AUDIO;
+    
+    sine_gen_is_on = false;
+    sine_sweep.frames = 0;
+    sine_left.phase = 0;
+    sine_right.phase = 0;
+    new_sine_gen_frequency_is_available = false;
+    stop_sine_gen = false;
+}
+
+/* Fills a stereo buffer with the generator.
+ * Returns false if the generator is off.
+ */
+bool proc_sinewave_generator(int *buffer, int num_samples)
 {
+    Sine_Oscillator *reference;
     int i = 0;
     
-    if (/*!sound_is_playing && */new_sound_to_start == NEW_SOUND_STATE_IS_AVAILABLE)
+    if (!sine_gen_is_on)
+    {
+        stop_sine_gen = false;
+        
+        if (!new_sine_gen_frequency_is_available)
+            return false;
+        
+        new_sine_gen_frequency_is_available = false;
+        
+        sine_left.phase = 0;
+        sine_right.phase = 0;
+        set_sine_gen_tone();
+        sine_gen_is_on = true;
+        sine_gen_cycle_start = false;
+        sinewave_marker_frame = 0;
+        
+        set_LED_AUDIO;
+    }
+    
+    /* A stored sound played in the meantime may have changed the sample rate */
+    if (sine_gen_sample_rate != current_sample_rate)
+    {
+        /* The sweep is computed for the previous one, so it ends here */
+        if (sine_sweep.frames != 0)
+            end_sine_sweep();
+        
+        set_sine_oscillator(&sine_left, sine_left.frequency);
+        set_sine_oscillator(&sine_right, sine_right.frequency);
+        sine_gen_sample_rate = current_sample_rate;
+    }
+    
+    reference = (sine_right.frequency != 0) ? &sine_right : &sine_left;
+    
+    for (; i < num_samples; i += 2)
     {
-        if (audio_buffer0_state == AUDIO_BUFFER_IS_EMPTY || audio_buffer1_state == AUDIO_BUFFER_IS_EMPTY)
+        if (sine_gen_cycle_start)
         {
-            new_sound_to_start = NEW_SOUND_STATE_FIRST_BUFFER_DONE;
-            set_sound_is_on_when_possible = SET_SOUND_IS_ON_WHEN_POSSIBLE;
-            sound_is_playing = true;
-            set_page_and_sound_index(1, new_sound_index);
-            
-            config_audio_dac(play_metadata.sample_rate, (play_metadata.sample_rate != current_sample_rate) ? true : false);
-            current_sample_rate = play_metadata.sample_rate;
+            sine_gen_cycle_start = false;
             
-            if (play_metadata.sound_length > AUDIO_BUFFER_LEN)
+            if (stop_sine_gen)
             {
-                sound_length_produced = AUDIO_BUFFER_LEN;
+                stop_sinewave_generator();
                 
-                if (audio_buffer0_state == AUDIO_BUFFER_IS_EMPTY)
-                {
-                    DRV_I2S_BufferAddWrite(i2sDriverHandle, &i2sBufferHandle0, audio_all_first_buffers[new_sound_index], AUDIO_BUFFER_LEN * 4);
-                    audio_buffer0_state = AUDIO_BUFFER_HAS_DATA;
-                    set_LED_AUDIO;
-                }
-                else
-                {
-                    DRV_I2S_BufferAddWrite(i2sDriverHandle, &i2sBufferHandle1, audio_all_first_buffers[new_sound_index], AUDIO_BUFFER_LEN * 4);
-                    audio_buffer1_state = AUDIO_BUFFER_HAS_DATA;
-                    set_LED_AUDIO;
-                }
+                for (; i < num_samples; i++)
+                    buffer[i] = 0;
+                
+                break;
             }
-            else
+            
+            if (new_sine_gen_frequency_is_available)
             {
-                sound_length_produced = play_metadata.sound_length;
+                new_sine_gen_frequency_is_available = false;
                 
-                if (audio_buffer0_state == AUDIO_BUFFER_IS_EMPTY)
+                /* Update only if the new tone is different */
+                if (sine_left.frequency != new_sine_gen_frequency_left ||
+                    sine_right.frequency != new_sine_gen_frequency_right ||
+                    sine_gen_phase_left != new_sine_gen_phase_left ||
+                    sine_sweep.frames != 0 || new_sine_gen_sweep_duration != 0)
                 {
-                    DRV_I2S_BufferAddWrite(i2sDriverHandle, &i2sBufferHandle0, audio_all_first_buffers[new_sound_index], play_metadata.sound_length * 4);
-                    audio_buffer0_state = AUDIO_BUFFER_HAS_DATA;
-                    set_LED_AUDIO;
+                    set_sine_gen_tone();
+                    reference = (sine_right.frequency != 0) ? &sine_right : &sine_left;
+                    sinewave_marker_frame = i >> 1;
                 }
-                else
-                {
-                    DRV_I2S_BufferAddWrite(i2sDriverHandle, &i2sBufferHandle1, audio_all_first_buffers[new_sound_index], play_metadata.sound_length * 4);
-                    audio_buffer1_state = AUDIO_BUFFER_HAS_DATA;
-                    set_LED_AUDIO;
-                }                
             }
         }
+        
+        buffer[i]   = sine_sample(sine_left.phase);
+        buffer[i+1] = sine_sample(sine_right.phase);
+        
+        if (reference->phase + reference->increment < reference->phase)
+            sine_gen_cycle_start = true;
+        
+        sine_left.phase += sine_left.increment;
+        sine_right.phase += sine_right.increment;
+        
+        if (sine_sweep.frames != 0)
+            update_sine_sweep();
+    }
+    
+    return true;
+}
+
+/* Stimulus generator.
+ * Plays a train of bursts described by a few parameters, so the usual
+ * conditions don't need a sound to be uploaded:
+ *   Tone pips: bursts of the carrier with raised cosine ramps.
+ *   AM tones: the carrier modulated by (1 + m.sin(2.pi.fm.t)) / (1 + m).
+ *   Click trains: rectangular pulses, if the carrier frequency is 0.
+ * Each burst lasts the duration, ramps in and out along the envelope, and
+ * starts one period after the previous one, for the number of bursts or until
+ * stopped if it's 0. The carrier and the modulation start at phase 0 on every
+ * burst, so all the bursts are equal. Both channels play the same stimulus.
+ * The times are converted to frames when the stimulus starts. The period
+ * keeps the fraction of a frame, so long trains don't drift.
+ * The marker pulse goes out on the onsets, at most one per buffer.
+ */
+typedef struct {
+    Sine_Oscillator carrier;
+    Sine_Oscillator modulator;
+    int am_offset;                  // Q30, 1 / (1 + m)
+    int am_depth;                   // Q30, m / (1 + m)
+    int duration;                   // Frames of each burst
+    int ramp;                       // Frames of each ramp
+    unsigned int ramp_step;         // Envelope entries per frame, Q16
+    int period;                     // Frames between onsets
+    int period_fraction;            // Fraction of a frame of the period, in 1/1000000
+    int period_error;               // Fraction accumulated
+    int period_length;              // Frames of the current period
+    int frame;                      // Frame of the current period
+    int count;                      // Bursts left, including the current one
+    bool endless;
+} Stimulus;
+
+Stimulus stimulus;
+bool stimulus_gen_is_on = false;
+int stimulus_gen_stop_ramp;                 // Frames left of the ramp down
+
+int new_stimulus_gen_carrier;               // mHz, 0 for clicks
+int new_stimulus_gen_modulation;            // mHz
+int new_stimulus_gen_depth;                 // 0.1%
+int new_stimulus_gen_duration;              // us
+int new_stimulus_gen_ramp;                  // us
+int new_stimulus_gen_period;                // us
+int new_stimulus_gen_count;                 // 0 until stopped
+bool new_stimulus_gen_is_available = false;
+bool stop_stimulus_gen = false;
+
+static int stimulus_frames(int time)
+{
+    return ((long long)time * current_sample_rate + 500000) / 1000000;
+}
+
+static void set_stimulus_gen(void)
+{
+    long long period = (long long)new_stimulus_gen_period * current_sample_rate;
+    double depth = new_stimulus_gen_depth / 1000.0;
+    
+    set_sine_oscillator(&stimulus.carrier, new_stimulus_gen_carrier);
+    set_sine_oscillator(&stimulus.modulator, new_stimulus_gen_modulation);
+    stimulus.am_offset = 1073741824.0 / (1 + depth);
+    stimulus.am_depth = 1073741824.0 * depth / (1 + depth);
+    
+    stimulus.duration = stimulus_frames(new_stimulus_gen_duration);
+    if (stimulus.duration == 0)
+        stimulus.duration = 1;
+    
+    stimulus.ramp = stimulus_frames(new_stimulus_gen_ramp);
+    if (stimulus.ramp > stimulus.duration / 2)
+        stimulus.ramp = stimulus.duration / 2;
+    if (stimulus.ramp != 0)
+        stimulus.ramp_step = ((unsigned int)ENVELOPE_LENGTH << 16) / stimulus.ramp;
+    
+    stimulus.period = period / 1000000;
+    stimulus.period_fraction = period % 1000000;
+    stimulus.period_error = 0;
+    if (stimulus.period < stimulus.duration)
+        stimulus.period = stimulus.duration;
+    
+    stimulus.count = new_stimulus_gen_count;
+    stimulus.endless = (new_stimulus_gen_count == 0);
+    
+    /* The first frame starts the first burst */
+    stimulus.period_length = 0;
+    stimulus.frame = 0;
+    
+    stimulus_gen_stop_ramp = AUDIO_STOP_RAMP_LENGTH;
+}
+
+void stop_stimulus_generator(void)
+{
+    if (stimulus_gen_is_on)
+        clr_LED_AUDIO;
+    
+    stimulus_gen_is_on = false;
+    new_stimulus_gen_is_available = false;
+    stop_stimulus_gen = false;
+}
+
+/* Fills a stereo buffer with the stimulus.
+ * Returns false if the generator is off.
+ */
+bool proc_stimulus_generator(int *buffer, int num_samples)
+{
+    int sample;
+    int i = 0;
+    
+    if (!stimulus_gen_is_on)
+    {
+        stop_stimulus_gen = false;
+        
+        /* A tone being played stops on its next zero crossing */
+        if (!new_stimulus_gen_is_available || sine_gen_is_on)
+            return false;
+        
+        new_stimulus_gen_is_available = false;
+        
+        set_stimulus_gen();
+        stimulus_gen_is_on = true;
+        
+        set_LED_AUDIO;
     }
     
-    if (new_sound_to_start == NEW_SOUND_STATE_FIRST_BUFFER_DONE)
+    for (; i < num_samples; i += 2)
     {
-        if (audio_buffer0_state == AUDIO_BUFFER_IS_EMPTY)
+        /* Ends after the last burst or the ramp down */
+        if ((!stimulus.endless && stimulus.count == 1 && stimulus.frame == stimulus.duration) ||
+            (stop_stimulus_gen && stimulus_gen_stop_ramp == 0))
         {
-            new_sound_to_start = NEW_SOUND_STATE_STANDBY;
+            stimulus_gen_is_on = false;
+            stop_stimulus_gen = false;
+            clr_LED_AUDIO;
             
-            if (play_metadata.sound_length > sound_length_produced)
-            {
-                if (play_metadata.sound_length - sound_length_produced > AUDIO_BUFFER_LEN)
-                {
-                    //audio_buffer0_length = AUDIO_BUFFER_LEN;
-                    DRV_I2S_BufferAddWrite(i2sDriverHandle, &i2sBufferHandle0, audio_all_second_buffers[new_sound_index], AUDIO_BUFFER_LEN * 4);
-                    sound_length_produced += AUDIO_BUFFER_LEN;
-                    audio_buffer0_state = AUDIO_BUFFER_HAS_DATA;
-                }
-                else
-                {
-                    //audio_buffer0_length = play_metadata.sound_length - sound_length_produced;
-                    DRV_I2S_BufferAddWrite(i2sDriverHandle, &i2sBufferHandle0, audio_all_second_buffers[new_sound_index], (play_metadata.sound_length - sound_length_produced) * 4);                    
-                    clr_sound_is_on_num_samples = play_metadata.sound_length - sound_length_produced;
-                    clr_sound_is_on_when_possible = CLR_SOUND_IS_ON_WHEN_POSSIBLE;
-                    sound_length_produced += play_metadata.sound_length - sound_length_produced;
-                    audio_buffer0_state = AUDIO_BUFFER_HAS_DATA;
-                    
-                    //sound_is_playing = false;
-                    //clr_LED_AUDIO;
-                }
-            }
-            else
-            {
-                sound_is_playing = false;
-                clr_LED_AUDIO;
-            }
+            for (; i < num_samples; i++)
+                buffer[i] = 0;
             
-            //if (audio_buffer0_state == AUDIO_BUFFER_HAS_DATA)
-            //{   
-            //    DRV_I2S_BufferAddWrite(i2sDriverHandle, &i2sBufferHandle0, audio_buffer0, audio_buffer0_length * 4);
-            //}
+            break;
         }
         
-        if (audio_buffer1_state == AUDIO_BUFFER_IS_EMPTY)
+        if (stimulus.frame == stimulus.period_length)
         {
-            new_sound_to_start = NEW_SOUND_STATE_STANDBY;
+            if (!stimulus.endless && stimulus.period_length != 0)
+                stimulus.count--;
             
-            if (play_metadata.sound_length > sound_length_produced)
-            {
-                if (play_metadata.sound_length - sound_length_produced > AUDIO_BUFFER_LEN)
-                {                    
-                    //audio_buffer1_length = AUDIO_BUFFER_LEN;
-                    DRV_I2S_BufferAddWrite(i2sDriverHandle, &i2sBufferHandle1, audio_all_second_buffers[new_sound_index], AUDIO_BUFFER_LEN * 4);
-                    sound_length_produced += AUDIO_BUFFER_LEN;
-                    audio_buffer1_state = AUDIO_BUFFER_HAS_DATA;
-                }
-                else
-                {
-                    //audio_buffer1_length = play_metadata.sound_length - sound_length_produced;
-                    DRV_I2S_BufferAddWrite(i2sDriverHandle, &i2sBufferHandle1, audio_all_second_buffers[new_sound_index], (play_metadata.sound_length - sound_length_produced) * 4);                    
-                    clr_sound_is_on_num_samples = play_metadata.sound_length - sound_length_produced;
-                    clr_sound_is_on_when_possible = CLR_SOUND_IS_ON_WHEN_POSSIBLE;
-                    sound_length_produced += play_metadata.sound_length - sound_length_produced;
-                    audio_buffer1_state = AUDIO_BUFFER_HAS_DATA;
-                    
-                    //sound_is_playing = false;
-                    //clr_LED_AUDIO;
-                }
-            }
-            else
+            stimulus.frame = 0;
+            stimulus.period_length = stimulus.period;
+            stimulus.period_error += stimulus.period_fraction;
+            if (stimulus.period_error >= 1000000)
             {
-                sound_is_playing = false;
-                clr_LED_AUDIO;
+                stimulus.period_error -= 1000000;
+                stimulus.period_length++;
             }
             
-            //if (audio_buffer1_state == AUDIO_BUFFER_HAS_DATA)
-            //{   
-            //    DRV_I2S_BufferAddWrite(i2sDriverHandle, &i2sBufferHandle1, audio_buffer1, audio_buffer1_length * 4);
-            //}
+            stimulus.carrier.phase = 0;
+            stimulus.modulator.phase = 0;
+            
+            if (sinewave_marker_frame < 0)
+                sinewave_marker_frame = i >> 1;
         }
-    }
-    
-    
-    if (/*sound_is_playing && */new_sound_to_start == NEW_SOUND_STATE_STANDBY)
-    {
-        if (audio_buffer0_state == AUDIO_BUFFER_IS_EMPTY)
+        
+        if (stimulus.frame < stimulus.duration)
         {
-            if (play_metadata.sound_length > sound_length_produced)
-            {
-                set_LED_MEMORY;
-                read_next_sound_page(audio_buffer0);
-                clr_LED_MEMORY;
-
-                if (play_metadata.sound_length - sound_length_produced > AUDIO_BUFFER_LEN)
-                {
-                    //audio_buffer0_length = AUDIO_BUFFER_LEN;
-                    DRV_I2S_BufferAddWrite(i2sDriverHandle, &i2sBufferHandle0, audio_buffer0, AUDIO_BUFFER_LEN * 4);
-                    sound_length_produced += AUDIO_BUFFER_LEN;
-                    audio_buffer0_state = AUDIO_BUFFER_HAS_DATA;
+            sample = (stimulus.carrier.frequency != 0) ? sine_sample(stimulus.carrier.phase) : SINE_AMPLITUDE;
             
-                    handle_USB_writing();
-                }
-                else
-                {
-                    //audio_buffer0_length = play_metadata.sound_length - sound_length_produced;
-                    DRV_I2S_BufferAddWrite(i2sDriverHandle, &i2sBufferHandle0, audio_buffer0, (play_metadata.sound_length - sound_length_produced) * 4);                    
-                    clr_sound_is_on_num_samples = play_metadata.sound_length - sound_length_produced;
-                    clr_sound_is_on_when_possible = CLR_SOUND_IS_ON_WHEN_POSSIBLE;
-                    sound_length_produced += play_metadata.sound_length - sound_length_produced;
-                    audio_buffer0_state = AUDIO_BUFFER_HAS_DATA;
-                    
-                    
-                    //sound_is_playing = false;
-                    //clr_LED_AUDIO;
-                }
-            }
-            else
-            {
-                sound_is_playing = false;
-                //clr_SOUND_IS_ON;
-                clr_LED_AUDIO;
-                //trigger_delayed_stop(current_sample_rate, 256);
-            }
+            if (stimulus.am_depth != 0)
+                sample = ((long long)sample * (stimulus.am_offset + (((long long)stimulus.am_depth * sine_sample(stimulus.modulator.phase)) >> 30))) >> 30;
             
-            //if (audio_buffer0_state == AUDIO_BUFFER_HAS_DATA)
-            //{   
-            //    DRV_I2S_BufferAddWrite(i2sDriverHandle, &i2sBufferHandle0, audio_buffer0, audio_buffer0_length * 4);
-            //}
+            if (stimulus.frame < stimulus.ramp)
+                sample = ((long long)sample * envelope_internal[(stimulus.frame * stimulus.ramp_step) >> 16]) >> 15;
+            else if (stimulus.frame >= stimulus.duration - stimulus.ramp)
+                sample = ((long long)sample * envelope_internal[((stimulus.duration - 1 - stimulus.frame) * stimulus.ramp_step) >> 16]) >> 15;
+            
+            stimulus.carrier.phase += stimulus.carrier.increment;
+            stimulus.modulator.phase += stimulus.modulator.increment;
         }
+        else
+            sample = 0;
+        
+        stimulus.frame++;
         
-        if (audio_buffer1_state == AUDIO_BUFFER_IS_EMPTY)
+        if (stop_stimulus_gen)
         {
-            if (play_metadata.sound_length > sound_length_produced)
-            {
-                set_LED_MEMORY;
-                read_next_sound_page(audio_buffer1);
-                clr_LED_MEMORY;
+            stimulus_gen_stop_ramp--;
+            sample = ((long long)sample * envelope_internal[stimulus_gen_stop_ramp * (ENVELOPE_LENGTH / AUDIO_STOP_RAMP_LENGTH)]) >> 15;
+        }
+        
+        buffer[i]   = sample;
+        buffer[i+1] = sample;
+    }
+    
+    return true;
+}
 
-                if (play_metadata.sound_length - sound_length_produced > AUDIO_BUFFER_LEN)
-                {                    
-                    //audio_buffer1_length = AUDIO_BUFFER_LEN;
-                    DRV_I2S_BufferAddWrite(i2sDriverHandle, &i2sBufferHandle1, audio_buffer1, AUDIO_BUFFER_LEN * 4);
-                    sound_length_produced += AUDIO_BUFFER_LEN;
-                    audio_buffer1_state = AUDIO_BUFFER_HAS_DATA;
-            
-                    handle_USB_writing();
-                }
-                else
-                {
-                    //audio_buffer1_length = play_metadata.sound_length - sound_length_produced;
-                    DRV_I2S_BufferAddWrite(i2sDriverHandle, &i2sBufferHandle1, audio_buffer1, (play_metadata.sound_length - sound_length_produced) * 4);
-                    clr_sound_is_on_num_samples = play_metadata.sound_length - sound_length_produced;
-                    clr_sound_is_on_when_possible = CLR_SOUND_IS_ON_WHEN_POSSIBLE;
-                    sound_length_produced += play_metadata.sound_length - sound_length_produced;
-                    audio_buffer1_state = AUDIO_BUFFER_HAS_DATA;
+/* Noise generator.
+ * A xorshift32 generator, one step per frame, gives white noise uniform on
+ * +-SINE_AMPLITUDE, the same on both channels. The generator is seeded again
+ * on every start, so the same settings always play the same noise.
+ *   Pink: the white noise through first-order sections with a pole and a zero
+ *   one octave apart, every two octaves from 10 Hz, for -3 dB/octave up to
+ *   ~20 KHz (+-0.3 dB).
+ *   Band-pass: the white noise through 2nd order Butterworth high-pass and
+ *   low-pass filters at the edges of the band, each one skipped if its
+ *   frequency is 0.
+ * The filters run in fixed point, with Q29 coefficients and 64-bit
+ * accumulators, and feed the rounding error back to keep the low cutoffs quiet.
+ * The band-pass noise keeps the density of the white noise (-10.8 dBFS RMS)
+ * and the pink noise plays at ~-18 dBFS RMS.
+ * The noise ramps in and out along the envelope in AUDIO_STOP_RAMP_LENGTH
+ * frames.
+ */
+#define NOISE_WHITE 40001
+#define NOISE_PINK 40002
+#define NOISE_BAND_PASS 40003
+
+#define NOISE_DEFAULT_SEED 0x2545F491
+#define NOISE_PINK_SECTIONS 6
+
+typedef struct {
+    int zero;       // Q29
+    int pole;       // Q29
+    int x1, y1;
+    int error;
+} Noise_Pink_Section;
+
+typedef struct {
+    int b0, b1, b2, a1, a2;     // Q29
+    int x1, x2, y1, y2;
+    int error;
+} Noise_Biquad;
+
+unsigned int noise_state;
+int noise_type;
+bool noise_gen_is_on = false;
+int noise_ramp;                             // Frames of the ramp played
+Noise_Pink_Section noise_pink[NOISE_PINK_SECTIONS];
+Noise_Biquad noise_high_pass;
+Noise_Biquad noise_low_pass;
+bool noise_high_pass_is_on;
+bool noise_low_pass_is_on;
+
+unsigned int noise_seed = NOISE_DEFAULT_SEED;
+int noise_low_frequency = 0;                // Hz, 0 for no high-pass
+int noise_high_frequency = 0;               // Hz, 0 for no low-pass
+
+int new_noise_gen_type;
+bool new_noise_gen_is_available = false;
+bool stop_noise_gen = false;
+
+static inline int noise_white(void)
+{
+    noise_state ^= noise_state << 13;
+    noise_state ^= noise_state >> 17;
+    noise_state ^= noise_state << 5;
+    
+    return (int)noise_state >> 1;
+}
+
+static inline int noise_pink_section(Noise_Pink_Section *section, int x)
+{
+    long long acc = ((long long)x << 29) - (long long)section->zero * section->x1 + (long long)section->pole * section->y1 + section->error;
+    int y = acc >> 29;
+    
+    section->error = acc - ((long long)y << 29);
+    section->x1 = x;
+    section->y1 = y;
+    
+    return y;
+}
+
+static inline int noise_biquad(Noise_Biquad *biquad, int x)
+{
+    long long acc = (long long)biquad->b0 * x + (long long)biquad->b1 * biquad->x1 + (long long)biquad->b2 * biquad->x2
+                  - (long long)biquad->a1 * biquad->y1 - (long long)biquad->a2 * biquad->y2 + biquad->error;
+    int y = acc >> 29;
+    
+    biquad->error = acc - ((long long)y << 29);
+    biquad->x2 = biquad->x1;
+    biquad->x1 = x;
+    biquad->y2 = biquad->y1;
+    biquad->y1 = y;
+    
+    return y;
+}
+
+/* Butterworth biquad, from the Audio EQ Cookbook */
+static void set_noise_biquad(Noise_Biquad *biquad, int frequency, bool high_pass)
+{
+    double w0 = 2 * 3.141592653589793 * frequency / current_sample_rate;
+    double cos_w0 = cos(w0);
+    double alpha = sin(w0) * 0.7071067811865476;    // sin(w0) / (2 * Q), Q = 1/sqrt(2)
+    double scale = 536870912.0 / (1 + alpha);       // Q29 and a0 = 1
+    
+    if (high_pass)
+    {
+        biquad->b0 = (1 + cos_w0) / 2 * scale;
+        biquad->b1 = -(1 + cos_w0) * scale;
+    }
+    else
+    {
+        biquad->b0 = (1 - cos_w0) / 2 * scale;
+        biquad->b1 = (1 - cos_w0) * scale;
+    }
+    
+    biquad->b2 = biquad->b0;
+    biquad->a1 = -2 * cos_w0 * scale;
+    biquad->a2 = (1 - alpha) * scale;
+    biquad->x1 = biquad->x2 = biquad->y1 = biquad->y2 = 0;
+    biquad->error = 0;
+}
+
+static void set_noise_gen(void)
+{
+    int i = 0;
+    
+    noise_type = new_noise_gen_type;
+    noise_state = noise_seed;
+    noise_ramp = 0;
+    
+    if (noise_type == NOISE_PINK)
+    {
+        for (; i < NOISE_PINK_SECTIONS; i++)
+        {
+            double frequency = 10 << (2 * i);
+            
+            noise_pink[i].pole = exp(-2 * 3.141592653589793 * frequency / current_sample_rate) * 536870912.0;
+            noise_pink[i].zero = exp(-4 * 3.141592653589793 * frequency / current_sample_rate) * 536870912.0;
+            noise_pink[i].x1 = noise_pink[i].y1 = 0;
+            noise_pink[i].error = 0;
+        }
+    }
+    
+    if (noise_type == NOISE_BAND_PASS)
+    {
+        /* Above the Nyquist frequency, the low-pass isn't needed */
+        noise_high_pass_is_on = noise_low_frequency != 0;
+        noise_low_pass_is_on = noise_high_frequency != 0 && noise_high_frequency < current_sample_rate / 2;
+        
+        if (noise_high_pass_is_on)
+            set_noise_biquad(&noise_high_pass, noise_low_frequency, true);
+        if (noise_low_pass_is_on)
+            set_noise_biquad(&noise_low_pass, noise_high_frequency, false);
+    }
+}
+
+void stop_noise_generator(void)
+{
+    if (noise_gen_is_on)
+        clr_LED_AUDIO;
+    
+    noise_gen_is_on = false;
+    new_noise_gen_is_available = false;
+    stop_noise_gen = false;
+}
+
+/* Fills a stereo buffer with the noise.
+ * Returns false if the generator is off.
+ */
+bool proc_noise_generator(int *buffer, int num_samples)
+{
+    int sample;
+    int i = 0;
+    
+    if (!noise_gen_is_on)
+    {
+        stop_noise_gen = false;
+        
+        /* A tone being played stops on its next zero crossing and a stimulus
+         * ramps down
+         */
+        if (!new_noise_gen_is_available || sine_gen_is_on || stimulus_gen_is_on)
+            return false;
+        
+        new_noise_gen_is_available = false;
+        
+        set_noise_gen();
+        noise_gen_is_on = true;
+        sinewave_marker_frame = 0;
+        
+        set_LED_AUDIO;
+    }
+    
+    for (; i < num_samples; i += 2)
+    {
+        switch (noise_type)
+        {
+            case NOISE_WHITE:
+                sample = noise_white();
+                break;
+            
+            case NOISE_PINK:
+                {
+                    int j = 0;
                     
-                    //sound_is_playing = false;
-                    //clr_LED_AUDIO;
+                    /* The sections amplify the lowest frequencies up to 36 dB */
+                    sample = noise_white() >> 2;
+                    for (; j < NOISE_PINK_SECTIONS; j++)
+                        sample = noise_pink_section(&noise_pink[j], sample);
                 }
+                break;
+            
+            default:
+                sample = noise_white();
+                if (noise_high_pass_is_on)
+                    sample = noise_biquad(&noise_high_pass, sample);
+                if (noise_low_pass_is_on)
+                    sample = noise_biquad(&noise_low_pass, sample);
+                break;
+        }
+        
+        /* Ramps down to the end, or up from the start */
+        if (stop_noise_gen)
+        {
+            if (noise_ramp == 0)
+            {
+                noise_gen_is_on = false;
+                stop_noise_gen = false;
+                clr_LED_AUDIO;
+                
+                for (; i < num_samples; i++)
+                    buffer[i] = 0;
+                
+                break;
+            }
+            
+            noise_ramp--;
+        }
+        
+        if (noise_ramp < AUDIO_STOP_RAMP_LENGTH)
+        {
+            sample = ((long long)sample * envelope_internal[noise_ramp * (ENVELOPE_LENGTH / AUDIO_STOP_RAMP_LENGTH)]) >> 15;
+            
+            if (!stop_noise_gen)
+                noise_ramp++;
+        }
+        
+        buffer[i]   = sample;
+        buffer[i+1] = sample;
+    }
+    
+    return true;
+}
+
+/* Start a new mixed sound if:
+ * - the selected index has a sound,
+ * - it uses the sample rate currently on the DAC, and
+ * - the sinewave generator is not being used.
+ */
+bool check_cmd_start_mixed(int index)
+{
+    if (!audio_sound_exists[index])
+        return false;
+
+    if (audio_all_metadata[index].sample_rate != current_sample_rate)
+        return false;
+
+    if (sine_gen_is_on || new_sine_gen_frequency_is_available)
+        return false;
+
+    if (noise_gen_is_on || new_noise_gen_is_available)
+        return false;
+
+    if (stimulus_gen_is_on || new_stimulus_gen_is_available)
+        return false;
+
+    return true;
+}
+
+/* Schedule a new sound if:
+ * - the selected index has a sound,
+ * - it uses the sample rate currently on the DAC, and
+ * - no mixed sounds are being played.
+ */
+bool check_cmd_start_scheduled(int index)
+{
+    if (!audio_sound_exists[index])
+        return false;
+
+    if (audio_all_metadata[index].sample_rate != current_sample_rate)
+        return false;
+
+    if (audio_voices_active)
+        return false;
+
+    return true;
+}
+
+/* Use a free voice or replace the oldest one */
+void launch_sound_mixed(int index, int att_left, int att_right)
+{
+    Audio_Voice *voice = &audio_voices[0];
+    int i = 0;
+
+    for (; i < AUDIO_MIX_VOICES; i++)
+    {
+        if (!audio_voices[i].active)
+        {
+            voice = &audio_voices[i];
+            break;
+        }
+
+        if (audio_voices[i].sound_length_produced > voice->sound_length_produced)
+            voice = &audio_voices[i];
+    }
+
+    if (!voice->active)
+        audio_voices_active++;
+
+    voice->sound_index = index;
+    voice->sound_length = audio_all_metadata[index].sound_length;
+    voice->sound_length_produced = 0;
+    voice->fade_length = audio_all_metadata[index].fade_length;
+    voice->gain_left = audio_gain_from_attenuation(att_left);
+    voice->gain_right = audio_gain_from_attenuation(att_right);
+    voice->page_index = -1;
+    voice->active = true;
+
+    set_LED_AUDIO;
+}
+
+void stop_sounds_mixed(void)
+{
+    int i = 0;
+
+    for (; i < AUDIO_MIX_VOICES; i++)
+        audio_voices[i].active = false;
+
+    audio_voices_active = 0;
+}
+
+static inline int audio_mix_saturate(long long sample)
+{
+    if (sample > 2147483647LL)
+        return 2147483647;
+    if (sample < -2147483648LL)
+        return -2147483647 - 1;
+
+    return (int)sample;
+}
+
+/* Saturating fixed-point sum of a stereo chunk into the buffer */
+static void audio_mix_chunk(int *buffer, int *samples, int num_samples, int gain_left, int gain_right)
+{
+    int i = 0;
+
+    for (; i < num_samples; i += 2)
+    {
+        buffer[i]   = audio_mix_saturate((long long)buffer[i]   + (((long long)samples[i]   * gain_left)  >> 30));
+        buffer[i+1] = audio_mix_saturate((long long)buffer[i+1] + (((long long)samples[i+1] * gain_right) >> 30));
+    }
+}
+
+/* Frames of the fades of a sound, they can't overlap */
+static inline int audio_fade_length(int fade_length, int sound_frames)
+{
+    return (fade_length > sound_frames / 2) ? sound_frames / 2 : fade_length;
+}
+
+/* True if a chunk of num_samples from first_frame has frames on the fades */
+static inline bool audio_chunk_is_on_fade(int first_frame, int num_samples, int sound_frames, int fade_length)
+{
+    fade_length = audio_fade_length(fade_length, sound_frames);
+    
+    return (first_frame < fade_length || first_frame + num_samples / 2 > sound_frames - fade_length) ? true : false;
+}
+
+/* Fade in and fade out of a sound, along envelope_internal.
+ * The frames of the chunk that fall on the fades are multiplied by the
+ * envelope, read with a Q15 step of ENVELOPE_LENGTH / fade_length entries.
+ * ~30 us @ 200MHz for a chunk of 512 samples on a fade, see bench_fade.
+ */
+void audio_fade_chunk(int *buffer, int num_samples, int first_frame, int sound_frames, int fade_length)
+{
+    int step;
+    int frame;
+    int envelope;
+    int i = 0;
+    
+    fade_length = audio_fade_length(fade_length, sound_frames);
+    
+    if (fade_length == 0)
+        return;
+    
+    step = (ENVELOPE_LENGTH << 15) / fade_length;
+    
+    for (frame = first_frame; frame < fade_length && i < num_samples; frame++, i += 2)
+    {
+        envelope = envelope_internal[(frame * step) >> 15];
+        buffer[i]   = ((long long)buffer[i]   * envelope) >> 15;
+        buffer[i+1] = ((long long)buffer[i+1] * envelope) >> 15;
+    }
+    
+    frame = sound_frames - fade_length;
+    
+    if (first_frame < frame)
+        i = (frame - first_frame) * 2;
+    else
+        frame = first_frame, i = 0;
+    
+    for (; i < num_samples; frame++, i += 2)
+    {
+        envelope = envelope_internal[((sound_frames - 1 - frame) * step) >> 15];
+        buffer[i]   = ((long long)buffer[i]   * envelope) >> 15;
+        buffer[i+1] = ((long long)buffer[i+1] * envelope) >> 15;
+    }
+}
+
+/* Returns the sound's entry, or the least recently used one if it has none */
+static Sound_Cache_Entry * sound_cache_entry(int sound_index)
+{
+    Sound_Cache_Entry *entry = &sound_cache[0];
+    int i = 0;
+
+    for (; i < SOUND_CACHE_ENTRIES; i++)
+    {
+        if (sound_cache[i].last_use && sound_cache[i].sound_index == sound_index)
+            return &sound_cache[i];
+
+        if (sound_cache[i].last_use < entry->last_use)
+            entry = &sound_cache[i];
+    }
+
+    return entry;
+}
+
+/* Returns the first page of a sound, reading it on a miss.
+ * The page is only valid until the next call, since a miss may replace it.
+ */
+static int * sound_first_page(int sound_index)
+{
+    Sound_Cache_Entry *entry;
+
+    /* Index 0 only plays silence */
+    if (sound_index == 0)
+        return audio_buffer_zeros;
+
+    entry = sound_cache_entry(sound_index);
+
+    if (entry->last_use && entry->sound_index == sound_index)
+    {
+        perf_sound_cache_hits++;
+    }
+    else
+    {
+        perf_sound_cache_misses++;
+
+        set_LED_MEMORY;
+        read_sound_page(sound_index, 0, entry->page);
+        clr_LED_MEMORY;
+
+        entry->sound_index = sound_index;
+    }
+
+    entry->last_use = ++sound_cache_use;
+
+    return entry->page;
+}
+
+/* Copies the first page of a sound that is already known */
+static void sound_first_page_fill(int sound_index, int *page)
+{
+    Sound_Cache_Entry *entry = sound_cache_entry(sound_index);
+    int i;
+
+    for (i = AUDIO_BUFFER_LEN; i != 0; i--)
+        entry->page[i-1] = page[i-1];
+
+    entry->sound_index = sound_index;
+    entry->last_use = ++sound_cache_use;
+}
+
+/* Drops the first page of a sound that was removed or replaced */
+static void sound_first_page_drop(int sound_index)
+{
+    Sound_Cache_Entry *entry = sound_cache_entry(sound_index);
+
+    if (entry->sound_index == sound_index)
+        entry->last_use = 0;
+}
+
+/* Mix the next chunk of each active voice into the buffer.
+ * The buffer already holds num_samples of the sound being played (if any) and
+ * is extended with zeros if a voice lasts longer.
+ * Returns the number of samples to be queued.
+ */
+static int audio_mix_voices(int *buffer, int num_samples)
+{
+    Audio_Voice *voice;
+    int *samples;
+    int voice_num_samples;
+    int page_index;
+    int i = 0;
+    int j;
+
+    for (; i < AUDIO_MIX_VOICES; i++)
+    {
+        voice = &audio_voices[i];
+
+        if (!voice->active)
+            continue;
+
+        voice_num_samples = voice->sound_length - voice->sound_length_produced;
+        if (voice_num_samples > AUDIO_BUFFER_LEN)
+            voice_num_samples = AUDIO_BUFFER_LEN;
+
+        for (; num_samples < voice_num_samples; num_samples++)
+            buffer[num_samples] = 0;
+
+        /* The first page is on RAM, the others prefetched */
+        page_index = voice->sound_length_produced / AUDIO_BUFFER_LEN;
+
+        if (page_index == 0)
+        {
+            samples = sound_first_page(voice->sound_index);
+        }
+        else
+        {
+            if (voice->page_index != page_index)
+            {
+                set_LED_MEMORY;
+                read_sound_page(voice->sound_index, page_index, voice->page);
+                clr_LED_MEMORY;
+                voice->page_index = page_index;
+            }
+            
+            samples = voice->page;
+        }
+        
+        /* The cache's pages are faded on a copy */
+        if (audio_chunk_is_on_fade(voice->sound_length_produced / 2, voice_num_samples, voice->sound_length / 2, voice->fade_length))
+        {
+            if (samples != voice->page)
+            {
+                for (j = 0; j < voice_num_samples; j++)
+                    audio_mix_page[j] = samples[j];
+                
+                samples = audio_mix_page;
+            }
+            
+            audio_fade_chunk(samples, voice_num_samples, voice->sound_length_produced / 2, voice->sound_length / 2, voice->fade_length);
+        }
+
+        audio_mix_chunk(buffer, samples, voice_num_samples, voice->gain_left, voice->gain_right);
+
+        voice->sound_length_produced += voice_num_samples;
+
+        if (voice->sound_length_produced >= voice->sound_length)
+        {
+            voice->active = false;
+            audio_voices_active--;
+        }
+    }
+
+    return num_samples;
+}
+
+#define VOICE_PREFETCH_STATE_STANDBY 0
+#define VOICE_PREFETCH_STATE_LOADING 1
+static int voice_prefetch_state = VOICE_PREFETCH_STATE_STANDBY;
+static Audio_Voice *voice_prefetch;
+static int voice_prefetch_sound_index;
+static int voice_prefetch_page_index;
+
+/* Reads the next page of one voice while the queued buffers are being played.
+ * The read is issued on one call and drained on a later one, so each main loop
+ * transfers one voice page at most.
+ */
+static void prefetch_voice_pages(void)
+{
+    Audio_Voice *voice;
+    int page_index;
+    int i = 0;
+    
+    if (voice_prefetch_state == VOICE_PREFETCH_STATE_LOADING)
+    {
+        if (!read_sound_page_check())
+            return;
+        
+        voice_prefetch_state = VOICE_PREFETCH_STATE_STANDBY;
+        voice = voice_prefetch;
+        
+        /* The voice may have been replaced meanwhile */
+        voice->page_index = -1;
+        
+        set_LED_MEMORY;
+        if (read_sound_page_finish(voice->page))
+            if (voice->active && voice->sound_index == voice_prefetch_sound_index)
+                voice->page_index = voice_prefetch_page_index;
+        clr_LED_MEMORY;
+        
+        return;
+    }
+    
+    for (; i < AUDIO_MIX_VOICES; i++)
+    {
+        voice = &audio_voices[i];
+        page_index = voice->sound_length_produced / AUDIO_BUFFER_LEN;
+        
+        if (!voice->active || page_index == 0 || voice->page_index == page_index)
+            continue;
+        
+        if (page_index * AUDIO_BUFFER_LEN >= voice->sound_length)
+            continue;
+        
+        /* The compressed sounds are decoded when mixed */
+        if (read_sound_page_start(voice->sound_index, page_index))
+        {
+            voice_prefetch_state = VOICE_PREFETCH_STATE_LOADING;
+            voice_prefetch = voice;
+            voice_prefetch_sound_index = voice->sound_index;
+            voice_prefetch_page_index = page_index;
+            return;
+        }
+    }
+}
+
+/* Number of buffers currently queued on the I2S DMA */
+static int audio_ring_in_flight(void)
+{
+    int in_flight = 0;
+    int slot = 0;
+    
+    for (; slot < AUDIO_RING_DEPTH; slot++)
+        if (audio_ring_state[slot] == AUDIO_BUFFER_HAS_DATA)
+            in_flight++;
+    
+    return in_flight;
+}
+
+/* Queue a buffer at the head of the ring.
+ * The events are attached to the previous buffer, since they must happen when
+ * this one starts to be played. If the previous one was already played, the
+ * ring underran and the events are attached to this buffer.
+ */
+static void audio_ring_queue(int *buffer, int num_samples, int event, int set_frame, int clr_frame)
+{
+    int slot = audio_ring_head;
+    int previous = (slot + AUDIO_RING_DEPTH - 1) % AUDIO_RING_DEPTH;
+    bool int_status;
+    
+#if AUDIO_DIGITAL_ATTENUATION
+    if (buffer != audio_buffer_zeros)
+        apply_audio_gains(buffer, num_samples);
+#else
+    step_audio_volume(num_samples);
+#endif
+    
+    audio_ring_event[slot] = 0;
+    audio_ring_buffer[slot] = buffer;
+    audio_ring_num_samples[slot] = num_samples;
+    audio_ring_state[slot] = AUDIO_BUFFER_HAS_DATA;
+    DRV_I2S_BufferAddWrite(i2sDriverHandle, &i2sBufferHandle[slot], buffer, num_samples * 4);
+    
+    if (event)
+    {
+        int_status = SYS_INT_Disable();
+        
+        if (audio_ring_state[previous] == AUDIO_BUFFER_HAS_DATA)
+            slot = previous;
+        
+        audio_ring_event[slot] |= event;
+        audio_ring_set_frame[slot] = set_frame;
+        audio_ring_clr_frame[slot] = clr_frame;
+        
+        SYS_INT_Restore(int_status);
+    }
+    
+    audio_ring_head = (audio_ring_head + 1) % AUDIO_RING_DEPTH;
+}
+
+/* Attach an event to the buffer before the one on slot, like
+ * audio_ring_queue() does, once other buffers were queued after it.
+ * Returns false if the buffer on slot already started to be played.
+ */
+static bool audio_ring_attach_event(int slot, int event, int set_frame, int clr_frame)
+{
+    int previous = (slot + AUDIO_RING_DEPTH - 1) % AUDIO_RING_DEPTH;
+    bool attached = false;
+    bool int_status;
+    
+    int_status = SYS_INT_Disable();
+    
+    if (audio_ring_state[slot] == AUDIO_BUFFER_HAS_DATA && audio_ring_state[previous] == AUDIO_BUFFER_HAS_DATA)
+    {
+        audio_ring_event[previous] |= event;
+        if (event & (AUDIO_RING_EVENT_SET_SOUND_IS_ON | AUDIO_RING_EVENT_PULSE_SOUND_IS_ON))
+            audio_ring_set_frame[previous] = set_frame;
+        if (event & AUDIO_RING_EVENT_CLR_SOUND_IS_ON)
+            audio_ring_clr_frame[previous] = clr_frame;
+        attached = true;
+    }
+    
+    SYS_INT_Restore(int_status);
+    
+    return attached;
+}
+
+/* Cut the queued buffers at the next frame that can be changed, ramping down.
+ * The events of the queued buffers are dropped and SOUND_IS_ON falls when
+ * the ramp ends.
+ * Returns the number of frames from now until the silence.
+ */
+static int audio_ring_stop(void)
+{
+    int slot = audio_ring_head;
+    int frame;
+    int ramp = 0;
+    int num_frames;
+    int *buffer;
+    int envelope;
+    int i = 0;
+    unsigned int now;
+    bool int_status;
+    
+    int_status = SYS_INT_Disable();
+    
+    now = _CP0_GET_COUNT();
+    frame = (long long)(now - audio_ring_tick) * current_sample_rate / CPU_CT_HZ;
+    
+    /* The oldest buffer queued is the one being played */
+    for (; i < AUDIO_RING_DEPTH; i++, slot = (slot + 1) % AUDIO_RING_DEPTH)
+        if (audio_ring_state[slot] == AUDIO_BUFFER_HAS_DATA)
+            break;
+    
+    for (i = 0; i < AUDIO_RING_DEPTH; i++)
+        audio_ring_event[i] = 0;
+    
+    SYS_INT_Restore(int_status);
+    
+    if (audio_ring_state[slot] != AUDIO_BUFFER_HAS_DATA)
+    {
+        stop_pin_sound_is_on(current_sample_rate, 0);
+        return 0;
+    }
+    
+    /* After an underrun, the buffer started later than the last completion */
+    if (frame > audio_ring_num_samples[slot] / 2)
+        frame = 0;
+    
+    frame += AUDIO_STOP_MARGIN;
+    num_frames = AUDIO_STOP_MARGIN + AUDIO_STOP_RAMP_LENGTH;
+    
+    for (i = 0; i < AUDIO_RING_DEPTH; i++, slot = (slot + 1) % AUDIO_RING_DEPTH)
+    {
+        if (audio_ring_state[slot] != AUDIO_BUFFER_HAS_DATA)
+            break;
+        
+        buffer = audio_ring_buffer[slot];
+        
+        for (; frame < audio_ring_num_samples[slot] / 2; frame++)
+        {
+            if (buffer == audio_buffer_zeros)
+            {
+                ramp = AUDIO_STOP_RAMP_LENGTH;
+                break;
+            }
+            
+            if (ramp < AUDIO_STOP_RAMP_LENGTH)
+            {
+                envelope = envelope_internal[(AUDIO_STOP_RAMP_LENGTH - 1 - ramp++) * (ENVELOPE_LENGTH / AUDIO_STOP_RAMP_LENGTH)];
+                buffer[frame*2]   = ((long long)buffer[frame*2]   * envelope) >> 15;
+                buffer[frame*2+1] = ((long long)buffer[frame*2+1] * envelope) >> 15;
             }
             else
             {
-                sound_is_playing = false;
-                //clr_SOUND_IS_ON;
-                clr_LED_AUDIO;
-                //trigger_delayed_stop(current_sample_rate, 256);
+                buffer[frame*2]   = 0;
+                buffer[frame*2+1] = 0;
             }
+        }
+        
+        frame -= audio_ring_num_samples[slot] / 2;
+        if (frame < 0)
+            frame = 0;
+    }
+    
+    num_frames -= (long long)(_CP0_GET_COUNT() - now) * current_sample_rate / CPU_CT_HZ;
+    if (num_frames < 0)
+        num_frames = 0;
+    
+    stop_pin_sound_is_on(current_sample_rate, num_frames);
+    
+    return num_frames;
+}
+
+/* Number of stereo samples from the start of the next buffer to be queued
+ * until the core timer reaches tick. Negative if the tick was missed.
+ */
+static int audio_ring_samples_until(unsigned int tick)
+{
+    unsigned int head_tick;
+    int num_samples = 0;
+    int slot = 0;
+    bool int_status;
+    
+    int_status = SYS_INT_Disable();
+    
+    head_tick = audio_ring_tick;
+    
+    for (; slot < AUDIO_RING_DEPTH; slot++)
+        if (audio_ring_state[slot] == AUDIO_BUFFER_HAS_DATA)
+            num_samples += audio_ring_num_samples[slot];
+    
+    SYS_INT_Restore(int_status);
+    
+    if (num_samples == 0)
+        head_tick = _CP0_GET_COUNT();
+    else
+        head_tick += (long long)(num_samples / 2) * CPU_CT_HZ / current_sample_rate;
+    
+    return (long long)((int)(tick - head_tick)) * current_sample_rate / CPU_CT_HZ;
+}
+
+/* First and last frames of the chunk with a non-zero sample, -1 if silent */
+static int audio_first_nonzero_frame(int *buffer, int num_samples)
+{
+    int i = 0;
+    
+    for (; i < num_samples; i++)
+        if (buffer[i])
+            return i >> 1;
+    
+    return -1;
+}
+
+static int audio_last_nonzero_frame(int *buffer, int num_samples)
+{
+    int i = num_samples - 1;
+    
+    for (; i >= 0; i--)
+        if (buffer[i])
+            return i >> 1;
+    
+    return -1;
+}
+
+/* Queue the next chunk of the sound being played.
+ * SOUND_IS_ON rises at the first non-zero sample of the sound and falls after
+ * its last non-zero sample. If the final chunks are silent, the falling edge
+ * goes back to the last chunk with sound while it is still queued, otherwise
+ * it falls at the start of the final chunk.
+ */
+static void audio_ring_queue_sound(int *buffer, int event)
+{
+    int num_samples = play_metadata.sound_length - sound_length_produced;
+    int set_frame = 0;
+    int clr_frame = 0;
+    int frame;
+    
+    if (event & AUDIO_RING_EVENT_SET_SOUND_IS_ON)
+    {
+        event &= ~AUDIO_RING_EVENT_SET_SOUND_IS_ON;
+        sound_marker_pending = true;
+    }
+    
+    if (num_samples > AUDIO_BUFFER_LEN)
+        num_samples = AUDIO_BUFFER_LEN;
+    
+    /* The cache's pages can be replaced while queued, so they are copied to the ring */
+    int *mix = audio_ring_buffers[audio_ring_head];
+    int i = 0;
+    
+    if (buffer != mix)
+        for (; i < num_samples; i++)
+            mix[i] = buffer[i];
+    
+    buffer = mix;
+    
+    /* The markers follow the faded sound */
+    if (audio_chunk_is_on_fade(sound_length_produced / 2, num_samples, play_metadata.sound_length / 2, play_metadata.fade_length))
+        audio_fade_chunk(buffer, num_samples, sound_length_produced / 2, play_metadata.sound_length / 2, play_metadata.fade_length);
+    
+    if (sound_marker_pending)
+    {
+        frame = audio_first_nonzero_frame(buffer, num_samples);
+        
+        if (frame >= 0)
+        {
+            sound_marker_pending = false;
+            sound_marker_is_on = true;
+            event |= AUDIO_RING_EVENT_SET_SOUND_IS_ON;
+            set_frame = frame;
+        }
+    }
+    
+    frame = sound_marker_is_on ? audio_last_nonzero_frame(buffer, num_samples) : -1;
+    
+    sound_length_produced += num_samples;
+    
+    if (sound_length_produced >= play_metadata.sound_length)
+    {
+        sound_marker_pending = false;
+        
+        if (sound_marker_is_on)
+        {
+            sound_marker_is_on = false;
+            
+            /* With up to AUDIO_RING_DEPTH - 2 chunks queued after the last
+             * chunk with sound, the slot before it wasn't reused
+             */
+            if (frame >= 0)
+            {
+                event |= AUDIO_RING_EVENT_CLR_SOUND_IS_ON;
+                clr_frame = frame + 1;
+            }
+            else if (sound_marker_silent_chunks > AUDIO_RING_DEPTH - 2 ||
+                     !audio_ring_attach_event(sound_marker_slot, AUDIO_RING_EVENT_CLR_SOUND_IS_ON, 0, sound_marker_clr_frame))
+            {
+                event |= AUDIO_RING_EVENT_CLR_SOUND_IS_ON;
+                clr_frame = 0;
+            }
+        }
+    }
+    else if (frame >= 0)
+    {
+        sound_marker_slot = audio_ring_head;
+        sound_marker_clr_frame = frame + 1;
+        sound_marker_silent_chunks = 0;
+    }
+    else
+    {
+        sound_marker_silent_chunks++;
+    }
+    
+    if (audio_voices_active)
+        num_samples = audio_mix_voices(buffer, num_samples);
+    
+    audio_ring_queue(buffer, num_samples, event, set_frame, clr_frame);
+}
+
+/* Queue the next chunk of the USB stream */
+static void update_stream_buffers(void)
+{
+    int *buffer = audio_ring_buffers[audio_ring_head];
+    int num_samples = (stream_fifo_count > AUDIO_BUFFER_LEN) ? AUDIO_BUFFER_LEN : stream_fifo_count;
+    int event = 0;
+    int clr_frame = 0;
+    int i = 0;
+    
+    /* A stored sound played in the meantime may have changed the sample rate */
+    if (stream_first_buffer || stream_sample_rate != current_sample_rate)
+    {
+        /* The mixed sounds can't follow a new sample rate */
+        if (stream_sample_rate != current_sample_rate)
+            stop_sounds_mixed();
+        
+        config_audio_dac(stream_sample_rate, (stream_sample_rate != current_sample_rate) ? true : false);
+        current_sample_rate = stream_sample_rate;
+    }
+    
+    if (stream_first_buffer)
+    {
+        stream_first_buffer = false;
+        
+        if (num_samples)
+        {
+            stream_marker_is_on = true;
+            event |= AUDIO_RING_EVENT_SET_SOUND_IS_ON;
+        }
+        
+        set_LED_AUDIO;
+    }
+    
+    if (num_samples == 0)
+    {
+        if (stream_ended)
+        {
+            stream_state = STREAM_STATE_IDLE;
             
-            //if (audio_buffer1_state == AUDIO_BUFFER_HAS_DATA)
-            //{   
-            //    DRV_I2S_BufferAddWrite(i2sDriverHandle, &i2sBufferHandle1, audio_buffer1, audio_buffer1_length * 4);
-            //}
+            if (stream_marker_is_on)
+                event |= AUDIO_RING_EVENT_CLR_SOUND_IS_ON;
+            stream_marker_is_on = false;
+            
+            clr_LED_AUDIO;
+        }
+        else
+        {
+            /* The host is late, play silence until the next chunk arrives */
+            stream_underruns++;
         }
+        
+        audio_ring_queue(audio_buffer_zeros, 128, event, 0, 0);
+        return;
+    }
+    
+    for (; i < num_samples; i++)
+        buffer[i] = stream_fifo[(stream_fifo_read + i) & (STREAM_FIFO_LEN - 1)];
+    
+    stream_fifo_read = (stream_fifo_read + num_samples) & (STREAM_FIFO_LEN - 1);
+    stream_fifo_count -= num_samples;
+    
+    if (stream_ended && stream_fifo_count == 0)
+    {
+        stream_state = STREAM_STATE_IDLE;
+        stream_marker_is_on = false;
+        event |= AUDIO_RING_EVENT_CLR_SOUND_IS_ON;
+        clr_frame = num_samples / 2;
+        
+        if (!audio_voices_active)
+            clr_LED_AUDIO;
     }
     
-    if (!sound_is_playing)
+    if (audio_voices_active)
+        num_samples = audio_mix_voices(buffer, num_samples);
+    
+    audio_ring_queue(buffer, num_samples, event, 0, clr_frame);
+}
+
+void stop_stream(void)
+{
+    if (stream_state == STREAM_STATE_PLAYING)
+        clr_LED_AUDIO;
+    
+    if (stream_marker_is_on)
+        clr_SOUND_IS_ON;
+    
+    stream_state = STREAM_STATE_IDLE;
+    stream_marker_is_on = false;
+}
+
+/* Stop everything being played, ramping down from the next frame that can be
+ * changed instead of waiting for the queued buffers.
+ */
+void stop_sound(void)
+{
+    int num_frames = audio_ring_stop();
+    
+    perf_stop_tick = _CP0_GET_COUNT() + (long long)num_frames * CPU_CT_HZ / current_sample_rate;
+    perf_stop_latency = perf_stop_tick - command_latched_tick;
+    if (perf_stop_latency > perf_stop_latency_max)
+        perf_stop_latency_max = perf_stop_latency;
+    
+    sound_is_playing = false;
+    new_sound_to_start = NEW_SOUND_STATE_STANDBY;
+    sound_marker_pending = false;
+    sound_marker_is_on = false;
+    sound_scheduled = false;
+    
+    stop_sounds_mixed();
+    
+    /* The marker was already handled */
+    stream_marker_is_on = false;
+    stop_stream();
+    
+    stop_sinewave_generator();
+    stop_noise_generator();
+    stop_stimulus_generator();
+    
+    clr_LED_AUDIO;
+}
+
+void update_sound_buffers (void)
+{
+    int depth;
+    
+    while (1)
     {
-        if (audio_buffer0_state == AUDIO_BUFFER_IS_EMPTY)
+        depth = (sound_is_playing || audio_voices_active || sound_scheduled || stream_state == STREAM_STATE_PLAYING || new_sound_to_start != NEW_SOUND_STATE_STANDBY) ? AUDIO_RING_DEPTH : AUDIO_RING_IDLE_DEPTH;
+        
+        if (audio_ring_state[audio_ring_head] == AUDIO_BUFFER_HAS_DATA || audio_ring_in_flight() >= depth)
+            break;
+        
+        if (new_sound_to_start == NEW_SOUND_STATE_IS_AVAILABLE)
+        {
+            new_sound_to_start = NEW_SOUND_STATE_STANDBY;
+            sound_is_playing = true;
+            sound_length_produced = 0;
+            set_page_and_sound_index(0, new_sound_index);
+            
+            /* The sound's attenuation starts with its first sample */
+            update_audio_attenuation(new_sound_att_left, new_sound_att_right, false);
+            new_sound_att_left = -1;
+            new_sound_att_right = -1;
+            
+            /* The mixed sounds can't follow a new sample rate */
+            if (play_metadata.sample_rate != current_sample_rate)
+                stop_sounds_mixed();
+            
+            config_audio_dac(play_metadata.sample_rate, (play_metadata.sample_rate != current_sample_rate) ? true : false);
+            current_sample_rate = play_metadata.sample_rate;
+            
+            audio_ring_queue_sound(sound_first_page(new_sound_index), AUDIO_RING_EVENT_SET_SOUND_IS_ON);
+            set_LED_AUDIO;
+            
+            /* The second page is prefetched while the first one is played */
+            break;
+        }
+        else if (sound_is_playing)
+        {
+            if (play_metadata.sound_length > sound_length_produced)
+            {
+                set_LED_MEMORY;
+                read_next_sound_page(audio_ring_buffers[audio_ring_head]);
+                clr_LED_MEMORY;
+                
+                audio_ring_queue_sound(audio_ring_buffers[audio_ring_head], 0);
+            
+                handle_USB_writing();
+                
+                /* A page per call, so the next one is prefetched meanwhile */
+                break;
+            }
+            else
+            {
+                sound_is_playing = false;
+                clr_LED_AUDIO;
+            }
+        }
+        else if (sound_scheduled)
         {
-            if (current_sample_rate == 96000)
+            /* Pad with zeros up to the scheduled sample.
+             * The pad is kept even since the DMA doesn't like 2 samples buffers.
+             */
+            int num_samples = audio_ring_samples_until(sound_scheduled_tick) & ~1;
+            
+            if (num_samples > AUDIO_BUFFER_LEN/2)
             {
-                //DRV_I2S_BufferAddWrite(i2sDriverHandle, &i2sBufferHandle0, audio_buffer_zeros, 32 * 4);
-                //DRV_I2S_BufferAddWrite(i2sDriverHandle, &i2sBufferHandle0, audio_buffer_zeros, 64 * 4);
+                num_samples -= 2;
                 
-                /*
-                for (; i < 256/2; i++)
-                {
-                    _X_ = _X_ + 2.0*3.141592654/(96000.0/3000.0);
-                    audio_sinewave[i*2] = 16777216/2 * sin(_X_);
-                    //audio_sinewave[i*2+1] = audio_sinewave[i*2];                    
-                }
-                */
-                        
-                proc_sinewave_generator();
+                if (num_samples > AUDIO_BUFFER_LEN/2)
+                    num_samples = AUDIO_BUFFER_LEN/2;
                 
-                DRV_I2S_BufferAddWrite(i2sDriverHandle, &i2sBufferHandle0, audio_sinewave, SINEWAVE_GEN_96KHZ_LOAD_SAMPLE_N * 4);
+                audio_ring_queue(audio_buffer_zeros, num_samples * 2, 0, 0, 0);
             }
             else
-                DRV_I2S_BufferAddWrite(i2sDriverHandle, &i2sBufferHandle0, audio_buffer_zeros, 128 * 4); // 8 works well
+            {
+                if (num_samples > 0)
+                    audio_ring_queue(audio_buffer_zeros, num_samples * 2, 0, 0, 0);
+                else if (num_samples < 0)
+                    perf_schedule_late++;
+                
+                sound_scheduled = false;
+                new_sound_index = sound_scheduled_index;
+                new_sound_att_left = sound_scheduled_att_left;
+                new_sound_att_right = sound_scheduled_att_right;
+                perf_trigger_tick = sound_scheduled_tick;
+                launch_sound_v3();
+            }
+        }
+        else if (stream_state == STREAM_STATE_PLAYING)
+        {
+            update_stream_buffers();
+            handle_USB_writing();
+        }
+        else if (audio_voices_active)
+        {
+            int num_samples = audio_mix_voices(audio_ring_buffers[audio_ring_head], 0);
+            
+            audio_ring_queue(audio_ring_buffers[audio_ring_head], num_samples, 0, 0, 0);
             
-            //clr_SOUND_IS_ON;
-            audio_buffer0_state = AUDIO_BUFFER_HAS_DATA;
+            if (!audio_voices_active)
+                clr_LED_AUDIO;
+            
+            handle_USB_writing();
         }
-        
-        if (audio_buffer1_state == AUDIO_BUFFER_IS_EMPTY)
+        else
         {
-            if (current_sample_rate == 96000)
+            int *buffer = audio_ring_buffers[audio_ring_head];
+            int num_samples = (current_sample_rate == 96000) ? SINEWAVE_GEN_96KHZ_LOAD_SAMPLE_N : SINEWAVE_GEN_192KHZ_LOAD_SAMPLE_N;
+            
+            if (proc_noise_generator(buffer, num_samples) ||
+                proc_stimulus_generator(buffer, num_samples) ||
+                proc_sinewave_generator(buffer, num_samples))
             {
-                //DRV_I2S_BufferAddWrite(i2sDriverHandle, &i2sBufferHandle1, audio_buffer_zeros, 32 * 4);
-                //DRV_I2S_BufferAddWrite(i2sDriverHandle, &i2sBufferHandle1, audio_buffer_zeros, 64 * 4);
-                
-                /*for (; i < 256/2; i++)
-                {
-                    _X_ = _X_ + 2.0*3.141592654/(96000.0/3000.0);
-                    audio_sinewave[i*2] = 16777216/2 * sin(_X_);
-                    //audio_sinewave[i*2+1] = audio_sinewave[i*2];
-                }
-                */
-                
-                proc_sinewave_generator();
-                
-                DRV_I2S_BufferAddWrite(i2sDriverHandle, &i2sBufferHandle1, audio_sinewave, SINEWAVE_GEN_96KHZ_LOAD_SAMPLE_N * 4);
+                audio_ring_queue(buffer, num_samples, (sinewave_marker_frame >= 0) ? AUDIO_RING_EVENT_PULSE_SOUND_IS_ON : 0, sinewave_marker_frame, 0);
+                sinewave_marker_frame = -1;
             }
             else
-                DRV_I2S_BufferAddWrite(i2sDriverHandle, &i2sBufferHandle1, audio_buffer_zeros, 128 * 4); // 8 works well
-            
-            //clr_SOUND_IS_ON;
-            audio_buffer1_state = AUDIO_BUFFER_HAS_DATA;
+                audio_ring_queue(audio_buffer_zeros, num_samples, 0, 0, 0);
             
             handle_USB_writing();
         }
     }
+    
+    /* Load the next pages while the queued buffers are being played */
+    if (audio_voices_active || voice_prefetch_state == VOICE_PREFETCH_STATE_LOADING)
+        prefetch_voice_pages();
+    
+    if (sound_is_playing && new_sound_to_start == NEW_SOUND_STATE_STANDBY)
+        if (play_metadata.sound_length > sound_length_produced)
+            prefetch_next_sound_page();
 }
 
 
-void fill_audio_first_and_second_buffers()
+void fill_audio_metadata()
 {
     int n_sounds = get_available_sounds();
+    
+    load_sound_table();
 
     int i = 2;
     for (; i < n_sounds; i++)
     {
-        audio_sound_exists[i] = (read_first_sound_page(i, audio_all_first_buffers[i], &audio_all_metadata[i]) != -1) ? true : false;
-        
+        audio_sound_exists[i] = (read_sound_metadata(i, &audio_all_metadata[i]) != -1) ? true : false;
+    }
+}
+
+/* Warms the cache with the first sounds */
+void fill_sound_first_pages()
+{
+    int n_sounds = get_available_sounds();
+    
+    int i = 2;
+    for (; i < n_sounds && sound_cache_use < SOUND_CACHE_ENTRIES; i++)
+    {
         if (audio_sound_exists[i])
-            read_next_sound_page(audio_all_second_buffers[i]);
+            sound_first_page(i);
     }
+    
+    /* The warming isn't a start */
+    perf_sound_cache_misses = 0;
 }
 
-void fill_audio_user_metadata()
+void fill_audio_sound_exists()
 {
     int n_sounds = get_available_sounds();
     
@@ -795,10 +2169,7 @@ void fill_audio_user_metadata()
     for (; i < n_sounds; i++)
     {   
         if (audio_sound_exists[i])
-        {
-            audio_sound_exists_bitmask |= (1 << i);
-            read_user_metadata(i, audio_user_metadata[i]);
-        }
+            audio_sound_exists_bitmask |= (1ULL << i);
     }
 }
 
@@ -831,10 +2202,47 @@ void handle_USB_writing(void)
 #define METADATACMD_STATE_SAVE_USER_METADATA 0
 #define METADATACMD_STATE_SAVE_PREPARE_MEMORY 1
 #define METADATACMD_STATE_SAVE_ALLOCATE_METADATA 2
+#define METADATACMD_STATE_SAVE_SOUND_TABLE 3
 int prepare_metadataCmd_state;
 
 int prepare_metadataCmd_sound_index;
 
+/* A page of the sound being uploaded failed to program and the sound was
+ * removed, the following data commands reply ERROR_MEMORYWRITE
+ */
+bool sound_write_failed = false;
+
+static void clear_sound_exists(int sound_index)
+{
+    audio_sound_exists[sound_index] = false;
+    audio_sound_exists_bitmask &= ~(1ULL << sound_index);
+    sound_first_page_drop(sound_index);
+}
+
+/*
+ * Converts float samples, with full scale at +/-1.0, to the 24 bits used by
+ * the DAC, on the top of the I2S' 32 bits words. Values out of range are
+ * clipped and NaN is converted to 0.
+ * The loop has no branches so it's compiled with the FPU's conditional moves.
+ * dst and src can be the same buffer.
+ */
+#define FLOAT_SAMPLE_FULL_SCALE 8388607.0f
+
+static void convert_float_samples(int *dst, float *src, int length)
+{
+    float sample;
+    
+    for (; length != 0; length--)
+    {
+        sample = *src++ * FLOAT_SAMPLE_FULL_SCALE;
+        sample = (sample == sample) ? sample : 0.0f;
+        sample = (sample > FLOAT_SAMPLE_FULL_SCALE) ? FLOAT_SAMPLE_FULL_SCALE : sample;
+        sample = (sample < -FLOAT_SAMPLE_FULL_SCALE - 1.0f) ? -FLOAT_SAMPLE_FULL_SCALE - 1.0f : sample;
+        
+        *dst++ = (int)(sample + ((sample < 0.0f) ? -0.5f : 0.5f)) * 256;
+    }
+}
+
 void prepare_metadataCmd(void)
 {
     int i;
@@ -844,22 +2252,36 @@ void prepare_metadataCmd(void)
     int *error = (int*)(transmitDataBuffer + 8);
     *error = ERROR_NOERROR;
 
+    /* Data commands carry the 32 KB chunks that follow the one in this command */
+    int last_data_index = (ptr->sound_length * 4 - 1) / 32768;
+    
     ptr->sound_length = ptr->sound_length & 0xFFFFFFFC; // Samples must be multiple of 4
                                                         // The DMA stops if loaded with 2 samples at 192KHz
 
-    if (ptr->sound_index < 0 || ptr->sound_index > get_available_sounds()) *error = ERROR_BADSOUNDINDEX;
+    if (ptr->sound_index < 0 || ptr->sound_index >= get_available_sounds()) *error = ERROR_BADSOUNDINDEX;
     if (ptr->sound_length < 16) *error = ERROR_BADSOUNDLENGTH;
+    if (ptr->fade_length > ENVELOPE_LENGTH) *error = ERROR_BADSOUNDLENGTH;
     if (ptr->sample_rate != 96000 && ptr->sample_rate != 192000) *error = ERROR_BADSAMPLERATE;
-    if (ptr->data_type != 0 && ptr->data_type != 1) *error = ERROR_BADDATATYPE;
+    if (ptr->data_type != 0 && ptr->data_type != 1 && ptr->data_type != 2) *error = ERROR_BADDATATYPE;
     if (ptr->sound_index == 0 && ptr->data_type != 1) *error = ERROR_BADDATATYPEMATCH;
     if (ptr->sound_index == 1 && ptr->data_type != 1) *error = ERROR_BADDATATYPEMATCH;
-    if (ptr->sound_index > 1 && ptr->data_type != 0) *error = ERROR_BADDATATYPEMATCH;
+    
+    /* Compressed sounds start with their header and an index with a frame per page decoded, within the stream */
+    Compressed_Sound_Header * header = (Compressed_Sound_Header*)(receivedDataBuffer + 8 + 16);
+    if (ptr->data_type == 2)
+    {
+        if (header->magic != COMPRESSED_SOUND_MAGIC || header->sound_length < 16) *error = ERROR_BADDATATYPE;
+        else if (header->number_of_frames < (header->sound_length - 1) / AUDIO_BUFFER_LEN + 1) *error = ERROR_BADSOUNDLENGTH;
+        else if (header->number_of_frames > ptr->sound_length - 4) *error = ERROR_BADSOUNDLENGTH;
+    }
 
     if (current_sample_rate == 192000)
         if (sound_is_playing)
             *error = ERROR_PRODUCINGSOUND;
     
-    if (prepare_memory_check(ptr->sound_index, ptr->sound_length) == false) *error = ERROR_BADSOUNDLENGTH;
+    /* Only with a valid index and length, the extent is found from them */
+    if (*error == ERROR_NOERROR)
+        if (prepare_memory_check(ptr->sound_index, ptr->sound_length) == false) *error = ERROR_BADSOUNDLENGTH;
     
     for (i = 8; i != 0; i--)
         transmitDataBuffer[i-1] = receivedDataBuffer[i-1];
@@ -867,29 +2289,34 @@ void prepare_metadataCmd(void)
     if (*error == ERROR_NOERROR)
     {
         prepare_metadataCmd_state = METADATACMD_STATE_SAVE_USER_METADATA;
+        sound_write_failed = false;
         
         audio_all_metadata[ptr->sound_index] = *ptr;
         audio_sound_exists[ptr->sound_index] = true;
-        audio_sound_exists_bitmask |= (1 << ptr->sound_index);
         
-        for (i = 2048; i != 0; i--)
-            audio_user_metadata[ptr->sound_index][i-1] = receivedDataBuffer[4+4+16+32768+i-1];
+        if (ptr->data_type == 2)
+            audio_all_metadata[ptr->sound_index].sound_length = header->sound_length & 0xFFFFFFFC;
+        audio_sound_exists_bitmask |= (1ULL << ptr->sound_index);
+        
+        /* Float samples are converted before being cached and programmed */
+        if (ptr->sound_index > 1 && ptr->data_type == 1)
+            convert_float_samples((int*)(&receivedDataBuffer[4+4+16]), (float*)(&receivedDataBuffer[4+4+16]), 32768/4);
         
-        int * first_buffer_index = ((int*)(&receivedDataBuffer[4+4+16]));
-        for (i = AUDIO_BUFFER_LEN; i != 0; i--)
+        if (ptr->sound_index != 0)
         {
-            audio_all_first_buffers[ptr->sound_index][i-1] = *(first_buffer_index +i-1);
-            audio_all_second_buffers[ptr->sound_index][i-1] = *( ((int*)(&receivedDataBuffer[4+4+16+AUDIO_BUFFER_LEN*4])) +i-1);
+            if (ptr->data_type == 2)
+            {
+                /* The page is decoded from the memory when needed */
+                sound_first_page_drop(ptr->sound_index);
+            }
+            else
+            {
+                sound_first_page_fill(ptr->sound_index, (int*)(&receivedDataBuffer[4+4+16]));
+            }
         }
         
         audio_all_metadata[0] = *ptr;
         
-        for (i = AUDIO_BUFFER_LEN; i != 0; i--)
-        {
-            audio_all_first_buffers[0][i-1] = 0;
-            audio_all_second_buffers[0][i-1] = 0;
-        }
-        
         //set_LED_MEMORY;
 
         //save_user_metadata(ptr->sound_index, &receivedDataBuffer[4+4+16+32768]);
@@ -902,13 +2329,15 @@ void prepare_metadataCmd(void)
         //clr_LED_MEMORY;
 
         sound_index_to_write = ptr->sound_index;
-        max_sound_data_index = 0x7FFFFFFF;  // Code to be done        
+        sound_data_type_to_write = (ptr->sound_index > 1) ? ptr->data_type : 0;
+        max_sound_data_index = last_data_index;
         
         metadataCmd_received = true;
     }
     else
     {
         sound_index_to_write = -1;
+        max_sound_data_index = 0;
         
         reply_USB(12);
     }
@@ -958,7 +2387,28 @@ void process_metadataCmd(void)
     if (prepare_metadataCmd_state == METADATACMD_STATE_SAVE_ALLOCATE_METADATA)
     {
         Sound_Metadata * ptr = (Sound_Metadata*)(receivedDataBuffer + 8);
-        if (allocate_metadata_command (*ptr, &receivedDataBuffer[4+4+16]) == true)
+        int pages = allocate_metadata_command (*ptr, &receivedDataBuffer[4+4+16]);
+        
+        if (pages == -1)
+        {
+            /* The sound was removed, the table is saved before replying */
+            sound_write_failed = true;
+            clear_sound_exists(prepare_metadataCmd_sound_index);
+            *error = ERROR_MEMORYWRITE;
+            
+            prepare_metadataCmd_state = METADATACMD_STATE_SAVE_SOUND_TABLE;
+        }
+        else if (pages == 32768/BYTES_PER_PAGE)
+        {
+            prepare_metadataCmd_state = METADATACMD_STATE_SAVE_SOUND_TABLE;
+        }
+        
+        return;
+    }
+    
+    if (prepare_metadataCmd_state == METADATACMD_STATE_SAVE_SOUND_TABLE)
+    {
+        if (save_sound_table() == true)
         {        
             metadataCmd_received = false;
             
@@ -970,28 +2420,46 @@ void process_metadataCmd(void)
 }
 
 int process_dataCmd_data_index;
+bool process_dataCmd_reply_pending;
+bool process_dataCmd_table_pending = false;
 
 void prepare_dataCmd(void)
 {
     int i;
     
     int *error = (int*)(transmitDataBuffer + 8); 
-    process_dataCmd_data_index = *((int*)(receivedDataBuffer + 8));
+    int data_index = *((int*)(receivedDataBuffer + 8));
     *error = ERROR_NOERROR;
    
-    /*if (process_dataCmd_data_index > max_sound_data_index) *error = ERROR_BADDATAINDEX;    
+    if (data_index < 1 || data_index > max_sound_data_index) *error = ERROR_BADDATAINDEX;
     if (current_sample_rate == 192000)
         if (sound_is_playing)
             *error = ERROR_PRODUCINGSOUND;
-    */
+    if (sound_write_failed) *error = ERROR_MEMORYWRITE;
     
     for (i = 8; i != 0; i--)
         transmitDataBuffer[i-1] = receivedDataBuffer[i-1];
 
     if (*error == ERROR_NOERROR)
     {
+        int *src = (int*)(&receivedDataBuffer[4+4+4]);
+        int *dst = (int*)dataCmd_buffer;
+        
+        if (sound_data_type_to_write == 1)
+            convert_float_samples(dst, (float*)src, 32768/4);
+        else
+            for (i = 32768/4; i != 0; i--)
+                *dst++ = *src++;
+        
+        process_dataCmd_data_index = data_index;
         allocate_data_command_reset();
         dataCmd_received = true;
+        
+        /* The last command is only acknowledged once it is programmed */
+        process_dataCmd_reply_pending = (data_index == max_sound_data_index);
+        
+        if (!process_dataCmd_reply_pending)
+            reply_USB(12);
     }
     else
     {
@@ -1001,33 +2469,132 @@ void prepare_dataCmd(void)
 
 void process_dataCmd(void)
 {
-    set_LED_MEMORY;
-    
-    int *error = (int*)(transmitDataBuffer + 8);
-    
+    /* Programming stalls the main loop too long at 192KHz, wait for the sound to end */
     if (current_sample_rate == 192000)
         if (sound_is_playing)
+            return;
+    
+    set_LED_MEMORY;
+    
+    if (process_dataCmd_table_pending)
+    {
+        if (save_sound_table() == false)
+            return;
+        
+        process_dataCmd_table_pending = false;
+    }
+    else
+    {
+        int pages = allocate_data_command(sound_index_to_write, process_dataCmd_data_index, dataCmd_buffer);
+        
+        if (pages == -1)
         {
-            *error = ERROR_PRODUCINGSOUND;
-            
-            dataCmd_received = false;
-            
-            clr_LED_MEMORY;
-
-            reply_USB(12);
+            /* The sound was removed, the table is saved before replying */
+            sound_write_failed = true;
+            clear_sound_exists(sound_index_to_write);
+            process_dataCmd_table_pending = true;
             return;
         }
+        
+        if (pages != 32768/BYTES_PER_PAGE)
+            return;
+    }
+    
+    dataCmd_received = false;
     
-    if (allocate_data_command(sound_index_to_write, process_dataCmd_data_index, &receivedDataBuffer[4+4+4]) == 32768/BYTES_PER_PAGE)
+    clr_LED_MEMORY;
+    
+    if (process_dataCmd_reply_pending)
     {
-        dataCmd_received = false;
+        int *error = (int*)(transmitDataBuffer + 8);
         
-        clr_LED_MEMORY;
+        if (sound_write_failed) *error = ERROR_MEMORYWRITE;
         
+        process_dataCmd_reply_pending = false;
         reply_USB(12);
     }
 }
 
+void process_streamStartCmd(void)
+{
+    int i;
+    int *error = (int*)(transmitDataBuffer + 8);
+    int sample_rate = *((int*)(receivedDataBuffer + 8));
+    *error = ERROR_NOERROR;
+    
+    if (sample_rate != 96000 && sample_rate != 192000) *error = ERROR_BADSAMPLERATE;
+    
+    for (i = 8; i != 0; i--)
+        transmitDataBuffer[i-1] = receivedDataBuffer[i-1];
+    
+    if (*error == ERROR_NOERROR)
+    {
+        stop_stream();
+        
+        stream_fifo_read = 0;
+        stream_fifo_write = 0;
+        stream_fifo_count = 0;
+        stream_sample_rate = sample_rate;
+        stream_ended = false;
+        stream_underruns = 0;
+        stream_state = STREAM_STATE_FILLING;
+        stop_sine_gen = true;
+        stop_noise_generator();
+        stop_stimulus_generator();
+    }
+    
+    reply_USB(12);
+}
+
+/* Returns false while the FIFO doesn't have room for the chunk.
+ * The reply is held until then, which throttles the host.
+ */
+bool process_streamDataCmd(void)
+{
+    int i;
+    int *error = (int*)(transmitDataBuffer + 8);
+    int num_samples = *((int*)(receivedDataBuffer + 8));
+    int *samples = (int*)(&receivedDataBuffer[4+4+4]);
+    *error = ERROR_NOERROR;
+    
+    if (stream_state == STREAM_STATE_IDLE || stream_ended) *error = ERROR_STREAMNOTSTARTED;
+    if (num_samples < 0 || num_samples > STREAM_CHUNK_LEN || (num_samples & 3)) *error = ERROR_BADSOUNDLENGTH;
+    
+    if (*error == ERROR_NOERROR)
+    {
+        if (STREAM_FIFO_LEN - stream_fifo_count < num_samples)
+            return false;
+        
+        for (i = 0; i < num_samples; i++)
+            stream_fifo[(stream_fifo_write + i) & (STREAM_FIFO_LEN - 1)] = samples[i];
+        
+        stream_fifo_write = (stream_fifo_write + num_samples) & (STREAM_FIFO_LEN - 1);
+        stream_fifo_count += num_samples;
+        
+        /* A chunk shorter than STREAM_CHUNK_LEN ends the stream */
+        if (num_samples < STREAM_CHUNK_LEN)
+            stream_ended = true;
+        
+        if (stream_state == STREAM_STATE_FILLING)
+            if (stream_ended || stream_fifo_count == STREAM_FIFO_LEN)
+            {
+                stream_first_buffer = true;
+                stream_state = STREAM_STATE_PLAYING;
+            }
+    }
+    
+    for (i = 8; i != 0; i--)
+        transmitDataBuffer[i-1] = receivedDataBuffer[i-1];
+    
+    /* Free chunks and underruns let the host follow the stream */
+    *((int*)(transmitDataBuffer + 12)) = (STREAM_FIFO_LEN - stream_fifo_count) / STREAM_CHUNK_LEN;
+    *((unsigned int*)(transmitDataBuffer + 16)) = stream_underruns;
+    
+    reply_USB(20);
+    
+    return true;
+}
+
 void process_readMetadataCmd(void)
 {    
     int i;
@@ -1035,17 +2602,29 @@ void process_readMetadataCmd(void)
     int *index = (int*)(receivedDataBuffer + 8);
     *error = ERROR_NOERROR;
     
-    if (*index < 0 || *index > 31) *error = ERROR_BADSOUNDINDEX;                                
+    if (*index < 0 || *index >= get_available_sounds()) *error = ERROR_BADSOUNDINDEX;                                
     //if (sound_is_playing) *error = ERROR_PRODUCINGSOUND;
 
     if (*error == ERROR_NOERROR)
     {
         /* Load user's metadata */
-        for (i = 2048; i != 0; i--)
-            transmitDataBuffer[28 + i-1] = audio_user_metadata[*index][i-1];
+        if (audio_sound_exists[*index])
+        {
+            set_LED_MEMORY;
+            read_user_metadata(*index, &transmitDataBuffer[28]);
+            clr_LED_MEMORY;
+        }
+        else
+        {
+            for (i = 2048; i != 0; i--)
+                transmitDataBuffer[28 + i-1] = 0;
+        }
 
-        /* Load audio exists bitmask */
-        *((unsigned int*)(&transmitDataBuffer[12])) = audio_sound_exists_bitmask;
+        /* Load audio exists bitmask
+         * The sounds 32 to 63 are appended after the user's metadata
+         */
+        *((unsigned int*)(&transmitDataBuffer[12])) = (unsigned int)(audio_sound_exists_bitmask);
+        *((unsigned int*)(&transmitDataBuffer[2076])) = (unsigned int)(audio_sound_exists_bitmask >> 32);
 
         /* Load sound's metadata */
         for (i = 3*4; i != 0; i--)
@@ -1055,7 +2634,7 @@ void process_readMetadataCmd(void)
     for (i = 8; i != 0; i--)
         transmitDataBuffer[i-1] = receivedDataBuffer[i-1];    
     
-    reply_USB(2076);
+    reply_USB(2080);
 }
 
 // *****************************************************************************
@@ -1110,34 +2689,18 @@ void APP_Initialize ( void )
      */
     initialize_ios((int) reasonType);   // Will leave all LEDs on
     
-    /*
-    for (; i < 64/2; i++)
-    {
-        _X_ = _X_ + 2.0*3.141592654/(96000.0/3000.0);
-        audio_sinewave[i*2] = 16777216/2 * sin(_X_);
-        audio_sinewave[i*2+1] = audio_sinewave[i*2];
-    }
-    */
-    
-    //right_sinewave_freq = 200;
-    
-    /*
-     * Clear the sinewave generator's buffers
-     */
-    for (; i < SINEWAVE_GEN_96KHZ_LOAD_SAMPLE_N/2; i++)
-    {
-        audio_sinewave[i*2+0] = 0;  // Left
-        audio_sinewave[i*2+1] = 0;  // Right
-    }
-    
     initialize_audio_ios((int) reasonType);
+    initialize_audio_gains();
     clr_LED_AUDIO;                      // There is no way to check the audio circuit
                                         // Turn AUDIO LED off         
     initialize_memory_ios();
     if (check_memory_connection() != -1) 
     {
-        fill_audio_first_and_second_buffers();
-        fill_audio_user_metadata();
+        perf_boot_memory = _CP0_GET_COUNT();
+        fill_audio_metadata();
+        fill_audio_sound_exists();
+        fill_sound_first_pages();
+        perf_boot_memory = _CP0_GET_COUNT() - perf_boot_memory;
         clr_LED_MEMORY;                 // Memory is OK, turn MEMORY LED off
     }
     
@@ -1173,6 +2736,11 @@ void APP_Initialize ( void )
      */
     populate_envelope_internal();
     
+    /* 
+     * Initialize the sine generator's table.
+     */
+    populate_sine_table();
+    
     /* 
      * Clean all metadata in the memory.
      */
@@ -1204,6 +2772,11 @@ void APP_Initialize ( void )
      * Register I2S callback routine for handler events.
      */
     DRV_I2S_BufferEventHandlerSet(i2sDriverHandle, I2SBufferEventHandler, NULL);
+    
+    /* 
+     * Start the main loop performance counter.
+     */
+    perf_loop_tick = _CP0_GET_COUNT();
 }
 
 
@@ -1220,10 +2793,19 @@ int command_received = 0;
 
 void APP_Tasks ( void )
 {   
+    unsigned int perf_now = _CP0_GET_COUNT();
+    perf_loop_last = perf_now - perf_loop_tick;
+    perf_loop_tick = perf_now;
+    if (perf_loop_last > perf_loop_max)
+        perf_loop_max = perf_loop_last;
+    
     update_sound_buffers();
     
     if (command_received != 0)
     {
+        int att_left = -1;
+        int att_right = -1;
+        
         switch(command_received)
         {
             case CMD_START:
@@ -1232,7 +2814,7 @@ void APP_Tasks ( void )
                 switch(command_received)
                 {
                     case CMD_START:
-                        new_sound_index = par_bus_process_command_start();
+                        new_sound_index = par_bus_process_command_start(&att_left, &att_right);
                         break;
                         
                     case CMD_UPDATE_FREQUENCY:
@@ -1240,52 +2822,149 @@ void APP_Tasks ( void )
                         break;
                 }
                 
-                if (new_sound_index < 32)
+                if (new_sound_index < get_available_sounds())
                 {
                     if (check_cmd_start(new_sound_index))
                     {
+                        perf_trigger_tick = _CP0_GET_COUNT();
+                        new_sound_att_left = att_left;
+                        new_sound_att_right = att_right;
                         launch_sound_v3(/*new_sound_index*/);
                     
                         stop_sine_gen = true;
+                        stop_noise_generator();
+                        stop_stimulus_generator();
                     }
                 }
                 else if (new_sound_index < 40000)
                 {
-                    new_right_sinewave_freq = new_sound_index;
+                    update_audio_attenuation(att_left, att_right, true);
+                    new_sine_gen_frequency_left = new_sound_index * 1000;
+                    new_sine_gen_frequency_right = new_sound_index * 1000;
+                    new_sine_gen_phase_left = 0;
+                    new_sine_gen_sweep_duration = 0;
                     new_sine_gen_frequency_is_available = true;
+                    
+                    new_noise_gen_is_available = false;
+                    stop_noise_gen = true;
+                    new_stimulus_gen_is_available = false;
+                    stop_stimulus_gen = true;
+                }
+                else if (new_sound_index >= NOISE_WHITE && new_sound_index <= NOISE_BAND_PASS)
+                {
+                    update_audio_attenuation(att_left, att_right, true);
+                    new_noise_gen_type = new_sound_index;
+                    new_noise_gen_is_available = true;
+                    
+                    /* A noise being played ramps down before the new one */
+                    stop_noise_gen = true;
+                    new_sine_gen_frequency_is_available = false;
+                    stop_sine_gen = true;
+                    new_stimulus_gen_is_available = false;
+                    stop_stimulus_gen = true;
                 }
                 
                 break;
             
-            case CMD_STOP:
-                if (right_sinewave_freq == 0)   // Sinewave generator is not working
+            case CMD_START_MIXED:
+                {
+                    int index = par_bus_process_command_start_mixed(&att_left, &att_right);
+                    
+                    launch_sound_mixed(index, att_left, att_right);
+                }
+                break;
+            
+            case CMD_START_SCHEDULED:
+                sound_scheduled_index = par_bus_process_command_start_scheduled(&sound_scheduled_tick, &sound_scheduled_att_left, &sound_scheduled_att_right);
+                sound_scheduled = true;
+                stop_sine_gen = true;
+                stop_noise_generator();
+                stop_stimulus_generator();
+                break;
+            
+            case CMD_START_TONE:
                 {
-                    par_bus_process_command_stop();
+                    int frequency_left;
+                    int frequency_right;
+                    int phase_left;
+                    
+                    par_bus_process_command_start_tone(&frequency_left, &frequency_right, &phase_left, &att_left, &att_right);
+                    
+                    update_audio_attenuation(att_left, att_right, true);
+                    new_sine_gen_frequency_left = frequency_left;
+                    new_sine_gen_frequency_right = frequency_right;
+                    new_sine_gen_phase_left = ((unsigned long long)phase_left << 32) / TONE_PHASE_MAX;
+                    new_sine_gen_sweep_duration = 0;
+                    new_sine_gen_frequency_is_available = true;
+                    
+                    new_noise_gen_is_available = false;
+                    stop_noise_gen = true;
+                    new_stimulus_gen_is_available = false;
+                    stop_stimulus_gen = true;
                 }
-                else
+                break;
+            
+            case CMD_START_SWEEP:
                 {
-                    stop_sine_gen = true;
+                    int frequency_start;
+                    int frequency_end;
+                    int duration;
+                    int mode;
+                    
+                    par_bus_process_command_start_sweep(&frequency_start, &frequency_end, &duration, &mode, &att_left, &att_right);
+                    
+                    update_audio_attenuation(att_left, att_right, true);
+                    new_sine_gen_frequency_left = frequency_start;
+                    new_sine_gen_frequency_right = frequency_start;
+                    new_sine_gen_phase_left = 0;
+                    new_sine_gen_sweep_frequency = frequency_end;
+                    new_sine_gen_sweep_duration = duration;
+                    new_sine_gen_sweep_mode = mode;
+                    new_sine_gen_frequency_is_available = true;
+                    
+                    new_noise_gen_is_available = false;
+                    stop_noise_gen = true;
+                    new_stimulus_gen_is_available = false;
+                    stop_stimulus_gen = true;
+                }
+                break;
+            
+            case CMD_START_STIMULUS:
+                par_bus_process_command_start_stimulus(&new_stimulus_gen_carrier, &new_stimulus_gen_modulation, &new_stimulus_gen_depth,
+                                                       &new_stimulus_gen_duration, &new_stimulus_gen_ramp, &new_stimulus_gen_period,
+                                                       &new_stimulus_gen_count, &att_left, &att_right);
+                
+                update_audio_attenuation(att_left, att_right, true);
+                new_stimulus_gen_is_available = true;
+                
+                /* A stimulus being played ramps down before the new one */
+                stop_stimulus_gen = true;
+                new_sine_gen_frequency_is_available = false;
+                stop_sine_gen = true;
+                new_noise_gen_is_available = false;
+                stop_noise_gen = true;
+                break;
+            
+            case CMD_NOISE_SETTINGS:
+                {
+                    int seed;
+                    
+                    par_bus_process_command_noise_settings(&seed, &noise_low_frequency, &noise_high_frequency);
+                    
+                    /* The generator would be stuck at 0 */
+                    noise_seed = (seed != 0) ? seed : NOISE_DEFAULT_SEED;
                 }
                 break;
+            
+            case CMD_STOP:
+                stop_sound();
+                par_bus_process_command_stop();
+                break;
         }
         
         command_received = 0;
     }
     
-    
-    
-    /*
-    set_TP1;
-    int i = 0;
-    for (; i < 512; i++)
-    {
-        audio_buffer0[i] = audio_all_first_buffers[2][i] * (envelope_user[i] / 32768);
-        audio_buffer1[i] = audio_all_first_buffers[3][i] * (envelope_internal[i] / 32768);
-    }
-    clr_TP1;
-    */
-        
-    
     command_received = par_bus_check_if_command_is_available();
     
     /* 
@@ -1293,13 +2972,7 @@ void APP_Tasks ( void )
      * Issue a software reset if not.
      * Usually, this test is performed each ~1.5 us
      */
-    if (++dma_i2s_handle0_timeout == 20000) // Around 30 ms
-    {
-        clr_AUDIO_RESET;
-        reset_PIC32();
-        while(1);
-    }
-    if (++dma_i2s_handle1_timeout == 20000) // Around 30 ms
+    if (++dma_i2s_timeout == 20000) // Around 30 ms
     {
         clr_AUDIO_RESET;
         reset_PIC32();
@@ -1418,6 +3091,10 @@ void APP_Tasks ( void )
                     switch (receivedDataBuffer[3])
                     {
                         case 0x80:
+                            /* Wait for the previous sound to be programmed */
+                            if (dataCmd_received)
+                                break;
+                            
                             if (receivedDataBuffer[32792+2048] == 'f')
                             {
                                 set_LED_USB;
@@ -1436,6 +3113,10 @@ void APP_Tasks ( void )
                             break;
                             
                         case 0x81:
+                            /* Wait for the previous command to be programmed */
+                            if (dataCmd_received)
+                                break;
+                            
                             if (receivedDataBuffer[32780] == 'f')
                             {
                                 set_LED_USB;                                
@@ -1453,7 +3134,43 @@ void APP_Tasks ( void )
                             
                             break;
                             
+                        case 0x82:
+                            if (receivedDataBuffer[32780] == 'f')
+                            {
+                                set_LED_USB;
+                                
+                                if (process_streamDataCmd())
+                                {
+                                    receivedDataBuffer[0] = 0;
+                                    receivedDataBuffer[1] = 0;
+                                    receivedDataBuffer[2] = 0;
+                                    receivedDataBuffer[3] = 0;
+                                    receivedDataBuffer[32780] = 0;
+                                }
+                            }    
+                            
+                            break;
+                            
+                        case 0x83:
+                            if (receivedDataBuffer[12] == 'f')
+                            {
+                                set_LED_USB;
+                                process_streamStartCmd();
+                                
+                                receivedDataBuffer[0] = 0;
+                                receivedDataBuffer[1] = 0;
+                                receivedDataBuffer[2] = 0;
+                                receivedDataBuffer[3] = 0;
+                                receivedDataBuffer[12] = 0;
+                            }    
+                            
+                            break;
+                            
                         case 0x84:
+                            /* Wait for the sound to be programmed */
+                            if (dataCmd_received || metadataCmd_received)
+                                break;
+                            
                             if (receivedDataBuffer[12] == 'f')
                             {
                                 set_LED_USB;
@@ -1499,7 +3216,7 @@ void APP_Tasks ( void )
                 //switch(receivedDataBuffer[0])
                 //{
                     int i = 0;
-                    for (; i < APP_READ_BUFFER_SIZE; i++)
+                    for (; i < APP_WRITE_BUFFER_SIZE; i++)
                         transmitDataBuffer[i] = receivedDataBuffer[i];
                     
                     USB_DEVICE_EndpointWrite ( appData.usbDevHandle, &appData.writeTranferHandle,
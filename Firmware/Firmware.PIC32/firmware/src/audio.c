@@ -75,17 +75,68 @@ void update_audio_register(int register_address, int register_content)
     clr_AUDIO_SDO;
 }
 
+/*
+ * Gains of each attenuation step, Q30.
+ * Computed once so an attenuation update is a lookup instead of a pow()
+ * (~12.7 us @ 200MHz).
+ */
+int audio_gain_table[AUDIO_ATTENUATION_MAX + 1];
+
+/* Gains of the output, Q30, on the samples or on the DAC's volume.
+ * On a transition, the gains move from the previous ones along the envelope.
+ */
+int audio_gain_left = AUDIO_GAIN_UNITY;
+int audio_gain_right = AUDIO_GAIN_UNITY;
+static int audio_gain_left_from;
+static int audio_gain_right_from;
+static int audio_gain_ramp_frame = AUDIO_GAIN_RAMP_LENGTH;     // Transition done
+
+void initialize_audio_gains(void)
+{
+    int i = 0;
+    
+    for (; i <= AUDIO_ATTENUATION_MAX; i++)
+        audio_gain_table[i] = AUDIO_GAIN_UNITY * pow(10, (i * -1) / 200.0) + 0.5;
+}
+
+/*
+ * Returns the Q30 gain of an attenuation.
+ * Each LSB of the integer is 0.1dB
+ */
+int audio_gain_from_attenuation(int attenuation)
+{
+    if (attenuation <= 0)
+        return AUDIO_GAIN_UNITY;
+    
+    if (attenuation > AUDIO_ATTENUATION_MAX)
+        return 0;
+    
+    return audio_gain_table[attenuation];
+}
+
+/* Content of the DAC's volume register for a Q30 gain */
+static int audio_volume_from_gain(int gain)
+{
+    int volume = ((long long)gain * ((1 << 14) - 1)) >> 30;
+    
+    return volume << 2;
+}
+
+/* Content of the DAC's volume register for an attenuation */
+static int audio_volume_register(int attenuation)
+{
+    return audio_volume_from_gain(audio_gain_from_attenuation(attenuation));
+}
+
 /*
  * Sets the audio attenuation.
- * 12.7 us @ 200MHz
  */
 void update_audio_volume_dBV(float gain, bool update_left, bool update_right)
 {
     if (gain > 0)
         return;
 
-    int volume = pow(10, gain / 20) * (pow(2, 14) - 1);    
-    int reg_content = volume << 2;
+    int reg_content = audio_volume_register(gain * -10 + 0.5);
     
     if (update_left)
         update_audio_register(2, reg_content);
@@ -105,15 +156,9 @@ void update_audio_volume_int(int att_left, int att_right)
     
     if (att_right < 0)
         return;
-
-    int volume_left  = pow(10, ((att_left  * -1) / 10.0) / 20) * (pow(2, 14) - 1);
-    int volume_right = pow(10, ((att_right * -1) / 10.0) / 20) * (pow(2, 14) - 1);
     
-    int reg_content_left  = volume_left  << 2;
-    int reg_content_right = volume_right << 2;
-    
-    update_audio_register(2, reg_content_left);
-    update_audio_register(3, reg_content_right);
+    update_audio_register(2, audio_volume_register(att_left));
+    update_audio_register(3, audio_volume_register(att_right));
 }
 
 /*
@@ -124,12 +169,8 @@ void update_audio_volume_left_int(int att_left)
 {
     if (att_left < 0)
         return;
-
-    int volume_left  = pow(10, ((att_left  * -1) / 10.0) / 20) * (pow(2, 14) - 1);
-    
-    int reg_content_left  = volume_left  << 2;
     
-    update_audio_register(2, reg_content_left);
+    update_audio_register(2, audio_volume_register(att_left));
 }
 
 /*
@@ -140,12 +181,115 @@ void update_audio_volume_right_int(int att_right)
 {
     if (att_right < 0)
         return;
+    
+    update_audio_register(3, audio_volume_register(att_right));
+}
+
+/* Gain on the current frame of a transition */
+static inline int audio_gain_ramp(int from, int to)
+{
+    int envelope = envelope_internal[audio_gain_ramp_frame * (ENVELOPE_LENGTH / AUDIO_GAIN_RAMP_LENGTH)];
+    
+    return from + (((long long)(to - from) * envelope) >> 15);
+}
+
+/*
+ * Sets the attenuation of the output, on the DAC or on the samples.
+ * If ramp is set, the gains move to the new ones in AUDIO_GAIN_RAMP_LENGTH
+ * frames from the next buffer queued. If not, the digital gains apply from
+ * the next buffer queued and the DAC's volume right away.
+ * A negative attenuation leaves the channel unchanged.
+ */
+void update_audio_attenuation(int att_left, int att_right, bool ramp)
+{
+    if (ramp)
+    {
+        /* A transition on the way starts from where it is */
+        if (audio_gain_ramp_frame < AUDIO_GAIN_RAMP_LENGTH)
+        {
+            audio_gain_left_from = audio_gain_ramp(audio_gain_left_from, audio_gain_left);
+            audio_gain_right_from = audio_gain_ramp(audio_gain_right_from, audio_gain_right);
+        }
+        else
+        {
+            audio_gain_left_from = audio_gain_left;
+            audio_gain_right_from = audio_gain_right;
+        }
+        
+        audio_gain_ramp_frame = 0;
+    }
+    else
+    {
+        audio_gain_ramp_frame = AUDIO_GAIN_RAMP_LENGTH;
+    }
+    
+    if (att_left >= 0)
+        audio_gain_left = audio_gain_from_attenuation(att_left);
+    
+    if (att_right >= 0)
+        audio_gain_right = audio_gain_from_attenuation(att_right);
+    
+#if !AUDIO_DIGITAL_ATTENUATION
+    if (!ramp)
+    {
+        update_audio_volume_left_int(att_left);
+        update_audio_volume_right_int(att_right);
+    }
+#endif
+}
+
+/*
+ * Moves the DAC's volume along the transition by the frames of a buffer.
+ * The ramp has a step per buffer queued, ~14 us @ 200MHz each.
+ */
+void step_audio_volume(int num_samples)
+{
+    int gain_left = audio_gain_left;
+    int gain_right = audio_gain_right;
+    
+    if (audio_gain_ramp_frame >= AUDIO_GAIN_RAMP_LENGTH)
+        return;
+    
+    audio_gain_ramp_frame += num_samples / 2;
+    
+    if (audio_gain_ramp_frame < AUDIO_GAIN_RAMP_LENGTH)
+    {
+        gain_left = audio_gain_ramp(audio_gain_left_from, gain_left);
+        gain_right = audio_gain_ramp(audio_gain_right_from, gain_right);
+    }
+    else
+    {
+        audio_gain_ramp_frame = AUDIO_GAIN_RAMP_LENGTH;
+    }
+    
+    update_audio_register(2, audio_volume_from_gain(gain_left));
+    update_audio_register(3, audio_volume_from_gain(gain_right));
+}
 
-    int volume_right  = pow(10, ((att_right  * -1) / 10.0) / 20) * (pow(2, 14) - 1);
+/*
+ * Applies the digital gains to a stereo buffer.
+ * ~25 us @ 200MHz for 512 samples, skipped at 0 dB out of a transition.
+ */
+void apply_audio_gains(int *buffer, int num_samples)
+{
+    int gain_left = audio_gain_left;
+    int gain_right = audio_gain_right;
+    int i = 0;
     
-    int reg_content_right  = volume_right  << 2;
+    for (; i < num_samples && audio_gain_ramp_frame < AUDIO_GAIN_RAMP_LENGTH; i += 2, audio_gain_ramp_frame++)
+    {
+        buffer[i]   = ((long long)buffer[i]   * audio_gain_ramp(audio_gain_left_from, gain_left))   >> 30;
+        buffer[i+1] = ((long long)buffer[i+1] * audio_gain_ramp(audio_gain_right_from, gain_right)) >> 30;
+    }
     
-    update_audio_register(3, reg_content_right);
+    if (gain_left == AUDIO_GAIN_UNITY && gain_right == AUDIO_GAIN_UNITY)
+        return;
+    
+    for (; i < num_samples; i += 2)
+    {
+        buffer[i]   = ((long long)buffer[i]   * gain_left)  >> 30;
+        buffer[i+1] = ((long long)buffer[i+1] * gain_right) >> 30;
+    }
 }
 
 /* 
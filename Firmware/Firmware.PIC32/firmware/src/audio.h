@@ -2,6 +2,7 @@
 #define	AUDIO_H
 
 #include <stdbool.h>
+#include <stdint.h>
 
 /* The configuration of the I2S lines are made using Harmony using these settings:
  * -> Pin Number 68: SS4 (out)
@@ -109,13 +110,41 @@
 #define SACD_MCLK_to_BCLK_FALLING_EDGE (1 << 2)
 
 
+/* Attenuation is 0.1 dB per LSB, the output is muted above 120 dB */
+#define AUDIO_ATTENUATION_MAX 1200
+#define AUDIO_GAIN_UNITY (1 << 30)
+
+/* Apply the attenuation to the samples instead of the DAC's volume.
+ * The attenuation of a start command then takes effect at the first sample
+ * of the sound, at the cost of the DAC's resolution on quiet sounds.
+ */
+#define AUDIO_DIGITAL_ATTENUATION 0
+
+/* Frames of a transition between two attenuations, with a step per buffer
+ * on the DAC's volume
+ *   1024 frames -> ~5.3 ms @ 192KHz, ~10.7 ms @ 96KHz
+ */
+#define AUDIO_GAIN_RAMP_LENGTH 1024
+
+/* Rising sin^2 ramp, Q15, populated by the application.
+ *   32K frames -> ~167 ms @ 192KHz, ~334 ms @ 96KHz
+ */
+#define ENVELOPE_LENGTH 1024*32
+extern uint16_t envelope_internal[ENVELOPE_LENGTH];
+
+
 void initialize_audio_ios(int reset_reason_type);
+void initialize_audio_gains(void);
+int audio_gain_from_attenuation(int attenuation);
 
 void update_audio_register(int register_address, int register_content);
 void update_audio_volume_dBV(float gain, bool update_left, bool update_right);
 void update_audio_volume_int(int att_left, int att_right);
 void update_audio_volume_left_int(int att_left);
 void update_audio_volume_right_int(int att_right);
+void update_audio_attenuation(int att_left, int att_right, bool ramp);
+void apply_audio_gains(int *buffer, int num_samples);
+void step_audio_volume(int num_samples);
 void config_audio_dac (int sample_rate, bool update_internal_clock);
 
 
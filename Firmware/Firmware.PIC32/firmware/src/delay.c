@@ -85,38 +85,50 @@ void config_timer_for_pin_sound_is_off(void)
 }
 
 
-void trigger_pin_sound_is_on(int sample_freq)
+/* Output latency, in frames, from the start of a DMA buffer until its first
+ * frame leaves the DAC (SPI FIFO + DAC digital filter group delay).
+ * The DAC runs a different filter at each rate so each one has its own value.
+ */
+#define OUTPUT_LATENCY_FRAMES_96KHZ 21
+#define OUTPUT_LATENCY_FRAMES_192KHZ 9
+
+/* Timer period to wait until the frame number frames of the buffer that just
+ * started to be transmitted reaches the DAC output
+ */
+static int frames_to_pin_timer_period(int sample_freq, int frames)
 {
-    TMR2    = 0;                        // Set counter to 0
+    unsigned int period;
     
     if (sample_freq == 96000)
-        PR2 = 664;                      // 216us
-    else                    
-        PR2 = 150; //49us
-      
-    //1/(3076923/PR) = us
+        frames += OUTPUT_LATENCY_FRAMES_96KHZ;
+    else
+        frames += OUTPUT_LATENCY_FRAMES_192KHZ;
+    
+    period = ((unsigned long long)frames * PIN_TIMER_HZ + sample_freq/2) / sample_freq;
+    
+    if (period < 1)
+        period = 1;
+    if (period > 0xFFFF)
+        period = 0xFFFF;
     
+    return period;
+}
+
+void trigger_pin_sound_is_on(int sample_freq, int frames)
+{
+    TMR2    = 0;                        // Set counter to 0
+    PR2     = frames_to_pin_timer_period(sample_freq, frames);
     T2CONbits.TON   = 1;                // Turn on
 }
 
 bool int_requested_by_sinewave_on = false;
 
-void trigger_pin_sinewave_is_on(int sample_freq, int samples)
+void trigger_pin_sinewave_is_on(int sample_freq, int frames)
 {
     int_requested_by_sinewave_on = true;
     
     TMR2    = 0;                        // Set counter to 0
-    
-    if (sample_freq == 96000)
-    {
-        if (samples == 0)
-            PR2 = 778;                  // Measured 254 us
-        else
-            PR2 = 778 /*254us*/ + (samples / 32.0) * 1020 /*333*/;
-    }
-    else
-        PR2 = 274;                      // 89us
-    
+    PR2     = frames_to_pin_timer_period(sample_freq, frames);
     T2CONbits.TON   = 1;                // Turn on
 }
 
@@ -131,22 +143,50 @@ void __attribute__((vector(_TIMER_2_VECTOR), interrupt(INT_T2_PRIORITY_TLDR_SOFT
     {
         int_requested_by_sinewave_on = false;
         
-        /* Configure Timer 3 with 532 us to clear the pin clr_SOUND_IS_ON */
+        /* Configure Timer 3 with 450 us to clear the pin clr_SOUND_IS_ON */
         TMR3 = 0;                       // Set counter to 0
         PR3  = 1388;                    // 450 us
         T3CONbits.TON   = 1;            // Turn on
     }
 }
 
-void trigger_pin_sound_is_off(int sample_freq, int num_samples)
+void trigger_pin_sound_is_off(int sample_freq, int frames)
 {
     TMR3    = 0;                        // Set counter to 0
+    PR3     = frames_to_pin_timer_period(sample_freq, frames);
+    T3CONbits.TON   = 1;                // Turn on
+}
+
+/* Clears the pin at the frame number frames from now, the sound stops there.
+ * A rising edge waiting for a later frame is dropped and a falling edge
+ * waiting for an earlier one is kept.
+ */
+void stop_pin_sound_is_on(int sample_freq, int frames)
+{
+    unsigned int period = frames_to_pin_timer_period(sample_freq, frames);
+    bool is_on = (LATG & (1 << 6)) ? true : false;
     
-    if (sample_freq == 96000)
-        PR3 = num_samples/2 * 32 + 818 + 40;
-    else
-        PR3 = num_samples/2 * 16 + 274 + 15;
+    if (T2CONbits.TON)
+    {
+        if (PR2 - TMR2 < period)
+        {
+            is_on = true;
+        }
+        else
+        {
+            T2CONbits.TON = 0;
+            int_requested_by_sinewave_on = false;
+        }
+    }
     
+    if (!is_on)
+        return;
+    
+    if (T3CONbits.TON && PR3 - TMR3 < period)
+        return;
+    
+    TMR3    = 0;                        // Set counter to 0
+    PR3     = period;
     T3CONbits.TON   = 1;                // Turn on
 }
 
@@ -5,6 +5,7 @@
 #define CPU_CT_HZ       (CPU_CLOCK_HZ/2)        // CPU CoreTimer in Hz
 #define TICKS_FOR_1US   (CPU_CT_HZ/1000000UL)   // Ticks to produce 1 uS
 #define TICKS_FOR_1MS   (CPU_CT_HZ/1000UL)      // Ticks to produce 1 mS
+#define PIN_TIMER_HZ    (CPU_CLOCK_HZ/65)       // PBCLK3, clocks Timer 2 and Timer 3
 
 void _tick_delay(int ticks);
 void _us_delay(int us);
@@ -12,9 +13,10 @@ void _ms_delay(int ms);
 
 void config_timer_for_pin_sound_is_on(void);
 void config_timer_for_pin_sound_is_off(void);
-void trigger_pin_sound_is_on(int sample_freq);
-void trigger_pin_sinewave_is_on(int sample_freq, int samples);
-void trigger_pin_sound_is_off(int sample_freq, int num_samples);
+void trigger_pin_sound_is_on(int sample_freq, int frames);
+void trigger_pin_sinewave_is_on(int sample_freq, int frames);
+void trigger_pin_sound_is_off(int sample_freq, int frames);
+void stop_pin_sound_is_on(int sample_freq, int frames);
 
 #endif	/* DELAY_H */
 
@@ -2,6 +2,242 @@
 #include <stdbool.h>
 #include "memory.h"
 
+/*
+ * A page read issued by read_memory_start() keeps the memory selected until
+ * read_memory_finish() drains it. Any other access aborts it first.
+ */
+static bool read_is_pending = false;
+
+static void abort_pending_read (void)
+{
+    if (read_is_pending)
+    {
+        /* Wait until the page is loaded (tR) before de-selecting memory */
+        while(!read_MEM_BUSY);
+        set_MEM_CE;
+        
+        read_is_pending = false;
+    }
+}
+
+/*
+ * A page issued by program_memory_cache_start() is programmed in background.
+ * Any other access waits until the array is idle.
+ * The fail bits of the sequence's pages are kept until the next sequence.
+ */
+static bool program_is_pending = false;
+static bool program_is_closed = false;      // The last page was issued (0x10)
+static int program_pages = 0;               // Pages issued on the sequence
+static unsigned int program_fails = 0;      // Bit n set if the nth page failed
+
+static unsigned char read_status (void)
+{
+    unsigned char byte;
+    
+    /* Configure data port to output */
+    to_output_MEM_DATA;
+    
+    /* Select memory */
+    clr_MEM_CE;
+    
+    /* Write command to read the status register */
+    set_MEM_CLE;    // Enable Command Latch Enable
+    clr_MEM_WE;
+    write_MEM_DATA(MEM_REG_READ_STATUS_REG);
+    set_MEM_WE;        
+    clr_MEM_CLE;
+    
+    /* Wait tWHR (min. 60 ns) */
+    clr_MEM_CLE;    // Each instruction is 20 ns
+    clr_MEM_CLE;    // Each instruction is 20 ns
+    clr_MEM_CLE;    // Each instruction is 20 ns
+    
+    /* Configure data port to input */
+    to_input_MEM_DATA;
+    
+    clr_MEM_RE;
+    clr_MEM_RE;
+    clr_MEM_RE;
+    byte = read_MEM_DATA;
+    set_MEM_RE;
+    
+    /* De-select memory */
+    set_MEM_CE;
+    
+    return byte;
+}
+
+static void finish_pending_program (void)
+{
+    unsigned char status;
+    
+    if (program_is_pending)
+    {
+        /* Wait until the last page leaves the data register (ARDY) */
+        while(!read_MEM_BUSY);
+        while(!((status = read_status()) & MEM_STATUS_ARDY));
+        
+        program_is_pending = false;
+        
+        /* FAIL is the last page and FAILC the one before */
+        if (status & MEM_STATUS_FAIL)
+            program_fails |= 1 << (program_pages - 1);
+        if ((status & MEM_STATUS_FAILC) && program_pages > 1)
+            program_fails |= 1 << (program_pages - 2);
+    }
+}
+
+static void finish_pending_operations (void)
+{
+    abort_pending_read();
+    finish_pending_program();
+}
+
+/*
+ * Data phase of the page transfers.
+ * Each byte takes 3 (write) or 5 (read) accesses to the ports at 20 ns, which
+ * is what bounds the transfer, so the loops move one byte per iteration.
+ * The NAND's IO0-7 are on RE0-7, the PMP's PMD0-7, but its WE# and RE# are on
+ * RC3 and RC4 instead of PMWR and PMRD (RD4 and RD5), so neither the PMP nor a
+ * DMA channel can generate the cycles.
+ */
+#define write_MEM_BYTE(byte) clr_MEM_WE; write_MEM_DATA(byte); set_MEM_WE
+#define read_MEM_BYTE(byte) clr_MEM_RE; clr_MEM_RE; clr_MEM_RE; byte = (unsigned char) (read_MEM_DATA & 0xFF); set_MEM_RE
+
+static void write_data (unsigned char *data, int length)
+{
+    unsigned char *end = data + length;
+    
+    for (; data != end; data++)
+    {
+        write_MEM_BYTE(*data);
+    }
+}
+
+static void write_data_value (unsigned char value, int length)
+{
+    for (; length != 0; length--)
+    {
+        write_MEM_BYTE(value);
+    }
+}
+
+static void read_data (unsigned char *data, int length)
+{
+    unsigned char *end = data + length;
+    
+    for (; data != end; data++)
+    {
+        read_MEM_BYTE(*data);
+    }
+}
+
+/*
+ * Software ECC.
+ * Each 512 bytes sector has a Hamming code that corrects one bit and detects
+ * two. The code has the parity of the bytes whose address bit is 1 and 0, for
+ * the 9 address bits, and the same for the 3 bits' position, so a flipped
+ * data bit shows as complementary halves that give its address.
+ * The codes are saved on the spare area, 4 bytes per sector:
+ *   Bytes 0-15: caller's spare (byte 0 is the bad block mark on a block's
+ *               first pages, the sound pages leave it at 0xFF)
+ *   Bytes 16-31: ECC, 3 bytes of code and ECC_MARK per sector
+ *   Bytes 32-63: not used
+ * Pages without ECC_MARK, erased or programmed by previous versions, are
+ * read without correction.
+ * Takes around 60 us per page @ 200 MHz, either to compute or to check.
+ */
+#define ECC_SECTOR_LENGTH 512
+#define ECC_SECTORS (BYTES_PER_PAGE / ECC_SECTOR_LENGTH)
+#define ECC_SPARE_OFFSET 16
+#define ECC_MARK 0xA5
+
+#define P2(n) n, n^1, n^1, n
+#define P4(n) P2(n), P2(n^1), P2(n^1), P2(n)
+#define P6(n) P4(n), P4(n^1), P4(n^1), P4(n)
+static const unsigned char byte_parity[256] = { P6(0), P6(1), P6(1), P6(0) };
+
+/* Read them with the debugger */
+unsigned int ecc_corrected_bits = 0;
+unsigned int ecc_uncorrectable_sectors = 0;
+
+static unsigned int get_sector_ecc (unsigned char *sector)
+{
+    unsigned int line = 0;
+    unsigned int column;
+    unsigned int parity;
+    unsigned char bytes = 0;
+    int i = 0;
+    
+    for (; i < ECC_SECTOR_LENGTH; i++)
+    {
+        bytes ^= sector[i];
+        
+        if (byte_parity[sector[i]])
+            line ^= i;
+    }
+    
+    column = byte_parity[bytes & 0xAA] | (byte_parity[bytes & 0xCC] << 1) | (byte_parity[bytes & 0xF0] << 2);
+    parity = byte_parity[bytes];
+    
+    /* The halves at 0 are the halves at 1 if the sector's parity is even */
+    return line | ((line ^ (parity ? 0x1FF : 0)) << 9) | (column << 18) | ((column ^ (parity ? 0x7 : 0)) << 21);
+}
+
+static void get_page_ecc (unsigned char *page, unsigned char *ecc)
+{
+    unsigned int code;
+    int i = 0;
+    
+    for (; i < ECC_SECTORS; i++, ecc += 4)
+    {
+        code = get_sector_ecc(page + i * ECC_SECTOR_LENGTH);
+        
+        ecc[0] = code & 0xFF;
+        ecc[1] = (code >> 8) & 0xFF;
+        ecc[2] = (code >> 16) & 0xFF;
+        ecc[3] = ECC_MARK;
+    }
+}
+
+static void correct_page (unsigned char *page, unsigned char *ecc)
+{
+    unsigned int syndrome;
+    unsigned int line;
+    unsigned int column;
+    int i = 0;
+    
+    for (; i < ECC_SECTORS; i++, ecc += 4, page += ECC_SECTOR_LENGTH)
+    {
+        /* Accepts the mark with one bit flipped */
+        syndrome = ecc[3] ^ ECC_MARK;
+        if (syndrome & (syndrome - 1))
+            continue;
+        
+        syndrome = get_sector_ecc(page) ^ (ecc[0] | (ecc[1] << 8) | (ecc[2] << 16));
+        
+        if (syndrome == 0)
+            continue;
+        
+        /* A bit of the code flipped, the data is fine */
+        if ((syndrome & (syndrome - 1)) == 0)
+            continue;
+        
+        line = syndrome & 0x1FF;
+        column = (syndrome >> 18) & 0x7;
+        
+        if (((line ^ (syndrome >> 9)) & 0x1FF) == 0x1FF && ((column ^ (syndrome >> 21)) & 0x7) == 0x7)
+        {
+            page[line] ^= 1 << column;
+            ecc_corrected_bits++;
+        }
+        else
+        {
+            ecc_uncorrectable_sectors++;
+        }
+    }
+}
+
 /*
  * Initializes the uC digital pins.
  */
@@ -105,6 +341,8 @@ int test_read_routines (void)
  */
 int read_memory_size (void)
 {
+    finish_pending_operations();
+    
     int manufacturer_code;
     int device_identifier;
     int byte3;
@@ -194,6 +432,8 @@ int read_memory_size (void)
  */
 unsigned char block_erase (int block_index)
 {
+    finish_pending_operations();
+    
     int block_address = block_index * 64;
     
     unsigned char row_add_1 = block_address & 0xFF;
@@ -284,6 +524,8 @@ unsigned char block_erase (int block_index)
 
 void block_erase_start (int block_index)
 {
+    finish_pending_operations();
+    
     int block_address = block_index * 64;
     
     unsigned char row_add_1 = block_address & 0xFF;
@@ -379,10 +621,16 @@ unsigned char block_erase_finish (void)
 
 /*
  * Writes a Page.
+ * Only the first 16 bytes of the spare are used, the others keep the ECC.
  * 298 us @ 200MHz
  */
 unsigned char program_memory (int page_address, unsigned char *page, unsigned char *spare)
 {
+    unsigned char ecc[ECC_SECTORS * 4];
+    get_page_ecc(page, ecc);
+    
+    finish_pending_operations();
+    
     unsigned char row_add_1 = page_address & 0xFF;
     unsigned char row_add_2 = (page_address >> 8) & 0xFF;
     unsigned char row_add_3 = (page_address >> 16) & 0xFF;
@@ -442,21 +690,12 @@ unsigned char program_memory (int page_address, unsigned char *page, unsigned ch
     clr_MEM_CLE;    // Each instruction is 20 ns
     
     /* Program Page */
-    int i = 0;
-    for (i = 0; i < 2048; i++)
-    {
-        clr_MEM_WE;
-        write_MEM_DATA(page[i]);
-        set_MEM_WE;
-    }    
+    write_data(page, 2048);
     
-    /* Program Header */
-    for (i = 0; i < 64; i++)
-    {
-        clr_MEM_WE;
-        write_MEM_DATA(spare[i]);
-        set_MEM_WE;
-    }
+    /* Program Header and ECC */
+    write_data(spare, ECC_SPARE_OFFSET);
+    write_data(ecc, ECC_SECTORS * 4);
+    write_data_value(0xFF, 64 - ECC_SPARE_OFFSET - ECC_SECTORS * 4);
     
     /* Write command second cycle */
     set_MEM_CLE;    // Enable Command Latch Enable
@@ -511,6 +750,11 @@ unsigned char program_memory (int page_address, unsigned char *page, unsigned ch
  */
 unsigned char program_memory_without_spare (int page_address, unsigned char *page)
 {
+    unsigned char ecc[ECC_SECTORS * 4];
+    get_page_ecc(page, ecc);
+    
+    finish_pending_operations();
+    
     unsigned char row_add_1 = page_address & 0xFF;
     unsigned char row_add_2 = (page_address >> 8) & 0xFF;
     unsigned char row_add_3 = (page_address >> 16) & 0xFF;
@@ -570,21 +814,12 @@ unsigned char program_memory_without_spare (int page_address, unsigned char *pag
     clr_MEM_CLE;    // Each instruction is 20 ns
     
     /* Program Page */
-    int i = 0;
-    for (i = 0; i < 2048; i++)
-    {
-        clr_MEM_WE;
-        write_MEM_DATA(page[i]);
-        set_MEM_WE;
-    }    
+    write_data(page, 2048);
     
-    /* Program empty Header */
-    for (i = 0; i < 64; i++)
-    {
-        clr_MEM_WE;
-        write_MEM_DATA(0);
-        set_MEM_WE;
-    }
+    /* Program ECC, the Header is left empty */
+    write_data_value(0xFF, ECC_SPARE_OFFSET);
+    write_data(ecc, ECC_SECTORS * 4);
+    write_data_value(0xFF, 64 - ECC_SPARE_OFFSET - ECC_SECTORS * 4);
     
     /* Write command second cycle */
     set_MEM_CLE;    // Enable Command Latch Enable
@@ -633,12 +868,159 @@ unsigned char program_memory_without_spare (int page_address, unsigned char *pag
     return byte & 0x03;
 }
 
+/*
+ * Loads a page with the cache program (0x80/0x15) and returns without waiting
+ * for it to be programmed. The memory moves the page to the data register and
+ * programs it while the next one is loaded into the cache register, so the
+ * data phase overlaps tPROG.
+ * The last page of a sequence must have last_page set (0x80/0x10).
+ * The cache register is free when program_memory_check() returns true.
+ */
+void program_memory_cache_start (int page_address, unsigned char *page, bool last_page)
+{
+    /* Computed while the memory programs the previous page */
+    unsigned char ecc[ECC_SECTORS * 4];
+    get_page_ecc(page, ecc);
+    
+    abort_pending_read();
+    
+    /* A closed sequence is programmed before the next one starts */
+    if (program_is_closed)
+        finish_pending_program();
+    
+    /* Wait until the cache register is free (tCBSY) */
+    while(!read_MEM_BUSY);
+    
+    if (program_is_pending)
+    {
+        /* With the cache register free, FAILC is the page before the one
+         * being programmed
+         */
+        if ((read_status() & MEM_STATUS_FAILC) && program_pages > 1)
+            program_fails |= 1 << (program_pages - 2);
+    }
+    else
+    {
+        program_pages = 0;
+        program_fails = 0;
+    }
+    
+    unsigned char row_add_1 = page_address & 0xFF;
+    unsigned char row_add_2 = (page_address >> 8) & 0xFF;
+    unsigned char row_add_3 = (page_address >> 16) & 0xFF;
+    
+    /* Configure data port to output */
+    to_output_MEM_DATA;
+
+    /* Select memory */
+    clr_MEM_CE;
+    
+    /* Write command */
+    set_MEM_CLE;    // Enable Command Latch Enable
+    clr_MEM_WE;
+    write_MEM_DATA(MEM_REG_PAGE_PROGRAM);
+    set_MEM_WE;        
+    clr_MEM_CLE;    // Disable Command Latch Enable
+    
+    /* Write Address Column Address 1 */
+    set_MEM_ALE;    // Enable Address Latch Enable
+    clr_MEM_WE;
+    write_MEM_DATA(0);
+    set_MEM_WE;        
+    clr_MEM_ALE;    // Disable Address Latch Enable
+    
+    /* Write Address Column Address 2 */
+    set_MEM_ALE;    // Enable Address Latch Enable
+    clr_MEM_WE;
+    write_MEM_DATA(0);
+    set_MEM_WE;        
+    clr_MEM_ALE;    // Disable Address Latch Enable
+    
+    /* Write Address Row Address 1 */
+    set_MEM_ALE;    // Enable Address Latch Enable
+    clr_MEM_WE;
+    write_MEM_DATA(row_add_1);
+    set_MEM_WE;        
+    clr_MEM_ALE;    // Disable Address Latch Enable
+    
+    /* Write Address Row Address 2 */
+    set_MEM_ALE;    // Enable Address Latch Enable
+    clr_MEM_WE;
+    write_MEM_DATA(row_add_2);
+    set_MEM_WE;        
+    clr_MEM_ALE;    // Disable Address Latch Enable
+    
+    /* Write Address Row Address 3 */
+    set_MEM_ALE;    // Enable Address Latch Enable
+    clr_MEM_WE;
+    write_MEM_DATA(row_add_3);
+    set_MEM_WE;        
+    clr_MEM_ALE;    // Disable Address Latch Enable
+    
+    /* Wait tADL (min. 70 ns) */
+    clr_MEM_CLE;    // Each instruction is 20 ns
+    clr_MEM_CLE;    // Each instruction is 20 ns
+    clr_MEM_CLE;    // Each instruction is 20 ns
+    clr_MEM_CLE;    // Each instruction is 20 ns
+    
+    /* Program Page */
+    write_data(page, 2048);
+    
+    /* Program ECC, the Header is left empty */
+    write_data_value(0xFF, ECC_SPARE_OFFSET);
+    write_data(ecc, ECC_SECTORS * 4);
+    write_data_value(0xFF, 64 - ECC_SPARE_OFFSET - ECC_SECTORS * 4);
+    
+    /* Write command second cycle */
+    set_MEM_CLE;    // Enable Command Latch Enable
+    clr_MEM_WE;
+    write_MEM_DATA(last_page ? MEM_REG_PAGE_PROGRAM_CONFIRM : MEM_REG_PAGE_PROGRAM_CACHE);
+    set_MEM_WE;        
+    clr_MEM_CLE;
+    
+    /* Wait tWB (max. 100 ns) */
+    clr_MEM_CLE;    // Each instruction is 20 ns
+    clr_MEM_CLE;    // Each instruction is 20 ns
+    clr_MEM_CLE;    // Each instruction is 20 ns
+    clr_MEM_CLE;    // Each instruction is 20 ns
+    clr_MEM_CLE;    // Each instruction is 20 ns
+    
+    /* De-select memory, the program goes on */
+    set_MEM_CE;
+    
+    program_is_pending = true;
+    program_is_closed = last_page;
+    program_pages++;
+}
+
+/*
+ * Returns true when the memory can take the next page.
+ * After the last page, it returns true when the page is programmed.
+ */
+bool program_memory_check (void)
+{
+    return (!program_is_pending || read_MEM_BUSY) ? true : false;
+}
+
+/*
+ * Waits for the pages issued by program_memory_cache_start() to be programmed.
+ * Returns the pages of the sequence that failed, bit n for the nth page.
+ */
+unsigned int program_memory_finish (void)
+{
+    finish_pending_program();
+    
+    return program_fails;
+}
+
 /*
  * Reads a page.
  * 348 us @ 200 MHz
  */
 void read_memory (int page_address, unsigned char *page, unsigned char *spare)
 {
+    finish_pending_operations();
+    
     unsigned char row_add_1 = page_address & 0xFF;
     unsigned char row_add_2 = (page_address >> 8) & 0xFF;
     unsigned char row_add_3 = (page_address >> 16) & 0xFF;
@@ -712,34 +1094,123 @@ void read_memory (int page_address, unsigned char *page, unsigned char *spare)
     to_input_MEM_DATA;
     
     /* Read page */
-    int i;
-    for (i = 0; i < 2048; i++)
-    {
-        /* Read Byte */
-        clr_MEM_RE;
-        clr_MEM_RE;
-        clr_MEM_RE;
-        page[i] = (unsigned char) (read_MEM_DATA & 0xFF);
-        set_MEM_RE;
-    }
+    read_data(page, 2048);
  
     /* Read spare */
-    for (i = 0; i < 64; i++)
-    {
-        /* Read Byte */
-        clr_MEM_RE;
-        clr_MEM_RE;
-        clr_MEM_RE;        
-        spare[i] = (unsigned char) (read_MEM_DATA & 0xFF);
-        set_MEM_RE;
-    }
+    read_data(spare, 64);
+    
+    /* De-select memory */
+    set_MEM_CE;
+    
+    correct_page(page, spare + ECC_SPARE_OFFSET);
+}
+
+/*
+ * Reads the first bytes of a page's spare area.
+ * The length must be a multiple of 4 and up to 64.
+ */
+void read_memory_spare (int page_address, unsigned char *spare, int length)
+{
+    finish_pending_operations();
+    
+    unsigned char row_add_1 = page_address & 0xFF;
+    unsigned char row_add_2 = (page_address >> 8) & 0xFF;
+    unsigned char row_add_3 = (page_address >> 16) & 0xFF;
+    
+    /* Configure data port to output */
+    to_output_MEM_DATA;
+
+    /* Select memory */
+    clr_MEM_CE;
+    
+    /* Write command */
+    set_MEM_CLE;    // Enable Command Latch Enable
+    clr_MEM_WE;
+    write_MEM_DATA(MEM_REG_PAGE_READ);
+    set_MEM_WE;        
+    clr_MEM_CLE;    // Disable Command Latch Enable
+
+    /* Write Address Column Address 1 */
+    set_MEM_ALE;    // Enable Address Latch Enable
+    clr_MEM_WE;
+    write_MEM_DATA(BYTES_PER_PAGE & 0xFF);
+    set_MEM_WE;        
+    clr_MEM_ALE;    // Disable Address Latch Enable
+    
+    /* Write Address Column Address 2 */
+    set_MEM_ALE;    // Enable Address Latch Enable
+    clr_MEM_WE;
+    write_MEM_DATA((BYTES_PER_PAGE >> 8) & 0xFF);
+    set_MEM_WE;        
+    clr_MEM_ALE;    // Disable Address Latch Enable
+    
+    /* Write Address Row Address 1 */
+    set_MEM_ALE;    // Enable Address Latch Enable
+    clr_MEM_WE;
+    write_MEM_DATA(row_add_1);
+    set_MEM_WE;        
+    clr_MEM_ALE;    // Disable Address Latch Enable
+    
+    /* Write Address Row Address 2 */
+    set_MEM_ALE;    // Enable Address Latch Enable
+    clr_MEM_WE;
+    write_MEM_DATA(row_add_2);
+    set_MEM_WE;        
+    clr_MEM_ALE;    // Disable Address Latch Enable
+    
+    /* Write Address Row Address 3 */
+    set_MEM_ALE;    // Enable Address Latch Enable
+    clr_MEM_WE;
+    write_MEM_DATA(row_add_3);
+    set_MEM_WE;        
+    clr_MEM_ALE;    // Disable Address Latch Enable
+    
+    /* Write command second cycle */
+    set_MEM_CLE;    // Enable Command Latch Enable
+    clr_MEM_WE;
+    write_MEM_DATA(0x30);
+    set_MEM_WE;        
+    clr_MEM_CLE;    // Disable Command Latch Enable
+    
+    /* Wait tWB (max. 100 ns) */
+    clr_MEM_CLE;    // Each instruction is 20 ns
+    clr_MEM_CLE;    // Each instruction is 20 ns
+    clr_MEM_CLE;    // Each instruction is 20 ns
+    clr_MEM_CLE;    // Each instruction is 20 ns
+    clr_MEM_CLE;    // Each instruction is 20 ns
+    
+    /* Wait until the BUSY line is set */
+    while(!read_MEM_BUSY);
+    
+    /* Configure data port to input */
+    to_input_MEM_DATA;
+    
+    /* Read spare */
+    read_data(spare, length);
     
     /* De-select memory */
     set_MEM_CE;
 }
 
+/*
+ * Reads a page without the spare area.
+ * Same as read_memory_start(), read_memory_check() and read_memory_finish().
+ */
 void read_memory_without_spare (int page_address, unsigned char *page)
 {
+    read_memory_start(page_address);
+    while(!read_memory_check());
+    read_memory_finish(page);
+}
+
+/*
+ * Issues a page read and returns while the page is loaded (tR, max. 25 us).
+ * The memory is left selected until read_memory_finish() is called.
+ */
+void read_memory_start (int page_address)
+{
+    finish_pending_operations();
+    
     unsigned char row_add_1 = page_address & 0xFF;
     unsigned char row_add_2 = (page_address >> 8) & 0xFF;
     unsigned char row_add_3 = (page_address >> 16) & 0xFF;
@@ -806,34 +1277,44 @@ void read_memory_without_spare (int page_address, unsigned char *page)
     clr_MEM_CLE;    // Each instruction is 20 ns
     clr_MEM_CLE;    // Each instruction is 20 ns
     
+    read_is_pending = true;
+}
+
+/*
+ * Returns true when the page issued by read_memory_start() is loaded.
+ */
+bool read_memory_check (void)
+{
+    return read_MEM_BUSY ? true : false;
+}
+
+/*
+ * Drains the page issued by read_memory_start().
+ * Returns false if the read was aborted by another memory access.
+ */
+bool read_memory_finish (unsigned char *page)
+{
+    unsigned char spare[ECC_SPARE_OFFSET + ECC_SECTORS * 4];
+    
+    if (!read_is_pending)
+        return false;
+    
     /* Wait until the BUSY line is set */
     while(!read_MEM_BUSY);
     
     /* Configure data port to input */
     to_input_MEM_DATA;
     
-    /* Read page */
-    int i;
-    for (i = 0; i < 2048; i++)
-    {
-        /* Read Byte */
-        clr_MEM_RE;
-        clr_MEM_RE;
-        clr_MEM_RE;
-        page[i] = (unsigned char) (read_MEM_DATA & 0xFF);
-        set_MEM_RE;
-    }
- 
-    /* Read spare */
-    for (i = 0; i < 64; i++)
-    {
-        /* Read Byte */
-        clr_MEM_RE;
-        clr_MEM_RE;
-        clr_MEM_RE;
-        set_MEM_RE;
-    }
+    /* Read page and the spare up to the ECC */
+    read_data(page, 2048);
+    read_data(spare, ECC_SPARE_OFFSET + ECC_SECTORS * 4);
     
     /* De-select memory */
     set_MEM_CE;
-}
\ No newline at end of file
+    
+    read_is_pending = false;
+    
+    correct_page(page, spare + ECC_SPARE_OFFSET);
+    
+    return true;
+}
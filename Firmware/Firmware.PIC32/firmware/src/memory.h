@@ -65,6 +65,15 @@
 #define MEM_REG_PAGE_PROGRAM 0x80
 #define MEM_REG_READ_ID 0x90
 
+// Second cycle of the page program
+#define MEM_REG_PAGE_PROGRAM_CONFIRM 0x10
+#define MEM_REG_PAGE_PROGRAM_CACHE 0x15
+
+// Status register
+#define MEM_STATUS_ARDY (1 << 5)    // Array is idle, cache programs included
+#define MEM_STATUS_FAILC (1 << 1)   // Page before the current one failed (cache program)
+#define MEM_STATUS_FAIL (1 << 0)    // Last operation failed
+
 // Prototypes
 void initialize_memory_ios (void);
 int check_memory_connection (void);
@@ -76,7 +85,14 @@ bool block_erase_check (void);
 unsigned char block_erase_finish (void);
 unsigned char program_memory (int page_address, unsigned char *page, unsigned char *spare);
 unsigned char program_memory_without_spare (int page_address, unsigned char *page);
+void program_memory_cache_start (int page_address, unsigned char *page, bool last_page);
+bool program_memory_check (void);
+unsigned int program_memory_finish (void);
 void read_memory (int page_address, unsigned char *page, unsigned char *spare);
 void read_memory_without_spare (int page_address, unsigned char *page);
+void read_memory_spare (int page_address, unsigned char *spare, int length);
+void read_memory_start (int page_address);
+bool read_memory_check (void);
+bool read_memory_finish (unsigned char *page);
 
 #endif	/* MEMORY_H */
\ No newline at end of file
@@ -4,19 +4,39 @@
 #include "parallel_bus.h"
 #include "audio.h"
 #include "sounds_allocation.h"
+#include "delay.h"
 
 bool check_cmd_start(int index);
+bool check_cmd_start_mixed(int index);
+bool check_cmd_start_scheduled(int index);
+void reset_PIC32(void);
 
-extern bool audio_sound_exists[32];
+extern bool audio_sound_exists[SOUNDS_MAX];
 
 unsigned char cmd_stop[CMD_STOP_LEN]                                     = {CMD_STOP, 0};
 unsigned char cmd_delete_sound[CMD_DELETE_SOUND_LEN]                     = {CMD_DELETE_SOUND, 0, 0};
 unsigned char cmd_start[CMD_START_LEN]                                   = {CMD_START, 0, 0, 0, 0, 0, 0};
+unsigned char cmd_start_mixed[CMD_START_MIXED_LEN]                       = {CMD_START_MIXED, 0, 0, 0, 0, 0, 0};
+unsigned char cmd_start_scheduled[CMD_START_SCHEDULED_LEN]               = {CMD_START_SCHEDULED, 0, 0, 0, 0, 0, 0, 0, 0};
+unsigned char cmd_start_tone[CMD_START_TONE_LEN]                         = {CMD_START_TONE, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+unsigned char cmd_start_sweep[CMD_START_SWEEP_LEN]                       = {CMD_START_SWEEP, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+unsigned char cmd_noise_settings[CMD_NOISE_SETTINGS_LEN]                 = {CMD_NOISE_SETTINGS, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+unsigned char cmd_start_stimulus[CMD_START_STIMULUS_LEN]                 = {CMD_START_STIMULUS, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+/* Core timer when the last command was latched.
+ * The ATXMEGA uses the same instant as the reference for the delays.
+ */
+unsigned int command_latched_tick;
 unsigned char cmd_update_amplitude[CMD_UPDATE_AMPLITUDE_LEN]             = {CMD_UPDATE_AMPLITUDE, 0, 0, 0, 0, 0};
 unsigned char cmd_update_frequency[CMD_UPDATE_FREQUENCY_LEN]             = {CMD_UPDATE_FREQUENCY, 0, 0, 0};
 unsigned char cmd_update_amplitude_left[CMD_UPDATE_AMPLITUDE_LEFT_LEN]   = {CMD_UPDATE_AMPLITUDE_LEFT, 0, 0, 0};
 unsigned char cmd_update_amplitude_right[CMD_UPDATE_AMPLITUDE_RIGHT_LEN] = {CMD_UPDATE_AMPLITUDE_RIGHT, 0, 0, 0};
 
+static int par_bus_get_int32(unsigned char *bytes)
+{
+    return (bytes[3] << 24) | (bytes[2] << 16) | (bytes[1] << 8) | bytes[0];
+}
+
 #define PAR_RECEIVE_BYTE(byte)  while (!read_PAR_CMD_WRITE); \
                                 byte = read_PAR_BUS; \
                                 set_PAR_CMD_LATCH; \
@@ -54,6 +74,7 @@ int par_bus_check_if_command_is_available(void)
         
         clr_PAR_CMD_ERROR;
         command_received = read_PAR_BUS;
+        command_latched_tick = _CP0_GET_COUNT();
         set_PAR_CMD_LATCH;
         while (read_PAR_CMD_WRITE);
         clr_PAR_CMD_LATCH;
@@ -83,7 +104,7 @@ int par_bus_check_if_command_is_available(void)
                     int index = cmd_start[2];
                     index = (index << 8) | cmd_start[1];
                     
-                    if (index < 32)
+                    if (index < get_available_sounds())
                         if(audio_sound_exists[index] == false)
                         {
                             /* Return error */
@@ -100,6 +121,212 @@ int par_bus_check_if_command_is_available(void)
                 PAR_RECEIVE_LAST_BYTE_REPLY(true);
                 return 0;
                 
+            case CMD_START_MIXED:
+                PAR_RECEIVE_BYTE(cmd_start_mixed[1]);
+                PAR_RECEIVE_BYTE(cmd_start_mixed[2]);
+                PAR_RECEIVE_BYTE(cmd_start_mixed[3]);
+                PAR_RECEIVE_BYTE(cmd_start_mixed[4]);
+                PAR_RECEIVE_BYTE(cmd_start_mixed[5]);
+                PAR_RECEIVE_BYTE(cmd_start_mixed[6]);
+                PAR_RECEIVE_LAST_BYTE(cmd_start_mixed[7]);
+                
+                for (i = CMD_START_MIXED_LEN - 1; i != 0; i--)
+                {
+                   checksum += cmd_start_mixed[i-1];
+                }
+                
+                if (checksum == cmd_start_mixed[CMD_START_MIXED_LEN - 1])
+                {
+                    int index = cmd_start_mixed[2];
+                    index = (index << 8) | cmd_start_mixed[1];
+                    
+                    /* Only sounds can be mixed */
+                    if (index < SOUNDS_MAX)
+                        if (check_cmd_start_mixed(index))
+                        {
+                            /* Return success */
+                            PAR_RECEIVE_LAST_BYTE_REPLY(false);
+                            return command_received;
+                        }
+                }
+                
+                /* Return error */
+                PAR_RECEIVE_LAST_BYTE_REPLY(true);
+                return 0;
+                
+            case CMD_START_SCHEDULED:
+                PAR_RECEIVE_BYTE(cmd_start_scheduled[1]);
+                PAR_RECEIVE_BYTE(cmd_start_scheduled[2]);
+                PAR_RECEIVE_BYTE(cmd_start_scheduled[3]);
+                PAR_RECEIVE_BYTE(cmd_start_scheduled[4]);
+                PAR_RECEIVE_BYTE(cmd_start_scheduled[5]);
+                PAR_RECEIVE_BYTE(cmd_start_scheduled[6]);
+                PAR_RECEIVE_BYTE(cmd_start_scheduled[7]);
+                PAR_RECEIVE_BYTE(cmd_start_scheduled[8]);
+                PAR_RECEIVE_LAST_BYTE(cmd_start_scheduled[9]);
+                
+                for (i = CMD_START_SCHEDULED_LEN - 1; i != 0; i--)
+                {
+                   checksum += cmd_start_scheduled[i-1];
+                }
+                
+                if (checksum == cmd_start_scheduled[CMD_START_SCHEDULED_LEN - 1])
+                {
+                    int index = cmd_start_scheduled[2];
+                    index = (index << 8) | cmd_start_scheduled[1];
+                    
+                    /* Only sounds can be scheduled */
+                    if (index < SOUNDS_MAX)
+                        if (check_cmd_start_scheduled(index))
+                        {
+                            /* Return success */
+                            PAR_RECEIVE_LAST_BYTE_REPLY(false);
+                            return command_received;
+                        }
+                }
+                
+                /* Return error */
+                PAR_RECEIVE_LAST_BYTE_REPLY(true);
+                return 0;
+                
+            case CMD_START_TONE:
+                for (i = 1; i < CMD_START_TONE_LEN - 1; i++)
+                {
+                    PAR_RECEIVE_BYTE(cmd_start_tone[i]);
+                }
+                PAR_RECEIVE_LAST_BYTE(cmd_start_tone[CMD_START_TONE_LEN - 1]);
+                
+                for (i = CMD_START_TONE_LEN - 1; i != 0; i--)
+                {
+                   checksum += cmd_start_tone[i-1];
+                }
+                
+                if (checksum == cmd_start_tone[CMD_START_TONE_LEN - 1])
+                {
+                    int frequency_left = par_bus_get_int32(&cmd_start_tone[1]);
+                    int frequency_right = par_bus_get_int32(&cmd_start_tone[5]);
+                    int phase_left = (cmd_start_tone[10] << 8) | cmd_start_tone[9];
+                    
+                    /* At least one of the channels must be playing */
+                    if (frequency_left >= 0 && frequency_left <= TONE_FREQUENCY_MAX &&
+                        frequency_right >= 0 && frequency_right <= TONE_FREQUENCY_MAX &&
+                        (frequency_left != 0 || frequency_right != 0) &&
+                        phase_left < TONE_PHASE_MAX)
+                    {
+                        /* Return success */
+                        PAR_RECEIVE_LAST_BYTE_REPLY(false);
+                        return command_received;
+                    }
+                }
+                
+                /* Return error */
+                PAR_RECEIVE_LAST_BYTE_REPLY(true);
+                return 0;
+                
+            case CMD_START_SWEEP:
+                for (i = 1; i < CMD_START_SWEEP_LEN - 1; i++)
+                {
+                    PAR_RECEIVE_BYTE(cmd_start_sweep[i]);
+                }
+                PAR_RECEIVE_LAST_BYTE(cmd_start_sweep[CMD_START_SWEEP_LEN - 1]);
+                
+                for (i = CMD_START_SWEEP_LEN - 1; i != 0; i--)
+                {
+                   checksum += cmd_start_sweep[i-1];
+                }
+                
+                if (checksum == cmd_start_sweep[CMD_START_SWEEP_LEN - 1])
+                {
+                    int frequency_start = par_bus_get_int32(&cmd_start_sweep[1]);
+                    int frequency_end = par_bus_get_int32(&cmd_start_sweep[5]);
+                    int duration = par_bus_get_int32(&cmd_start_sweep[9]);
+                    
+                    if (frequency_start > 0 && frequency_start <= TONE_FREQUENCY_MAX &&
+                        frequency_end > 0 && frequency_end <= TONE_FREQUENCY_MAX &&
+                        duration > 0 && duration <= SWEEP_DURATION_MAX &&
+                        cmd_start_sweep[13] <= SWEEP_MODE_MAX)
+                    {
+                        /* Return success */
+                        PAR_RECEIVE_LAST_BYTE_REPLY(false);
+                        return command_received;
+                    }
+                }
+                
+                /* Return error */
+                PAR_RECEIVE_LAST_BYTE_REPLY(true);
+                return 0;
+                
+            case CMD_START_STIMULUS:
+                for (i = 1; i < CMD_START_STIMULUS_LEN - 1; i++)
+                {
+                    PAR_RECEIVE_BYTE(cmd_start_stimulus[i]);
+                }
+                PAR_RECEIVE_LAST_BYTE(cmd_start_stimulus[CMD_START_STIMULUS_LEN - 1]);
+                
+                for (i = CMD_START_STIMULUS_LEN - 1; i != 0; i--)
+                {
+                   checksum += cmd_start_stimulus[i-1];
+                }
+                
+                if (checksum == cmd_start_stimulus[CMD_START_STIMULUS_LEN - 1])
+                {
+                    int frequency_carrier = par_bus_get_int32(&cmd_start_stimulus[1]);
+                    int frequency_modulation = par_bus_get_int32(&cmd_start_stimulus[5]);
+                    int depth = (cmd_start_stimulus[10] << 8) | cmd_start_stimulus[9];
+                    int duration = par_bus_get_int32(&cmd_start_stimulus[11]);
+                    int ramp = par_bus_get_int32(&cmd_start_stimulus[15]);
+                    int period = par_bus_get_int32(&cmd_start_stimulus[19]);
+                    int count = par_bus_get_int32(&cmd_start_stimulus[23]);
+                    
+                    /* The bursts can't overlap, unless there's only one */
+                    if (frequency_carrier >= 0 && frequency_carrier <= TONE_FREQUENCY_MAX &&
+                        frequency_modulation >= 0 && frequency_modulation <= TONE_FREQUENCY_MAX &&
+                        depth <= STIMULUS_DEPTH_MAX &&
+                        duration > 0 && duration <= STIMULUS_TIME_MAX &&
+                        ramp >= 0 && ramp <= duration / 2 &&
+                        period >= 0 && period <= STIMULUS_TIME_MAX && (period >= duration || count == 1) &&
+                        count >= 0)
+                    {
+                        /* Return success */
+                        PAR_RECEIVE_LAST_BYTE_REPLY(false);
+                        return command_received;
+                    }
+                }
+                
+                /* Return error */
+                PAR_RECEIVE_LAST_BYTE_REPLY(true);
+                return 0;
+                
+            case CMD_NOISE_SETTINGS:
+                for (i = 1; i < CMD_NOISE_SETTINGS_LEN - 1; i++)
+                {
+                    PAR_RECEIVE_BYTE(cmd_noise_settings[i]);
+                }
+                PAR_RECEIVE_LAST_BYTE(cmd_noise_settings[CMD_NOISE_SETTINGS_LEN - 1]);
+                
+                for (i = CMD_NOISE_SETTINGS_LEN - 1; i != 0; i--)
+                {
+                   checksum += cmd_noise_settings[i-1];
+                }
+                
+                if (checksum == cmd_noise_settings[CMD_NOISE_SETTINGS_LEN - 1])
+                {
+                    int frequency_low = (cmd_noise_settings[6] << 8) | cmd_noise_settings[5];
+                    int frequency_high = (cmd_noise_settings[8] << 8) | cmd_noise_settings[7];
+                    
+                    if (frequency_low <= NOISE_FREQUENCY_MAX && frequency_high <= NOISE_FREQUENCY_MAX &&
+                        (frequency_high == 0 || frequency_low < frequency_high))
+                    {
+                        /* Return success */
+                        PAR_RECEIVE_LAST_BYTE_REPLY(false);
+                        return command_received;
+                    }
+                }
+                
+                /* Return error */
+                PAR_RECEIVE_LAST_BYTE_REPLY(true);
+                return 0;
+                
             case CMD_STOP:
                 PAR_RECEIVE_BYTE(cmd_stop[1]);
                 
@@ -118,16 +345,17 @@ int par_bus_check_if_command_is_available(void)
                 
                 if (cmd_delete_sound[2] == (unsigned char)(CMD_DELETE_SOUND + cmd_delete_sound[1]))
                 {
-                    if ((cmd_delete_sound[1] < 32) || (cmd_delete_sound[1] == 0xAA))
+                    if ((cmd_delete_sound[1] < SOUNDS_MAX) || (cmd_delete_sound[1] == 0xAA))
                     {
                         /* Return success */
                         PAR_RECEIVE_LAST_BYTE_REPLY(false);
                     
-                        if (cmd_delete_sound[1] < 32)
+                        if (cmd_delete_sound[1] < SOUNDS_MAX)
                         {
                             if (audio_sound_exists[cmd_delete_sound[1]] == true)
                             {
-                                block_erase(cmd_delete_sound[1] * BLOCKS_PER_SOUND);
+                                remove_sound(cmd_delete_sound[1]);
+                                while (save_sound_table() == false);
                                 
                                 clr_AUDIO_RESET;
                                 reset_PIC32();
@@ -143,13 +371,15 @@ int par_bus_check_if_command_is_available(void)
                             {
                                 if (audio_sound_exists[i] == true)
                                 {
-                                    block_erase(i * BLOCKS_PER_SOUND);
+                                    remove_sound(i);
                                     have_sounds = true;
                                 }
                             }
                             
                             if (have_sounds)
                             {
+                                while (save_sound_table() == false);
+                                
                                 clr_AUDIO_RESET;
                                 reset_PIC32();
                                 while(1);
@@ -184,7 +414,7 @@ int par_bus_check_if_command_is_available(void)
                     att_right = (att_right << 8) | cmd_update_amplitude[3];
 
                     /* Update output amplitude */
-                    update_audio_volume_int(att_left, att_right);
+                    update_audio_attenuation(att_left, att_right, true);
                     
                     return 0;
                 }
@@ -207,7 +437,7 @@ int par_bus_check_if_command_is_available(void)
                     int index = cmd_update_frequency[2];
                     index = (index << 8) | cmd_update_frequency[1];
                     
-                    if (index < 32)
+                    if (index < get_available_sounds())
                         if(audio_sound_exists[index] == false)
                         {
                             /* Return error */
@@ -241,7 +471,7 @@ int par_bus_check_if_command_is_available(void)
                     att_left = cmd_update_amplitude_left[2];
                     att_left = (att_left << 8) | cmd_update_amplitude_left[1];
 
-                    update_audio_volume_left_int(att_left);
+                    update_audio_attenuation(att_left, -1, true);
                     
                     return 0;
                 }
@@ -267,7 +497,7 @@ int par_bus_check_if_command_is_available(void)
                     att_right = cmd_update_amplitude_right[2];
                     att_right = (att_right << 8) | cmd_update_amplitude_right[1];
 
-                    update_audio_volume_right_int(att_right);
+                    update_audio_attenuation(-1, att_right, true);
                     
                     return 0;
                 }
@@ -281,22 +511,83 @@ int par_bus_check_if_command_is_available(void)
     return 0;
 }
 
-int par_bus_process_command_start(void)
+int par_bus_process_command_start(int *att_left, int *att_right)
 {
     int index = cmd_start[2];
-    int att_left = cmd_start[4];
-    int att_right = cmd_start[6];
     index = (index << 8) | cmd_start[1];
-    att_left = (att_left << 8) | cmd_start[3];
-    att_right = (att_right << 8) | cmd_start[5];
+    *att_left = (cmd_start[4] << 8) | cmd_start[3];
+    *att_right = (cmd_start[6] << 8) | cmd_start[5];
+    
+    /* Return sound index */
+    return index;
+}
+
+int par_bus_process_command_start_mixed(int *att_left, int *att_right)
+{
+    int index = cmd_start_mixed[2];
+    index = (index << 8) | cmd_start_mixed[1];
+    *att_left = (cmd_start_mixed[4] << 8) | cmd_start_mixed[3];
+    *att_right = (cmd_start_mixed[6] << 8) | cmd_start_mixed[5];
+    
+    /* Return sound index */
+    return index;
+}
+
+int par_bus_process_command_start_scheduled(unsigned int *start_tick, int *att_left, int *att_right)
+{
+    int index = cmd_start_scheduled[2];
+    int delay_us = cmd_start_scheduled[8];
+    index = (index << 8) | cmd_start_scheduled[1];
+    *att_left = (cmd_start_scheduled[4] << 8) | cmd_start_scheduled[3];
+    *att_right = (cmd_start_scheduled[6] << 8) | cmd_start_scheduled[5];
+    delay_us = (delay_us << 8) | cmd_start_scheduled[7];
     
-    /* Update output amplitude */
-    update_audio_volume_int(att_left, att_right);
+    /* The delay is counted from the moment the command was latched */
+    *start_tick = command_latched_tick + delay_us * TICKS_FOR_1US;
     
     /* Return sound index */
     return index;
 }
 
+void par_bus_process_command_start_tone(int *frequency_left, int *frequency_right, int *phase_left, int *att_left, int *att_right)
+{
+    *frequency_left = par_bus_get_int32(&cmd_start_tone[1]);
+    *frequency_right = par_bus_get_int32(&cmd_start_tone[5]);
+    *phase_left = (cmd_start_tone[10] << 8) | cmd_start_tone[9];
+    *att_left = (cmd_start_tone[12] << 8) | cmd_start_tone[11];
+    *att_right = (cmd_start_tone[14] << 8) | cmd_start_tone[13];
+}
+
+void par_bus_process_command_start_sweep(int *frequency_start, int *frequency_end, int *duration, int *mode, int *att_left, int *att_right)
+{
+    *frequency_start = par_bus_get_int32(&cmd_start_sweep[1]);
+    *frequency_end = par_bus_get_int32(&cmd_start_sweep[5]);
+    *duration = par_bus_get_int32(&cmd_start_sweep[9]);
+    *mode = cmd_start_sweep[13];
+    *att_left = (cmd_start_sweep[15] << 8) | cmd_start_sweep[14];
+    *att_right = (cmd_start_sweep[17] << 8) | cmd_start_sweep[16];
+}
+
+void par_bus_process_command_start_stimulus(int *frequency_carrier, int *frequency_modulation, int *depth, int *duration, int *ramp, int *period, int *count, int *att_left, int *att_right)
+{
+    *frequency_carrier = par_bus_get_int32(&cmd_start_stimulus[1]);
+    *frequency_modulation = par_bus_get_int32(&cmd_start_stimulus[5]);
+    *depth = (cmd_start_stimulus[10] << 8) | cmd_start_stimulus[9];
+    *duration = par_bus_get_int32(&cmd_start_stimulus[11]);
+    *ramp = par_bus_get_int32(&cmd_start_stimulus[15]);
+    *period = par_bus_get_int32(&cmd_start_stimulus[19]);
+    *count = par_bus_get_int32(&cmd_start_stimulus[23]);
+    *att_left = (cmd_start_stimulus[28] << 8) | cmd_start_stimulus[27];
+    *att_right = (cmd_start_stimulus[30] << 8) | cmd_start_stimulus[29];
+}
+
+void par_bus_process_command_noise_settings(int *seed, int *frequency_low, int *frequency_high)
+{
+    *seed = par_bus_get_int32(&cmd_noise_settings[1]);
+    *frequency_low = (cmd_noise_settings[6] << 8) | cmd_noise_settings[5];
+    *frequency_high = (cmd_noise_settings[8] << 8) | cmd_noise_settings[7];
+}
+
 void par_bus_process_command_stop(void)
 {    
     /* Mute the device */
@@ -29,38 +29,83 @@
 /* DONE STOP                 11110000                                             checksum(1)
  * DONE START                11110001  index(1)   A_left(2)  A_right(2)           checksum(1)
  * X    START W/ FREQUENCY   11110010             A_left(2)  A_right(2)  Freq(2)  checksum(1)
- * DONE DELETE_SOUND         11110100  index(1)                                   checksum(1)
+ * DONE DELETE_SOUND         11110111  index(1)                                   checksum(1)
  * TODO UPDATE AMP           11111001             A_left(2)  A_right(2)           checksum(1)
  * X    UPDATE AMP. & FREQ.  11111010             A_left(2)  A_right(2)  Freq(2)  checksum(1)
- * TODO UPDATE FREQUENCY     11110011                                    Freq(2)  checksum(1)
+ * TODO UPDATE FREQUENCY     11111011                                    Freq(2)  checksum(1)
  * TODO UPDATE AMP LEFT      11111100             A_left(2)                       checksum(1)
  * TODO UPDATE AMP RIGHT     11111101                        A_right(2)           checksum(1)
+ * DONE START MIXED          11110101  index(2)   A_left(2)  A_right(2)           checksum(1)
+ * DONE START SCHEDULED      11110110  index(2)   A_left(2)  A_right(2)  Delay(2) checksum(1)
+ * DONE START TONE           11111000  F_left(4)  F_right(4) Phase(2) A_left(2)  A_right(2)  checksum(1)
+ * DONE START SWEEP          11111110  F_start(4) F_end(4)   Duration(4) Mode(1) A_left(2) A_right(2) checksum(1)
+ * DONE NOISE SETTINGS       11110100  Seed(4)    F_low(2)   F_high(2)            checksum(1)
+ * DONE START STIMULUS       11110011  F_carrier(4) F_mod(4) Depth(2) Duration(4) Ramp(4) Period(4) Count(4) A_left(2) A_right(2) checksum(1)
  */
 #define CMD_STOP 0xF0
 #define CMD_START 0xF1
 #define CMD_START_W_FREQUENCY 0xF2
+#define CMD_START_STIMULUS 0xF3
+#define CMD_NOISE_SETTINGS 0xF4
+#define CMD_START_MIXED 0xF5
+#define CMD_START_SCHEDULED 0xF6
 #define CMD_DELETE_SOUND 0xF7
+#define CMD_START_TONE 0xF8
 #define CMD_UPDATE_AMPLITUDE 0xF9
 #define CMD_UPDATE_AMPLITUDE_AND_FREQUENCY 0xFA
 #define CMD_UPDATE_FREQUENCY 0xFB
 #define CMD_UPDATE_AMPLITUDE_LEFT 0xFC
 #define CMD_UPDATE_AMPLITUDE_RIGHT 0xFD
+#define CMD_START_SWEEP 0xFE
 
 #define CMD_STOP_LEN 2
 #define CMD_DELETE_SOUND_LEN 3
 #define CMD_START_LEN 8
+#define CMD_START_MIXED_LEN 8
+#define CMD_START_SCHEDULED_LEN 10
+#define CMD_START_TONE_LEN 16
+#define CMD_START_SWEEP_LEN 19
+#define CMD_NOISE_SETTINGS_LEN 10
+#define CMD_START_STIMULUS_LEN 32
 #define CMD_UPDATE_AMPLITUDE_LEN 6
 #define CMD_UPDATE_FREQUENCY_LEN 4
 #define CMD_UPDATE_AMPLITUDE_LEFT_LEN 4
 #define CMD_UPDATE_AMPLITUDE_RIGHT_LEN 4
 
+/* Tone frequencies are in mHz, up to 40 KHz */
+#define TONE_FREQUENCY_MAX 40000000
+
+/* Phase offsets are in 0.01 degrees */
+#define TONE_PHASE_MAX 36000
+
+/* Sweeps last up to 10 minutes, in ms */
+#define SWEEP_DURATION_MAX 600000
+
+/* Sweep modes: bit 0 is logarithmic, bit 1 holds the end frequency */
+#define SWEEP_MODE_MAX 3
+
+/* Noise band edges are in Hz, up to 40 KHz, 0 to skip the edge */
+#define NOISE_FREQUENCY_MAX 40000
+
+/* Stimulus times are in us, up to 10 minutes, and depths in 0.1% */
+#define STIMULUS_TIME_MAX 600000000
+#define STIMULUS_DEPTH_MAX 1000
+
 /************************************************************************/
 /* Prototypes                                                           */
 /************************************************************************/
+extern unsigned int command_latched_tick;
+
 void initialize_par_ios(void);
 int par_bus_check_if_command_is_available(void);
 
-int par_bus_process_command_start(void);
+int par_bus_process_command_start(int *att_left, int *att_right);
+int par_bus_process_command_start_mixed(int *att_left, int *att_right);
+int par_bus_process_command_start_scheduled(unsigned int *start_tick, int *att_left, int *att_right);
+void par_bus_process_command_start_tone(int *frequency_left, int *frequency_right, int *phase_left, int *att_left, int *att_right);
+void par_bus_process_command_start_sweep(int *frequency_start, int *frequency_end, int *duration, int *mode, int *att_left, int *att_right);
+void par_bus_process_command_start_stimulus(int *frequency_carrier, int *frequency_modulation, int *depth, int *duration, int *ramp, int *period, int *count, int *att_left, int *att_right);
+void par_bus_process_command_noise_settings(int *seed, int *frequency_low, int *frequency_high);
 void par_bus_process_command_stop(void);
 int par_bus_process_command_update_frequency(void);
 
@@ -16,6 +16,820 @@ int get_available_sounds(void)
     return available_sounds;
 }
 
+static int get_available_blocks(void)
+{
+    return get_available_sounds() * BLOCKS_PER_SOUND;
+}
+
+static int get_number_of_blocks(int sound_size)
+{
+    int number_of_pages = sound_size * 4 / BYTES_PER_PAGE;
+    if (((sound_size * 4) % BYTES_PER_PAGE) > 0)
+        number_of_pages++;
+    
+    int number_of_blocks = number_of_pages / PAGES_PER_BLOCK;
+    if ((number_of_pages % PAGES_PER_BLOCK) > 0)
+        number_of_blocks++;
+    
+    return number_of_blocks;
+}
+
+/*
+ * Allocation table.
+ * Each sound is saved on a contiguous extent sized to its length. The table
+ * is kept on RAM and each update is saved on the next page of the table's
+ * blocks, so the blocks are erased only once every PAGES_PER_BLOCK updates.
+ * The page's header is also saved on its spare area, so the current table is
+ * found reading only spare areas and then a single page.
+ * A page is valid if it has the current version and its CRC matches. The
+ * valid page with the highest sequence is the current table.
+ * New extents are searched from the end of the last one, so the erases
+ * rotate over the whole memory instead of reusing the first blocks.
+ *
+ * Bad blocks.
+ * The factory bad blocks are found on the first use and the blocks failing an
+ * erase or a program are added later. The extents never include bad blocks.
+ * A block that fails while its extent is being erased is remapped to a free
+ * block, so the extent stays at the same place.
+ */
+typedef struct
+{
+    int first_block;
+    int number_of_blocks;       // 0 if there's no sound
+    int metadata_page;          // Page with the user metadata
+    Sound_Metadata metadata;
+} Sound_Extent;
+
+#define SOUND_TABLE_MAGIC 0x42545348    // "HSTB"
+#define SOUND_TABLE_VERSION 1
+
+typedef struct
+{
+    unsigned int magic;
+    unsigned int version;
+    unsigned int sequence;
+    unsigned int crc;           // CRC-32 of the page with this field at 0
+} Sound_Table_Header;
+
+typedef struct
+{
+    unsigned short block;
+    unsigned short replacement;
+} Sound_Remap;
+
+/* Up to 80 factory bad blocks on the 4 Gb memory */
+#define SOUND_TABLE_BAD_BLOCKS 80
+#define SOUND_TABLE_REMAPS 16
+
+/* Fills a page, the fields added after the first version were at 0 */
+typedef struct
+{
+    Sound_Table_Header header;
+    int next_block;
+    int number_of_bad_blocks;
+    int number_of_remaps;
+    int bad_blocks_are_scanned;
+    Sound_Extent extents[SOUNDS_MAX];
+    unsigned short bad_blocks[SOUND_TABLE_BAD_BLOCKS];
+    Sound_Remap remaps[SOUND_TABLE_REMAPS];
+} Sound_Table;
+
+static Sound_Table sound_table;
+static int sound_table_page_address;
+
+static bool is_bad_block(int block)
+{
+    int i = 0;
+    
+    for (; i < sound_table.number_of_bad_blocks; i++)
+        if (sound_table.bad_blocks[i] == block)
+            return true;
+    
+    return false;
+}
+
+/* Bad blocks that didn't fit on the table and may be used again, read it with
+ * the debugger
+ */
+unsigned int sound_table_bad_blocks_lost = 0;
+
+/*
+ * Only the table on RAM is updated, save_sound_table() must be called after.
+ * Returns false if the table is full.
+ */
+static bool add_bad_block(int block)
+{
+    if (is_bad_block(block))
+        return true;
+    
+    if (sound_table.number_of_bad_blocks == SOUND_TABLE_BAD_BLOCKS)
+    {
+        sound_table_bad_blocks_lost++;
+        return false;
+    }
+    
+    sound_table.bad_blocks[sound_table.number_of_bad_blocks++] = block;
+    return true;
+}
+
+static bool is_replacement_block(int block)
+{
+    int i = 0;
+    
+    for (; i < sound_table.number_of_remaps; i++)
+        if (sound_table.remaps[i].replacement == block)
+            return true;
+    
+    return false;
+}
+
+/* Returns the block written in place of block */
+static int get_block(int block)
+{
+    int i = 0;
+    
+    for (; i < sound_table.number_of_remaps; i++)
+        if (sound_table.remaps[i].block == block)
+            return sound_table.remaps[i].replacement;
+    
+    return block;
+}
+
+static int get_extent_page(int first_block, int page_index)
+{
+    return get_block(first_block + page_index / PAGES_PER_BLOCK) * PAGES_PER_BLOCK + page_index % PAGES_PER_BLOCK;
+}
+
+static int get_page_address(int sound_index, int page_index)
+{
+    return get_extent_page(sound_table.extents[sound_index].first_block, page_index);
+}
+
+static unsigned int get_crc32(unsigned char *data, int length)
+{
+    unsigned int crc = 0xFFFFFFFF;
+    int i;
+    
+    for (; length != 0; length--)
+    {
+        crc ^= *data++;
+        
+        for (i = 8; i != 0; i--)
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+    }
+    
+    return ~crc;
+}
+
+static unsigned int get_sound_table_crc(void)
+{
+    unsigned int crc = sound_table.header.crc;
+    unsigned int new_crc;
+    
+    sound_table.header.crc = 0;
+    new_crc = get_crc32((unsigned char*)(&sound_table), sizeof(Sound_Table));
+    sound_table.header.crc = crc;
+    
+    return new_crc;
+}
+
+static bool read_sound_table_header(int page_address, Sound_Table_Header *header)
+{
+    read_memory_spare(page_address, (unsigned char*)(header), sizeof(Sound_Table_Header));
+    
+    return (header->magic == SOUND_TABLE_MAGIC && header->version == SOUND_TABLE_VERSION) ? true : false;
+}
+
+static bool read_sound_table_page(int page_address)
+{
+    read_memory_without_spare(page_address, (unsigned char*)(&sound_table));
+    
+    if (sound_table.header.magic != SOUND_TABLE_MAGIC) return false;
+    if (sound_table.header.version != SOUND_TABLE_VERSION) return false;
+    if (sound_table.header.crc != get_sound_table_crc()) return false;
+    
+    return true;
+}
+
+/*
+ * Builds the table from the fixed slots used before, where each sound has its
+ * metadata on the spare area of its first page.
+ */
+static void build_sound_table_from_slots(void)
+{
+    Sound_Metadata metadata;
+    Sound_Extent *extent;
+    int i = 0;
+    
+    sound_table.header.magic = SOUND_TABLE_MAGIC;
+    sound_table.header.version = SOUND_TABLE_VERSION;
+    sound_table.header.sequence = 0;
+    sound_table.next_block = SOUNDS_FIRST_BLOCK;
+    sound_table.number_of_bad_blocks = 0;
+    sound_table.number_of_remaps = 0;
+    sound_table.bad_blocks_are_scanned = 0;
+    
+    for (; i < SOUNDS_MAX; i++)
+    {
+        extent = &sound_table.extents[i];
+        extent->number_of_blocks = 0;
+        extent->metadata_page = i * PAGES_PER_BLOCK;
+        
+        if (i < 2 || i >= get_available_sounds())
+            continue;
+        
+        read_memory_spare(i * BLOCKS_PER_SOUND * PAGES_PER_BLOCK, (unsigned char*)(&metadata), sizeof(Sound_Metadata));
+        
+        if (metadata.sample_rate != 96000 && metadata.sample_rate != 192000) continue;
+        if (metadata.data_type != 0 && metadata.data_type != 1) continue;
+        if (metadata.sound_index != i) continue;
+        if (metadata.sound_length <= 0) continue;
+        
+        extent->first_block = i * BLOCKS_PER_SOUND;
+        extent->number_of_blocks = get_number_of_blocks(metadata.sound_length);
+        extent->metadata = metadata;
+    }
+    
+    /* The next save uses the first page */
+    sound_table_page_address = (SOUND_TABLE_FIRST_BLOCK + SOUND_TABLE_BLOCKS) * PAGES_PER_BLOCK - 1;
+}
+
+static bool is_extent_block(int block)
+{
+    Sound_Extent *extent;
+    int i = 0;
+    
+    for (; i < SOUNDS_MAX; i++)
+    {
+        extent = &sound_table.extents[i];
+        
+        if (extent->number_of_blocks != 0)
+            if (block >= extent->first_block && block < extent->first_block + extent->number_of_blocks)
+                return true;
+    }
+    
+    return false;
+}
+
+/*
+ * Finds the factory bad blocks, marked with a byte other than 0xFF at the
+ * beginning of the spare area of the block's first or second page.
+ * The previous versions programmed the spare areas of the pages they wrote
+ * with 0x00, on the slots of the sounds kept, of the uploads aborted or
+ * replaced by shorter sounds and of the indexes 0 and 1. A block with an all
+ * 0x00 spare area was written by them and is erased, only if the erase fails
+ * it's bad. Any other mark is trusted.
+ * Runs once, around 300 ms on the 4 Gb memory plus the erases.
+ */
+static void scan_bad_blocks(void)
+{
+    Sound_Table_Header header;
+    unsigned char spare[64];
+    bool is_marked;
+    bool is_written;
+    int block = SOUND_TABLE_FIRST_BLOCK;
+    int i;
+    
+    for (; block < get_available_blocks(); block++)
+    {
+        if (is_extent_block(block))
+            continue;
+        
+        /* A table's block with a valid page */
+        if (block < SOUNDS_FIRST_BLOCK)
+            if (read_sound_table_header(block * PAGES_PER_BLOCK, &header))
+                continue;
+        
+        read_memory_spare(block * PAGES_PER_BLOCK, spare, 64);
+        
+        if (spare[0] == 0xFF)
+            read_memory_spare(block * PAGES_PER_BLOCK + 1, spare, 64);
+        
+        is_marked = (spare[0] != 0xFF) ? true : false;
+        is_written = (block < SOUNDS_FIRST_BLOCK) ? true : false;
+        
+        for (i = 0; i < 64; i++)
+            if (spare[i] != 0)
+                break;
+        
+        if (i == 64)
+            is_written = true;
+        
+        if (is_marked)
+            if (is_written == false || block_erase(block) != 0)
+                add_bad_block(block);
+    }
+    
+    sound_table.bad_blocks_are_scanned = 1;
+}
+
+/*
+ * Finds the current table reading the spare area of each table block's first
+ * page plus a binary search over the newest block. Only the table's page is
+ * read completely, unless it's corrupted and the previous one is used.
+ */
+void load_sound_table(void)
+{
+    Sound_Table_Header header;
+    int newest_block = -1;
+    unsigned int newest_sequence = 0;
+    int first_page;
+    int last_page;
+    int page;
+    int i = 0;
+    
+    for (; i < SOUND_TABLE_BLOCKS; i++)
+    {
+        if (read_sound_table_header((SOUND_TABLE_FIRST_BLOCK + i) * PAGES_PER_BLOCK, &header))
+        {
+            if (newest_block == -1 || header.sequence > newest_sequence)
+            {
+                newest_block = i;
+                newest_sequence = header.sequence;
+            }
+        }
+    }
+    
+    if (newest_block != -1)
+    {
+        /* The pages are saved in order, so the used ones come first */
+        first_page = (SOUND_TABLE_FIRST_BLOCK + newest_block) * PAGES_PER_BLOCK;
+        last_page = first_page + PAGES_PER_BLOCK;
+        
+        while (last_page - first_page > 1)
+        {
+            page = (first_page + last_page) / 2;
+            
+            if (read_sound_table_header(page, &header))
+                first_page = page;
+            else
+                last_page = page;
+        }
+        
+        /* A save interrupted by a reset leaves the previous pages valid */
+        page = first_page;
+        
+        for (i = 0; i < SOUND_TABLE_BLOCKS * PAGES_PER_BLOCK; i++)
+        {
+            if (read_sound_table_page(page))
+            {
+                sound_table_page_address = first_page;
+                break;
+            }
+            
+            if (page == SOUND_TABLE_FIRST_BLOCK * PAGES_PER_BLOCK)
+                page = (SOUND_TABLE_FIRST_BLOCK + SOUND_TABLE_BLOCKS) * PAGES_PER_BLOCK;
+            page--;
+        }
+    }
+    
+    if (newest_block == -1 || i == SOUND_TABLE_BLOCKS * PAGES_PER_BLOCK)
+        build_sound_table_from_slots();
+    
+    if (sound_table.bad_blocks_are_scanned == 0)
+    {
+        scan_bad_blocks();
+        while (save_sound_table() == false);
+    }
+}
+
+#define SAVE_TABLE_STATE_STANDBY 0
+#define SAVE_TABLE_STATE_CHECK_ERASE 1
+static int save_sound_table_state = SAVE_TABLE_STATE_STANDBY;
+
+static int get_next_table_page(int page_address)
+{
+    int first_page = SOUND_TABLE_FIRST_BLOCK * PAGES_PER_BLOCK;
+    return first_page + (page_address - first_page + 1) % (SOUND_TABLE_BLOCKS * PAGES_PER_BLOCK);
+}
+
+/*
+ * Saves the table on the next page, erasing its block first if it's the
+ * block's first page. The bad blocks are skipped.
+ */
+bool save_sound_table(void)
+{
+    int page_address = get_next_table_page(sound_table_page_address);
+    unsigned char spare[64];
+    int i;
+    
+    for (i = 0; i < SOUND_TABLE_BLOCKS; i++)
+    {
+        if (page_address % PAGES_PER_BLOCK != 0 || is_bad_block(page_address / PAGES_PER_BLOCK) == false)
+            break;
+        
+        page_address = get_next_table_page(page_address + PAGES_PER_BLOCK - 1);
+    }
+    
+    switch (save_sound_table_state)
+    {
+        case SAVE_TABLE_STATE_STANDBY:
+            if (page_address % PAGES_PER_BLOCK == 0)
+            {
+                block_erase_start(page_address / PAGES_PER_BLOCK);
+                save_sound_table_state = SAVE_TABLE_STATE_CHECK_ERASE;
+                return false;
+            }
+            break;
+        
+        case SAVE_TABLE_STATE_CHECK_ERASE:
+            if (block_erase_check() == false)
+                return false;
+            
+            save_sound_table_state = SAVE_TABLE_STATE_STANDBY;
+            
+            if (block_erase_finish() != 0)
+            {
+                /* The next call uses the next block */
+                add_bad_block(page_address / PAGES_PER_BLOCK);
+                sound_table_page_address = page_address + PAGES_PER_BLOCK - 1;
+                return false;
+            }
+            break;
+    }
+    
+    sound_table.header.sequence++;
+    sound_table.header.crc = get_sound_table_crc();
+    
+    for (i = 0; i < 64; i++)
+        spare[i] = 0xFF;
+    
+    *((Sound_Table_Header*)(spare)) = sound_table.header;
+    
+    if (program_memory(page_address, (unsigned char*)(&sound_table), spare) != 0)
+    {
+        /* The next call uses the next block */
+        add_bad_block(page_address / PAGES_PER_BLOCK);
+        sound_table_page_address = page_address - page_address % PAGES_PER_BLOCK + PAGES_PER_BLOCK - 1;
+        return false;
+    }
+    
+    sound_table_page_address = page_address;
+    
+    return true;
+}
+
+/*
+ * Compressed sounds (data_type 2).
+ * The sound is saved as a stream of pages:
+ *   Index: a Compressed_Sound_Header followed by one word per frame with the
+ *          frame's page, relative to the sound's first page, on the bits 11
+ *          and above and its byte offset on the bits 0 to 10
+ *   Frames: a frame decodes to a page of COMPRESSED_FRAME_LEN stereo samples
+ *           and never crosses a page, so any page of the sound is decoded
+ *           from the index and a single page
+ * Each frame starts on a word with the mode and Rice parameter of the left
+ * and right channels (1 byte each), followed by the bits of the left and the
+ * right channel, MSB first. A channel with mode 0 to 3 has mode warm-up
+ * samples of 24 bits and the residuals of the fixed predictor of that order,
+ * Rice coded. Mode COMPRESSED_MODE_VERBATIM has all the samples on 24 bits.
+ * The samples are the 24 bits played by the DAC, on the top of the words.
+ *
+ * Each decoder keeps the last index page and the last frames' page read for
+ * a sound, so a sequential read only reads a page when its frames end.
+ * A frame out of the sound's pages or with a bad mode or parameter plays as
+ * silence, and so do the samples of a frame that runs past its page.
+ */
+#define COMPRESSED_FRAME_LEN 256
+#define COMPRESSED_MODE_VERBATIM 4
+#define COMPRESSED_PARAMETER_MAX 24
+#define SOUND_DECODERS 4
+
+typedef struct
+{
+    int sound_index;            // -1 if not used
+    unsigned int last_use;
+    int index_page;
+    int data_page;
+    unsigned int index[BYTES_PER_PAGE/4];
+    unsigned int data[BYTES_PER_PAGE/4 + 3];    // The bit reader reads up to 3 words past the page
+} Sound_Decoder;
+
+static Sound_Decoder sound_decoders[SOUND_DECODERS] = {
+    {-1, 0, -1, -1}, {-1, 0, -1, -1}, {-1, 0, -1, -1}, {-1, 0, -1, -1}
+};
+static unsigned int sound_decoders_use = 0;
+
+/* Core timer ticks of the slowest page decoded, read it with the debugger */
+unsigned int perf_sound_decode_max = 0;
+
+static bool is_compressed_sound(int sound_index)
+{
+    return (sound_table.extents[sound_index].metadata.data_type == 2) ? true : false;
+}
+
+/* Drops the pages kept for a sound that was replaced or removed */
+static void reset_sound_decoders(int sound_index)
+{
+    int i = 0;
+    
+    for (; i < SOUND_DECODERS; i++)
+        if (sound_decoders[i].sound_index == sound_index)
+            sound_decoders[i].sound_index = -1;
+}
+
+/* Returns the sound's decoder, replacing the least recently used one if needed */
+static Sound_Decoder * get_sound_decoder(int sound_index)
+{
+    Sound_Decoder *decoder = &sound_decoders[0];
+    int i = 0;
+    
+    for (; i < SOUND_DECODERS; i++)
+    {
+        if (sound_decoders[i].sound_index == sound_index)
+        {
+            sound_decoders[i].last_use = ++sound_decoders_use;
+            return &sound_decoders[i];
+        }
+        
+        if (sound_decoders[i].last_use < decoder->last_use)
+            decoder = &sound_decoders[i];
+    }
+    
+    decoder->sound_index = sound_index;
+    decoder->last_use = ++sound_decoders_use;
+    decoder->index_page = -1;
+    decoder->data_page = -1;
+    
+    return decoder;
+}
+
+/* Returns the word of the index, reading its page if needed */
+static unsigned int read_sound_index(Sound_Decoder *decoder, int word)
+{
+    int page = word / (BYTES_PER_PAGE/4);
+    
+    if (decoder->index_page != page)
+    {
+        read_memory_without_spare(get_page_address(decoder->sound_index, page), (unsigned char*)(decoder->index));
+        decoder->index_page = page;
+    }
+    
+    return decoder->index[word % (BYTES_PER_PAGE/4)];
+}
+
+static int get_compressed_sound_length(int sound_index)
+{
+    Compressed_Sound_Header *header;
+    Sound_Decoder *decoder = get_sound_decoder(sound_index);
+    
+    read_sound_index(decoder, 0);
+    header = (Compressed_Sound_Header*)(decoder->index);
+    
+    return (header->magic == COMPRESSED_SOUND_MAGIC) ? header->sound_length & 0xFFFFFFFC : 0;
+}
+
+typedef struct
+{
+    unsigned char *data;
+    unsigned char *end;         // A word past the page, data never goes beyond it on a valid frame
+    unsigned int bits;          // Next bits, MSB first
+    int number_of_bits;
+} Bit_Reader;
+
+/* Leaves at least 25 bits on the reader */
+static inline void fill_bits(Bit_Reader *reader)
+{
+    while (reader->number_of_bits <= 24)
+    {
+        reader->bits |= (unsigned int)(*reader->data++) << (24 - reader->number_of_bits);
+        reader->number_of_bits += 8;
+    }
+}
+
+/* Up to 24 bits */
+static inline unsigned int read_bits(Bit_Reader *reader, int length)
+{
+    unsigned int value;
+    
+    if (length == 0)
+        return 0;
+    
+    fill_bits(reader);
+    
+    value = reader->bits >> (32 - length);
+    reader->bits <<= length;
+    reader->number_of_bits -= length;
+    
+    return value;
+}
+
+static inline int read_sample(Bit_Reader *reader)
+{
+    return ((int)(read_bits(reader, 24) << 8)) >> 8;
+}
+
+static inline int read_rice(Bit_Reader *reader, int parameter)
+{
+    unsigned int value = 0;
+    int zeros;
+    
+    fill_bits(reader);
+    
+    /* The unary part, a corrupted one may never end */
+    while (reader->bits == 0)
+    {
+        if (reader->data > reader->end)
+            return 0;
+        
+        value += reader->number_of_bits;
+        reader->number_of_bits = 0;
+        fill_bits(reader);
+    }
+    
+    /* Shifted twice, since the stop bit can be the last one of the 32 */
+    zeros = __builtin_clz(reader->bits);
+    value += zeros;
+    reader->bits <<= zeros;
+    reader->bits <<= 1;
+    reader->number_of_bits -= zeros + 1;
+    
+    value = (value << parameter) | read_bits(reader, parameter);
+    
+    /* Zigzag to signed */
+    return (int)(value >> 1) ^ -(int)(value & 1);
+}
+
+static const int fixed_predictors[4][3] = {
+    {0, 0, 0},
+    {1, 0, 0},
+    {2, -1, 0},
+    {3, -3, 1}
+};
+
+static void decode_channel(Bit_Reader *reader, int mode, int parameter, int *samples)
+{
+    const int *predictor = fixed_predictors[mode & 3];
+    int s1 = 0, s2 = 0, s3 = 0;
+    int sample;
+    int i = 0;
+    
+    if (mode == COMPRESSED_MODE_VERBATIM)
+    {
+        for (; i < COMPRESSED_FRAME_LEN && reader->data <= reader->end; i++)
+            samples[i*2] = read_sample(reader) * 256;
+    }
+    
+    for (; i < COMPRESSED_FRAME_LEN && reader->data <= reader->end; i++)
+    {
+        if (i < mode)
+            sample = read_sample(reader);
+        else
+            sample = predictor[0] * s1 + predictor[1] * s2 + predictor[2] * s3 + read_rice(reader, parameter);
+        
+        s3 = s2;
+        s2 = s1;
+        s1 = sample;
+        
+        samples[i*2] = sample * 256;
+    }
+    
+    /* The frame ran past its page */
+    for (; i < COMPRESSED_FRAME_LEN; i++)
+        samples[i*2] = 0;
+}
+
+/*
+ * Decodes a page of a compressed sound.
+ * Around 40 instructions per sample, so around 150 us @ 200 MHz plus the pages
+ * read, at most two. It must stay below a page at 192 KHz, 1333 us, check it
+ * with perf_sound_decode_max.
+ */
+static void read_compressed_sound_page(int sound_index, int page_index, int *page)
+{
+    Sound_Decoder *decoder = get_sound_decoder(sound_index);
+    unsigned int start = _CP0_GET_COUNT();
+    unsigned int entry = read_sound_index(decoder, sizeof(Compressed_Sound_Header)/4 + page_index);
+    int number_of_pages = (sound_table.extents[sound_index].metadata.sound_length * 4 + BYTES_PER_PAGE - 1) / BYTES_PER_PAGE;
+    unsigned char *frame;
+    Bit_Reader reader;
+    int i = 0;
+    
+    if ((int)(entry >> 11) >= number_of_pages || (entry & 0x7FF) > BYTES_PER_PAGE - 4)
+    {
+        for (; i < BYTES_PER_PAGE/4; i++)
+            page[i] = 0;
+        
+        return;
+    }
+    
+    if (decoder->data_page != (int)(entry >> 11))
+    {
+        read_memory_without_spare(get_page_address(sound_index, entry >> 11), (unsigned char*)(decoder->data));
+        decoder->data_page = entry >> 11;
+    }
+    
+    frame = (unsigned char*)(decoder->data) + (entry & 0x7FF);
+    
+    if (frame[0] > COMPRESSED_MODE_VERBATIM || frame[1] > COMPRESSED_PARAMETER_MAX ||
+        frame[2] > COMPRESSED_MODE_VERBATIM || frame[3] > COMPRESSED_PARAMETER_MAX)
+    {
+        for (; i < BYTES_PER_PAGE/4; i++)
+            page[i] = 0;
+        
+        return;
+    }
+    
+    reader.data = frame + 4;
+    reader.end = (unsigned char*)(decoder->data) + BYTES_PER_PAGE + 4;
+    reader.bits = 0;
+    reader.number_of_bits = 0;
+    
+    decode_channel(&reader, frame[0], frame[1], page);
+    decode_channel(&reader, frame[2], frame[3], page + 1);
+    
+    if (_CP0_GET_COUNT() - start > perf_sound_decode_max)
+        perf_sound_decode_max = _CP0_GET_COUNT() - start;
+}
+
+/* The sound_length of the compressed sounds is the length after decoded */
+int read_sound_metadata(int sound_index, Sound_Metadata * metadata)
+{
+    if (sound_index >= get_available_sounds()) return -1;
+    if (sound_table.extents[sound_index].number_of_blocks == 0) return -1;
+    
+    *metadata = sound_table.extents[sound_index].metadata;
+    
+    if (is_compressed_sound(sound_index))
+        metadata->sound_length = get_compressed_sound_length(sound_index);
+    
+    return 0;
+}
+
+/* Drops the remaps of the blocks that aren't used by any extent */
+static void release_remaps(void)
+{
+    int i = 0;
+    
+    while (i < sound_table.number_of_remaps)
+    {
+        if (is_extent_block(sound_table.remaps[i].block))
+            i++;
+        else
+            sound_table.remaps[i] = sound_table.remaps[--sound_table.number_of_remaps];
+    }
+}
+
+/* Only the table on RAM is updated, save_sound_table() must be called after */
+void remove_sound(int sound_index)
+{
+    sound_table.extents[sound_index].number_of_blocks = 0;
+    reset_sound_decoders(sound_index);
+    release_remaps();
+}
+
+/*
+ * Returns the first block of a free extent between first_block and last_block,
+ * or -1 if there's none.
+ * The extent of sound_index is considered free since it will be replaced.
+ * The bad blocks and the replacements of remapped blocks are never free.
+ */
+static int find_free_extent(int sound_index, int first_block, int last_block, int number_of_blocks)
+{
+    Sound_Extent *extent;
+    bool is_free;
+    int i;
+    
+    while (first_block + number_of_blocks <= last_block)
+    {
+        is_free = true;
+        
+        for (i = 0; i < SOUNDS_MAX; i++)
+        {
+            extent = &sound_table.extents[i];
+            
+            if (i == sound_index || extent->number_of_blocks == 0)
+                continue;
+            
+            if (extent->first_block < first_block + number_of_blocks && first_block < extent->first_block + extent->number_of_blocks)
+            {
+                /* Try again after the overlapped extent */
+                first_block = extent->first_block + extent->number_of_blocks;
+                is_free = false;
+                break;
+            }
+        }
+        
+        if (is_free == false)
+            continue;
+        
+        for (i = first_block; i < first_block + number_of_blocks; i++)
+        {
+            if (is_bad_block(i) || is_replacement_block(i))
+            {
+                first_block = i + 1;
+                is_free = false;
+                break;
+            }
+        }
+        
+        if (is_free)
+            return first_block;
+    }
+    
+    return -1;
+}
+
 #define SAVE_METADATA_STATE_STANDBY 0
 #define SAVE_METADATA_STATE_CHECK_ERASE 1
 #define SAVE_METADATA_STATE_ERASE_IS_DONE 2
@@ -62,10 +876,10 @@ int save_user_metadata(int sound_index, unsigned char * user_metadata)
 
 int read_user_metadata(int sound_index, unsigned char * user_metadata)
 {
-    if (sound_index > get_available_sounds())
+    if (sound_index >= get_available_sounds())
         return -1;
     
-    read_memory_without_spare(sound_index * PAGES_PER_BLOCK, user_metadata);
+    read_memory_without_spare(sound_table.extents[sound_index].metadata_page, user_metadata);
     
     return 0;
 }
@@ -80,42 +894,98 @@ static int prepare_memory_state = PREPARE_MEMORY_STATE_STANDBY;
 
 static int number_of_blocks_index;
 static int number_of_blocks_to_erase;
+static int first_block_to_erase;
 static int sound_index_to_erase;
 
-bool prepare_memory_check(int sound_index, int sound_size)
+/* Returns a free block outside the extent being erased, or -1 if there's none */
+static int find_replacement_block(void)
 {
-    int number_of_pages = sound_size * 4 / BYTES_PER_PAGE;
-    if (((sound_size * 4) % BYTES_PER_PAGE) > 0)
-        number_of_pages++;
+    int block = SOUNDS_FIRST_BLOCK;
     
-    number_of_blocks_to_erase = number_of_pages / PAGES_PER_BLOCK;
-    if ((number_of_pages % PAGES_PER_BLOCK) > 0)
-        number_of_blocks_to_erase++;
+    while ((block = find_free_extent(sound_index_to_erase, block, get_available_blocks(), 1)) != -1)
+    {
+        if (block < first_block_to_erase || block >= first_block_to_erase + number_of_blocks_to_erase)
+            return block;
+        
+        block = first_block_to_erase + number_of_blocks_to_erase;
+    }
     
-    sound_index_to_erase = sound_index;
-    number_of_blocks_index = 0;
-    prepare_memory_state = PREPARE_MEMORY_STATE_STANDBY;
+    return -1;
+}
+
+/*
+ * Remaps a block of the extent being erased that failed the erase.
+ * Returns false if there's no room, the block is used anyway.
+ */
+static bool remap_block(int block)
+{
+    int replacement;
+    int i = 0;
     
-    if (sound_index * PAGES_PER_SOUND + number_of_pages > get_available_sounds() * PAGES_PER_SOUND)
+    add_bad_block(get_block(block));
+    
+    replacement = find_replacement_block();
+    if (replacement == -1)
+        return false;
+    
+    for (; i < sound_table.number_of_remaps; i++)
+    {
+        if (sound_table.remaps[i].block == block)
+        {
+            sound_table.remaps[i].replacement = replacement;
+            return true;
+        }
+    }
+    
+    if (sound_table.number_of_remaps == SOUND_TABLE_REMAPS)
         return false;
     
+    sound_table.remaps[sound_table.number_of_remaps].block = block;
+    sound_table.remaps[sound_table.number_of_remaps].replacement = replacement;
+    sound_table.number_of_remaps++;
+    
     return true;
 }
 
+/*
+ * Finds the extent for the new sound.
+ * The table is only updated by allocate_metadata_command(), once the
+ * sound's first pages are programmed.
+ */
+bool prepare_memory_check(int sound_index, int sound_size)
+{
+    number_of_blocks_to_erase = get_number_of_blocks(sound_size);
+    number_of_blocks_index = 0;
+    prepare_memory_state = PREPARE_MEMORY_STATE_STANDBY;
+    sound_index_to_erase = sound_index;
+    
+    first_block_to_erase = find_free_extent(sound_index, sound_table.next_block, get_available_blocks(), number_of_blocks_to_erase);
+    
+    if (first_block_to_erase == -1)
+        first_block_to_erase = find_free_extent(sound_index, SOUNDS_FIRST_BLOCK, get_available_blocks(), number_of_blocks_to_erase);
+    
+    return (first_block_to_erase == -1) ? false : true;
+}
+
 bool prepare_memory_erase(void)
 {
     switch (prepare_memory_state)
     {   
         case PREPARE_MEMORY_STATE_STANDBY:
-            block_erase_start(sound_index_to_erase * BLOCKS_PER_SOUND + number_of_blocks_index);
+            block_erase_start(get_block(first_block_to_erase + number_of_blocks_index));
             prepare_memory_state = PREPARE_MEMORY_STATE_CHECK_ERASE;
             break;
         
         case PREPARE_MEMORY_STATE_CHECK_ERASE:
             if (block_erase_check())
             {
-                block_erase_finish();
                 prepare_memory_state = PREPARE_MEMORY_STATE_STANDBY;
+                
+                /* Erases the replacement on the next call */
+                if (block_erase_finish() != 0)
+                    if (remap_block(first_block_to_erase + number_of_blocks_index))
+                        break;
+                
                 tgl_LED_USB;
                 number_of_blocks_index++;
                 
@@ -130,22 +1000,10 @@ bool prepare_memory_erase(void)
 
 int prepare_memory(int sound_index, int sound_size)
 {
-    int number_of_pages = sound_size * 4 / BYTES_PER_PAGE;
-    if (((sound_size * 4) % BYTES_PER_PAGE) > 0)
-        number_of_pages++;
-    
-    if (sound_index * PAGES_PER_SOUND + number_of_pages > get_available_sounds() * PAGES_PER_SOUND)
+    if (prepare_memory_check(sound_index, sound_size) == false)
         return -1;
     
-    int number_of_blocks = number_of_pages / PAGES_PER_BLOCK;
-    if ((number_of_pages % PAGES_PER_BLOCK) > 0)
-        number_of_blocks++;
-    
-    int i = 0;
-    for (; i < number_of_blocks; i++)
-    {
-        block_erase(sound_index * BLOCKS_PER_SOUND + i);
-    }
+    while (prepare_memory_erase() == false);
     
     return 0;
 }
@@ -153,42 +1011,124 @@ int prepare_memory(int sound_index, int sound_size)
 int _sound_index;
 int _page_index;
 
-int read_first_sound_page(int sound_index, int *page, Sound_Metadata * metadata)
+#define PREFETCH_STATE_STANDBY 0
+#define PREFETCH_STATE_LOADING 1
+static int prefetch_state = PREFETCH_STATE_STANDBY;
+static int prefetch_page_index;
+
+/* A page issued by read_sound_page_start() is on the memory */
+static bool page_read_is_pending = false;
+
+void set_page_and_sound_index(int page_index, int sound_index)
 {
-    if (sound_index >= get_available_sounds()) return -1;
+    _page_index = page_index;
+    _sound_index = sound_index;
+    prefetch_state = PREFETCH_STATE_STANDBY;
+}
+
+/*
+ * Issues the read of the next page and returns.
+ * The page is loaded (tR) while the previous pages are being played and is
+ * drained by read_next_sound_page().
+ */
+void prefetch_next_sound_page(void)
+{
+    /* The compressed sounds read a page only once every few pages */
+    if (is_compressed_sound(_sound_index))
+        return;
     
-    read_memory(
-        sound_index * BLOCKS_PER_SOUND * PAGES_PER_BLOCK,
-        (unsigned char*)(page),
-        (unsigned char*)(metadata)
-    );
+    /* Waits until the other read is drained */
+    if (page_read_is_pending)
+        return;
     
-    if (metadata->sample_rate != 96000 && metadata->sample_rate != 192000) return -1;
-    if (metadata->data_type != 0 && metadata->data_type != 1) return -1;
-    if (metadata->sound_index != sound_index) return -1;
+    if (prefetch_state == PREFETCH_STATE_LOADING)
+        if (prefetch_page_index == _page_index + 1)
+            return;
     
-    _sound_index = sound_index;
-    _page_index = 0;
+    prefetch_page_index = _page_index + 1;
+    prefetch_state = PREFETCH_STATE_LOADING;
     
-    return 0;
+    read_memory_start(get_page_address(_sound_index, prefetch_page_index));
 }
 
-void set_page_and_sound_index(int page_index, int sound_index)
+void read_next_sound_page(int *page)
 {
-    _page_index = page_index;
-    _sound_index = sound_index;
+    _page_index++;
+    
+    if (is_compressed_sound(_sound_index))
+    {
+        read_compressed_sound_page(_sound_index, _page_index, page);
+        return;
+    }
+    
+    if (prefetch_state == PREFETCH_STATE_LOADING)
+    {
+        prefetch_state = PREFETCH_STATE_STANDBY;
+        
+        /* The read is lost if another memory access happened meanwhile */
+        if (prefetch_page_index == _page_index)
+            if (read_memory_finish((unsigned char*)(page)))
+                return;
+    }
+    
+    read_memory_without_spare(
+        get_page_address(_sound_index, _page_index),
+        (unsigned char*)(page)
+    );
 }
 
-void read_next_sound_page(int *page)
+/*
+ * Reads any page of a sound without moving the sequential position used by
+ * read_next_sound_page().
+ */
+void read_sound_page(int sound_index, int page_index, int *page)
 {
-    _page_index++;
+    if (is_compressed_sound(sound_index))
+    {
+        read_compressed_sound_page(sound_index, page_index, page);
+        return;
+    }
     
     read_memory_without_spare(
-        _sound_index * BLOCKS_PER_SOUND * PAGES_PER_BLOCK + _page_index,
+        get_page_address(sound_index, page_index),
         (unsigned char*)(page)
     );
 }
 
+/*
+ * Issues the read of any page of a sound, drained by read_sound_page_finish().
+ * The read replaces the sequential prefetch, which is issued again once it
+ * is drained.
+ * Returns false for the compressed sounds, use read_sound_page() instead.
+ */
+bool read_sound_page_start(int sound_index, int page_index)
+{
+    if (is_compressed_sound(sound_index))
+        return false;
+    
+    prefetch_state = PREFETCH_STATE_STANDBY;
+    page_read_is_pending = true;
+    
+    read_memory_start(get_page_address(sound_index, page_index));
+    
+    return true;
+}
+
+bool read_sound_page_check(void)
+{
+    return read_memory_check();
+}
+
+/*
+ * Returns false if the read was aborted by another memory access.
+ */
+bool read_sound_page_finish(int *page)
+{
+    page_read_is_pending = false;
+    
+    return read_memory_finish((unsigned char*)(page));
+}
+
 #define ALLOCATE_METADATA_STATE_STANDBY 0
 #define ALLOCATE_METADATA_PROGRAM_MEMORY 1
 static int allocate_metadata_state = ALLOCATE_METADATA_STATE_STANDBY;
@@ -196,41 +1136,62 @@ static int allocate_metadata_state = ALLOCATE_METADATA_STATE_STANDBY;
 
 static int number_of_pages_index;
 
-bool allocate_metadata_command (Sound_Metadata metadata, unsigned char *sound_array)
+/*
+ * Programs the next page of a metadata command and returns the number of
+ * pages already programmed, 32768/BYTES_PER_PAGE when done, or -1 if a page
+ * failed. The sound is then removed, since its previous extent may have been
+ * erased.
+ * The metadata is only kept on the table, the spare area of the first page
+ * is left for the bad block mark.
+ */
+int allocate_metadata_command (Sound_Metadata metadata, unsigned char *sound_array)
 {
+    int page_address;
+    
     switch (allocate_metadata_state)
     {
         case ALLOCATE_METADATA_STATE_STANDBY:
-            program_memory(
-                metadata.sound_index * BLOCKS_PER_SOUND * PAGES_PER_BLOCK,
-                sound_array,
-                (unsigned char*)(&metadata)
-            );
-            
-            number_of_pages_index = 1;
+            number_of_pages_index = 0;
             
             allocate_metadata_state = ALLOCATE_METADATA_PROGRAM_MEMORY;
             
-            break;
+            /* No break */
          
         case ALLOCATE_METADATA_PROGRAM_MEMORY:
-            program_memory_without_spare(
-                metadata.sound_index * BLOCKS_PER_SOUND * PAGES_PER_BLOCK + number_of_pages_index,
-                sound_array + BYTES_PER_PAGE * number_of_pages_index
-            );
+            page_address = get_extent_page(first_block_to_erase, number_of_pages_index);
+            
+            if (program_memory_without_spare(page_address, sound_array + BYTES_PER_PAGE * number_of_pages_index) != 0)
+            {
+                allocate_metadata_state = ALLOCATE_METADATA_STATE_STANDBY;
+                
+                add_bad_block(page_address / PAGES_PER_BLOCK);
+                remove_sound(metadata.sound_index);
+                
+                return -1;
+            }
             
             number_of_pages_index++;
             
             if (number_of_pages_index == 32768/BYTES_PER_PAGE)
             {
                 allocate_metadata_state = ALLOCATE_METADATA_STATE_STANDBY;
-                return true;
+                
+                /* The data commands use the new extent from now on */
+                reset_sound_decoders(metadata.sound_index);
+                sound_table.extents[metadata.sound_index].first_block = first_block_to_erase;
+                sound_table.extents[metadata.sound_index].number_of_blocks = number_of_blocks_to_erase;
+                sound_table.extents[metadata.sound_index].metadata_page = metadata.sound_index * PAGES_PER_BLOCK;
+                sound_table.extents[metadata.sound_index].metadata = metadata;
+                sound_table.next_block = first_block_to_erase + number_of_blocks_to_erase;
+                
+                /* The remaps of the previous extent aren't needed anymore */
+                release_remaps();
             }
             
             break;
     }
     
-    return false;
+    return number_of_pages_index;
 }
 
 /*
@@ -254,15 +1215,49 @@ void allocate_metadata_command (Sound_Metadata metadata, unsigned char *sound_ar
 
 static int allocate_data_command_counter;
 
+/*
+ * Programs the next page of a data command and returns the number of pages
+ * already programmed, 32768/BYTES_PER_PAGE when done, or -1 if a page failed.
+ * The sound is then removed.
+ * The pages use the cache program, so each call only loads a page and the
+ * main loop runs while the memory programs the previous one.
+ */
 int allocate_data_command (int sound_index, int data_index, unsigned char *sound_array)
 {
-    program_memory_without_spare(
-        sound_index * BLOCKS_PER_SOUND * PAGES_PER_BLOCK + allocate_data_command_counter + data_index * 32768 / BYTES_PER_PAGE,
-        sound_array + BYTES_PER_PAGE * allocate_data_command_counter
+    int pages = 32768 / BYTES_PER_PAGE;
+    unsigned int fails;
+    int i;
+    
+    /* The memory is still busy with the previous page */
+    if (program_memory_check() == false)
+        return allocate_data_command_counter - 1;
+    
+    /* The last page closed the cache program and is programmed */
+    if (allocate_data_command_counter == pages)
+    {
+        fails = program_memory_finish();
+        
+        if (fails == 0)
+            return pages;
+        
+        /* Bit i is the i-th page of the cache program */
+        for (i = 0; i < pages; i++)
+            if (fails & (1 << i))
+                add_bad_block(get_page_address(sound_index, i + data_index * 32768 / BYTES_PER_PAGE) / PAGES_PER_BLOCK);
+        
+        remove_sound(sound_index);
+        
+        return -1;
+    }
+    
+    program_memory_cache_start(
+        get_page_address(sound_index, allocate_data_command_counter + data_index * 32768 / BYTES_PER_PAGE),
+        sound_array + BYTES_PER_PAGE * allocate_data_command_counter,
+        allocate_data_command_counter == pages - 1
     );
     
     allocate_data_command_counter++;
-    return allocate_data_command_counter;
+    return allocate_data_command_counter - 1;
 }
 
 void allocate_data_command_reset (void)
@@ -287,6 +1282,8 @@ void clean_memory (void)
 {
     int i = 0;
     
-    for (; i < get_available_sounds(); i++)
-        block_erase(i * BLOCKS_PER_SOUND);
+    for (; i < SOUNDS_MAX; i++)
+        remove_sound(i);
+    
+    while (save_sound_table() == false);
 }
\ No newline at end of file
@@ -6,24 +6,50 @@
 #define SOUNDS_PER_MEMORY_2G 32
 #define SOUNDS_PER_MEMORY_4G SOUNDS_PER_MEMORY_2G * 2
 
+/* Indexes below SOUNDS_MAX are sounds, the others are frequencies up to
+ * 40000 Hz, followed by the noises
+ */
+#define SOUNDS_MAX SOUNDS_PER_MEMORY_4G
+
+/* Size of the fixed slots used before the allocation table */
 #define PAGES_PER_SOUND PAGES_PER_MEM_2G/SOUNDS_PER_MEMORY_2G
 //#define POINTS_PER_SOUND PAGES_PER_SOUND*BYTES_PER_PAGE/4
 #define BLOCKS_PER_SOUND PAGES_PER_SOUND/PAGES_PER_BLOCK
 
+/*
+ * Memory map
+ *   Blocks 0 to SOUNDS_MAX-1: user metadata, one block per sound index
+ *   Next SOUND_TABLE_BLOCKS blocks: allocation table, one page per update
+ *   Remaining blocks: sounds, each one on a contiguous extent of blocks
+ */
+#define SOUND_TABLE_FIRST_BLOCK SOUNDS_MAX
+#define SOUND_TABLE_BLOCKS 8
+#define SOUNDS_FIRST_BLOCK (SOUND_TABLE_FIRST_BLOCK + SOUND_TABLE_BLOCKS)
+
 /*
  * Structure to accommodate the metadata of each sound.
- * 
- * Note: If samples_length is equal to PAGES_PER_SOUND the board will
- * continue the sound production using the next sound.
  */
 typedef struct {
     int sound_index;
     int sound_length;
     int sample_rate;
-    int data_type;      // 0: int32, 1: float(4B)
+    short data_type;    // 0: int32, 1: float(4B), saved as int32 after conversion
+                        // 2: compressed int24, sound_length is the compressed length on uploads
+    unsigned short fade_length; // Frames of the fade in and fade out, 0 for none
 } Sound_Metadata;
 #define SOUND_METADATA_LENGTH 16
 
+/*
+ * Header of the compressed sounds, on their first words.
+ */
+typedef struct {
+    unsigned int magic;
+    int sound_length;           // Length after decoded
+    int number_of_frames;
+    int reserved;
+} Compressed_Sound_Header;
+#define COMPRESSED_SOUND_MAGIC 0x5A435348   // "HSCZ"
+
 #define ERROR_NOERROR 0
 #define ERROR_BADSOUNDINDEX -1020
 #define ERROR_BADSOUNDLENGTH -1021
@@ -31,8 +57,10 @@ typedef struct {
 #define ERROR_BADDATATYPE -1023
 #define ERROR_BADDATATYPEMATCH -1024
 #define ERROR_BADDATAINDEX -1025
+#define ERROR_MEMORYWRITE -1026
 #define ERROR_PRODUCINGSOUND -1030
 #define ERROR_STARTEDPRODUCINGSOUND -1021
+#define ERROR_STREAMNOTSTARTED -1032
 
 int get_available_sounds(void);
 
@@ -43,11 +71,20 @@ bool prepare_memory_check(int sound_index, int sound_size);
 bool prepare_memory_erase(void);
 int prepare_memory(int sound_index, int sound_size);
 
-int read_first_sound_page(int sound_index, int *page, Sound_Metadata * metadata);
+void load_sound_table(void);
+bool save_sound_table(void);
+int read_sound_metadata(int sound_index, Sound_Metadata * metadata);
+void remove_sound(int sound_index);
+
 void set_page_and_sound_index(int page_index, int sound_index);
+void prefetch_next_sound_page(void);
 void read_next_sound_page(int *page);
+void read_sound_page(int sound_index, int page_index, int *page);
+bool read_sound_page_start(int sound_index, int page_index);
+bool read_sound_page_check(void);
+bool read_sound_page_finish(int *page);
 
-bool allocate_metadata_command (Sound_Metadata metadata, unsigned char *sound_array);
+int allocate_metadata_command (Sound_Metadata metadata, unsigned char *sound_array);
 
 int allocate_data_command (int sound_index, int data_index, unsigned char *sound_array);
 void allocate_data_command_reset (void);
@@ -188,12 +188,12 @@ extern "C" {
 #define DRV_I2S_AUDIO_PROTOCOL_MODE_IDX0		DRV_I2S_AUDIO_I2S
 #define DRV_I2S_TX_INT_SRC_IDX0					INT_SOURCE_SPI_4_TRANSMIT
 #define DRV_I2S_RX_INT_SRC_IDX0					INT_SOURCE_SPI_4_RECEIVE
-#define QUEUE_SIZE_TX_IDX0                      3
+#define QUEUE_SIZE_TX_IDX0                      5
 #define QUEUE_SIZE_RX_IDX0                      2
 #define DRV_I2S_TX_DMA_CHANNEL_IDX0				DMA_CHANNEL_0
 #define DRV_I2S_TX_DMA_SOURCE_IDX0				INT_SOURCE_DMA_0
 #define DRV_I2S_POWER_STATE_IDX0				SYS_MODULE_POWER_RUN_FULL
-#define DRV_I2S_QUEUE_DEPTH_COMBINED     		5
+#define DRV_I2S_QUEUE_DEPTH_COMBINED     		7
 
 /*** Timer Driver Configuration ***/
 #define DRV_TMR_INTERRUPT_MODE             true
@@ -275,7 +275,8 @@ extern "C" {
 
     
     
-#define APP_READ_BUFFER_SIZE 65536  // Previously it was 512
+#define APP_READ_BUFFER_SIZE 35328  // Largest command is the metadata one (34841 bytes), multiple of 512
+#define APP_WRITE_BUFFER_SIZE 4096  // Largest reply is the read metadata command (2080 bytes)
 
 /* Fulfill USB DMA transfer criteria */
 #define APP_MAKE_BUFFER_DMA_READY  __attribute__((coherent)) __attribute__((aligned(16)))
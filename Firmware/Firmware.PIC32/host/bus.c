@@ -0,0 +1,179 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+
+/*
+ * ATXMEGA side of the parallel bus.
+ * Each byte is put on PORTA with CMD_WRITE (RB5) raised. The PIC32 raises
+ * LATCH (RB4) once it has read it, and the ATXMEGA drops CMD_WRITE. With the
+ * last byte, ERROR (RB2) holds the reply when LATCH rises. When LATCH falls
+ * the next byte follows, after the ATXMEGA's reaction time.
+ */
+
+#define PIN_LATCH (sim_lat('B') & (1 << 4))
+#define PIN_ERROR (sim_lat('B') & (1 << 2))
+
+/* Reaction of the ATXMEGA to each edge of LATCH */
+#define SIM_BUS_REACTION_PS (500 * 1000LL)
+
+#define SIM_BUS_COMMANDS 64
+#define SIM_BUS_COMMAND_LEN 32
+
+typedef struct {
+    unsigned char bytes[SIM_BUS_COMMAND_LEN];
+    int length;
+    Sim_Bus_Command result;
+} Bus_Command;
+
+static Bus_Command commands[SIM_BUS_COMMANDS];
+static int command_head = 0;        // Command on the bus
+static int command_tail = 0;
+static int byte_index = 0;
+static bool cmd_write = false;
+static bool byte_is_presented = false;  // Until LATCH falls
+static sim_time_t cmd_write_at = -1;    // CMD_WRITE rises at this time
+static bool last_latch = false;
+static sim_time_t bus_free_at = 0;      // The ATXMEGA is ready for the next command
+
+static Bus_Command *current(void)
+{
+    return (command_head != command_tail) ? &commands[command_head % SIM_BUS_COMMANDS] : NULL;
+}
+
+/* Puts the next command on the bus when it is due */
+static void update(void)
+{
+    Bus_Command *command = current();
+
+    if (command && !byte_is_presented)
+    {
+        byte_is_presented = true;
+        cmd_write_at = command->result.queued > bus_free_at ? command->result.queued : bus_free_at;
+        if (cmd_write_at < sim_now())
+            cmd_write_at = sim_now();
+    }
+
+    if (cmd_write_at >= 0 && sim_now() >= cmd_write_at)
+    {
+        cmd_write = true;
+        cmd_write_at = -1;
+    }
+}
+
+Sim_Bus_Command * sim_bus_send(sim_time_t time, const unsigned char *bytes, int length)
+{
+    Bus_Command *command = &commands[command_tail % SIM_BUS_COMMANDS];
+    unsigned char checksum = 0;
+    int i = 0;
+
+    if (command_tail - command_head == SIM_BUS_COMMANDS || length > SIM_BUS_COMMAND_LEN)
+    {
+        fprintf(stderr, "bus: too many commands\n");
+        exit(1);
+    }
+
+    memcpy(command->bytes, bytes, length);
+    for (; i < length - 1; i++)
+        checksum += bytes[i];
+    command->bytes[length - 1] = checksum;
+    command->length = length;
+
+    memset(&command->result, 0, sizeof(command->result));
+    command->result.queued = time;
+
+    command_tail++;
+    update();
+
+    return &command->result;
+}
+
+Sim_Bus_Command * sim_bus_start(sim_time_t time, int index, int att_left, int att_right)
+{
+    unsigned char bytes[8] = {0xF1, index & 0xFF, index >> 8, att_left & 0xFF, att_left >> 8, att_right & 0xFF, att_right >> 8, 0};
+
+    return sim_bus_send(time, bytes, sizeof(bytes));
+}
+
+Sim_Bus_Command * sim_bus_start_mixed(sim_time_t time, int index, int att_left, int att_right)
+{
+    unsigned char bytes[8] = {0xF5, index & 0xFF, index >> 8, att_left & 0xFF, att_left >> 8, att_right & 0xFF, att_right >> 8, 0};
+
+    return sim_bus_send(time, bytes, sizeof(bytes));
+}
+
+Sim_Bus_Command * sim_bus_stop(sim_time_t time)
+{
+    unsigned char bytes[2] = {0xF0, 0};
+
+    return sim_bus_send(time, bytes, sizeof(bytes));
+}
+
+bool sim_bus_is_idle(void)
+{
+    return current() == NULL;
+}
+
+void sim_bus_pins(void)
+{
+    Bus_Command *command = current();
+    bool latch = PIN_LATCH ? true : false;
+
+    if (latch == last_latch)
+        return;
+
+    last_latch = latch;
+
+    if (command == NULL)
+        return;
+
+    if (latch)
+    {
+        cmd_write = false;
+
+        if (byte_index == 0)
+            command->result.first_byte = sim_now();
+
+        if (byte_index == command->length - 1)
+        {
+            command->result.error = PIN_ERROR ? true : false;
+            command->result.done = sim_now();
+            command->result.is_done = true;
+        }
+    }
+    else
+    {
+        byte_is_presented = false;
+
+        /* The PIC32 may reject a command on its first byte */
+        if (byte_index == command->length - 1 || (byte_index == 0 && (command->bytes[0] & 0xF0) != 0xF0))
+        {
+            byte_index = 0;
+            command_head++;
+            bus_free_at = sim_now() + SIM_BUS_REACTION_PS;
+            update();
+        }
+        else
+        {
+            byte_index++;
+            byte_is_presented = true;
+            cmd_write_at = sim_now() + SIM_BUS_REACTION_PS;
+        }
+    }
+}
+
+unsigned int sim_bus_data(void)
+{
+    Bus_Command *command = current();
+
+    update();
+
+    return command ? command->bytes[byte_index] : 0;
+}
+
+bool sim_bus_cmd_write(void)
+{
+    update();
+
+    return cmd_write;
+}
@@ -0,0 +1,23 @@
+#ifndef _PLIB_OSC_H
+#define _PLIB_OSC_H
+
+/*
+ * Reference oscillator of the host build.
+ * Its divisor sets the sample rate of the simulated I2S.
+ */
+
+typedef enum {
+    OSC_ID_0
+} OSC_MODULE_ID;
+
+typedef enum {
+    OSC_REFERENCE_1
+} OSC_REFERENCE;
+
+void PLIB_OSC_ReferenceOscDivisorValueSet(OSC_MODULE_ID index, OSC_REFERENCE reference, int value);
+void PLIB_OSC_ReferenceOscTrimSet(OSC_MODULE_ID index, OSC_REFERENCE reference, int value);
+
+void SYS_DEVCON_SystemUnlock(void);
+void SYS_DEVCON_SystemLock(void);
+
+#endif /* _PLIB_OSC_H */
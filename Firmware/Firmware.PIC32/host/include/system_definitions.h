@@ -0,0 +1,135 @@
+#ifndef _SYS_DEFINITIONS_H
+#define _SYS_DEFINITIONS_H
+
+/*
+ * The Harmony services used by the application, implemented by the host
+ * build's simulator.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <xc.h>
+
+/* Modules */
+typedef uintptr_t SYS_MODULE_OBJ;
+typedef uintptr_t DRV_HANDLE;
+#define DRV_HANDLE_INVALID ((DRV_HANDLE)-1)
+#define DRV_IO_INTENT_WRITE 0x02
+#define DRV_IO_INTENT_READWRITE 0x03
+
+/* Interrupts */
+bool SYS_INT_Disable(void);
+void SYS_INT_Restore(bool state);
+bool SYS_INT_StatusGetAndDisable(void);
+
+/* Reset */
+typedef enum {
+    RESET_REASON_POWERON = 0x03,
+    RESET_REASON_WDT_TIMEOUT = 0x10,
+    RESET_REASON_SOFTWARE = 0x40,
+    RESET_REASON_MCLR = 0x80
+} RESET_REASON;
+
+RESET_REASON SYS_RESET_ReasonGet(void);
+void SYS_RESET_ReasonClear(RESET_REASON reason);
+void SYS_RESET_SoftwareReset(void);
+
+/* DMA */
+#define DMA_ID_0 0
+void PLIB_DMA_SuspendEnable(int index);
+
+/* Device control */
+void SYS_DEVCON_SystemUnlock(void);
+void SYS_DEVCON_SystemLock(void);
+
+/* I2S driver, a DMA queue of QUEUE_SIZE_TX_IDX0 buffers */
+#define DRV_I2S_INDEX_0 0
+typedef uintptr_t DRV_I2S_BUFFER_HANDLE;
+#define DRV_I2S_BUFFER_HANDLE_INVALID ((DRV_I2S_BUFFER_HANDLE)-1)
+
+typedef enum {
+    DRV_I2S_BUFFER_EVENT_COMPLETE,
+    DRV_I2S_BUFFER_EVENT_ERROR,
+    DRV_I2S_BUFFER_EVENT_ABORT
+} DRV_I2S_BUFFER_EVENT;
+
+typedef void (*DRV_I2S_BUFFER_EVENT_HANDLER)(DRV_I2S_BUFFER_EVENT event, DRV_I2S_BUFFER_HANDLE bufferHandle, uintptr_t contextHandle);
+
+DRV_HANDLE DRV_I2S_Open(int index, int intent);
+void DRV_I2S_BufferEventHandlerSet(DRV_HANDLE handle, DRV_I2S_BUFFER_EVENT_HANDLER eventHandler, uintptr_t contextHandle);
+void DRV_I2S_BufferAddWrite(DRV_HANDLE handle, DRV_I2S_BUFFER_HANDLE *bufferHandle, void *buffer, size_t size);
+void DRV_I2S_BufferQueueFlush(DRV_HANDLE handle);
+
+/* USB device layer, a single bulk endpoint pair */
+typedef uintptr_t USB_DEVICE_HANDLE;
+#define USB_DEVICE_HANDLE_INVALID ((USB_DEVICE_HANDLE)-1)
+#define USB_DEVICE_INDEX_0 0
+typedef uintptr_t USB_DEVICE_TRANSFER_HANDLE;
+typedef uint8_t USB_ENDPOINT_ADDRESS;
+#define USB_EP_DIRECTION_OUT 0x00
+#define USB_EP_DIRECTION_IN 0x80
+
+typedef enum {
+    USB_SPEED_FULL,
+    USB_SPEED_HIGH
+} USB_SPEED;
+
+typedef enum {
+    USB_TRANSFER_TYPE_CONTROL,
+    USB_TRANSFER_TYPE_BULK
+} USB_TRANSFER_TYPE;
+
+typedef enum {
+    USB_DEVICE_TRANSFER_FLAGS_DATA_COMPLETE,
+    USB_DEVICE_TRANSFER_FLAGS_MORE_DATA_PENDING
+} USB_DEVICE_TRANSFER_FLAGS;
+
+typedef enum {
+    USB_DEVICE_CONTROL_STATUS_OK,
+    USB_DEVICE_CONTROL_STATUS_ERROR
+} USB_DEVICE_CONTROL_STATUS;
+
+typedef enum {
+    USB_DEVICE_EVENT_RESET,
+    USB_DEVICE_EVENT_DECONFIGURED,
+    USB_DEVICE_EVENT_CONFIGURED,
+    USB_DEVICE_EVENT_SUSPENDED,
+    USB_DEVICE_EVENT_RESUMED,
+    USB_DEVICE_EVENT_POWER_DETECTED,
+    USB_DEVICE_EVENT_POWER_REMOVED,
+    USB_DEVICE_EVENT_CONTROL_TRANSFER_SETUP_REQUEST,
+    USB_DEVICE_EVENT_ENDPOINT_READ_COMPLETE,
+    USB_DEVICE_EVENT_ENDPOINT_WRITE_COMPLETE,
+    USB_DEVICE_EVENT_ERROR
+} USB_DEVICE_EVENT;
+
+#define USB_REQUEST_GET_INTERFACE 0x0A
+#define USB_REQUEST_SET_INTERFACE 0x0B
+
+typedef struct {
+    uint8_t bmRequestType;
+    uint8_t bRequest;
+    uint16_t wValue;
+    uint16_t wIndex;
+    uint16_t wLength;
+} USB_SETUP_PACKET;
+
+typedef void (*USB_DEVICE_EVENT_HANDLER)(USB_DEVICE_EVENT event, void *eventData, uintptr_t context);
+
+USB_DEVICE_HANDLE USB_DEVICE_Open(int index, int intent);
+void USB_DEVICE_EventHandlerSet(USB_DEVICE_HANDLE handle, USB_DEVICE_EVENT_HANDLER callback, uintptr_t context);
+void USB_DEVICE_Attach(USB_DEVICE_HANDLE handle);
+void USB_DEVICE_Detach(USB_DEVICE_HANDLE handle);
+void USB_DEVICE_ControlStatus(USB_DEVICE_HANDLE handle, USB_DEVICE_CONTROL_STATUS status);
+void USB_DEVICE_ControlSend(USB_DEVICE_HANDLE handle, void *data, size_t length);
+USB_SPEED USB_DEVICE_ActiveSpeedGet(USB_DEVICE_HANDLE handle);
+bool USB_DEVICE_EndpointIsEnabled(USB_DEVICE_HANDLE handle, USB_ENDPOINT_ADDRESS endpoint);
+void USB_DEVICE_EndpointEnable(USB_DEVICE_HANDLE handle, int interface, USB_ENDPOINT_ADDRESS endpoint, USB_TRANSFER_TYPE type, size_t size);
+void USB_DEVICE_EndpointDisable(USB_DEVICE_HANDLE handle, USB_ENDPOINT_ADDRESS endpoint);
+void USB_DEVICE_EndpointRead(USB_DEVICE_HANDLE handle, USB_DEVICE_TRANSFER_HANDLE *transferHandle, USB_ENDPOINT_ADDRESS endpoint, void *buffer, size_t size);
+void USB_DEVICE_EndpointWrite(USB_DEVICE_HANDLE handle, USB_DEVICE_TRANSFER_HANDLE *transferHandle, USB_ENDPOINT_ADDRESS endpoint, const void *buffer, size_t size, USB_DEVICE_TRANSFER_FLAGS flags);
+
+#include "app.h"
+
+#endif /* _SYS_DEFINITIONS_H */
@@ -0,0 +1,216 @@
+#ifndef XC_H
+#define	XC_H
+
+/*
+ * Special function registers of the host build.
+ * Each access goes through sim_sfr(), which advances the virtual clock and
+ * returns a scratch word loaded with the register's value. A write to the
+ * word is applied on the next access, so the pins seen by the NAND, the
+ * parallel bus and the timers change in the same order as on the device.
+ */
+
+enum {
+#define SIM_PORT_SFRS(x) SFR_TRIS##x, SFR_TRIS##x##SET, SFR_TRIS##x##CLR, SFR_TRIS##x##INV, \
+                         SFR_LAT##x, SFR_LAT##x##SET, SFR_LAT##x##CLR, SFR_LAT##x##INV, \
+                         SFR_PORT##x, \
+                         SFR_ANSEL##x, SFR_ANSEL##x##SET, SFR_ANSEL##x##CLR, SFR_ANSEL##x##INV
+    SIM_PORT_SFRS(A), SIM_PORT_SFRS(B), SIM_PORT_SFRS(C), SIM_PORT_SFRS(D),
+    SIM_PORT_SFRS(E), SIM_PORT_SFRS(F), SIM_PORT_SFRS(G),
+    SFR_T2CON, SFR_TMR2, SFR_PR2,
+    SFR_T3CON, SFR_TMR3, SFR_PR3,
+    SFR_IFS0, SFR_IEC0, SFR_IPC2, SFR_IPC3,
+    SFR_INTCON, SFR_REFO1CON, SFR_REFO1TRIM,
+    SFR_NUMBER
+};
+
+volatile unsigned int * sim_sfr(int sfr);
+unsigned int sim_core_timer(void);
+
+#define SIM_SFR(sfr) (*sim_sfr(sfr))
+
+#define TRISA SIM_SFR(SFR_TRISA)
+#define TRISASET SIM_SFR(SFR_TRISASET)
+#define TRISACLR SIM_SFR(SFR_TRISACLR)
+#define TRISAINV SIM_SFR(SFR_TRISAINV)
+#define LATA SIM_SFR(SFR_LATA)
+#define LATASET SIM_SFR(SFR_LATASET)
+#define LATACLR SIM_SFR(SFR_LATACLR)
+#define LATAINV SIM_SFR(SFR_LATAINV)
+#define PORTA SIM_SFR(SFR_PORTA)
+#define ANSELA SIM_SFR(SFR_ANSELA)
+#define ANSELASET SIM_SFR(SFR_ANSELASET)
+#define ANSELACLR SIM_SFR(SFR_ANSELACLR)
+#define ANSELAINV SIM_SFR(SFR_ANSELAINV)
+
+#define TRISB SIM_SFR(SFR_TRISB)
+#define TRISBSET SIM_SFR(SFR_TRISBSET)
+#define TRISBCLR SIM_SFR(SFR_TRISBCLR)
+#define TRISBINV SIM_SFR(SFR_TRISBINV)
+#define LATB SIM_SFR(SFR_LATB)
+#define LATBSET SIM_SFR(SFR_LATBSET)
+#define LATBCLR SIM_SFR(SFR_LATBCLR)
+#define LATBINV SIM_SFR(SFR_LATBINV)
+#define PORTB SIM_SFR(SFR_PORTB)
+#define ANSELB SIM_SFR(SFR_ANSELB)
+#define ANSELBSET SIM_SFR(SFR_ANSELBSET)
+#define ANSELBCLR SIM_SFR(SFR_ANSELBCLR)
+#define ANSELBINV SIM_SFR(SFR_ANSELBINV)
+
+#define TRISC SIM_SFR(SFR_TRISC)
+#define TRISCSET SIM_SFR(SFR_TRISCSET)
+#define TRISCCLR SIM_SFR(SFR_TRISCCLR)
+#define TRISCINV SIM_SFR(SFR_TRISCINV)
+#define LATC SIM_SFR(SFR_LATC)
+#define LATCSET SIM_SFR(SFR_LATCSET)
+#define LATCCLR SIM_SFR(SFR_LATCCLR)
+#define LATCINV SIM_SFR(SFR_LATCINV)
+#define PORTC SIM_SFR(SFR_PORTC)
+#define ANSELC SIM_SFR(SFR_ANSELC)
+#define ANSELCSET SIM_SFR(SFR_ANSELCSET)
+#define ANSELCCLR SIM_SFR(SFR_ANSELCCLR)
+#define ANSELCINV SIM_SFR(SFR_ANSELCINV)
+
+#define TRISD SIM_SFR(SFR_TRISD)
+#define TRISDSET SIM_SFR(SFR_TRISDSET)
+#define TRISDCLR SIM_SFR(SFR_TRISDCLR)
+#define TRISDINV SIM_SFR(SFR_TRISDINV)
+#define LATD SIM_SFR(SFR_LATD)
+#define LATDSET SIM_SFR(SFR_LATDSET)
+#define LATDCLR SIM_SFR(SFR_LATDCLR)
+#define LATDINV SIM_SFR(SFR_LATDINV)
+#define PORTD SIM_SFR(SFR_PORTD)
+#define ANSELD SIM_SFR(SFR_ANSELD)
+#define ANSELDSET SIM_SFR(SFR_ANSELDSET)
+#define ANSELDCLR SIM_SFR(SFR_ANSELDCLR)
+#define ANSELDINV SIM_SFR(SFR_ANSELDINV)
+
+#define TRISE SIM_SFR(SFR_TRISE)
+#define TRISESET SIM_SFR(SFR_TRISESET)
+#define TRISECLR SIM_SFR(SFR_TRISECLR)
+#define TRISEINV SIM_SFR(SFR_TRISEINV)
+#define LATE SIM_SFR(SFR_LATE)
+#define LATESET SIM_SFR(SFR_LATESET)
+#define LATECLR SIM_SFR(SFR_LATECLR)
+#define LATEINV SIM_SFR(SFR_LATEINV)
+#define PORTE SIM_SFR(SFR_PORTE)
+#define ANSELE SIM_SFR(SFR_ANSELE)
+#define ANSELESET SIM_SFR(SFR_ANSELESET)
+#define ANSELECLR SIM_SFR(SFR_ANSELECLR)
+#define ANSELEINV SIM_SFR(SFR_ANSELEINV)
+
+#define TRISF SIM_SFR(SFR_TRISF)
+#define TRISFSET SIM_SFR(SFR_TRISFSET)
+#define TRISFCLR SIM_SFR(SFR_TRISFCLR)
+#define TRISFINV SIM_SFR(SFR_TRISFINV)
+#define LATF SIM_SFR(SFR_LATF)
+#define LATFSET SIM_SFR(SFR_LATFSET)
+#define LATFCLR SIM_SFR(SFR_LATFCLR)
+#define LATFINV SIM_SFR(SFR_LATFINV)
+#define PORTF SIM_SFR(SFR_PORTF)
+#define ANSELF SIM_SFR(SFR_ANSELF)
+#define ANSELFSET SIM_SFR(SFR_ANSELFSET)
+#define ANSELFCLR SIM_SFR(SFR_ANSELFCLR)
+#define ANSELFINV SIM_SFR(SFR_ANSELFINV)
+
+#define TRISG SIM_SFR(SFR_TRISG)
+#define TRISGSET SIM_SFR(SFR_TRISGSET)
+#define TRISGCLR SIM_SFR(SFR_TRISGCLR)
+#define TRISGINV SIM_SFR(SFR_TRISGINV)
+#define LATG SIM_SFR(SFR_LATG)
+#define LATGSET SIM_SFR(SFR_LATGSET)
+#define LATGCLR SIM_SFR(SFR_LATGCLR)
+#define LATGINV SIM_SFR(SFR_LATGINV)
+#define PORTG SIM_SFR(SFR_PORTG)
+#define ANSELG SIM_SFR(SFR_ANSELG)
+#define ANSELGSET SIM_SFR(SFR_ANSELGSET)
+#define ANSELGCLR SIM_SFR(SFR_ANSELGCLR)
+#define ANSELGINV SIM_SFR(SFR_ANSELGINV)
+
+/* Timers 2 and 3, clocked by PBCLK3 */
+typedef struct {
+    unsigned :1;
+    unsigned TCS:1;
+    unsigned :1;
+    unsigned T32:1;
+    unsigned TCKPS:3;
+    unsigned TGATE:1;
+    unsigned :5;
+    unsigned SIDL:1;
+    unsigned :1;
+    unsigned TON:1;
+} __TxCONbits_t;
+
+typedef struct {
+    unsigned :9;
+    unsigned T2IF:1;
+    unsigned :4;
+    unsigned T3IF:1;
+} __IFS0bits_t;
+
+typedef struct {
+    unsigned :9;
+    unsigned T2IE:1;
+    unsigned :4;
+    unsigned T3IE:1;
+} __IEC0bits_t;
+
+typedef struct {
+    unsigned :8;
+    unsigned T2IS:2;
+    unsigned T2IP:3;
+} __IPC2bits_t;
+
+typedef struct {
+    unsigned :8;
+    unsigned T3IS:2;
+    unsigned T3IP:3;
+} __IPC3bits_t;
+
+typedef struct {
+    unsigned :12;
+    unsigned MVEC:1;
+} __INTCONbits_t;
+
+typedef struct {
+    unsigned ROSEL:4;
+    unsigned :4;
+    unsigned ACTIVE:1;
+    unsigned DIVSWEN:1;
+    unsigned :5;
+    unsigned ON:1;
+    unsigned RODIV:15;
+} __REFO1CONbits_t;
+
+#define T2CON SIM_SFR(SFR_T2CON)
+#define TMR2 SIM_SFR(SFR_TMR2)
+#define PR2 SIM_SFR(SFR_PR2)
+#define T3CON SIM_SFR(SFR_T3CON)
+#define TMR3 SIM_SFR(SFR_TMR3)
+#define PR3 SIM_SFR(SFR_PR3)
+#define IFS0 SIM_SFR(SFR_IFS0)
+#define IEC0 SIM_SFR(SFR_IEC0)
+#define IPC2 SIM_SFR(SFR_IPC2)
+#define IPC3 SIM_SFR(SFR_IPC3)
+#define INTCON SIM_SFR(SFR_INTCON)
+#define REFO1CON SIM_SFR(SFR_REFO1CON)
+#define REFO1TRIM SIM_SFR(SFR_REFO1TRIM)
+
+#define T2CONbits (*(volatile __TxCONbits_t *)sim_sfr(SFR_T2CON))
+#define T3CONbits (*(volatile __TxCONbits_t *)sim_sfr(SFR_T3CON))
+#define IFS0bits (*(volatile __IFS0bits_t *)sim_sfr(SFR_IFS0))
+#define IEC0bits (*(volatile __IEC0bits_t *)sim_sfr(SFR_IEC0))
+#define IPC2bits (*(volatile __IPC2bits_t *)sim_sfr(SFR_IPC2))
+#define IPC3bits (*(volatile __IPC3bits_t *)sim_sfr(SFR_IPC3))
+#define INTCONbits (*(volatile __INTCONbits_t *)sim_sfr(SFR_INTCON))
+#define REFO1CONbits (*(volatile __REFO1CONbits_t *)sim_sfr(SFR_REFO1CON))
+
+/* Core timer, CPU_CT_HZ */
+#define _CP0_GET_COUNT() sim_core_timer()
+
+/* The interrupt handlers are called by the simulator */
+#define vector(v)
+#define interrupt(ipl)
+#define _TIMER_2_VECTOR 9
+#define _TIMER_3_VECTOR 14
+
+#endif	/* XC_H */
@@ -0,0 +1,416 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "sim.h"
+
+/*
+ * NAND flash on the pins of memory.h, 2 Gb or 4 Gb with 2048 + 64 bytes per
+ * page and 64 pages per block, like the MT29F on the board.
+ * Commands are latched on the rising edge of WE#, with CLE or ALE selecting
+ * command or address cycles. The data register is driven on IO0-7 while RE#
+ * is low and its column advances on the rising edge of RE#.
+ * The array is a file mapped in memory, saved inverted so a new (sparse)
+ * file reads as erased. Forked processes share it, which lets a test reboot
+ * the firmware on the same memory.
+ */
+
+#define PIN_CE (sim_lat('D') & (1 << 12))
+#define PIN_CLE (sim_lat('D') & (1 << 13))
+#define PIN_ALE (sim_lat('G') & (1 << 7))
+#define PIN_WP (sim_lat('G') & (1 << 8))
+#define PIN_WE (sim_lat('C') & (1 << 3))
+#define PIN_RE (sim_lat('C') & (1 << 4))
+#define PIN_IO (sim_lat('E') & 0xFF)
+
+#define T_R (25 * SIM_PS_PER_US)
+#define T_PROG (200 * SIM_PS_PER_US)
+#define T_CBSY (3 * SIM_PS_PER_US)
+#define T_BERS (700 * SIM_PS_PER_US)
+
+#define STATUS_WP (1 << 7)
+#define STATUS_RDY (1 << 6)
+#define STATUS_ARDY (1 << 5)
+#define STATUS_FAILC (1 << 1)
+#define STATUS_FAIL (1 << 0)
+
+Sim_NAND_Stats sim_nand_stats;
+
+static unsigned char *array = NULL;     // Inverted
+static int pages = 0;
+static int gigabits = 0;
+static int *block_erases = NULL;
+static int *erase_failures = NULL;
+static int *program_failures = NULL;
+
+typedef enum {
+    OUT_DATA,
+    OUT_STATUS,
+    OUT_ID
+} Output;
+
+static Output output = OUT_DATA;
+static int command = -1;
+static unsigned char address[5];
+static int address_cycles = 0;
+static int column = 0;
+static unsigned char data_register[SIM_NAND_PAGE_LENGTH];
+static unsigned char cache_register[SIM_NAND_PAGE_LENGTH];
+static bool last_we = true;
+static bool last_re = true;
+
+/* R/B# is low until busy_until, the array is programming until array_until */
+static sim_time_t busy_until = 0;
+static sim_time_t array_until = 0;
+
+/* Pages or erases on the array, with their results */
+typedef struct {
+    sim_time_t done;
+    bool fail;
+} Operation;
+
+static Operation operations[2];
+static int operations_pending = 0;
+static unsigned char fail_bits = 0;
+
+void sim_nand_open(const char *path, int gbits)
+{
+    char temporary[] = "/tmp/sim_nandXXXXXX";
+    size_t size;
+    int fd;
+
+    gigabits = gbits;
+    pages = (gbits == 2) ? 131072 : 262144;
+    size = (size_t)pages * SIM_NAND_PAGE_LENGTH;
+
+    if (path)
+    {
+        fd = open(path, O_RDWR | O_CREAT, 0644);
+    }
+    else
+    {
+        fd = mkstemp(temporary);
+        unlink(temporary);
+    }
+
+    if (fd < 0 || ftruncate(fd, size))
+    {
+        perror("sim_nand_open");
+        exit(1);
+    }
+
+    array = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (array == MAP_FAILED)
+    {
+        perror("sim_nand_open");
+        exit(1);
+    }
+
+    block_erases = calloc(sim_nand_blocks(), sizeof(int));
+    erase_failures = calloc(sim_nand_blocks(), sizeof(int));
+    program_failures = calloc(pages, sizeof(int));
+}
+
+int sim_nand_blocks(void)
+{
+    return pages / SIM_NAND_PAGES_PER_BLOCK;
+}
+
+static unsigned char *page_of(int page)
+{
+    return array + (size_t)page * SIM_NAND_PAGE_LENGTH;
+}
+
+void sim_nand_read_raw(int page, unsigned char *data)
+{
+    unsigned char *stored = page_of(page);
+    int i = 0;
+
+    for (; i < SIM_NAND_PAGE_LENGTH; i++)
+        data[i] = ~stored[i];
+}
+
+void sim_nand_write_raw(int page, const unsigned char *data)
+{
+    unsigned char *stored = page_of(page);
+    int i = 0;
+
+    for (; i < SIM_NAND_PAGE_LENGTH; i++)
+        stored[i] = ~data[i];
+}
+
+void sim_nand_set_bad_block(int block)
+{
+    page_of(block * SIM_NAND_PAGES_PER_BLOCK)[2048] = ~0x00;
+}
+
+void sim_nand_fail_erase(int block, int times)
+{
+    erase_failures[block] = times;
+}
+
+void sim_nand_fail_program(int page, int times)
+{
+    program_failures[page] = times;
+}
+
+void sim_nand_flip_bit(int page, int byte, int bit)
+{
+    page_of(page)[byte] ^= 1 << bit;
+}
+
+int sim_nand_block_erases(int block)
+{
+    return block_erases[block];
+}
+
+/* Results of the operations done by now */
+static void update(void)
+{
+    sim_time_t now = sim_now();
+
+    while (operations_pending && operations[0].done <= now)
+    {
+        fail_bits = ((fail_bits << 1) & STATUS_FAILC) | (operations[0].fail ? STATUS_FAIL : 0);
+        operations[0] = operations[1];
+        operations_pending--;
+    }
+}
+
+static void add_operation(sim_time_t done, bool fail)
+{
+    update();
+
+    if (operations_pending == 2)
+    {
+        fprintf(stderr, "NAND: more than two operations on the array\n");
+        exit(1);
+    }
+
+    operations[operations_pending].done = done;
+    operations[operations_pending].fail = fail;
+    operations_pending++;
+}
+
+static int row(void)
+{
+    return address[2] | (address[3] << 8) | (address[4] << 16);
+}
+
+static void page_read(void)
+{
+    int page = row();
+    sim_time_t start = (sim_now() > array_until) ? sim_now() : array_until;
+
+    sim_nand_read_raw(page % pages, data_register);
+    column = (address[0] | (address[1] << 8)) % SIM_NAND_PAGE_LENGTH;
+    busy_until = start + T_R;
+    output = OUT_DATA;
+
+    sim_nand_stats.reads++;
+    if (column >= 2048)
+        sim_nand_stats.spare_reads++;
+}
+
+static void page_program(bool cache)
+{
+    int page = row() % pages;
+    unsigned char *stored = page_of(page);
+    sim_time_t start = (sim_now() > array_until) ? sim_now() : array_until;
+    bool fail = false;
+    int i = 0;
+
+    if (!PIN_WP)
+    {
+        fail = true;
+    }
+    else if (program_failures[page])
+    {
+        program_failures[page]--;
+        sim_nand_stats.program_failures++;
+        fail = true;
+
+        /* Half of the page reaches the array */
+        for (; i < SIM_NAND_PAGE_LENGTH / 2; i++)
+            stored[i] |= (unsigned char)~cache_register[i];
+    }
+    else
+    {
+        /* The array only takes 1s to 0s, it is saved inverted */
+        for (; i < SIM_NAND_PAGE_LENGTH; i++)
+            stored[i] |= (unsigned char)~cache_register[i];
+    }
+
+    sim_nand_stats.programs++;
+
+    array_until = start + T_PROG;
+    busy_until = cache ? start + T_CBSY : array_until;
+    add_operation(array_until, fail);
+}
+
+static void block_erase(void)
+{
+    int block = (row() % pages) / SIM_NAND_PAGES_PER_BLOCK;
+    sim_time_t start = (sim_now() > array_until) ? sim_now() : array_until;
+    bool fail = false;
+
+    if (!PIN_WP)
+    {
+        fail = true;
+    }
+    else if (erase_failures[block])
+    {
+        erase_failures[block]--;
+        sim_nand_stats.erase_failures++;
+        fail = true;
+    }
+    else
+    {
+        memset(page_of(block * SIM_NAND_PAGES_PER_BLOCK), 0, (size_t)SIM_NAND_PAGES_PER_BLOCK * SIM_NAND_PAGE_LENGTH);
+    }
+
+    block_erases[block]++;
+    sim_nand_stats.erases++;
+
+    array_until = start + T_BERS;
+    busy_until = array_until;
+    add_operation(array_until, fail);
+}
+
+static void latch_command(unsigned char byte)
+{
+    command = byte;
+    address_cycles = 0;
+
+    switch (byte)
+    {
+        case 0x70:
+            output = OUT_STATUS;
+            break;
+
+        case 0x90:
+            output = OUT_ID;
+            column = 0;
+            break;
+
+        case 0x80:
+            memset(cache_register, 0xFF, sizeof(cache_register));
+            output = OUT_DATA;
+            break;
+
+        case 0x30:
+            page_read();
+            break;
+
+        case 0x10:
+        case 0x15:
+            page_program(byte == 0x15);
+            break;
+
+        case 0xD0:
+            block_erase();
+            break;
+
+        case 0x00:
+        case 0x60:
+            output = OUT_DATA;
+            break;
+
+        default:
+            fprintf(stderr, "NAND: unknown command 0x%02X\n", byte);
+            exit(1);
+    }
+}
+
+static void latch_address(unsigned char byte)
+{
+    /* The erase only has the row address */
+    if (command == 0x60 && address_cycles == 0)
+        address_cycles = 2;
+
+    if (address_cycles < 5)
+        address[address_cycles++] = byte;
+
+    if (command == 0x80 && address_cycles == 2)
+        column = (address[0] | (address[1] << 8)) % SIM_NAND_PAGE_LENGTH;
+}
+
+void sim_nand_pins(void)
+{
+    bool we = PIN_WE ? true : false;
+    bool re = PIN_RE ? true : false;
+
+    if (array == NULL)
+        return;
+
+    if (!PIN_CE)
+    {
+        if (we && !last_we)
+        {
+            if (PIN_CLE)
+                latch_command(PIN_IO);
+            else if (PIN_ALE)
+                latch_address(PIN_IO);
+            else if (command == 0x80 && column < SIM_NAND_PAGE_LENGTH)
+                cache_register[column++] = PIN_IO;
+        }
+
+        if (re && !last_re)
+        {
+            if (output == OUT_DATA && column < SIM_NAND_PAGE_LENGTH)
+                column++;
+            else if (output == OUT_ID)
+                column++;
+        }
+    }
+
+    last_we = we;
+    last_re = re;
+}
+
+bool sim_nand_ready(void)
+{
+    return sim_now() >= busy_until;
+}
+
+unsigned int sim_nand_data(void)
+{
+    static const unsigned char id[5] = {0x2C, 0xDA, 0x90, 0x95, 0x06};
+    unsigned char status;
+
+    /* IO0-7 are driven while RE# is low */
+    if (PIN_CE || PIN_RE)
+        return 0;
+
+    switch (output)
+    {
+        case OUT_STATUS:
+            update();
+            /* While a cache program is on the array, FAILC is the last page
+             * done and FAIL isn't valid
+             */
+            if (operations_pending)
+                status = (fail_bits & STATUS_FAIL) ? STATUS_FAILC : 0;
+            else
+                status = fail_bits;
+            if (PIN_WP)
+                status |= STATUS_WP;
+            if (sim_now() >= busy_until)
+                status |= STATUS_RDY;
+            if (sim_now() >= array_until)
+                status |= STATUS_ARDY;
+            return status;
+
+        case OUT_ID:
+            if (column == 1)
+                return gigabits == 2 ? 0xDA : 0xDC;
+            return column < 5 ? id[column] : 0;
+
+        default:
+            return column < SIM_NAND_PAGE_LENGTH ? data_register[column] : 0;
+    }
+}
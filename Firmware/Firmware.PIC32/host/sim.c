@@ -0,0 +1,936 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <xc.h>
+#include "system_config.h"
+#include "system_definitions.h"
+#include "peripheral/osc/plib_osc.h"
+#include "sim.h"
+
+/* Firmware */
+void timer2_handler(void);
+void timer3_handler(void);
+void I2SBufferEventHandler(DRV_I2S_BUFFER_EVENT event, DRV_I2S_BUFFER_HANDLE bufferHandle, uintptr_t context);
+extern APP_DATA appData;
+
+double sim_cpu_scale = 0;
+int sim_reset_reason = RESET_REASON_SOFTWARE;
+int sim_failures = 0;
+
+Sim_Loop_Stats sim_loop_stats;
+Sim_I2S_Stats sim_i2s_stats;
+Sim_I2S_Capture sim_i2s_capture = NULL;
+Sim_Pin_Edge sim_sound_is_on_edge = NULL;
+
+static sim_time_t now = 0;
+
+static void commit_writes(void);
+
+/*
+ * CPU time.
+ * The host time spent on the firmware between two register accesses is
+ * charged to the virtual clock, the simulator's own time isn't.
+ */
+static long long host_mark;
+static long long host_overhead;         // Of reading the host time
+static long long host_credit = 0;       // Time taken by the overhead and not charged
+
+static long long host_ns(void)
+{
+    struct timespec time;
+
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return time.tv_sec * 1000000000LL + time.tv_nsec;
+}
+
+static void charge_cpu(void)
+{
+    long long gap;
+
+    if (sim_cpu_scale <= 0)
+        return;
+
+    gap = host_ns() - host_mark - host_overhead;
+    if (gap > SIM_CPU_GAP_MAX_NS)
+        gap = SIM_CPU_GAP_MAX_NS;
+
+    /* The overhead is a mean, the short gaps may be below it */
+    host_credit += gap;
+    if (host_credit < -SIM_CPU_GAP_MAX_NS)
+        host_credit = -SIM_CPU_GAP_MAX_NS;
+
+    if (host_credit > 0)
+    {
+        sim_advance(host_credit * 1000 * sim_cpu_scale);
+        host_credit = 0;
+    }
+}
+
+static void resume_cpu(void)
+{
+    if (sim_cpu_scale > 0)
+        host_mark = host_ns();
+}
+
+static void calibrate_cpu(void)
+{
+    long long start = host_ns();
+    int i = 0;
+
+    for (; i < 100000; i++)
+        host_ns();
+
+    host_overhead = (host_ns() - start) / 100000;
+}
+
+sim_time_t sim_now(void)
+{
+    return now;
+}
+
+/*
+ * Ports.
+ */
+#define SIM_PORTS 7
+#define SIM_PORT_REGS 13
+
+typedef struct {
+    unsigned int tris;
+    unsigned int lat;
+    unsigned int ansel;
+} Sim_Port;
+
+static Sim_Port ports[SIM_PORTS] = {
+    {0xFFFF, 0, 0xFFFF}, {0xFFFF, 0, 0xFFFF}, {0xFFFF, 0, 0xFFFF}, {0xFFFF, 0, 0xFFFF},
+    {0xFFFF, 0, 0xFFFF}, {0xFFFF, 0, 0xFFFF}, {0xFFFF, 0, 0xFFFF}
+};
+
+#define PORT_A 0
+#define PORT_B 1
+#define PORT_C 2
+#define PORT_D 3
+#define PORT_E 4
+#define PORT_F 5
+#define PORT_G 6
+
+unsigned int sim_lat(char port)
+{
+    return ports[port - 'A'].lat;
+}
+
+unsigned int sim_tris(char port)
+{
+    return ports[port - 'A'].tris;
+}
+
+static unsigned int port_inputs(int port)
+{
+    switch (port)
+    {
+        case PORT_A: return sim_bus_data();
+        case PORT_B: return sim_bus_cmd_write() ? (1 << 5) : 0;
+        case PORT_E: return sim_nand_data();
+        case PORT_G: return sim_nand_ready() ? (1 << 9) : 0;
+    }
+
+    return 0;
+}
+
+static unsigned int port_read(int port)
+{
+    return (ports[port].lat & ~ports[port].tris) | (port_inputs(port) & ports[port].tris);
+}
+
+static bool sound_is_on = false;
+
+/*
+ * DAC's control port, CS, SDO and SCK on RB8 to RB10.
+ * The bits are shifted on the rising edges of SCK, MSB first, and the word
+ * latched on the rising edge of CS: the content on bits 15 to 2 and the
+ * register on bits 1 and 0.
+ */
+int sim_dac_registers[4];
+
+static unsigned int dac_word = 0;
+static int dac_bits = 0;
+static bool dac_cs = false;
+static bool dac_sck = false;
+
+static void dac_pins(void)
+{
+    unsigned int lat = ports[PORT_B].lat;
+    bool cs = (lat & (1 << 8)) ? true : false;
+    bool sck = (lat & (1 << 10)) ? true : false;
+
+    if (!cs && dac_cs)
+        dac_word = 0, dac_bits = 0;
+
+    if (!cs && sck && !dac_sck)
+        dac_word = (dac_word << 1) | ((lat >> 9) & 1), dac_bits++;
+
+    if (cs && !dac_cs && dac_bits == 16)
+        sim_dac_registers[dac_word & 3] = dac_word & 0xFFFC;
+
+    dac_cs = cs;
+    dac_sck = sck;
+}
+
+static void port_changed(int port)
+{
+    bool level;
+
+    switch (port)
+    {
+        case PORT_B:
+            sim_bus_pins();
+            dac_pins();
+            break;
+
+        case PORT_C:
+        case PORT_D:
+        case PORT_E:
+            sim_nand_pins();
+            break;
+
+        case PORT_G:
+            sim_nand_pins();
+
+            level = (ports[PORT_G].lat & (1 << 6)) ? true : false;
+            if (level != sound_is_on)
+            {
+                sound_is_on = level;
+                if (sim_sound_is_on_edge)
+                    sim_sound_is_on_edge(now, level);
+            }
+            break;
+    }
+}
+
+static unsigned int set_reg(unsigned int value, int op, unsigned int written)
+{
+    switch (op)
+    {
+        case 0: return written;
+        case 1: return value | written;
+        case 2: return value & ~written;
+        default: return value ^ written;
+    }
+}
+
+static void port_write(int port, int reg, unsigned int value)
+{
+    if (reg < 4)
+        ports[port].tris = set_reg(ports[port].tris, reg, value);
+    else if (reg < 8)
+        ports[port].lat = set_reg(ports[port].lat, reg - 4, value);
+    else if (reg == 8)
+        ports[port].lat = value;
+    else
+        ports[port].ansel = set_reg(ports[port].ansel, reg - 9, value);
+
+    port_changed(port);
+}
+
+static unsigned int port_reg_read(int port, int reg)
+{
+    switch (reg)
+    {
+        case 0: return ports[port].tris;
+        case 4: return ports[port].lat;
+        case 8: return port_read(port);
+        case 9: return ports[port].ansel;
+    }
+
+    /* The SET, CLR and INV registers read as 0 */
+    return 0;
+}
+
+/*
+ * Timers 2 and 3.
+ * They count PBCLK3 / prescaler from the value written on TMRx and match
+ * when TMRx reaches PRx, setting the interrupt flag and restarting from 0.
+ */
+#define TIMER_CLOCK_PS 325000LL     // PBCLK3, 200 MHz / 65
+#define TxCON_TON (1 << 15)
+
+typedef struct {
+    unsigned int con;
+    unsigned int pr;
+    unsigned int base;              // TMRx when the count started
+    sim_time_t start;
+    unsigned int flag;              // Bit on IFS0 and IEC0
+    void (*handler)(void);
+} Sim_Timer;
+
+static Sim_Timer timers[2] = {
+    {0, 0xFFFF, 0, 0, (1 << 9), timer2_handler},
+    {0, 0xFFFF, 0, 0, (1 << 14), timer3_handler}
+};
+
+static unsigned int ifs0 = 0;
+static unsigned int iec0 = 0;
+static unsigned int sfr_other[SFR_NUMBER];
+
+static sim_time_t timer_period(Sim_Timer *timer)
+{
+    static const int prescaler[8] = {1, 2, 4, 8, 16, 32, 64, 256};
+
+    return TIMER_CLOCK_PS * prescaler[(timer->con >> 4) & 7];
+}
+
+static unsigned int timer_count(Sim_Timer *timer)
+{
+    if (!(timer->con & TxCON_TON))
+        return timer->base;
+
+    return (timer->base + (now - timer->start) / timer_period(timer)) & 0xFFFF;
+}
+
+static sim_time_t timer_match(Sim_Timer *timer)
+{
+    long long counts;
+
+    if (!(timer->con & TxCON_TON))
+        return INT64_MAX;
+
+    counts = (timer->pr >= timer->base) ? timer->pr - timer->base + 1 : 0x10000 - timer->base + timer->pr + 1;
+
+    return timer->start + counts * timer_period(timer);
+}
+
+static void timer_write(Sim_Timer *timer, int reg, unsigned int value)
+{
+    switch (reg)
+    {
+        case 0:
+            if ((value ^ timer->con) & TxCON_TON)
+            {
+                if (value & TxCON_TON)
+                    timer->start = now;
+                else
+                    timer->base = timer_count(timer);
+            }
+            timer->con = value;
+            break;
+
+        case 1:
+            timer->base = value & 0xFFFF;
+            timer->start = now;
+            break;
+
+        case 2:
+            timer->pr = value & 0xFFFF;
+            break;
+    }
+}
+
+/*
+ * I2S.
+ * The DMA plays the queued buffers back to back. The driver's interrupt
+ * starts the next buffer when one completes, the SPI FIFO covers the latency
+ * of the interrupt up to SIM_I2S_FIFO_FRAMES. If the interrupt comes later, or
+ * there's nothing queued, the DMA starves until the next buffer.
+ */
+#define SIM_I2S_FIFO_FRAMES 2
+#define SIM_I2S_QUEUE QUEUE_SIZE_TX_IDX0
+
+typedef struct {
+    DRV_I2S_BUFFER_HANDLE handle;
+    int *buffer;
+    int frames;
+} Sim_I2S_Buffer;
+
+static Sim_I2S_Buffer i2s_queue[SIM_I2S_QUEUE];
+static int i2s_queued = 0;
+static bool i2s_is_playing = false;         // i2s_queue[0] is on the DMA
+static bool i2s_interrupt = false;          // i2s_queue[0] completed
+static sim_time_t i2s_start;
+static sim_time_t i2s_end;
+static DRV_I2S_BUFFER_HANDLE i2s_next_handle = 1;
+static DRV_I2S_BUFFER_EVENT_HANDLER i2s_handler = NULL;
+static uintptr_t i2s_context;
+static int i2s_divisor = 1;
+
+int sim_i2s_sample_rate(void)
+{
+    /* REFCLKO1 is the MCLK, 512 x 192 KHz divided by 2 x RODIV */
+    return i2s_divisor ? 192000 / (2 * i2s_divisor) : 192000;
+}
+
+static void i2s_play(sim_time_t start)
+{
+    int sample_rate = sim_i2s_sample_rate();
+
+    i2s_is_playing = true;
+    i2s_start = start;
+    i2s_end = start + (i2s_queue[0].frames * SIM_PS_PER_S + sample_rate / 2) / sample_rate;
+    sim_i2s_stats.sample_rate = sample_rate;
+}
+
+static void i2s_complete(void)
+{
+    Sim_I2S_Buffer *done = &i2s_queue[0];
+
+    sim_i2s_stats.buffers++;
+    sim_i2s_stats.frames += done->frames;
+
+    if (sim_i2s_capture)
+        sim_i2s_capture(i2s_start, sim_i2s_stats.sample_rate, done->buffer, done->frames);
+
+    i2s_is_playing = false;
+    i2s_interrupt = true;
+}
+
+/* The driver's interrupt */
+static void i2s_service(void)
+{
+    DRV_I2S_BUFFER_HANDLE handle = i2s_queue[0].handle;
+    sim_time_t end = i2s_end;
+
+    i2s_interrupt = false;
+    memmove(&i2s_queue[0], &i2s_queue[1], sizeof(Sim_I2S_Buffer) * --i2s_queued);
+
+    if (i2s_queued)
+    {
+        if (now - end <= (SIM_I2S_FIFO_FRAMES * SIM_PS_PER_S) / sim_i2s_sample_rate())
+        {
+            i2s_play(end);
+        }
+        else
+        {
+            sim_i2s_stats.starved++;
+            sim_i2s_stats.starved_time += now - end;
+            i2s_play(now);
+        }
+    }
+    else
+    {
+        sim_i2s_stats.starved++;
+        i2s_start = end;
+    }
+
+    if (i2s_handler)
+        i2s_handler(DRV_I2S_BUFFER_EVENT_COMPLETE, handle, i2s_context);
+}
+
+/*
+ * Interrupts.
+ */
+static bool interrupts_enabled = true;
+static bool in_interrupt = false;
+
+#define SIM_INTERRUPT_ENTRY_PS 300000LL     // Context saved by software
+
+static bool interrupt_is_pending(void)
+{
+    if (!interrupts_enabled || in_interrupt)
+        return false;
+
+    return i2s_interrupt || (ifs0 & iec0 & (timers[0].flag | timers[1].flag));
+}
+
+static void take_interrupt(void)
+{
+    in_interrupt = true;
+    now += SIM_INTERRUPT_ENTRY_PS;
+    resume_cpu();
+
+    if (i2s_interrupt)
+        i2s_service();
+    else if (ifs0 & iec0 & timers[0].flag)
+        timers[0].handler();
+    else
+        timers[1].handler();
+
+    charge_cpu();
+    commit_writes();
+    in_interrupt = false;
+}
+
+/* Next event of the peripherals */
+static sim_time_t next_event(void)
+{
+    sim_time_t event = INT64_MAX;
+    sim_time_t match;
+    int i = 0;
+
+    if (i2s_is_playing)
+        event = i2s_end;
+
+    for (; i < 2; i++)
+    {
+        match = timer_match(&timers[i]);
+        if (match < event)
+            event = match;
+    }
+
+    return event;
+}
+
+static void process_event(sim_time_t event)
+{
+    int i = 0;
+
+    if (i2s_is_playing && i2s_end == event)
+        i2s_complete();
+
+    for (; i < 2; i++)
+        if (timer_match(&timers[i]) == event)
+        {
+            ifs0 |= timers[i].flag;
+            timers[i].base = 0;
+            timers[i].start = event;
+        }
+}
+
+/* Advances the clock, taking the interrupts at the time they are raised */
+void sim_advance(sim_time_t ps)
+{
+    sim_time_t event;
+
+    for (;;)
+    {
+        if (interrupt_is_pending())
+        {
+            take_interrupt();
+            continue;
+        }
+
+        event = next_event();
+        if (event > now + ps)
+            break;
+
+        if (event > now)
+        {
+            ps -= event - now;
+            now = event;
+        }
+
+        process_event(event);
+    }
+
+    now += ps;
+}
+
+/*
+ * Registers.
+ * A small ring of scratch words is used, so an expression can read two
+ * registers. The words written are applied on the following accesses.
+ */
+#define SIM_SCRATCH 64
+#define SIM_SCRATCH_WINDOW 4
+
+typedef struct {
+    int sfr;
+    unsigned int loaded;
+    volatile unsigned int value;
+} Sim_Scratch;
+
+static Sim_Scratch scratch[SIM_SCRATCH];
+static int scratch_head = 0;
+
+static unsigned int sfr_read(int sfr)
+{
+    if (sfr < SFR_T2CON)
+        return port_reg_read(sfr / SIM_PORT_REGS, sfr % SIM_PORT_REGS);
+
+    switch (sfr)
+    {
+        case SFR_T2CON: return timers[0].con;
+        case SFR_TMR2: return timer_count(&timers[0]);
+        case SFR_PR2: return timers[0].pr;
+        case SFR_T3CON: return timers[1].con;
+        case SFR_TMR3: return timer_count(&timers[1]);
+        case SFR_PR3: return timers[1].pr;
+        case SFR_IFS0: return ifs0;
+        case SFR_IEC0: return iec0;
+    }
+
+    return sfr_other[sfr];
+}
+
+static void sfr_write(int sfr, unsigned int value)
+{
+    if (sfr < SFR_T2CON)
+    {
+        port_write(sfr / SIM_PORT_REGS, sfr % SIM_PORT_REGS, value);
+        return;
+    }
+
+    switch (sfr)
+    {
+        case SFR_T2CON: timer_write(&timers[0], 0, value); break;
+        case SFR_TMR2: timer_write(&timers[0], 1, value); break;
+        case SFR_PR2: timer_write(&timers[0], 2, value); break;
+        case SFR_T3CON: timer_write(&timers[1], 0, value); break;
+        case SFR_TMR3: timer_write(&timers[1], 1, value); break;
+        case SFR_PR3: timer_write(&timers[1], 2, value); break;
+        case SFR_IFS0: ifs0 = value; break;
+        case SFR_IEC0: iec0 = value; break;
+        default: sfr_other[sfr] = value; break;
+    }
+}
+
+static void commit_writes(void)
+{
+    int i = 1;
+    Sim_Scratch *word;
+
+    for (; i <= SIM_SCRATCH_WINDOW; i++)
+    {
+        word = &scratch[(scratch_head + SIM_SCRATCH - i) % SIM_SCRATCH];
+
+        if (word->sfr >= 0 && word->value != word->loaded)
+        {
+            word->loaded = word->value;
+            sfr_write(word->sfr, word->value);
+        }
+    }
+}
+
+volatile unsigned int * sim_sfr(int sfr)
+{
+    Sim_Scratch *word;
+
+    charge_cpu();
+    commit_writes();
+    sim_advance(SIM_SFR_PS);
+
+    word = &scratch[scratch_head];
+    scratch_head = (scratch_head + 1) % SIM_SCRATCH;
+
+    word->sfr = sfr;
+    word->loaded = sfr_read(sfr);
+    word->value = word->loaded;
+
+    resume_cpu();
+
+    return &word->value;
+}
+
+unsigned int sim_core_timer(void)
+{
+    unsigned int ticks;
+
+    charge_cpu();
+    commit_writes();
+    sim_advance(SIM_SFR_PS / 2);
+    ticks = now / SIM_PS_PER_TICK;
+    resume_cpu();
+
+    return ticks;
+}
+
+/*
+ * Harmony services.
+ */
+bool SYS_INT_Disable(void)
+{
+    bool enabled = interrupts_enabled;
+
+    charge_cpu();
+    commit_writes();
+    interrupts_enabled = false;
+    resume_cpu();
+
+    return enabled;
+}
+
+void SYS_INT_Restore(bool state)
+{
+    charge_cpu();
+    commit_writes();
+    interrupts_enabled = state;
+    sim_advance(0);
+    resume_cpu();
+}
+
+bool SYS_INT_StatusGetAndDisable(void)
+{
+    return SYS_INT_Disable();
+}
+
+RESET_REASON SYS_RESET_ReasonGet(void)
+{
+    return sim_reset_reason;
+}
+
+void SYS_RESET_ReasonClear(RESET_REASON reason)
+{
+}
+
+void SYS_RESET_SoftwareReset(void)
+{
+    printf("FAIL software reset at %.3f ms\n", (double)now / SIM_PS_PER_MS);
+    exit(2);
+}
+
+void PLIB_DMA_SuspendEnable(int index)
+{
+}
+
+void SYS_DEVCON_SystemUnlock(void)
+{
+}
+
+void SYS_DEVCON_SystemLock(void)
+{
+}
+
+void PLIB_OSC_ReferenceOscDivisorValueSet(OSC_MODULE_ID index, OSC_REFERENCE reference, int value)
+{
+    i2s_divisor = value;
+}
+
+void PLIB_OSC_ReferenceOscTrimSet(OSC_MODULE_ID index, OSC_REFERENCE reference, int value)
+{
+}
+
+DRV_HANDLE DRV_I2S_Open(int index, int intent)
+{
+    return 1;
+}
+
+void DRV_I2S_BufferEventHandlerSet(DRV_HANDLE handle, DRV_I2S_BUFFER_EVENT_HANDLER eventHandler, uintptr_t contextHandle)
+{
+    i2s_handler = eventHandler;
+    i2s_context = contextHandle;
+}
+
+void DRV_I2S_BufferAddWrite(DRV_HANDLE handle, DRV_I2S_BUFFER_HANDLE *bufferHandle, void *buffer, size_t size)
+{
+    bool enabled = interrupts_enabled;
+
+    /* Queued with the DMA's interrupt disabled */
+    charge_cpu();
+    commit_writes();
+    interrupts_enabled = false;
+    sim_advance(50 * SIM_SFR_PS);
+
+    if (i2s_queued == SIM_I2S_QUEUE)
+    {
+        *bufferHandle = DRV_I2S_BUFFER_HANDLE_INVALID;
+    }
+    else
+    {
+        *bufferHandle = i2s_next_handle++;
+
+        i2s_queue[i2s_queued].handle = *bufferHandle;
+        i2s_queue[i2s_queued].buffer = buffer;
+        i2s_queue[i2s_queued].frames = size / 8;
+
+        if (i2s_queued++ == 0)
+        {
+            if (sim_i2s_stats.buffers)
+                sim_i2s_stats.starved_time += now - i2s_start;
+            i2s_play(now);
+        }
+    }
+
+    interrupts_enabled = enabled;
+    sim_advance(0);
+    resume_cpu();
+}
+
+void DRV_I2S_BufferQueueFlush(DRV_HANDLE handle)
+{
+}
+
+/*
+ * USB device layer.
+ * The endpoints are served by upload.c.
+ */
+static USB_DEVICE_EVENT_HANDLER usb_handler = NULL;
+
+USB_DEVICE_HANDLE USB_DEVICE_Open(int index, int intent)
+{
+    return 1;
+}
+
+void USB_DEVICE_EventHandlerSet(USB_DEVICE_HANDLE handle, USB_DEVICE_EVENT_HANDLER callback, uintptr_t context)
+{
+    usb_handler = callback;
+}
+
+void USB_DEVICE_Attach(USB_DEVICE_HANDLE handle)
+{
+}
+
+void USB_DEVICE_Detach(USB_DEVICE_HANDLE handle)
+{
+}
+
+void USB_DEVICE_ControlStatus(USB_DEVICE_HANDLE handle, USB_DEVICE_CONTROL_STATUS status)
+{
+}
+
+void USB_DEVICE_ControlSend(USB_DEVICE_HANDLE handle, void *data, size_t length)
+{
+}
+
+USB_SPEED USB_DEVICE_ActiveSpeedGet(USB_DEVICE_HANDLE handle)
+{
+    return USB_SPEED_HIGH;
+}
+
+bool USB_DEVICE_EndpointIsEnabled(USB_DEVICE_HANDLE handle, USB_ENDPOINT_ADDRESS endpoint)
+{
+    return false;
+}
+
+void USB_DEVICE_EndpointEnable(USB_DEVICE_HANDLE handle, int interface, USB_ENDPOINT_ADDRESS endpoint, USB_TRANSFER_TYPE type, size_t size)
+{
+}
+
+void USB_DEVICE_EndpointDisable(USB_DEVICE_HANDLE handle, USB_ENDPOINT_ADDRESS endpoint)
+{
+}
+
+void USB_DEVICE_EndpointRead(USB_DEVICE_HANDLE handle, USB_DEVICE_TRANSFER_HANDLE *transferHandle, USB_ENDPOINT_ADDRESS endpoint, void *buffer, size_t size)
+{
+    sim_usb_read_armed(buffer, size);
+}
+
+void USB_DEVICE_EndpointWrite(USB_DEVICE_HANDLE handle, USB_DEVICE_TRANSFER_HANDLE *transferHandle, USB_ENDPOINT_ADDRESS endpoint, const void *buffer, size_t size, USB_DEVICE_TRANSFER_FLAGS flags)
+{
+    sim_usb_written(buffer, size);
+}
+
+/*
+ * Main loop.
+ */
+static sim_time_t loop_start = -1;
+
+static void step(void)
+{
+    if (loop_start >= 0)
+    {
+        sim_time_t loop = now - loop_start;
+
+        sim_loop_stats.loops++;
+        sim_loop_stats.loop_sum += loop;
+        if (loop > sim_loop_stats.loop_max)
+            sim_loop_stats.loop_max = loop;
+    }
+
+    loop_start = now;
+
+    if (sim_usb_poll() && usb_handler)
+        usb_handler(USB_DEVICE_EVENT_ENDPOINT_READ_COMPLETE, NULL, 0);
+
+    resume_cpu();
+    APP_Tasks();
+    charge_cpu();
+    commit_writes();
+
+    if (sim_cpu_scale <= 0)
+        sim_advance(SIM_LOOP_PS);
+}
+
+void sim_boot(void)
+{
+    static uint8_t configuration = 1;
+    char *scale = getenv("SIM_CPU_SCALE");
+
+    if (scale)
+        sim_cpu_scale = atof(scale);
+
+    if (sim_cpu_scale > 0)
+        calibrate_cpu();
+
+    if (sim_nand_blocks() == 0)
+        sim_nand_open(NULL, 4);
+
+    resume_cpu();
+    APP_Initialize();
+    charge_cpu();
+    commit_writes();
+
+    /* The host configures the device */
+    while (usb_handler == NULL)
+        step();
+    usb_handler(USB_DEVICE_EVENT_CONFIGURED, &configuration, 0);
+
+    while (appData.state != APP_STATE_MAIN_TASK)
+        step();
+
+    memset(&sim_loop_stats, 0, sizeof(sim_loop_stats));
+    loop_start = -1;
+}
+
+void sim_run_until(sim_time_t time)
+{
+    while (now < time)
+        step();
+}
+
+void sim_run_for(sim_time_t duration)
+{
+    sim_run_until(now + duration);
+}
+
+bool sim_run_while_not(bool (*condition)(void), sim_time_t timeout)
+{
+    sim_time_t end = now + timeout;
+
+    while (!condition())
+    {
+        if (now >= end)
+            return false;
+
+        step();
+    }
+
+    return true;
+}
+
+/*
+ * Reports.
+ */
+double sim_ticks_to_us(unsigned int ticks)
+{
+    return ticks * (double)SIM_PS_PER_TICK / SIM_PS_PER_US;
+}
+
+long long sim_bench_start(void)
+{
+    return host_ns();
+}
+
+double sim_bench_stop(const char *name, long long start, double units, const char *unit)
+{
+    double ns = (host_ns() - start) / units;
+    char label[64];
+
+    snprintf(label, sizeof(label), "host %s", name);
+    printf("  %-24s%9.1f ns/%s\n", label, ns, unit);
+
+    if (sim_cpu_scale > 0)
+    {
+        snprintf(label, sizeof(label), "PIC32 %s", name);
+        printf("  %-24s%9.1f ns/%s, %.0f cycles\n", label, ns * sim_cpu_scale, unit, ns * sim_cpu_scale * SIM_CPU_HZ / 1e9);
+    }
+
+    return ns;
+}
+
+void sim_report(const char *name)
+{
+    extern volatile unsigned int perf_trigger_latency_max;
+    extern volatile unsigned int perf_underruns;
+    extern unsigned int perf_loop_max;
+    extern unsigned int perf_sound_cache_hits;
+    extern unsigned int perf_sound_cache_misses;
+
+    printf("%s:\n", name);
+    printf("  trigger latency max     %9.1f us\n", sim_ticks_to_us(perf_trigger_latency_max));
+    printf("  underruns               %9u\n", perf_underruns);
+    printf("  I2S starved             %9llu (%.1f us)\n", (unsigned long long)sim_i2s_stats.starved, (double)sim_i2s_stats.starved_time / SIM_PS_PER_US);
+    printf("  main loop max           %9.1f us (firmware %.1f us)\n", (double)sim_loop_stats.loop_max / SIM_PS_PER_US, sim_ticks_to_us(perf_loop_max));
+    printf("  main loop mean          %9.2f us over %llu loops\n",
+           sim_loop_stats.loops ? (double)sim_loop_stats.loop_sum / sim_loop_stats.loops / SIM_PS_PER_US : 0.0,
+           (unsigned long long)sim_loop_stats.loops);
+    printf("  first page cache        %9u hits, %u misses\n", perf_sound_cache_hits, perf_sound_cache_misses);
+}
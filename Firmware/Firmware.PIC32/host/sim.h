@@ -0,0 +1,191 @@
+#ifndef SIM_H
+#define	SIM_H
+
+/*
+ * Host build of the PIC32 firmware.
+ * The application, the memory and the parallel bus are compiled unchanged and
+ * run against models of the hardware they talk to:
+ *   - A virtual core timer. Each register access costs SIM_SFR_PS and the code
+ *     between accesses costs its host time times sim_cpu_scale.
+ *   - An I2S driver that consumes the queued buffers at the sample rate set on
+ *     the reference oscillator and calls the buffer event handler.
+ *   - Timers 2 and 3 and their interrupts, driving SOUND_IS_ON.
+ *   - A NAND on the pins of memory.h, backed by a file.
+ *   - The DAC's control port, keeping the registers written.
+ *   - The ATXMEGA side of the parallel bus, playing a script of commands.
+ *   - The USB bulk endpoints, fed by the tests' commands.
+ * The interrupts are taken between register accesses, at the time they are
+ * raised, unless they are disabled.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Virtual time, in ps */
+typedef int64_t sim_time_t;
+
+#define SIM_PS_PER_US 1000000LL
+#define SIM_PS_PER_MS 1000000000LL
+#define SIM_PS_PER_S 1000000000000LL
+#define SIM_PS_PER_TICK 10000LL                 // Core timer, CPU_CT_HZ
+
+/* Cost of a register access on the peripheral bus */
+#define SIM_SFR_PS 20000LL
+
+/* Host time of the code between register accesses above this is taken as a
+ * preemption of the host and clamped.
+ */
+#define SIM_CPU_GAP_MAX_NS 50000LL
+
+/* Ratio between the PIC32MZ and the host running the same code, set with
+ * SIM_CPU_SCALE on the environment (~25 for a desktop). The host's clock is
+ * too noisy for the checks, so by default (0) the runs are deterministic: the
+ * code between accesses costs nothing and each main loop costs SIM_LOOP_PS.
+ */
+extern double sim_cpu_scale;
+
+#define SIM_LOOP_PS 1500000LL
+
+sim_time_t sim_now(void);
+void sim_advance(sim_time_t ps);
+
+/* Boots the firmware: memory, APP_Initialize() and the USB configuration */
+void sim_boot(void);
+
+/* Runs the main loop until the virtual time */
+void sim_run_until(sim_time_t time);
+void sim_run_for(sim_time_t duration);
+
+/* Runs the main loop until condition() is true or the timeout expires.
+ * Returns false on timeout.
+ */
+bool sim_run_while_not(bool (*condition)(void), sim_time_t timeout);
+
+/* Reset reason returned on the boot, the power on waits for the supplies */
+extern int sim_reset_reason;
+
+/* Main loop */
+typedef struct {
+    uint64_t loops;
+    sim_time_t loop_max;
+    sim_time_t loop_sum;
+} Sim_Loop_Stats;
+
+extern Sim_Loop_Stats sim_loop_stats;
+
+/* I2S */
+typedef struct {
+    uint64_t buffers;
+    uint64_t frames;
+    uint64_t starved;               // Buffers completed with nothing queued
+    sim_time_t starved_time;        // Time without a buffer on the DMA
+    int sample_rate;
+} Sim_I2S_Stats;
+
+extern Sim_I2S_Stats sim_i2s_stats;
+
+/* Called with each buffer once it is transmitted, first frame at start */
+typedef void (*Sim_I2S_Capture)(sim_time_t start, int sample_rate, const int *samples, int frames);
+extern Sim_I2S_Capture sim_i2s_capture;
+
+int sim_i2s_sample_rate(void);
+
+/* SOUND_IS_ON, called on each edge */
+typedef void (*Sim_Pin_Edge)(sim_time_t time, bool level);
+extern Sim_Pin_Edge sim_sound_is_on_edge;
+
+/* NAND, nand.c */
+#define SIM_NAND_PAGE_LENGTH (2048 + 64)
+#define SIM_NAND_PAGES_PER_BLOCK 64
+
+typedef struct {
+    uint64_t reads;
+    uint64_t spare_reads;           // Reads starting on the spare area
+    uint64_t programs;
+    uint64_t erases;
+    uint64_t program_failures;
+    uint64_t erase_failures;
+} Sim_NAND_Stats;
+
+extern Sim_NAND_Stats sim_nand_stats;
+
+/* Opens the NAND on path, created erased, or on a temporary file if NULL */
+void sim_nand_open(const char *path, int gbits);
+int sim_nand_blocks(void);
+void sim_nand_set_bad_block(int block);     // Factory mark
+void sim_nand_fail_erase(int block, int times);
+void sim_nand_fail_program(int page, int times);
+void sim_nand_flip_bit(int page, int byte, int bit);
+void sim_nand_read_raw(int page, unsigned char *data);      // Page and spare
+void sim_nand_write_raw(int page, const unsigned char *data);
+int sim_nand_block_erases(int block);
+
+void sim_nand_pins(void);
+unsigned int sim_nand_data(void);
+bool sim_nand_ready(void);
+
+/* Parallel bus, bus.c
+ * The commands are sent at their times, or as soon as the previous one is
+ * done, with the checksum computed by sim_bus_send().
+ */
+typedef struct {
+    sim_time_t queued;              // Time the command was due
+    sim_time_t first_byte;          // First byte latched by the PIC32
+    sim_time_t done;                // Reply of the last byte latched
+    bool error;
+    bool is_done;
+} Sim_Bus_Command;
+
+Sim_Bus_Command * sim_bus_send(sim_time_t time, const unsigned char *bytes, int length);
+Sim_Bus_Command * sim_bus_start(sim_time_t time, int index, int att_left, int att_right);
+Sim_Bus_Command * sim_bus_start_mixed(sim_time_t time, int index, int att_left, int att_right);
+Sim_Bus_Command * sim_bus_stop(sim_time_t time);
+bool sim_bus_is_idle(void);
+
+void sim_bus_pins(void);
+unsigned int sim_bus_data(void);
+bool sim_bus_cmd_write(void);
+
+/* USB, upload.c */
+void sim_usb_send(const void *command, int length);
+int sim_usb_receive(void *reply, int reply_length, sim_time_t timeout);
+int sim_usb_command(const void *command, int length, void *reply, int reply_length, sim_time_t timeout);
+int sim_upload_sound(int index, const int *samples, int length, int sample_rate, int data_type, int fade_length);
+int sim_upload_raw(int index, const void *data, int data_length, int sound_length, int sample_rate, int data_type, int fade_length);
+int sim_compress_sound(const int *samples, int length, unsigned char **stream);
+int sim_read_metadata(int index, int *sound_length, int *sample_rate, int *data_type);
+bool sim_sound_exists(int index);
+
+void sim_usb_read_armed(void *buffer, int size);
+void sim_usb_written(const void *buffer, int size);
+bool sim_usb_poll(void);
+
+/* Pins driven by the PIC32 */
+unsigned int sim_lat(char port);
+unsigned int sim_tris(char port);
+
+/* DAC's registers, as last written on its control port */
+extern int sim_dac_registers[4];
+
+/* Reports */
+double sim_ticks_to_us(unsigned int ticks);
+void sim_report(const char *name);
+
+/* Benches, timed on the host's clock around the runs of the code.
+ * The PIC32's time is estimated as the host's times sim_cpu_scale, so it's
+ * printed only with SIM_CPU_SCALE set, with its cycles at SIM_CPU_HZ. The
+ * estimate is as good as the scale, so the benches check the output of the
+ * code timed and never the times.
+ */
+#define SIM_CPU_HZ 200000000.0
+
+long long sim_bench_start(void);
+
+/* Prints the time of each unit run since start, returns the host's in ns */
+double sim_bench_stop(const char *name, long long start, double units, const char *unit);
+
+/* Tests */
+extern int sim_failures;
+#define SIM_CHECK(condition, ...) do { if (!(condition)) { sim_failures++; printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } } while (0)
+
+#endif	/* SIM_H */
@@ -0,0 +1,100 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "sim.h"
+
+/*
+ * Boots on the same memory at each stage of its life and reports the time
+ * taken to load the sounds' table and the first pages, and the reads it took.
+ * Each boot runs on its own process, like a reset of the board.
+ * Fails if a sound is missing after the boot.
+ */
+extern unsigned int perf_boot_memory;
+
+#define FRAMES 512
+#define TABLE_PAGES (8 * 64)
+
+static char path[] = "/tmp/bench_bootXXXXXX";
+static int *sound;
+
+static void upload(int first_index, int last_index)
+{
+    int index = first_index;
+
+    for (; index <= last_index; index++)
+        SIM_CHECK(sim_upload_sound(index, sound, FRAMES * 2, 96000, 0, 0) == 0, "upload of sound %d", index);
+}
+
+/* Boots, checks the sounds below sounds and runs stage() */
+static void boot(const char *name, int sounds, void (*stage)(void))
+{
+    pid_t pid = fork();
+    int status;
+
+    if (pid == 0)
+    {
+        Sim_NAND_Stats before;
+        int length, sample_rate, data_type;
+        int index = 2;
+
+        sim_nand_open(path, 4);
+        before = sim_nand_stats;
+        sim_boot();
+
+        printf("%s:\n", name);
+        printf("  boot memory             %9.1f us\n", sim_ticks_to_us(perf_boot_memory));
+        printf("  page reads              %9llu\n", (unsigned long long)(sim_nand_stats.reads - sim_nand_stats.spare_reads - before.reads + before.spare_reads));
+        printf("  spare reads             %9llu\n", (unsigned long long)(sim_nand_stats.spare_reads - before.spare_reads));
+
+        for (; index < sounds; index++)
+            SIM_CHECK(sim_read_metadata(index, &length, &sample_rate, &data_type) == 0 && length == FRAMES * 2,
+                      "sound %d missing on %s", index, name);
+
+        if (stage)
+            stage();
+
+        exit(sim_failures ? 1 : 0);
+    }
+
+    if (pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status))
+        sim_failures++;
+}
+
+static void fill(void)
+{
+    upload(2, 63);
+}
+
+/* Each upload saves the table, so it moves past all the table's pages */
+static void wrap(void)
+{
+    int round = 0;
+
+    for (; round < TABLE_PAGES / 62 + 1; round++)
+        upload(2, 63);
+}
+
+int main(void)
+{
+    int fd = mkstemp(path);
+    int i = 0;
+
+    if (fd < 0)
+        return 1;
+    close(fd);
+
+    sound = malloc(FRAMES * 2 * sizeof(int));
+    for (; i < FRAMES * 2; i++)
+        sound[i] = (i + 1) << 12;
+
+    boot("erased memory", 0, NULL);
+    boot("no sounds", 0, fill);
+    boot("62 sounds", 64, wrap);
+    boot("62 sounds, table wrapped", 64, NULL);
+
+    unlink(path);
+    free(sound);
+
+    return sim_failures ? 1 : 0;
+}
@@ -0,0 +1,82 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "sim.h"
+
+/*
+ * Plays compressed sounds at 192 KHz and reports the slowest page decoded,
+ * pages and reads included, and the decode time of a page already read.
+ * A tone takes the predictors and noise the verbatim frames.
+ * Fails if a page takes longer than it plays, the I2S starves or the page timed
+ * isn't the 24 bits of the original one.
+ */
+extern unsigned int perf_sound_decode_max;
+extern volatile unsigned int perf_underruns;
+
+void read_sound_page(int sound_index, int page_index, int *page);
+
+#define FRAMES 192000
+#define PAGE_PLAY_US (256 * 1000000.0 / 192000)
+#define DECODES 20000
+
+static void bench(const char *name, int index, const int *samples)
+{
+    unsigned char *stream;
+    int length = sim_compress_sound(samples, FRAMES * 2, &stream);
+    int page[512];
+    long long start;
+    uint64_t starved;
+    int i = 0;
+
+    SIM_CHECK(sim_upload_raw(index, stream, length, length / 4, 192000, 2, 0) == 0, "upload of %s", name);
+    free(stream);
+
+    sim_bus_start(sim_now(), index, 0, 0);
+    sim_run_for(10 * SIM_PS_PER_MS);
+
+    /* While the sound is being played */
+    perf_sound_decode_max = 0;
+    perf_underruns = 0;
+    sim_i2s_stats.starved = 0;
+    sim_run_for((sim_time_t)FRAMES * SIM_PS_PER_S / 192000 - 20 * SIM_PS_PER_MS);
+    starved = sim_i2s_stats.starved;
+    sim_run_for(50 * SIM_PS_PER_MS);
+
+    printf("%s:\n", name);
+    printf("  compression             %9.2f\n", (double)FRAMES * 2 * 4 / length);
+    printf("  decode max              %9.1f us\n", sim_ticks_to_us(perf_sound_decode_max));
+    printf("  I2S starved             %9d\n", (int)starved);
+
+    /* The same page, so only the decode is timed */
+    read_sound_page(index, 100, page);
+    start = sim_bench_start();
+    for (; i < DECODES; i++)
+        read_sound_page(index, 100, page);
+    sim_bench_stop("decode", start, DECODES, "page");
+
+    for (i = 0; i < 512 && page[i] == (samples[100 * 512 + i] & (int)0xFFFFFF00); i++);
+    SIM_CHECK(i == 512, "%s: sample %d of the page decoded is 0x%08X, 0x%08X expected", name, i, page[i % 512], samples[100 * 512 + i % 512] & (int)0xFFFFFF00);
+
+    SIM_CHECK(sim_ticks_to_us(perf_sound_decode_max) < PAGE_PLAY_US, "%s: a page decoded in %.1f us", name, sim_ticks_to_us(perf_sound_decode_max));
+    SIM_CHECK(perf_underruns == 0 && starved == 0, "%s: the I2S starved", name);
+}
+
+int main(void)
+{
+    int *samples = malloc(FRAMES * 2 * sizeof(int));
+    int i = 0;
+
+    sim_boot();
+
+    for (; i < FRAMES; i++)
+        samples[2 * i] = samples[2 * i + 1] = (int)(0x40000000 * sin(2 * M_PI * 1000 * i / 192000.0)) | 0x100;
+    bench("tone", 2, samples);
+
+    for (i = 0; i < FRAMES * 2; i++)
+        samples[i] = rand() * 2 | 0x100;
+    bench("noise", 3, samples);
+
+    free(samples);
+
+    return sim_failures ? 1 : 0;
+}
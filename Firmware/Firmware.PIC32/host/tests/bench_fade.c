@@ -0,0 +1,165 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "sim.h"
+
+/*
+ * Times the fade of a 512 samples buffer on the fade in, on the fade out and
+ * across the end of the fade in, for the shortest and the longest fades.
+ * Fails if a frame on a fade isn't multiplied by envelope_internal at its
+ * place on the fade, if a frame out of the fades is changed, or if an update
+ * of the attenuation doesn't step the DAC's volume along the envelope.
+ */
+extern uint16_t envelope_internal[];
+
+void audio_fade_chunk(int *buffer, int num_samples, int first_frame, int sound_frames, int fade_length);
+int audio_gain_from_attenuation(int attenuation);
+
+#define ENVELOPE_LENGTH (1024 * 32)
+#define SOUND_FRAMES 192000
+#define BUFFER_LEN 512
+#define RUNS 200000
+#define SAMPLE 0x40000000
+
+#define RAMP_LENGTH 1024
+
+/* Checks a frame faded from SAMPLE, k frames from the sound's edge.
+ * The envelope is read with a truncated step, so one entry before its place.
+ */
+static bool is_faded(int sample, int k, int fade_length)
+{
+    int place = (long long)k * ENVELOPE_LENGTH / fade_length;
+    int low = ((long long)SAMPLE * envelope_internal[place > 0 ? place - 1 : 0]) >> 15;
+    int high = ((long long)SAMPLE * envelope_internal[place]) >> 15;
+
+    return sample >= low && sample <= high;
+}
+
+static void bench(const char *name, int first_frame, int fade_length)
+{
+    static int buffer[BUFFER_LEN];
+    long long start;
+    int faded = 0;
+    int frame;
+    int i = 0;
+
+    for (; i < BUFFER_LEN; i++)
+        buffer[i] = SAMPLE;
+    audio_fade_chunk(buffer, BUFFER_LEN, first_frame, SOUND_FRAMES, fade_length);
+
+    for (i = 0; i < BUFFER_LEN; i++)
+    {
+        frame = first_frame + i / 2;
+
+        if (frame < fade_length)
+            SIM_CHECK(is_faded(buffer[i], frame, fade_length), "%s: 0x%08X on frame %d of the fade in", name, buffer[i], frame);
+        else if (frame >= SOUND_FRAMES - fade_length)
+            SIM_CHECK(is_faded(buffer[i], SOUND_FRAMES - 1 - frame, fade_length), "%s: 0x%08X on frame %d of the fade out", name, buffer[i], frame);
+        else
+            SIM_CHECK(buffer[i] == SAMPLE, "%s: frame %d out of the fades changed", name, frame);
+
+        if (buffer[i] != SAMPLE)
+            faded++;
+    }
+
+    printf("%s, %d frames:\n", name, fade_length);
+    printf("  samples faded           %9d\n", faded);
+
+    start = sim_bench_start();
+    for (i = 0; i < RUNS; i++)
+        audio_fade_chunk(buffer, BUFFER_LEN, first_frame, SOUND_FRAMES, fade_length);
+    sim_bench_stop("fade", start, RUNS, "buffer");
+}
+
+/* Content of the DAC's volume register for a Q30 gain */
+static int volume(int gain)
+{
+    return (int)(((long long)gain * ((1 << 14) - 1)) >> 30) << 2;
+}
+
+/* Volume register on a frame of the ramp from 0 dB to an attenuation */
+static int ramp_volume(int attenuation, int frame)
+{
+    int gain = audio_gain_from_attenuation(attenuation);
+
+    if (frame >= RAMP_LENGTH)
+        return volume(gain);
+
+    return volume((1 << 30) + (((long long)(gain - (1 << 30)) * envelope_internal[frame * (ENVELOPE_LENGTH / RAMP_LENGTH)]) >> 15));
+}
+
+/*
+ * Updates the attenuation of a tone from 0 dB. Each channel's volume must step
+ * down the envelope, a step per buffer, and end on the attenuation.
+ */
+static void check_ramp(int att_left, int att_right)
+{
+    unsigned char bytes[6] = {0xF9, att_left & 0xFF, att_left >> 8, att_right & 0xFF, att_right >> 8, 0};
+    int attenuations[2] = {att_left, att_right};
+    int frames[2] = {0, 0};
+    int steps[2] = {0, 0};
+    bool off[2] = {false, false};
+    int channel;
+    int value;
+    int i = 0;
+
+    sim_bus_start(sim_now(), 1000, 0, 0);
+    sim_run_for(20 * SIM_PS_PER_MS);
+
+    SIM_CHECK(sim_dac_registers[2] == volume(1 << 30) && sim_dac_registers[3] == volume(1 << 30), "volume of the tone not set");
+
+    sim_bus_send(sim_now(), bytes, sizeof(bytes));
+
+    for (; i < 1000; i++)
+    {
+        sim_run_for(20 * SIM_PS_PER_US);
+
+        for (channel = 0; channel < 2; channel++)
+        {
+            value = sim_dac_registers[2 + channel];
+
+            if (off[channel] || value == ramp_volume(attenuations[channel], frames[channel]))
+                continue;
+
+            /* The next frame on the envelope with this volume */
+            while (frames[channel] < RAMP_LENGTH && ramp_volume(attenuations[channel], frames[channel]) != value)
+                frames[channel]++;
+
+            off[channel] = ramp_volume(attenuations[channel], frames[channel]) != value;
+            SIM_CHECK(!off[channel], "volume 0x%04X off the ramp on channel %d", value, channel);
+            steps[channel]++;
+        }
+    }
+
+    printf("attenuation ramp, %d and %d:\n", att_left, att_right);
+    printf("  steps                   %9d\n", steps[0]);
+
+    for (channel = 0; channel < 2; channel++)
+    {
+        SIM_CHECK(steps[channel] > 1, "volume of channel %d in %d steps", channel, steps[channel]);
+        SIM_CHECK(sim_dac_registers[2 + channel] == ramp_volume(attenuations[channel], RAMP_LENGTH), "ramp of channel %d not ended", channel);
+    }
+
+    sim_bus_stop(sim_now());
+    sim_run_for(20 * SIM_PS_PER_MS);
+}
+
+int main(void)
+{
+    static const int fade_lengths[2] = {BUFFER_LEN / 2, 32768};
+    int i = 0;
+
+    /* Populates the envelope */
+    sim_boot();
+
+    for (; i < 2; i++)
+    {
+        bench("fade in", 0, fade_lengths[i]);
+        bench("fade out", SOUND_FRAMES - BUFFER_LEN / 2, fade_lengths[i]);
+        bench("end of the fade in", fade_lengths[i] - BUFFER_LEN / 4, fade_lengths[i]);
+    }
+
+    check_ramp(200, 400);
+
+    return sim_failures ? 1 : 0;
+}
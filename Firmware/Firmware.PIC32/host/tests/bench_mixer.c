@@ -0,0 +1,101 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "sim.h"
+
+/*
+ * Plays a sound with 0 to AUDIO_MIX_VOICES sounds mixed on top, at each
+ * sample rate, and reports the main loop time and the NAND reads per buffer.
+ * The reads count the sound's prefetch each time it is issued again after a
+ * voice's page. Fails if the I2S starves while the voices are playing.
+ */
+extern volatile unsigned int perf_trigger_latency_max;
+extern volatile unsigned int perf_underruns;
+extern unsigned int perf_loop_max;
+
+#define FRAMES 96000
+#define VOICES 3
+
+static int *make_tone(int sample_rate, int frequency)
+{
+    int *samples = malloc(FRAMES * 2 * sizeof(int));
+    int i = 0;
+
+    for (; i < FRAMES; i++)
+        samples[2 * i] = samples[2 * i + 1] = (int)(0x10000000 * sin(2 * M_PI * frequency * i / sample_rate));
+
+    return samples;
+}
+
+static void play(int first_index, int sample_rate, int voices)
+{
+    sim_time_t duration = (sim_time_t)FRAMES * SIM_PS_PER_S / sample_rate;
+    uint64_t reads;
+    uint64_t buffers;
+    int voice = 0;
+    char name[48];
+
+    perf_trigger_latency_max = 0;
+    perf_underruns = 0;
+    perf_loop_max = 0;
+    sim_loop_stats = (Sim_Loop_Stats){0};
+    sim_i2s_stats.starved = 0;
+    sim_i2s_stats.starved_time = 0;
+
+    sim_bus_start(sim_now(), first_index, 0, 0);
+    sim_run_for(2 * SIM_PS_PER_MS);
+
+    /* Starts the voices once the sound is being played */
+    for (; voice < voices; voice++)
+    {
+        Sim_Bus_Command *start = sim_bus_start_mixed(sim_now(), first_index + 1 + voice, 60, 60);
+
+        sim_run_for(SIM_PS_PER_MS);
+        SIM_CHECK(start->is_done && !start->error, "voice %d on sound %d", voice, first_index + 1 + voice);
+    }
+
+    reads = sim_nand_stats.reads;
+    buffers = sim_i2s_stats.buffers;
+    sim_run_for(duration / 2);
+    reads = sim_nand_stats.reads - reads;
+    buffers = sim_i2s_stats.buffers - buffers;
+
+    snprintf(name, sizeof(name), "%d Hz, %d voices", sample_rate, voices);
+    sim_report(name);
+    printf("  NAND reads per buffer   %9.2f\n", buffers ? (double)reads / buffers : 0.0);
+
+    SIM_CHECK(perf_underruns == 0, "%u underruns at %d Hz with %d voices", perf_underruns, sample_rate, voices);
+    SIM_CHECK(sim_i2s_stats.starved == 0, "I2S starved %d times at %d Hz with %d voices", (int)sim_i2s_stats.starved, sample_rate, voices);
+
+    sim_bus_stop(sim_now());
+    sim_run_for(10 * SIM_PS_PER_MS);
+}
+
+int main(void)
+{
+    static const int sample_rates[2] = {96000, 192000};
+    int rate = 0;
+    int index;
+    int voices;
+
+    sim_boot();
+
+    /* Sounds 2 to 5 at 96 kHz and 6 to 9 at 192 kHz */
+    for (; rate < 2; rate++)
+    {
+        for (index = 0; index < VOICES + 1; index++)
+        {
+            int *tone = make_tone(sample_rates[rate], 500 + 250 * index);
+
+            SIM_CHECK(sim_upload_sound(2 + 4 * rate + index, tone, FRAMES * 2, sample_rates[rate], 0, 0) == 0,
+                      "upload of sound %d", 2 + 4 * rate + index);
+            free(tone);
+        }
+    }
+
+    for (rate = 0; rate < 2; rate++)
+        for (voices = 0; voices <= VOICES; voices++)
+            play(2 + 4 * rate, sample_rates[rate], voices);
+
+    return sim_failures ? 1 : 0;
+}
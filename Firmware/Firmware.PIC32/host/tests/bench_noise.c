@@ -0,0 +1,168 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "sim.h"
+
+/*
+ * Times each noise generator on buffers of 256 frames, a noise sample per
+ * frame copied to both channels. The band-pass noise runs both filters, from
+ * 300 Hz to 3 KHz.
+ * Fails if a noise doesn't start, its spectrum is off its shape, or 40000
+ * plays a noise. The white noise is flat, the pink one falls 10 dB a decade
+ * and the band-pass one is 3 dB down on its edges and 20 dB out of the band.
+ */
+extern bool noise_gen_is_on;
+extern int noise_type;
+extern int noise_low_frequency;
+extern int noise_high_frequency;
+extern int current_sample_rate;
+
+bool proc_noise_generator(int *buffer, int num_samples);
+
+#define BUFFER_LEN 512
+#define RUNS 20000
+
+/* Spectrum, averaged over BLOCKS Hann windowed blocks of BLOCK_LEN frames */
+#define BLOCK_LEN 16384
+#define BLOCKS 16
+#define BINS 9
+
+static double window[BLOCK_LEN];
+static double *noise;
+
+/* Power on a bin of a block, Goertzel */
+static double bin_power(const double *block, int bin)
+{
+    double coefficient = 2 * cos(2 * M_PI * bin / BLOCK_LEN);
+    double s0, s1 = 0, s2 = 0;
+    int i = 0;
+
+    for (; i < BLOCK_LEN; i++)
+    {
+        s0 = block[i] * window[i] + coefficient * s1 - s2;
+        s2 = s1;
+        s1 = s0;
+    }
+
+    return s1 * s1 + s2 * s2 - coefficient * s1 * s2;
+}
+
+/* Power density around a frequency, in dB */
+static double density(double frequency)
+{
+    int center = frequency * BLOCK_LEN / current_sample_rate + 0.5;
+    double power = 0;
+    int block = 0;
+    int bin;
+
+    for (; block < BLOCKS; block++)
+        for (bin = center - BINS / 2; bin <= center + BINS / 2; bin++)
+            power += bin_power(noise + block * BLOCK_LEN, bin);
+
+    return 10 * log10(power / (BLOCKS * BINS));
+}
+
+/* Generates the blocks from the noise being played, the left channel */
+static void generate(void)
+{
+    static int buffer[BUFFER_LEN];
+    int frame = 0;
+    int i;
+
+    for (; frame < BLOCKS * BLOCK_LEN; frame += BUFFER_LEN / 2)
+    {
+        proc_noise_generator(buffer, BUFFER_LEN);
+
+        for (i = 0; i < BUFFER_LEN; i += 2)
+            noise[frame + i / 2] = buffer[i];
+    }
+}
+
+static void check_spectrum(const char *name, int index)
+{
+    double reference, low, high;
+
+    generate();
+
+    switch (index)
+    {
+        case 40001:
+            reference = density(1000);
+            low = density(100) - reference;
+            high = density(20000) - reference;
+            printf("  100 Hz, 20 KHz          %9.1f dB, %.1f dB of 1 KHz\n", low, high);
+            SIM_CHECK(fabs(low) < 1.5 && fabs(high) < 1.5, "%s noise not flat", name);
+            break;
+
+        case 40002:
+            reference = density(100);
+            low = density(1000) - reference;
+            high = density(10000) - reference;
+            printf("  1 KHz, 10 KHz           %9.1f dB, %.1f dB of 100 Hz\n", low, high);
+            SIM_CHECK(fabs(low + 10) < 2 && fabs(high + 20) < 3, "%s noise not -10 dB a decade", name);
+            break;
+
+        default:
+            reference = density(1000);
+            low = density(noise_low_frequency) - reference;
+            high = density(noise_high_frequency) - reference;
+            printf("  edges                   %9.1f dB, %.1f dB of 1 KHz\n", low, high);
+            SIM_CHECK(fabs(low + 3) < 1.5 && fabs(high + 3) < 1.5, "%s noise not 3 dB down on its edges", name);
+
+            low = density(noise_low_frequency / 4) - reference;
+            high = density(noise_high_frequency * 4) - reference;
+            printf("  2 octaves out           %9.1f dB, %.1f dB of 1 KHz\n", low, high);
+            SIM_CHECK(low < -20 && high < -20, "%s noise not 20 dB down out of its band", name);
+            break;
+    }
+}
+
+static void bench(const char *name, int index)
+{
+    static int buffer[BUFFER_LEN];
+    long long start;
+    int i = 0;
+
+    sim_bus_start(sim_now(), index, 0, 0);
+    sim_run_for(20 * SIM_PS_PER_MS);
+
+    SIM_CHECK(noise_gen_is_on && noise_type == index, "%s noise not started", name);
+
+    printf("%s noise:\n", name);
+    check_spectrum(name, index);
+
+    start = sim_bench_start();
+    for (; i < RUNS; i++)
+        proc_noise_generator(buffer, BUFFER_LEN);
+    sim_bench_stop("noise", start, (double)RUNS * (BUFFER_LEN / 2), "frame");
+}
+
+int main(void)
+{
+    int i = 0;
+
+    noise_low_frequency = 300;
+    noise_high_frequency = 3000;
+
+    noise = malloc(BLOCKS * BLOCK_LEN * sizeof(double));
+    for (; i < BLOCK_LEN; i++)
+        window[i] = 0.5 - 0.5 * cos(2 * M_PI * i / BLOCK_LEN);
+
+    sim_boot();
+
+    bench("white", 40001);
+    bench("pink", 40002);
+    bench("band-pass", 40003);
+
+    /* Between the tones and the noises */
+    sim_bus_stop(sim_now());
+    sim_run_for(20 * SIM_PS_PER_MS);
+    sim_bus_start(sim_now(), 40000, 0, 0);
+    sim_run_for(20 * SIM_PS_PER_MS);
+
+    SIM_CHECK(!noise_gen_is_on, "40000 played a noise");
+
+    free(noise);
+
+    return sim_failures ? 1 : 0;
+}
@@ -0,0 +1,162 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "sim.h"
+
+/*
+ * Times the tone generator against the CORDIC one it replaced, on buffers of
+ * 256 frames of a 1 KHz tone. The DDS fills both channels and the CORDIC
+ * filled only the right one.
+ * Fails if a second of the tone isn't a sine of 1 KHz at -6 dBFS on both
+ * channels, without jumps of phase between the buffers.
+ */
+extern bool sine_gen_is_on;
+extern int current_sample_rate;
+
+bool proc_sinewave_generator(int *buffer, int num_samples);
+
+#define BUFFER_LEN 512
+#define RUNS 20000
+#define FREQUENCY 1000
+#define AMPLITUDE (1 << 30)
+
+/* The generator before the DDS, with 12 iterations @ 96 KHz */
+#define cordic_1K 0x26DD3B6A
+#define half_pi 0x6487ED51
+#define CORDIC_ITERACTIONS 12
+
+static const int cordic_ctab[] = {
+    0x3243F6A8, 0x1DAC6705, 0x0FADBAFC, 0x07F56EA6, 0x03FEAB76, 0x01FFD55B,
+    0x00FFFAAA, 0x007FFF55, 0x003FFFEA, 0x001FFFFD, 0x000FFFFF, 0x0007FFFF
+};
+
+static float right_tetha = 0;
+static int right_mult = 1;
+
+static int cordic(int theta, int n)
+{
+    int k, d, tx, ty, tz;
+    int x = cordic_1K, y = 0, z = theta;
+
+    for (k = 0; k < n; ++k)
+    {
+        d = z >> 31;
+        tx = x - (((y >> k) ^ d) - d);
+        ty = y + (((x >> k) ^ d) - d);
+        tz = z - ((cordic_ctab[k] ^ d) - d);
+        x = tx; y = ty; z = tz;
+    }
+
+    return y;
+}
+
+static void proc_cordic_generator(int *buffer, int num_samples, int frequency)
+{
+    int i = 0;
+
+    for (; i < num_samples / 2; i++)
+    {
+        right_tetha = right_tetha + (right_mult) * (half_pi / (96000.0 / (frequency << 2)));
+
+        if (right_tetha > half_pi)
+        {
+            right_mult = -1;
+            right_tetha = half_pi - (right_tetha - half_pi);
+        }
+        if (right_tetha < -half_pi)
+        {
+            right_mult = 1;
+            right_tetha = -half_pi - (right_tetha + half_pi);
+        }
+
+        buffer[i * 2 + 1] = cordic((int)(right_tetha), CORDIC_ITERACTIONS);
+    }
+}
+
+/*
+ * Generates a second of the tone and fits it to a sine of FREQUENCY. The
+ * residual is the error of the table's interpolation, and a drift of the
+ * frequency or a jump of the phase between buffers adds to it.
+ */
+static void check_tone(void)
+{
+    static int buffer[BUFFER_LEN];
+    int frames = current_sample_rate;
+    double *left = malloc(frames * sizeof(double));
+    double w = 2 * M_PI * FREQUENCY / current_sample_rate;
+    double in_phase = 0, quadrature = 0;
+    double amplitude, phase, error, residual = 0;
+    int mismatches = 0;
+    int frame = 0;
+    int i;
+
+    for (; frame < frames; frame += BUFFER_LEN / 2)
+    {
+        proc_sinewave_generator(buffer, BUFFER_LEN);
+
+        for (i = 0; i < BUFFER_LEN; i += 2)
+        {
+            left[frame + i / 2] = buffer[i];
+            if (buffer[i + 1] != buffer[i])
+                mismatches++;
+        }
+    }
+
+    /* A whole number of cycles */
+    for (frame = 0; frame < frames; frame++)
+    {
+        in_phase += left[frame] * sin(w * frame);
+        quadrature += left[frame] * cos(w * frame);
+    }
+    amplitude = 2 * sqrt(in_phase * in_phase + quadrature * quadrature) / frames;
+    phase = atan2(quadrature, in_phase);
+
+    for (frame = 0; frame < frames; frame++)
+    {
+        error = left[frame] - amplitude * sin(w * frame + phase);
+        residual += error * error;
+    }
+    residual = 20 * log10(sqrt(2 * residual / frames) / amplitude);
+
+    printf("tone of %d Hz @ %d Hz:\n", FREQUENCY, current_sample_rate);
+    printf("  amplitude               %9.4f of -6 dBFS\n", amplitude / AMPLITUDE);
+    printf("  residual                %9.1f dB\n", residual);
+
+    SIM_CHECK(fabs(amplitude / AMPLITUDE - 1) < 1e-3, "amplitude of the tone %.4f of -6 dBFS", amplitude / AMPLITUDE);
+    SIM_CHECK(residual < -80, "tone %.1f dB off a sine of %d Hz", residual, FREQUENCY);
+    SIM_CHECK(mismatches == 0, "%d frames with the right channel off the left one", mismatches);
+
+    free(left);
+}
+
+int main(void)
+{
+    static int buffer[BUFFER_LEN];
+    long long start;
+    double dds_ns, cordic_ns;
+    int i = 0;
+
+    sim_boot();
+    sim_bus_start(sim_now(), FREQUENCY, 0, 0);
+    sim_run_for(5 * SIM_PS_PER_MS);
+
+    SIM_CHECK(sine_gen_is_on, "tone not started");
+
+    check_tone();
+
+    printf("DDS, both channels:\n");
+    start = sim_bench_start();
+    for (; i < RUNS; i++)
+        proc_sinewave_generator(buffer, BUFFER_LEN);
+    dds_ns = sim_bench_stop("DDS", start, (double)RUNS * (BUFFER_LEN / 2), "frame");
+
+    printf("CORDIC, right channel:\n");
+    start = sim_bench_start();
+    for (i = 0; i < RUNS; i++)
+        proc_cordic_generator(buffer, BUFFER_LEN, FREQUENCY);
+    cordic_ns = sim_bench_stop("CORDIC", start, (double)RUNS * (BUFFER_LEN / 2), "frame");
+
+    printf("CORDIC / DDS              %9.2f\n", cordic_ns / dds_ns);
+
+    return sim_failures ? 1 : 0;
+}
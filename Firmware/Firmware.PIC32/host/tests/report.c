@@ -0,0 +1,109 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "sim.h"
+
+/*
+ * Plays a sound at each sample rate, started and stopped on the parallel bus,
+ * and reports the trigger to first sample latency, the underruns and the main
+ * loop time. Fails if the I2S starves while a sound is playing.
+ */
+extern volatile unsigned int perf_trigger_latency_max;
+extern volatile unsigned int perf_underruns;
+extern unsigned int perf_loop_max;
+
+static sim_time_t first_sample = -1;
+
+static void capture(sim_time_t start, int sample_rate, const int *samples, int frames)
+{
+    int i = 0;
+
+    if (first_sample >= 0)
+        return;
+
+    for (; i < frames; i++)
+        if (samples[2 * i] || samples[2 * i + 1])
+        {
+            first_sample = start + i * SIM_PS_PER_S / sample_rate;
+            return;
+        }
+}
+
+static int *make_tone(int sample_rate, int frames)
+{
+    int *samples = malloc(frames * 2 * sizeof(int));
+    int i = 0;
+
+    for (; i < frames; i++)
+        samples[2 * i] = samples[2 * i + 1] = (int)(0x40000000 * cos(2 * M_PI * 1000 * i / sample_rate));
+
+    return samples;
+}
+
+static void play(int index, int sample_rate)
+{
+    const int triggers = 20;
+    sim_time_t latency_sum = 0;
+    sim_time_t latency_max = 0;
+    int trigger = 0;
+    char name[32];
+
+    perf_trigger_latency_max = 0;
+    perf_underruns = 0;
+    perf_loop_max = 0;
+    sim_loop_stats = (Sim_Loop_Stats){0};
+    sim_i2s_stats.starved = 0;
+    sim_i2s_stats.starved_time = 0;
+    sim_i2s_capture = capture;
+
+    for (; trigger < triggers; trigger++)
+    {
+        Sim_Bus_Command *start;
+        sim_time_t latency;
+
+        /* Triggers at different phases of the DMA buffers */
+        sim_run_for(17 * SIM_PS_PER_MS + trigger * 331 * SIM_PS_PER_US);
+
+        first_sample = -1;
+        start = sim_bus_start(sim_now(), index, 0, 0);
+        sim_run_for(80 * SIM_PS_PER_MS);
+
+        SIM_CHECK(start->is_done && !start->error, "start of sound %d", index);
+        SIM_CHECK(first_sample >= 0, "sound %d not played", index);
+
+        latency = first_sample - start->first_byte;
+        latency_sum += latency;
+        if (latency > latency_max)
+            latency_max = latency;
+
+        sim_bus_stop(sim_now());
+        sim_run_for(10 * SIM_PS_PER_MS);
+    }
+
+    snprintf(name, sizeof(name), "%d Hz", sample_rate);
+    sim_report(name);
+    printf("  command to first sample %9.1f us mean, %.1f us max\n",
+           (double)latency_sum / triggers / SIM_PS_PER_US, (double)latency_max / SIM_PS_PER_US);
+
+    SIM_CHECK(perf_underruns == 0, "%u underruns at %d Hz", perf_underruns, sample_rate);
+    SIM_CHECK(sim_i2s_stats.starved == 0, "I2S starved %d times at %d Hz", (int)sim_i2s_stats.starved, sample_rate);
+}
+
+int main(void)
+{
+    int *tone_96 = make_tone(96000, 96000);
+    int *tone_192 = make_tone(192000, 96000);
+
+    sim_boot();
+
+    SIM_CHECK(sim_upload_sound(2, tone_96, 96000 * 2, 96000, 0, 0) == 0, "upload of sound 2");
+    SIM_CHECK(sim_upload_sound(3, tone_192, 96000 * 2, 192000, 0, 0) == 0, "upload of sound 3");
+
+    play(2, 96000);
+    play(3, 192000);
+
+    free(tone_96);
+    free(tone_192);
+
+    return sim_failures ? 1 : 0;
+}
@@ -0,0 +1,153 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "sim.h"
+
+/*
+ * A compressed sound plays the 24 bits of the original one. The uploads with
+ * an index too short for the sound or longer than the stream fail, and a
+ * corrupted frame plays its page as silence without affecting the others: a
+ * bad mode, an index entry out of the sound and a unary run to the page's end.
+ */
+#define ERROR_BADSOUNDLENGTH -1021
+
+#define PAGES 40
+#define FRAMES (PAGES * 256)
+#define PAGE_LEN 2048
+
+static int *sound;
+static int *played;
+static int played_frames = 0;
+
+static void capture(sim_time_t start, int sample_rate, const int *samples, int frames)
+{
+    int i = 0;
+
+    for (; i < frames; i++)
+    {
+        if (played_frames == 0 && samples[2 * i] == 0 && samples[2 * i + 1] == 0)
+            continue;
+
+        if (played_frames < FRAMES)
+        {
+            played[2 * played_frames] = samples[2 * i];
+            played[2 * played_frames + 1] = samples[2 * i + 1];
+        }
+        played_frames++;
+    }
+}
+
+static unsigned int get_entry(const unsigned char *stream, int frame)
+{
+    unsigned int entry;
+
+    memcpy(&entry, stream + 16 + frame * 4, 4);
+
+    return entry;
+}
+
+static void set_int(unsigned char *stream, int offset, unsigned int value)
+{
+    memcpy(stream + offset, &value, 4);
+}
+
+/* Plays the stream, returns the pages that don't match or aren't silent */
+static int play(const unsigned char *stream, int length, const bool *silent)
+{
+    Sim_Bus_Command *start;
+    int mismatches = 0;
+    int page = 0;
+    int i;
+
+    SIM_CHECK(sim_upload_raw(2, stream, length, length / 4, 96000, 2, 0) == 0, "upload of the compressed sound");
+
+    played_frames = 0;
+    start = sim_bus_start(sim_now(), 2, 0, 0);
+    sim_run_for((sim_time_t)FRAMES * SIM_PS_PER_S / 96000 + 50 * SIM_PS_PER_MS);
+
+    SIM_CHECK(start->is_done && !start->error, "start of the compressed sound");
+    SIM_CHECK(played_frames >= FRAMES, "%d of %d frames played", played_frames, FRAMES);
+
+    for (; page < PAGES; page++)
+        for (i = page * 512; i < (page + 1) * 512; i++)
+            if (played[i] != (silent[page] ? 0 : (sound[i] & 0xFFFFFF00)))
+            {
+                printf("  page %d: 0x%08X played on sample %d, 0x%08X expected\n", page, played[i], i,
+                       silent[page] ? 0 : (sound[i] & 0xFFFFFF00));
+                mismatches++;
+                break;
+            }
+
+    return mismatches;
+}
+
+int main(void)
+{
+    bool silent[PAGES] = {false};
+    unsigned char *stream;
+    unsigned char *corrupted;
+    unsigned int entry;
+    int length;
+    int frame;
+    int i = 0;
+
+    sound = malloc(FRAMES * 2 * sizeof(int));
+    played = malloc(FRAMES * 2 * sizeof(int));
+
+    /* A tone, silence, noise and a full scale square */
+    for (; i < FRAMES; i++)
+    {
+        int page = i / 256;
+
+        if (page < 10)
+            sound[2 * i] = sound[2 * i + 1] = (int)(0x40000000 * sin(2 * M_PI * 1000 * i / 96000.0)) | 0x100;
+        else if (page < 15)
+            sound[2 * i] = sound[2 * i + 1] = 0;
+        else if (page < 20)
+            sound[2 * i] = rand(), sound[2 * i + 1] = rand() * 2;
+        else
+            sound[2 * i] = sound[2 * i + 1] = ((i / 37) & 1) ? 0x7FFFFF00 : (int)0x80000000;
+    }
+
+    length = sim_compress_sound(sound, FRAMES * 2, &stream);
+    corrupted = malloc(length);
+
+    sim_i2s_capture = capture;
+    sim_boot();
+
+    SIM_CHECK(play(stream, length, silent) == 0, "compressed sound");
+
+    /* The index must have a frame per page decoded, within the stream */
+    memcpy(corrupted, stream, length);
+    set_int(corrupted, 8, PAGES - 1);
+    SIM_CHECK(sim_upload_raw(3, corrupted, length, length / 4, 96000, 2, 0) == ERROR_BADSOUNDLENGTH, "index shorter than the sound");
+    set_int(corrupted, 8, length / 4 - 3);
+    SIM_CHECK(sim_upload_raw(3, corrupted, length, length / 4, 96000, 2, 0) == ERROR_BADSOUNDLENGTH, "index longer than the stream");
+
+    /* A bad mode, and a page out of the sound */
+    memcpy(corrupted, stream, length);
+    entry = get_entry(stream, 5);
+    corrupted[(entry >> 11) * PAGE_LEN + (entry & 0x7FF)] = 9;
+    silent[5] = true;
+    set_int(corrupted, 16 + 8 * 4, get_entry(stream, 8) + (1000 << 11));
+    silent[8] = true;
+
+    /* The last frame of a page never ends its unary run */
+    for (frame = 20; frame < PAGES - 1; frame++)
+        if (get_entry(stream, frame) >> 11 != get_entry(stream, frame + 1) >> 11)
+            break;
+    entry = get_entry(stream, frame);
+    memset(corrupted + (entry >> 11) * PAGE_LEN + (entry & 0x7FF), 0, PAGE_LEN - (entry & 0x7FF));
+    silent[frame] = true;
+
+    SIM_CHECK(play(corrupted, length, silent) == 0, "corrupted frames");
+
+    free(stream);
+    free(corrupted);
+    free(sound);
+    free(played);
+    printf("%s\n", sim_failures ? "FAILED" : "OK");
+
+    return sim_failures ? 1 : 0;
+}
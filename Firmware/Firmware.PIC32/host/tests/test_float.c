@@ -0,0 +1,106 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "sim.h"
+
+/*
+ * A float sound is converted on the upload: +/-1.0 is the 24 bits full scale
+ * on the top of the I2S word, the values out of range are clipped and NaN is
+ * 0. The edge values are checked on the metadata command and on each data
+ * command, the others within the float's rounding.
+ */
+#define FRAMES 12288                // Metadata and two data commands
+#define CHUNK_FRAMES (32768 / 8)
+
+static float *sound;
+static int *played;
+static int played_frames = 0;
+
+static void capture(sim_time_t start, int sample_rate, const int *samples, int frames)
+{
+    int i = 0;
+
+    for (; i < frames; i++)
+    {
+        if (played_frames == 0 && samples[2 * i] == 0 && samples[2 * i + 1] == 0)
+            continue;
+
+        if (played_frames < FRAMES)
+        {
+            played[2 * played_frames] = samples[2 * i];
+            played[2 * played_frames + 1] = samples[2 * i + 1];
+        }
+        played_frames++;
+    }
+}
+
+static int expected(float value)
+{
+    double sample = (double)value * 8388607.0;
+
+    if (value != value)
+        return 0;
+    if (sample > 8388607.0)
+        return 8388607 * 256;
+    if (sample < -8388608.0)
+        return -8388608 * 256;
+
+    return (int)lround(sample) * 256;
+}
+
+int main(void)
+{
+    static const float edges[] = {
+        1.0f, -1.0f, 0.0f, -0.0f, 1.0000001f, -1.0000001f, 2.0f, -2.0f, 1e30f, -1e30f,
+        INFINITY, -INFINITY, NAN, -NAN, 1e-9f, -1e-9f, 3.0f / 8388607.0f, -3.0f / 8388607.0f, 0.999999f, -0.999999f
+    };
+    const int n_edges = sizeof(edges) / sizeof(edges[0]);
+    Sim_Bus_Command *start;
+    int mismatches = 0;
+    int chunk = 0;
+    int i = 0;
+
+    sound = malloc(FRAMES * 2 * sizeof(float));
+    played = malloc(FRAMES * 2 * sizeof(int));
+
+    /* Never 0 on the first frame, so it is found */
+    for (; i < FRAMES * 2; i++)
+        sound[i] = (float)sin(i * 0.001) * 1.2f + 0.001f;
+
+    /* The edges on the first frames of each command */
+    for (; chunk < FRAMES / CHUNK_FRAMES; chunk++)
+        for (i = 0; i < n_edges; i++)
+            sound[chunk * CHUNK_FRAMES * 2 + 2 + i] = edges[i];
+
+    sim_i2s_capture = capture;
+    sim_boot();
+
+    SIM_CHECK(sim_upload_raw(2, sound, FRAMES * 2 * sizeof(float), FRAMES * 2, 96000, 1, 0) == 0, "upload of the float sound");
+
+    start = sim_bus_start(sim_now(), 2, 0, 0);
+    sim_run_for((sim_time_t)FRAMES * SIM_PS_PER_S / 96000 + 50 * SIM_PS_PER_MS);
+
+    SIM_CHECK(start->is_done && !start->error, "start of the float sound");
+    SIM_CHECK(played_frames >= FRAMES, "%d of %d frames played", played_frames, FRAMES);
+
+    for (chunk = 0; chunk < FRAMES / CHUNK_FRAMES; chunk++)
+        for (i = 0; i < n_edges; i++)
+        {
+            int index = chunk * CHUNK_FRAMES * 2 + 2 + i;
+
+            SIM_CHECK(played[index] == expected(edges[i]), "%g played as 0x%08X on command %d, 0x%08X expected",
+                      edges[i], played[index], chunk, expected(edges[i]));
+        }
+
+    for (i = 0; i < FRAMES * 2; i++)
+        if (abs(played[i] - expected(sound[i])) > 256)
+            mismatches++;
+    SIM_CHECK(mismatches == 0, "%d samples differ by more than an LSB", mismatches);
+
+    free(sound);
+    free(played);
+    printf("%s\n", sim_failures ? "FAILED" : "OK");
+
+    return sim_failures ? 1 : 0;
+}
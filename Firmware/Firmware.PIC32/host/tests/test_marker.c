@@ -0,0 +1,100 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+
+/*
+ * SOUND_IS_ON rises with the first non-zero frame of a sound and falls after
+ * its last one, both delayed by the DAC's output latency, also when the sound
+ * starts or ends with silence or fits in a single buffer.
+ */
+#define TOLERANCE_US 10
+
+static sim_time_t first_frame;          // First non-zero frame on the I2S
+static sim_time_t last_frame_end;       // End of the last non-zero frame
+static sim_time_t marker_on;
+static sim_time_t marker_off;
+static int edges;
+
+static void capture(sim_time_t start, int sample_rate, const int *samples, int frames)
+{
+    int i = 0;
+
+    for (; i < frames; i++)
+    {
+        if (samples[2 * i] == 0 && samples[2 * i + 1] == 0)
+            continue;
+
+        if (first_frame < 0)
+            first_frame = start + i * SIM_PS_PER_S / sample_rate;
+        last_frame_end = start + (i + 1) * SIM_PS_PER_S / sample_rate;
+    }
+}
+
+static void sound_is_on(sim_time_t time, bool level)
+{
+    edges++;
+
+    if (level && marker_on < 0)
+        marker_on = time;
+    if (!level && marker_off < 0)
+        marker_off = time;
+}
+
+/* Frames of silence, frames of sound and frames of silence */
+static void play(int index, int sample_rate, int latency_frames, int leading, int frames, int trailing)
+{
+    int length = leading + frames + trailing;
+    int *sound = calloc(length * 2, sizeof(int));
+    sim_time_t latency = latency_frames * SIM_PS_PER_S / sample_rate;
+    sim_time_t duration = (sim_time_t)length * SIM_PS_PER_S / sample_rate;
+    Sim_Bus_Command *start;
+    int i = 0;
+
+    for (; i < frames; i++)
+        sound[2 * (leading + i)] = sound[2 * (leading + i) + 1] = 0x10000000;
+
+    SIM_CHECK(sim_upload_sound(index, sound, length * 2, sample_rate, 0, 0) == 0, "upload of sound %d", index);
+
+    first_frame = last_frame_end = -1;
+    marker_on = marker_off = -1;
+    edges = 0;
+
+    start = sim_bus_start(sim_now(), index, 0, 0);
+    sim_run_for(duration + 50 * SIM_PS_PER_MS);
+
+    SIM_CHECK(start->is_done && !start->error, "start of sound %d", index);
+    SIM_CHECK(first_frame >= 0, "sound %d not played", index);
+    SIM_CHECK(edges == 2, "%d edges on sound %d (%d + %d + %d frames)", edges, index, leading, frames, trailing);
+
+    SIM_CHECK(llabs(marker_on - first_frame - latency) < TOLERANCE_US * SIM_PS_PER_US,
+              "%d Hz, %d + %d + %d frames: SOUND_IS_ON rises %.1f us after the first frame, %.1f us expected",
+              sample_rate, leading, frames, trailing, (double)(marker_on - first_frame) / SIM_PS_PER_US, (double)latency / SIM_PS_PER_US);
+    SIM_CHECK(llabs(marker_off - last_frame_end - latency) < TOLERANCE_US * SIM_PS_PER_US,
+              "%d Hz, %d + %d + %d frames: SOUND_IS_ON falls %.1f us after the last frame, %.1f us expected",
+              sample_rate, leading, frames, trailing, (double)(marker_off - last_frame_end) / SIM_PS_PER_US, (double)latency / SIM_PS_PER_US);
+
+    free(sound);
+}
+
+int main(void)
+{
+    sim_i2s_capture = capture;
+    sim_sound_is_on_edge = sound_is_on;
+
+    sim_boot();
+
+    /* Output latency of 21 frames @ 96KHz and 9 frames @ 192KHz */
+    play(2, 96000, 21, 0, 4000, 0);
+    play(3, 96000, 21, 700, 4000, 500);      // Silence past the first buffer
+    play(4, 96000, 21, 10, 100, 20);         // A single buffer
+    play(8, 96000, 21, 300, 100, 600);       // Both edges on the same buffer
+    play(5, 192000, 9, 0, 4000, 0);
+    play(6, 192000, 9, 700, 4000, 500);
+    play(7, 192000, 9, 10, 100, 20);
+    play(9, 192000, 9, 300, 100, 600);
+
+    printf("%s\n", sim_failures ? "FAILED" : "OK");
+
+    return sim_failures ? 1 : 0;
+}
@@ -0,0 +1,118 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "memory.h"
+
+/*
+ * The data phase moves the same bytes as the NAND's array: the pages and
+ * spares programmed are found on the array as they were given, and the reads
+ * return the array's bytes, on the page, on the spare areas of any length and
+ * on the reads started and finished apart.
+ */
+extern unsigned int ecc_corrected_bits;
+extern unsigned int ecc_uncorrectable_sectors;
+
+#define PAGE_LEN 2048
+#define SPARE_LEN 64
+#define ECC_SPARE_OFFSET 16
+#define ECC_MARK 0xA5
+#define PAGES 8
+
+static void fill_random(unsigned char *bytes, int length)
+{
+    int i = 0;
+
+    for (; i < length; i++)
+        bytes[i] = rand();
+}
+
+/* Programs random pages and finds them on the array */
+static void check_programs(int first_page)
+{
+    unsigned char page[PAGE_LEN];
+    unsigned char spare[ECC_SPARE_OFFSET];
+    unsigned char raw[SIM_NAND_PAGE_LENGTH];
+    int i = 0;
+    int j;
+
+    for (; i < PAGES; i++)
+    {
+        fill_random(page, PAGE_LEN);
+        fill_random(spare, ECC_SPARE_OFFSET);
+
+        if (i & 1)
+        {
+            program_memory_without_spare(first_page + i, page);
+            sim_nand_read_raw(first_page + i, raw);
+            SIM_CHECK(memcmp(raw, page, PAGE_LEN) == 0, "page programmed without the spare differs on page %d", i);
+        }
+        else
+        {
+            program_memory(first_page + i, page, spare);
+            sim_nand_read_raw(first_page + i, raw);
+            SIM_CHECK(memcmp(raw, page, PAGE_LEN) == 0, "page programmed differs on page %d", i);
+            SIM_CHECK(memcmp(raw + PAGE_LEN, spare, ECC_SPARE_OFFSET) == 0, "spare programmed differs on page %d", i);
+
+            for (j = 0; j < 4; j++)
+                SIM_CHECK(raw[PAGE_LEN + ECC_SPARE_OFFSET + 4 * j + 3] == ECC_MARK, "ECC mark %d missing on page %d", j, i);
+        }
+    }
+}
+
+/* Writes random pages on the array, without the ECC mark, and reads them */
+static void check_reads(int first_page)
+{
+    unsigned char raw[SIM_NAND_PAGE_LENGTH];
+    unsigned char page[PAGE_LEN];
+    unsigned char spare[SPARE_LEN];
+    int length;
+    int i = 0;
+
+    for (; i < PAGES; i++)
+    {
+        fill_random(raw, SIM_NAND_PAGE_LENGTH);
+        memset(raw + PAGE_LEN + ECC_SPARE_OFFSET, 0xFF, 16);
+        sim_nand_write_raw(first_page + i, raw);
+
+        memset(page, 0, PAGE_LEN);
+        memset(spare, 0, SPARE_LEN);
+        read_memory(first_page + i, page, spare);
+        SIM_CHECK(memcmp(page, raw, PAGE_LEN) == 0, "page read differs on page %d", i);
+        SIM_CHECK(memcmp(spare, raw + PAGE_LEN, SPARE_LEN) == 0, "spare read differs on page %d", i);
+
+        memset(page, 0, PAGE_LEN);
+        read_memory_without_spare(first_page + i, page);
+        SIM_CHECK(memcmp(page, raw, PAGE_LEN) == 0, "page read without the spare differs on page %d", i);
+
+        memset(page, 0, PAGE_LEN);
+        read_memory_start(first_page + i);
+        while (!read_memory_check());
+        SIM_CHECK(read_memory_finish(page) && memcmp(page, raw, PAGE_LEN) == 0, "page read apart differs on page %d", i);
+
+        for (length = 4; length <= SPARE_LEN; length += 4)
+        {
+            memset(spare, 0, SPARE_LEN);
+            read_memory_spare(first_page + i, spare, length);
+            SIM_CHECK(memcmp(spare, raw + PAGE_LEN, length) == 0, "%d bytes of the spare differ on page %d", length, i);
+        }
+    }
+}
+
+int main(void)
+{
+    int block;
+
+    sim_boot();
+    block = sim_nand_blocks() - 2;
+
+    block_erase(block);
+    check_programs(block * SIM_NAND_PAGES_PER_BLOCK);
+    check_reads((block + 1) * SIM_NAND_PAGES_PER_BLOCK);
+
+    SIM_CHECK(ecc_corrected_bits == 0 && ecc_uncorrectable_sectors == 0, "ECC corrected %u bits", ecc_corrected_bits);
+
+    printf("%s\n", sim_failures ? "FAILED" : "OK");
+
+    return sim_failures ? 1 : 0;
+}
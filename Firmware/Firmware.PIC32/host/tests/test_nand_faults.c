@@ -0,0 +1,274 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include "sim.h"
+
+/*
+ * Failed programs and erases, and the bad blocks found on the first use.
+ * A sound with a failed page is removed and the upload fails, a failed erase
+ * or table page moves to another block, and the table survives a reboot.
+ * Each boot runs on its own process, like a reset of the board.
+ */
+extern unsigned int sound_table_bad_blocks_lost;
+
+#define ERROR_BADSOUNDINDEX -1020
+#define ERROR_MEMORYWRITE -1026
+
+#define PAGES_PER_BLOCK SIM_NAND_PAGES_PER_BLOCK
+#define TABLE_FIRST_BLOCK 64
+#define SOUNDS_FIRST_BLOCK 72        // First extent on an empty table
+#define SLOT_BLOCKS 64               // Fixed slots of the previous versions
+
+#define FRAMES 12288                 // Metadata and two data commands
+
+static char path[] = "/tmp/test_nand_faultsXXXXXX";
+static int *sound;
+
+static int *played;
+static int played_frames;
+
+static void capture(sim_time_t start, int sample_rate, const int *samples, int frames)
+{
+    int i = 0;
+
+    for (; i < frames; i++)
+    {
+        if (played_frames == 0 && samples[2 * i] == 0 && samples[2 * i + 1] == 0)
+            continue;
+
+        if (played_frames < FRAMES)
+        {
+            played[2 * played_frames] = samples[2 * i];
+            played[2 * played_frames + 1] = samples[2 * i + 1];
+        }
+        played_frames++;
+    }
+}
+
+static int upload(int index)
+{
+    return sim_upload_sound(index, sound, FRAMES * 2, 96000, 0, 0);
+}
+
+static bool sound_plays(int index)
+{
+    played_frames = 0;
+    sim_i2s_capture = capture;
+    sim_bus_start(sim_now(), index, 0, 0);
+    sim_run_for((sim_time_t)FRAMES * SIM_PS_PER_S / 96000 + 50 * SIM_PS_PER_MS);
+    sim_i2s_capture = NULL;
+
+    return played_frames >= FRAMES && memcmp(played, sound, FRAMES * 2 * sizeof(int)) == 0;
+}
+
+/* Erases the memory, runs setup() before the first boot */
+static void erase(void (*setup)(void))
+{
+    int fd = open(path, O_RDWR | O_TRUNC);
+
+    close(fd);
+
+    if (setup)
+    {
+        sim_nand_open(path, 4);
+        setup();
+    }
+}
+
+/* Boots on its own process and runs stage() */
+static void boot(const char *name, void (*stage)(void))
+{
+    pid_t pid = fork();
+    int status;
+
+    if (pid == 0)
+    {
+        sim_failures = 0;
+        sim_nand_open(path, 4);
+        sim_boot();
+        stage();
+
+        if (sim_failures)
+            printf("  on %s\n", name);
+        exit(sim_failures ? 1 : 0);
+    }
+
+    if (pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status))
+        sim_failures++;
+}
+
+/* A page of the second data command */
+static void fail_data_page(void)
+{
+    sim_nand_fail_program(SOUNDS_FIRST_BLOCK * PAGES_PER_BLOCK + 16 + 5, 1);
+
+    SIM_CHECK(upload(2) == ERROR_MEMORYWRITE, "upload with a failed data page");
+    SIM_CHECK(!sim_sound_exists(2), "sound with a failed data page kept");
+}
+
+/* A page programmed by the metadata command */
+static void fail_metadata_page(void)
+{
+    SIM_CHECK(upload(3) == 0, "upload of sound 3");
+
+    sim_nand_fail_program((SOUNDS_FIRST_BLOCK + 1) * PAGES_PER_BLOCK + 3, 1);
+
+    SIM_CHECK(upload(2) == ERROR_MEMORYWRITE, "upload with a failed metadata page");
+    SIM_CHECK(!sim_sound_exists(2), "sound with a failed metadata page kept");
+    SIM_CHECK(sim_sound_exists(3), "other sound removed");
+}
+
+/* The removal and the bad block were saved, the block isn't used again */
+static void upload_after_failure(void)
+{
+    SIM_CHECK(!sim_sound_exists(2), "sound with a failed page back after the reboot");
+
+    SIM_CHECK(upload(2) == 0, "upload after a failed page");
+    SIM_CHECK(sim_nand_block_erases(SOUNDS_FIRST_BLOCK) == 0, "failed block erased again");
+    SIM_CHECK(sound_plays(2), "sound after a failed page");
+}
+
+/* The page after the one saved on the boot */
+static void fail_table_page(void)
+{
+    sim_nand_fail_program(TABLE_FIRST_BLOCK * PAGES_PER_BLOCK + 1, 1);
+
+    SIM_CHECK(upload(2) == 0, "upload with a failed table page");
+    SIM_CHECK(sim_nand_block_erases(TABLE_FIRST_BLOCK + 1) == 1, "table not moved to the next block");
+}
+
+static void fail_erase(void)
+{
+    sim_nand_fail_erase(SOUNDS_FIRST_BLOCK, 1);
+
+    SIM_CHECK(upload(2) == 0, "upload with a failed erase");
+    SIM_CHECK(sound_plays(2), "sound with a remapped block");
+}
+
+static void check_sound(void)
+{
+    SIM_CHECK(sim_sound_exists(2), "sound lost on the reboot");
+    SIM_CHECK(sound_plays(2), "sound after the reboot");
+}
+
+static void bad_index(void)
+{
+    SIM_CHECK(upload(64) == ERROR_BADSOUNDINDEX, "upload to index 64");
+    SIM_CHECK(upload(-1) == ERROR_BADSOUNDINDEX, "upload to index -1");
+    SIM_CHECK(upload(2) == 0, "upload after a bad index");
+}
+
+/*
+ * A sound of the previous versions on slot 2, with 0x00 on all the spare
+ * areas and its metadata on the first one. The slot's next block was written
+ * by a longer sound. Slot 5 has a block of an aborted upload and slot 1 a
+ * block of the sounds under index 2, both with a spare of 0x00, and are
+ * erased. A factory bad block is kept as it is.
+ */
+static void write_slots(void)
+{
+    unsigned char page[SIM_NAND_PAGE_LENGTH];
+    int metadata[4] = {2, FRAMES * 2, 96000, 0};
+    int i = 0;
+
+    for (; i < 2 * PAGES_PER_BLOCK; i++)
+    {
+        memset(page, 0, sizeof(page));
+        if (i < FRAMES * 2 * 4 / 2048)
+            memcpy(page, (unsigned char*)sound + i * 2048, 2048);
+        if (i == 0)
+            memcpy(page + 2048, metadata, sizeof(metadata));
+
+        sim_nand_write_raw(2 * SLOT_BLOCKS * PAGES_PER_BLOCK + i, page);
+    }
+
+    memset(page, 0, sizeof(page));
+    sim_nand_write_raw(5 * SLOT_BLOCKS * PAGES_PER_BLOCK + 7 * PAGES_PER_BLOCK, page);
+    sim_nand_write_raw(SLOT_BLOCKS * PAGES_PER_BLOCK + 40 * PAGES_PER_BLOCK, page);
+
+    sim_nand_set_bad_block(2000);
+}
+
+static void check_slots(void)
+{
+    unsigned char page[SIM_NAND_PAGE_LENGTH];
+
+    check_sound();
+
+    SIM_CHECK(sim_nand_block_erases(2 * SLOT_BLOCKS) == 0, "sound's block erased");
+    SIM_CHECK(sim_nand_block_erases(2 * SLOT_BLOCKS + 1) == 1, "block of the slot erased %d times", sim_nand_block_erases(2 * SLOT_BLOCKS + 1));
+    SIM_CHECK(sim_nand_block_erases(5 * SLOT_BLOCKS + 7) == 1, "block of an aborted upload erased %d times", sim_nand_block_erases(5 * SLOT_BLOCKS + 7));
+    SIM_CHECK(sim_nand_block_erases(SLOT_BLOCKS + 40) == 1, "block of slot 1 erased %d times", sim_nand_block_erases(SLOT_BLOCKS + 40));
+    SIM_CHECK(sim_nand_block_erases(2000) == 0, "factory bad block erased");
+
+    sim_nand_read_raw(5 * SLOT_BLOCKS * PAGES_PER_BLOCK + 7 * PAGES_PER_BLOCK, page);
+    SIM_CHECK(page[2048] == 0xFF, "block of an aborted upload kept its mark");
+    sim_nand_read_raw(SLOT_BLOCKS * PAGES_PER_BLOCK + 40 * PAGES_PER_BLOCK, page);
+    SIM_CHECK(page[2048] == 0xFF, "block of slot 1 kept its mark");
+    sim_nand_read_raw(2000 * PAGES_PER_BLOCK, page);
+    SIM_CHECK(page[2048] != 0xFF, "factory mark lost");
+}
+
+static void mark_bad_blocks(void)
+{
+    int i = 0;
+
+    for (; i < 90; i++)
+        sim_nand_set_bad_block(100 + 3 * i);
+}
+
+static void check_bad_blocks_lost(void)
+{
+    SIM_CHECK(sound_table_bad_blocks_lost == 10, "%u bad blocks lost, 10 expected", sound_table_bad_blocks_lost);
+}
+
+int main(void)
+{
+    int fd = mkstemp(path);
+    int i = 0;
+
+    if (fd < 0)
+        return 1;
+    close(fd);
+
+    sound = malloc(FRAMES * 2 * sizeof(int));
+    played = malloc(FRAMES * 2 * sizeof(int));
+    for (; i < FRAMES * 2; i++)
+        sound[i] = ((i * 2654435761u) | 0x100) & 0xFFFFFF00;
+
+    erase(NULL);
+    boot("failed data page", fail_data_page);
+    boot("reboot after a failed data page", upload_after_failure);
+
+    erase(NULL);
+    boot("failed metadata page", fail_metadata_page);
+    boot("reboot after a failed metadata page", upload_after_failure);
+
+    erase(NULL);
+    boot("failed table page", fail_table_page);
+    boot("reboot after a failed table page", check_sound);
+
+    erase(NULL);
+    boot("failed erase", fail_erase);
+    boot("reboot after a failed erase", check_sound);
+
+    erase(NULL);
+    boot("bad index", bad_index);
+
+    erase(write_slots);
+    boot("sound on a slot", check_slots);
+
+    erase(mark_bad_blocks);
+    boot("bad blocks", check_bad_blocks_lost);
+
+    unlink(path);
+    free(sound);
+    free(played);
+
+    printf("%s\n", sim_failures ? "FAILED" : "OK");
+
+    return sim_failures ? 1 : 0;
+}
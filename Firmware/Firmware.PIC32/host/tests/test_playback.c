@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+
+/*
+ * A sound uploaded on USB and started on the parallel bus is played sample
+ * by sample, at its sample rate, and SOUND_IS_ON covers it.
+ */
+#define FRAMES 40000
+
+static int *played;
+static int played_frames = 0;
+static sim_time_t played_start = -1;
+static sim_time_t marker_on = -1;
+static sim_time_t marker_off = -1;
+
+static void capture(sim_time_t start, int sample_rate, const int *samples, int frames)
+{
+    int i = 0;
+
+    for (; i < frames; i++)
+    {
+        if (played_frames == 0 && samples[2 * i] == 0 && samples[2 * i + 1] == 0)
+            continue;
+
+        if (played_frames == 0)
+            played_start = start + i * SIM_PS_PER_S / sample_rate;
+
+        if (played_frames < FRAMES)
+        {
+            played[2 * played_frames] = samples[2 * i];
+            played[2 * played_frames + 1] = samples[2 * i + 1];
+        }
+        played_frames++;
+    }
+}
+
+static void sound_is_on(sim_time_t time, bool level)
+{
+    if (level && marker_on < 0)
+        marker_on = time;
+    if (!level && marker_on >= 0 && marker_off < 0)
+        marker_off = time;
+}
+
+static void play(int index, int sample_rate)
+{
+    int *sound = malloc(FRAMES * 2 * sizeof(int));
+    Sim_Bus_Command *start;
+    sim_time_t duration = (sim_time_t)FRAMES * SIM_PS_PER_S / sample_rate;
+    int mismatches = 0;
+    int i = 0;
+
+    /* Never 0, so the first sample is found */
+    for (; i < FRAMES * 2; i++)
+        sound[i] = ((rand() & 0xFFFFFF) | 1) << 8;
+
+    SIM_CHECK(sim_upload_sound(index, sound, FRAMES * 2, sample_rate, 0, 0) == 0, "upload of sound %d", index);
+
+    played_frames = 0;
+    marker_on = marker_off = -1;
+    start = sim_bus_start(sim_now(), index, 0, 0);
+    sim_run_for(duration + 50 * SIM_PS_PER_MS);
+
+    SIM_CHECK(start->is_done && !start->error, "start of sound %d", index);
+    SIM_CHECK(played_frames >= FRAMES, "%d of %d frames played", played_frames, FRAMES);
+    SIM_CHECK(sim_i2s_stats.sample_rate == sample_rate, "played at %d Hz", sim_i2s_stats.sample_rate);
+
+    for (i = 0; i < FRAMES * 2; i++)
+        if (played[i] != sound[i])
+            mismatches++;
+    SIM_CHECK(mismatches == 0, "%d samples of sound %d differ", mismatches, index);
+
+    /* The marker follows the DAC's output, so it comes after the I2S */
+    SIM_CHECK(marker_on >= played_start && marker_on - played_start < 300 * SIM_PS_PER_US,
+              "SOUND_IS_ON rises %.1f us after the first sample", (double)(marker_on - played_start) / SIM_PS_PER_US);
+    SIM_CHECK(marker_off > marker_on && llabs(marker_off - marker_on - duration) < 300 * SIM_PS_PER_US,
+              "SOUND_IS_ON lasts %.3f ms for %.3f ms", (double)(marker_off - marker_on) / SIM_PS_PER_MS, (double)duration / SIM_PS_PER_MS);
+
+    free(sound);
+}
+
+int main(void)
+{
+    played = malloc(FRAMES * 2 * sizeof(int));
+    sim_i2s_capture = capture;
+    sim_sound_is_on_edge = sound_is_on;
+
+    sim_boot();
+
+    play(2, 96000);
+    play(5, 192000);
+
+    free(played);
+    printf("%s\n", sim_failures ? "FAILED" : "OK");
+
+    return sim_failures ? 1 : 0;
+}
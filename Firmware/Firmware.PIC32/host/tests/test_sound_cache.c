@@ -0,0 +1,105 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+
+/*
+ * The head-of-sound cache keeps the first page of the 16 sounds used last.
+ * A sound plays the same whether its first page is on the cache or read on
+ * its start, each start is a hit or a miss, and a miss replaces the least
+ * recently used entry. An upload replaces the page of its index.
+ */
+extern unsigned int perf_sound_cache_hits;
+extern unsigned int perf_sound_cache_misses;
+
+#define ENTRIES 16
+#define FRAMES 2048
+
+static int sound[FRAMES * 2];
+static int played[FRAMES * 2];
+static int played_frames = 0;
+
+static void capture(sim_time_t start, int sample_rate, const int *samples, int frames)
+{
+    int i = 0;
+
+    for (; i < frames; i++)
+    {
+        if (played_frames == 0 && samples[2 * i] == 0 && samples[2 * i + 1] == 0)
+            continue;
+
+        if (played_frames < FRAMES)
+        {
+            played[2 * played_frames] = samples[2 * i];
+            played[2 * played_frames + 1] = samples[2 * i + 1];
+        }
+        played_frames++;
+    }
+}
+
+static void make_sound(int index, int version)
+{
+    int i = 0;
+
+    for (; i < FRAMES; i++)
+    {
+        sound[2 * i] = ((index << 16) + (version << 12) + i + 1) << 8;
+        sound[2 * i + 1] = -sound[2 * i];
+    }
+}
+
+static void upload(int index, int version)
+{
+    make_sound(index, version);
+    SIM_CHECK(sim_upload_sound(index, sound, FRAMES * 2, 96000, 0, 0) == 0, "upload of sound %d", index);
+}
+
+/* Plays a sound and checks it was a hit or a miss */
+static void play(int index, int version, bool hit)
+{
+    unsigned int hits = perf_sound_cache_hits;
+    unsigned int misses = perf_sound_cache_misses;
+
+    make_sound(index, version);
+    played_frames = 0;
+    sim_bus_start(sim_now(), index, 0, 0);
+    sim_run_for((sim_time_t)FRAMES * SIM_PS_PER_S / 96000 + 30 * SIM_PS_PER_MS);
+
+    SIM_CHECK(played_frames >= FRAMES && memcmp(played, sound, sizeof(sound)) == 0, "sound %d not played as uploaded", index);
+    SIM_CHECK(perf_sound_cache_hits - hits == (hit ? 1 : 0) && perf_sound_cache_misses - misses == (hit ? 0 : 1),
+              "start of sound %d: %u hits, %u misses", index, perf_sound_cache_hits - hits, perf_sound_cache_misses - misses);
+}
+
+int main(void)
+{
+    int index = 2;
+
+    sim_i2s_capture = capture;
+    sim_boot();
+
+    /* The uploads fill the cache, the last 16 stay */
+    for (; index < 2 + ENTRIES + 4; index++)
+        upload(index, 0);
+
+    play(2 + ENTRIES + 3, 0, true);
+    play(2, 0, false);
+    play(2, 0, true);
+
+    /* 6 was replaced by 2, then 7 by 3 and 8 by 7 */
+    play(3, 0, false);
+    play(7, 0, false);
+    play(9, 0, true);
+
+    /* 10 is now the least recently used */
+    play(8, 0, false);
+    play(9, 0, true);
+    play(10, 0, false);
+
+    /* The entry of a sound uploaded again has the new page */
+    upload(9, 1);
+    play(9, 1, true);
+
+    printf("%s\n", sim_failures ? "FAILED" : "OK");
+
+    return sim_failures ? 1 : 0;
+}
@@ -0,0 +1,432 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+
+/*
+ * The host's side of the USB bulk endpoints.
+ * Commands are queued and each one reaches receivedDataBuffer once the
+ * firmware has a read armed, at the bulk transfer rate. The replies written
+ * by the firmware are kept until a test takes them.
+ * sim_upload_raw() sends the commands like WaveformHelper.cs does, with up to
+ * two data commands in flight.
+ */
+#define SIM_USB_PS_PER_BYTE (SIM_PS_PER_S / 35000000)     // Bulk at ~35 MB/s
+
+#define SIM_USB_COMMANDS 4
+#define SIM_USB_REPLIES 8
+#define SIM_USB_REPLY_LEN 4096
+
+#define METADATA_CMD_LEN (4 + 4 + 16 + 32768 + 2048 + 1)
+#define DATA_CMD_LEN (4 + 4 + 4 + 32768 + 1)
+#define REPLY_TIMEOUT (2 * SIM_PS_PER_S)
+
+typedef struct {
+    unsigned char *bytes;
+    int length;
+    sim_time_t sent;
+} Usb_Command;
+
+typedef struct {
+    unsigned char bytes[SIM_USB_REPLY_LEN];
+    int length;
+} Usb_Reply;
+
+static Usb_Command commands[SIM_USB_COMMANDS];
+static int commands_queued = 0;
+static Usb_Reply replies[SIM_USB_REPLIES];
+static int replies_queued = 0;
+
+static unsigned char *read_buffer = NULL;
+static int read_size;
+static sim_time_t read_armed_at;
+
+void sim_usb_read_armed(void *buffer, int size)
+{
+    read_buffer = buffer;
+    read_size = size;
+    read_armed_at = sim_now();
+}
+
+void sim_usb_written(const void *buffer, int size)
+{
+    if (replies_queued == SIM_USB_REPLIES || size > SIM_USB_REPLY_LEN)
+    {
+        fprintf(stderr, "usb: replies not read\n");
+        exit(1);
+    }
+
+    memcpy(replies[replies_queued].bytes, buffer, size);
+    replies[replies_queued].length = size;
+    replies_queued++;
+}
+
+/* Delivers the next command, returns true if it reached the firmware */
+bool sim_usb_poll(void)
+{
+    Usb_Command *command = &commands[0];
+    sim_time_t start;
+
+    if (read_buffer == NULL || commands_queued == 0)
+        return false;
+
+    start = (command->sent > read_armed_at) ? command->sent : read_armed_at;
+    if (sim_now() < start + command->length * SIM_USB_PS_PER_BYTE)
+        return false;
+
+    if (command->length > read_size)
+    {
+        fprintf(stderr, "usb: command of %d bytes on a read of %d\n", command->length, read_size);
+        exit(1);
+    }
+
+    memcpy(read_buffer, command->bytes, command->length);
+    read_buffer = NULL;
+
+    free(command->bytes);
+    memmove(&commands[0], &commands[1], sizeof(Usb_Command) * --commands_queued);
+
+    return true;
+}
+
+void sim_usb_send(const void *command, int length)
+{
+    if (commands_queued == SIM_USB_COMMANDS)
+    {
+        fprintf(stderr, "usb: too many commands\n");
+        exit(1);
+    }
+
+    commands[commands_queued].bytes = malloc(length);
+    memcpy(commands[commands_queued].bytes, command, length);
+    commands[commands_queued].length = length;
+    commands[commands_queued].sent = sim_now();
+    commands_queued++;
+}
+
+static bool reply_is_available(void)
+{
+    return replies_queued != 0;
+}
+
+int sim_usb_receive(void *reply, int reply_length, sim_time_t timeout)
+{
+    int length;
+
+    if (!sim_run_while_not(reply_is_available, timeout))
+        return -1;
+
+    length = replies[0].length < reply_length ? replies[0].length : reply_length;
+    memcpy(reply, replies[0].bytes, length);
+    memmove(&replies[0], &replies[1], sizeof(Usb_Reply) * --replies_queued);
+
+    return length;
+}
+
+int sim_usb_command(const void *command, int length, void *reply, int reply_length, sim_time_t timeout)
+{
+    sim_usb_send(command, length);
+
+    return sim_usb_receive(reply, reply_length, timeout);
+}
+
+static void put_int(unsigned char *bytes, int value)
+{
+    memcpy(bytes, &value, 4);
+}
+
+static int get_int(const unsigned char *bytes)
+{
+    int value;
+
+    memcpy(&value, bytes, 4);
+
+    return value;
+}
+
+/* Returns the reply's error, or -1 if it didn't come or doesn't match */
+static int check_reply(const unsigned char *reply, int length, int header, int random)
+{
+    if (length < 12 || memcmp(reply, "cmd", 3) || reply[3] != header || get_int(reply + 4) != random)
+        return -1;
+
+    return get_int(reply + 8);
+}
+
+int sim_upload_raw(int index, const void *data, int data_length, int sound_length, int sample_rate, int data_type, int fade_length)
+{
+    unsigned char *command = calloc(1, METADATA_CMD_LEN);
+    const unsigned char *bytes = data;
+    unsigned char reply[12];
+    int randoms[2];
+    int in_flight = 0;
+    int commands_to_send = (data_length + 32767) / 32768;
+    int data_index = 0;
+    int random = rand();
+    int length;
+    int error;
+    short type = data_type;
+    unsigned short fade = fade_length;
+
+    /* Metadata and the first 32768 bytes */
+    memcpy(command, "cmd\x80", 4);
+    put_int(command + 4, random);
+    put_int(command + 8, index);
+    put_int(command + 12, sound_length);
+    put_int(command + 16, sample_rate);
+    memcpy(command + 20, &type, 2);
+    memcpy(command + 22, &fade, 2);
+    memcpy(command + 24, bytes, data_length < 32768 ? data_length : 32768);
+    command[METADATA_CMD_LEN - 1] = 'f';
+
+    length = sim_usb_command(command, METADATA_CMD_LEN, reply, sizeof(reply), REPLY_TIMEOUT);
+    error = check_reply(reply, length, 0x80, random);
+
+    /* Data commands */
+    while (error == 0 && (data_index < commands_to_send - 1 || in_flight))
+    {
+        if (data_index < commands_to_send - 1 && in_flight < 2)
+        {
+            int offset = ++data_index * 32768;
+            int chunk = data_length - offset < 32768 ? data_length - offset : 32768;
+
+            memset(command, 0, DATA_CMD_LEN);
+            memcpy(command, "cmd\x81", 4);
+            randoms[in_flight++] = random = rand();
+            put_int(command + 4, random);
+            put_int(command + 8, data_index);
+            memcpy(command + 12, bytes + offset, chunk);
+            command[DATA_CMD_LEN - 1] = 'f';
+
+            sim_usb_send(command, DATA_CMD_LEN);
+            continue;
+        }
+
+        length = sim_usb_receive(reply, sizeof(reply), REPLY_TIMEOUT);
+        error = check_reply(reply, length, 0x81, randoms[0]);
+        randoms[0] = randoms[1];
+        in_flight--;
+    }
+
+    /* The replies of the commands sent after an error */
+    for (; in_flight != 0; in_flight--)
+        sim_usb_receive(reply, sizeof(reply), REPLY_TIMEOUT);
+
+    free(command);
+
+    return error;
+}
+
+int sim_upload_sound(int index, const int *samples, int length, int sample_rate, int data_type, int fade_length)
+{
+    return sim_upload_raw(index, samples, length * 4, length, sample_rate, data_type, fade_length);
+}
+
+/*
+ * Compresses a sound like SoundEncoder.cs does, returns the stream's length in
+ * bytes. The stream is allocated and freed by the caller.
+ */
+#define COMPRESSED_PAGE_LEN 2048
+#define COMPRESSED_FRAME_LEN 256
+#define COMPRESSED_PARAMETER_MAX 24
+#define COMPRESSED_MODE_VERBATIM 4
+
+typedef struct {
+    unsigned char *bytes;
+    int length;
+    unsigned int bits;
+    int number_of_bits;
+} Bit_Writer;
+
+static const int fixed_predictors[4][3] = {{0, 0, 0}, {1, 0, 0}, {2, -1, 0}, {3, -3, 1}};
+
+static void write_bits(Bit_Writer *writer, unsigned int value, int length)
+{
+    int i = length - 1;
+
+    for (; i >= 0; i--)
+    {
+        writer->bits = writer->bits << 1 | ((value >> i) & 1);
+        if (++writer->number_of_bits == 8)
+        {
+            writer->bytes[writer->length++] = writer->bits;
+            writer->bits = 0;
+            writer->number_of_bits = 0;
+        }
+    }
+}
+
+static unsigned int get_residual(const int *samples, int order, int i)
+{
+    int residual = samples[i];
+    int j = 0;
+
+    for (; j < order; j++)
+        residual -= fixed_predictors[order][j] * samples[i - 1 - j];
+
+    return (unsigned int)(residual << 1) ^ (unsigned int)(residual >> 31);
+}
+
+static int select_mode(const int *samples, int *parameter)
+{
+    long long best_length = (long long)COMPRESSED_FRAME_LEN * 24;
+    unsigned int residuals[COMPRESSED_FRAME_LEN];
+    int mode = COMPRESSED_MODE_VERBATIM;
+    int order = 0;
+    int k;
+    int i;
+
+    *parameter = 0;
+
+    for (; order < 4; order++)
+    {
+        for (i = order; i < COMPRESSED_FRAME_LEN; i++)
+            residuals[i] = get_residual(samples, order, i);
+
+        for (k = 0; k <= COMPRESSED_PARAMETER_MAX; k++)
+        {
+            long long length = order * 24;
+
+            for (i = order; i < COMPRESSED_FRAME_LEN; i++)
+                length += (residuals[i] >> k) + 1 + k;
+
+            if (length < best_length)
+            {
+                best_length = length;
+                mode = order;
+                *parameter = k;
+            }
+        }
+    }
+
+    return mode;
+}
+
+static void encode_channel(Bit_Writer *writer, const int *samples, int mode, int parameter)
+{
+    unsigned int residual;
+    int i = 0;
+
+    for (; i < COMPRESSED_FRAME_LEN && (i < mode || mode == COMPRESSED_MODE_VERBATIM); i++)
+        write_bits(writer, samples[i] & 0xFFFFFF, 24);
+
+    for (; i < COMPRESSED_FRAME_LEN; i++)
+    {
+        residual = get_residual(samples, mode, i);
+
+        for (; residual >> parameter; residual -= 1u << parameter)
+            write_bits(writer, 0, 1);
+        write_bits(writer, 1, 1);
+        write_bits(writer, residual, parameter);
+    }
+}
+
+int sim_compress_sound(const int *samples, int length, unsigned char **stream)
+{
+    int number_of_frames = (length / 2 + COMPRESSED_FRAME_LEN - 1) / COMPRESSED_FRAME_LEN;
+    int index_pages = (16 + number_of_frames * 4 + COMPRESSED_PAGE_LEN - 1) / COMPRESSED_PAGE_LEN;
+    int channels[2][COMPRESSED_FRAME_LEN];
+    unsigned char frame[4 + 2 * COMPRESSED_FRAME_LEN * 4];
+    unsigned int header[4] = {0x5A435348, length, number_of_frames, 0};
+    int modes[2], parameters[2];
+    unsigned int entry;
+    int page = index_pages;
+    int offset = 0;
+    int stream_length;
+    int i = 0;
+    int j;
+
+    /* A frame never takes more than the verbatim one */
+    *stream = calloc((size_t)(index_pages + number_of_frames) * COMPRESSED_PAGE_LEN + 16, 1);
+    memcpy(*stream, header, sizeof(header));
+
+    for (; i < number_of_frames; i++)
+    {
+        Bit_Writer writer = {frame + 4, 0, 0, 0};
+
+        for (j = 0; j < COMPRESSED_FRAME_LEN * 2; j++)
+        {
+            int sample = i * COMPRESSED_FRAME_LEN * 2 + j;
+
+            channels[j & 1][j / 2] = sample < length ? samples[sample] >> 8 : 0;
+        }
+
+        for (j = 0; j < 2; j++)
+            modes[j] = select_mode(channels[j], &parameters[j]);
+        for (j = 0; j < 2; j++)
+            encode_channel(&writer, channels[j], modes[j], parameters[j]);
+        if (writer.number_of_bits)
+            write_bits(&writer, 0, 8 - writer.number_of_bits);
+
+        frame[0] = modes[0];
+        frame[1] = parameters[0];
+        frame[2] = modes[1];
+        frame[3] = parameters[1];
+        writer.length = (4 + writer.length + 3) / 4 * 4;
+
+        if (offset + writer.length > COMPRESSED_PAGE_LEN)
+        {
+            page++;
+            offset = 0;
+        }
+
+        entry = page << 11 | offset;
+        memcpy(*stream + 16 + i * 4, &entry, 4);
+        memcpy(*stream + page * COMPRESSED_PAGE_LEN + offset, frame, writer.length);
+        offset += writer.length;
+    }
+
+    /* The device reads the sound length as a multiple of 4 samples */
+    stream_length = page * COMPRESSED_PAGE_LEN + offset;
+
+    return (stream_length + 15) / 16 * 16;
+}
+
+int sim_read_metadata(int index, int *sound_length, int *sample_rate, int *data_type)
+{
+    unsigned char command[13] = {'c', 'm', 'd', 0x84};
+    unsigned char reply[2080];
+    int random = rand();
+    int length;
+    int error;
+    short type;
+
+    put_int(command + 4, random);
+    put_int(command + 8, index);
+    command[12] = 'f';
+
+    length = sim_usb_command(command, sizeof(command), reply, sizeof(reply), REPLY_TIMEOUT);
+    error = check_reply(reply, length, 0x84, random);
+
+    if (error == 0)
+    {
+        *sound_length = get_int(reply + 16);
+        *sample_rate = get_int(reply + 20);
+        memcpy(&type, reply + 24, 2);
+        *data_type = type;
+    }
+
+    return error;
+}
+
+bool sim_sound_exists(int index)
+{
+    unsigned char command[13] = {'c', 'm', 'd', 0x84};
+    unsigned char reply[2080];
+    int random = rand();
+    int length;
+    unsigned long long exists;
+
+    put_int(command + 4, random);
+    put_int(command + 8, index);
+    command[12] = 'f';
+
+    length = sim_usb_command(command, sizeof(command), reply, sizeof(reply), REPLY_TIMEOUT);
+    if (check_reply(reply, length, 0x84, random) != 0 || length < (int)sizeof(reply))
+        return false;
+
+    /* Sounds 0 to 31 after the error and 32 to 63 at the end */
+    exists = (unsigned int)get_int(reply + 12) | ((unsigned long long)(unsigned int)get_int(reply + 2076) << 32);
+
+    return (exists >> index) & 1;
+}
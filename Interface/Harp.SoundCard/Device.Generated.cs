@@ -43,8 +43,8 @@ namespace Harp.SoundCard
             { 35, typeof(AttenuationRight) },
             { 36, typeof(AttenuationBoth) },
             { 37, typeof(AttenuationAndPlaySoundOrFreq) },
-            { 38, typeof(Reserved0) },
-            { 39, typeof(Reserved1) },
+            { 38, typeof(AttenuationAndMixSound) },
+            { 39, typeof(PlaySoundAtTime) },
             { 40, typeof(InputState) },
             { 41, typeof(ConfigureDI0) },
             { 42, typeof(ConfigureDI1) },
@@ -67,16 +67,16 @@ namespace Harp.SoundCard
             { 59, typeof(AttenuationAndFrequencyDI0) },
             { 60, typeof(AttenuationAndFrequencyDI1) },
             { 61, typeof(AttenuationAndFrequencyDI2) },
-            { 62, typeof(Reserved2) },
-            { 63, typeof(Reserved3) },
-            { 64, typeof(Reserved4) },
+            { 62, typeof(PlayStereoTone) },
+            { 63, typeof(PlaySweep) },
+            { 64, typeof(NoiseSettings) },
             { 65, typeof(ConfigureDO0) },
             { 66, typeof(ConfigureDO1) },
             { 67, typeof(ConfigureDO2) },
             { 68, typeof(PulseDO0) },
             { 69, typeof(PulseDO1) },
             { 70, typeof(PulseDO2) },
-            { 71, typeof(Reserved5) },
+            { 71, typeof(PlayStimulus) },
             { 72, typeof(Reserved6) },
             { 73, typeof(Reserved7) },
             { 74, typeof(OutputSet) },
@@ -311,6 +311,8 @@ namespace Harp.SoundCard
     /// <seealso cref="AttenuationRight"/>
     /// <seealso cref="AttenuationBoth"/>
     /// <seealso cref="AttenuationAndPlaySoundOrFreq"/>
+    /// <seealso cref="AttenuationAndMixSound"/>
+    /// <seealso cref="PlaySoundAtTime"/>
     /// <seealso cref="InputState"/>
     /// <seealso cref="ConfigureDI0"/>
     /// <seealso cref="ConfigureDI1"/>
@@ -333,12 +335,16 @@ namespace Harp.SoundCard
     /// <seealso cref="AttenuationAndFrequencyDI0"/>
     /// <seealso cref="AttenuationAndFrequencyDI1"/>
     /// <seealso cref="AttenuationAndFrequencyDI2"/>
+    /// <seealso cref="PlayStereoTone"/>
+    /// <seealso cref="PlaySweep"/>
+    /// <seealso cref="NoiseSettings"/>
     /// <seealso cref="ConfigureDO0"/>
     /// <seealso cref="ConfigureDO1"/>
     /// <seealso cref="ConfigureDO2"/>
     /// <seealso cref="PulseDO0"/>
     /// <seealso cref="PulseDO1"/>
     /// <seealso cref="PulseDO2"/>
+    /// <seealso cref="PlayStimulus"/>
     /// <seealso cref="OutputSet"/>
     /// <seealso cref="OutputClear"/>
     /// <seealso cref="OutputToggle"/>
@@ -353,6 +359,8 @@ namespace Harp.SoundCard
     [XmlInclude(typeof(AttenuationRight))]
     [XmlInclude(typeof(AttenuationBoth))]
     [XmlInclude(typeof(AttenuationAndPlaySoundOrFreq))]
+    [XmlInclude(typeof(AttenuationAndMixSound))]
+    [XmlInclude(typeof(PlaySoundAtTime))]
     [XmlInclude(typeof(InputState))]
     [XmlInclude(typeof(ConfigureDI0))]
     [XmlInclude(typeof(ConfigureDI1))]
@@ -375,12 +383,16 @@ namespace Harp.SoundCard
     [XmlInclude(typeof(AttenuationAndFrequencyDI0))]
     [XmlInclude(typeof(AttenuationAndFrequencyDI1))]
     [XmlInclude(typeof(AttenuationAndFrequencyDI2))]
+    [XmlInclude(typeof(PlayStereoTone))]
+    [XmlInclude(typeof(PlaySweep))]
+    [XmlInclude(typeof(NoiseSettings))]
     [XmlInclude(typeof(ConfigureDO0))]
     [XmlInclude(typeof(ConfigureDO1))]
     [XmlInclude(typeof(ConfigureDO2))]
     [XmlInclude(typeof(PulseDO0))]
     [XmlInclude(typeof(PulseDO1))]
     [XmlInclude(typeof(PulseDO2))]
+    [XmlInclude(typeof(PlayStimulus))]
     [XmlInclude(typeof(OutputSet))]
     [XmlInclude(typeof(OutputClear))]
     [XmlInclude(typeof(OutputToggle))]
@@ -416,6 +428,8 @@ namespace Harp.SoundCard
     /// <seealso cref="AttenuationRight"/>
     /// <seealso cref="AttenuationBoth"/>
     /// <seealso cref="AttenuationAndPlaySoundOrFreq"/>
+    /// <seealso cref="AttenuationAndMixSound"/>
+    /// <seealso cref="PlaySoundAtTime"/>
     /// <seealso cref="InputState"/>
     /// <seealso cref="ConfigureDI0"/>
     /// <seealso cref="ConfigureDI1"/>
@@ -438,12 +452,16 @@ namespace Harp.SoundCard
     /// <seealso cref="AttenuationAndFrequencyDI0"/>
     /// <seealso cref="AttenuationAndFrequencyDI1"/>
     /// <seealso cref="AttenuationAndFrequencyDI2"/>
+    /// <seealso cref="PlayStereoTone"/>
+    /// <seealso cref="PlaySweep"/>
+    /// <seealso cref="NoiseSettings"/>
     /// <seealso cref="ConfigureDO0"/>
     /// <seealso cref="ConfigureDO1"/>
     /// <seealso cref="ConfigureDO2"/>
     /// <seealso cref="PulseDO0"/>
     /// <seealso cref="PulseDO1"/>
     /// <seealso cref="PulseDO2"/>
+    /// <seealso cref="PlayStimulus"/>
     /// <seealso cref="OutputSet"/>
     /// <seealso cref="OutputClear"/>
     /// <seealso cref="OutputToggle"/>
@@ -458,6 +476,8 @@ namespace Harp.SoundCard
     [XmlInclude(typeof(AttenuationRight))]
     [XmlInclude(typeof(AttenuationBoth))]
     [XmlInclude(typeof(AttenuationAndPlaySoundOrFreq))]
+    [XmlInclude(typeof(AttenuationAndMixSound))]
+    [XmlInclude(typeof(PlaySoundAtTime))]
     [XmlInclude(typeof(InputState))]
     [XmlInclude(typeof(ConfigureDI0))]
     [XmlInclude(typeof(ConfigureDI1))]
@@ -480,12 +500,16 @@ namespace Harp.SoundCard
     [XmlInclude(typeof(AttenuationAndFrequencyDI0))]
     [XmlInclude(typeof(AttenuationAndFrequencyDI1))]
     [XmlInclude(typeof(AttenuationAndFrequencyDI2))]
+    [XmlInclude(typeof(PlayStereoTone))]
+    [XmlInclude(typeof(PlaySweep))]
+    [XmlInclude(typeof(NoiseSettings))]
     [XmlInclude(typeof(ConfigureDO0))]
     [XmlInclude(typeof(ConfigureDO1))]
     [XmlInclude(typeof(ConfigureDO2))]
     [XmlInclude(typeof(PulseDO0))]
     [XmlInclude(typeof(PulseDO1))]
     [XmlInclude(typeof(PulseDO2))]
+    [XmlInclude(typeof(PlayStimulus))]
     [XmlInclude(typeof(OutputSet))]
     [XmlInclude(typeof(OutputClear))]
     [XmlInclude(typeof(OutputToggle))]
@@ -500,6 +524,8 @@ namespace Harp.SoundCard
     [XmlInclude(typeof(TimestampedAttenuationRight))]
     [XmlInclude(typeof(TimestampedAttenuationBoth))]
     [XmlInclude(typeof(TimestampedAttenuationAndPlaySoundOrFreq))]
+    [XmlInclude(typeof(TimestampedAttenuationAndMixSound))]
+    [XmlInclude(typeof(TimestampedPlaySoundAtTime))]
     [XmlInclude(typeof(TimestampedInputState))]
     [XmlInclude(typeof(TimestampedConfigureDI0))]
     [XmlInclude(typeof(TimestampedConfigureDI1))]
@@ -522,12 +548,16 @@ namespace Harp.SoundCard
     [XmlInclude(typeof(TimestampedAttenuationAndFrequencyDI0))]
     [XmlInclude(typeof(TimestampedAttenuationAndFrequencyDI1))]
     [XmlInclude(typeof(TimestampedAttenuationAndFrequencyDI2))]
+    [XmlInclude(typeof(TimestampedPlayStereoTone))]
+    [XmlInclude(typeof(TimestampedPlaySweep))]
+    [XmlInclude(typeof(TimestampedNoiseSettings))]
     [XmlInclude(typeof(TimestampedConfigureDO0))]
     [XmlInclude(typeof(TimestampedConfigureDO1))]
     [XmlInclude(typeof(TimestampedConfigureDO2))]
     [XmlInclude(typeof(TimestampedPulseDO0))]
     [XmlInclude(typeof(TimestampedPulseDO1))]
     [XmlInclude(typeof(TimestampedPulseDO2))]
+    [XmlInclude(typeof(TimestampedPlayStimulus))]
     [XmlInclude(typeof(TimestampedOutputSet))]
     [XmlInclude(typeof(TimestampedOutputClear))]
     [XmlInclude(typeof(TimestampedOutputToggle))]
@@ -560,6 +590,8 @@ namespace Harp.SoundCard
     /// <seealso cref="AttenuationRight"/>
     /// <seealso cref="AttenuationBoth"/>
     /// <seealso cref="AttenuationAndPlaySoundOrFreq"/>
+    /// <seealso cref="AttenuationAndMixSound"/>
+    /// <seealso cref="PlaySoundAtTime"/>
     /// <seealso cref="InputState"/>
     /// <seealso cref="ConfigureDI0"/>
     /// <seealso cref="ConfigureDI1"/>
@@ -582,12 +614,16 @@ namespace Harp.SoundCard
     /// <seealso cref="AttenuationAndFrequencyDI0"/>
     /// <seealso cref="AttenuationAndFrequencyDI1"/>
     /// <seealso cref="AttenuationAndFrequencyDI2"/>
+    /// <seealso cref="PlayStereoTone"/>
+    /// <seealso cref="PlaySweep"/>
+    /// <seealso cref="NoiseSettings"/>
     /// <seealso cref="ConfigureDO0"/>
     /// <seealso cref="ConfigureDO1"/>
     /// <seealso cref="ConfigureDO2"/>
     /// <seealso cref="PulseDO0"/>
     /// <seealso cref="PulseDO1"/>
     /// <seealso cref="PulseDO2"/>
+    /// <seealso cref="PlayStimulus"/>
     /// <seealso cref="OutputSet"/>
     /// <seealso cref="OutputClear"/>
     /// <seealso cref="OutputToggle"/>
@@ -602,6 +638,8 @@ namespace Harp.SoundCard
     [XmlInclude(typeof(AttenuationRight))]
     [XmlInclude(typeof(AttenuationBoth))]
     [XmlInclude(typeof(AttenuationAndPlaySoundOrFreq))]
+    [XmlInclude(typeof(AttenuationAndMixSound))]
+    [XmlInclude(typeof(PlaySoundAtTime))]
     [XmlInclude(typeof(InputState))]
     [XmlInclude(typeof(ConfigureDI0))]
     [XmlInclude(typeof(ConfigureDI1))]
@@ -624,12 +662,16 @@ namespace Harp.SoundCard
     [XmlInclude(typeof(AttenuationAndFrequencyDI0))]
     [XmlInclude(typeof(AttenuationAndFrequencyDI1))]
     [XmlInclude(typeof(AttenuationAndFrequencyDI2))]
+    [XmlInclude(typeof(PlayStereoTone))]
+    [XmlInclude(typeof(PlaySweep))]
+    [XmlInclude(typeof(NoiseSettings))]
     [XmlInclude(typeof(ConfigureDO0))]
     [XmlInclude(typeof(ConfigureDO1))]
     [XmlInclude(typeof(ConfigureDO2))]
     [XmlInclude(typeof(PulseDO0))]
     [XmlInclude(typeof(PulseDO1))]
     [XmlInclude(typeof(PulseDO2))]
+    [XmlInclude(typeof(PlayStimulus))]
     [XmlInclude(typeof(OutputSet))]
     [XmlInclude(typeof(OutputClear))]
     [XmlInclude(typeof(OutputToggle))]
@@ -653,9 +695,9 @@ namespace Harp.SoundCard
     }
 
     /// <summary>
-    /// Represents a register that starts the sound index (if less than 32) or frequency (if greater or equal than 32).
+    /// Represents a register that starts the sound index (if less than 32, or 64 on the 4 Gb memory), frequency (if greater or equal) or noise (40001 to 40003).
     /// </summary>
-    [Description("Starts the sound index (if less than 32) or frequency (if greater or equal than 32)")]
+    [Description("Starts the sound index (if less than 32, or 64 on the 4 Gb memory), frequency (if greater or equal) or noise (40001 to 40003)")]
     public partial class PlaySoundOrFrequency
     {
         /// <summary>
@@ -1229,47 +1271,195 @@ namespace Harp.SoundCard
     }
 
     /// <summary>
-    /// Represents a register that reserved for future use.
+    /// Represents a register that configures attenuation and mixes sound index with the current sound [Index] [Att L] [Att R].
     /// </summary>
-    [Description("Reserved for future use")]
-    internal partial class Reserved0
+    [Description("Configures attenuation and mixes sound index with the current sound [Index] [Att L] [Att R]")]
+    public partial class AttenuationAndMixSound
     {
         /// <summary>
-        /// Represents the address of the <see cref="Reserved0"/> register. This field is constant.
+        /// Represents the address of the <see cref="AttenuationAndMixSound"/> register. This field is constant.
         /// </summary>
         public const int Address = 38;
 
         /// <summary>
-        /// Represents the payload type of the <see cref="Reserved0"/> register. This field is constant.
+        /// Represents the payload type of the <see cref="AttenuationAndMixSound"/> register. This field is constant.
         /// </summary>
-        public const PayloadType RegisterType = PayloadType.U8;
+        public const PayloadType RegisterType = PayloadType.U16;
 
         /// <summary>
-        /// Represents the length of the <see cref="Reserved0"/> register. This field is constant.
+        /// Represents the length of the <see cref="AttenuationAndMixSound"/> register. This field is constant.
         /// </summary>
-        public const int RegisterLength = 1;
+        public const int RegisterLength = 3;
+
+        /// <summary>
+        /// Returns the payload data for <see cref="AttenuationAndMixSound"/> register messages.
+        /// </summary>
+        /// <param name="message">A <see cref="HarpMessage"/> object representing the register message.</param>
+        /// <returns>A value representing the message payload.</returns>
+        public static ushort[] GetPayload(HarpMessage message)
+        {
+            return message.GetPayloadArray<ushort>();
+        }
+
+        /// <summary>
+        /// Returns the timestamped payload data for <see cref="AttenuationAndMixSound"/> register messages.
+        /// </summary>
+        /// <param name="message">A <see cref="HarpMessage"/> object representing the register message.</param>
+        /// <returns>A value representing the timestamped message payload.</returns>
+        public static Timestamped<ushort[]> GetTimestampedPayload(HarpMessage message)
+        {
+            return message.GetTimestampedPayloadArray<ushort>();
+        }
+
+        /// <summary>
+        /// Returns a Harp message for the <see cref="AttenuationAndMixSound"/> register.
+        /// </summary>
+        /// <param name="messageType">The type of the Harp message.</param>
+        /// <param name="value">The value to be stored in the message payload.</param>
+        /// <returns>
+        /// A <see cref="HarpMessage"/> object for the <see cref="AttenuationAndMixSound"/> register
+        /// with the specified message type and payload.
+        /// </returns>
+        public static HarpMessage FromPayload(MessageType messageType, ushort[] value)
+        {
+            return HarpMessage.FromUInt16(Address, messageType, value);
+        }
+
+        /// <summary>
+        /// Returns a timestamped Harp message for the <see cref="AttenuationAndMixSound"/>
+        /// register.
+        /// </summary>
+        /// <param name="timestamp">The timestamp of the message payload, in seconds.</param>
+        /// <param name="messageType">The type of the Harp message.</param>
+        /// <param name="value">The value to be stored in the message payload.</param>
+        /// <returns>
+        /// A <see cref="HarpMessage"/> object for the <see cref="AttenuationAndMixSound"/> register
+        /// with the specified message type, timestamp, and payload.
+        /// </returns>
+        public static HarpMessage FromPayload(double timestamp, MessageType messageType, ushort[] value)
+        {
+            return HarpMessage.FromUInt16(Address, timestamp, messageType, value);
+        }
     }
 
     /// <summary>
-    /// Represents a register that reserved for future use.
+    /// Provides methods for manipulating timestamped messages from the
+    /// AttenuationAndMixSound register.
     /// </summary>
-    [Description("Reserved for future use")]
-    internal partial class Reserved1
+    /// <seealso cref="AttenuationAndMixSound"/>
+    [Description("Filters and selects timestamped messages from the AttenuationAndMixSound register.")]
+    public partial class TimestampedAttenuationAndMixSound
+    {
+        /// <summary>
+        /// Represents the address of the <see cref="AttenuationAndMixSound"/> register. This field is constant.
+        /// </summary>
+        public const int Address = AttenuationAndMixSound.Address;
+
+        /// <summary>
+        /// Returns timestamped payload data for <see cref="AttenuationAndMixSound"/> register messages.
+        /// </summary>
+        /// <param name="message">A <see cref="HarpMessage"/> object representing the register message.</param>
+        /// <returns>A value representing the timestamped message payload.</returns>
+        public static Timestamped<ushort[]> GetPayload(HarpMessage message)
+        {
+            return AttenuationAndMixSound.GetTimestampedPayload(message);
+        }
+    }
+
+    /// <summary>
+    /// Represents a register that plays sound index at a Harp timestamp with the current attenuation [Index] [Seconds] [Microseconds].
+    /// </summary>
+    [Description("Plays sound index at a Harp timestamp with the current attenuation [Index] [Seconds] [Microseconds]")]
+    public partial class PlaySoundAtTime
     {
         /// <summary>
-        /// Represents the address of the <see cref="Reserved1"/> register. This field is constant.
+        /// Represents the address of the <see cref="PlaySoundAtTime"/> register. This field is constant.
         /// </summary>
         public const int Address = 39;
 
         /// <summary>
-        /// Represents the payload type of the <see cref="Reserved1"/> register. This field is constant.
+        /// Represents the payload type of the <see cref="PlaySoundAtTime"/> register. This field is constant.
         /// </summary>
-        public const PayloadType RegisterType = PayloadType.U8;
+        public const PayloadType RegisterType = PayloadType.U32;
 
         /// <summary>
-        /// Represents the length of the <see cref="Reserved1"/> register. This field is constant.
+        /// Represents the length of the <see cref="PlaySoundAtTime"/> register. This field is constant.
         /// </summary>
-        public const int RegisterLength = 1;
+        public const int RegisterLength = 3;
+
+        /// <summary>
+        /// Returns the payload data for <see cref="PlaySoundAtTime"/> register messages.
+        /// </summary>
+        /// <param name="message">A <see cref="HarpMessage"/> object representing the register message.</param>
+        /// <returns>A value representing the message payload.</returns>
+        public static uint[] GetPayload(HarpMessage message)
+        {
+            return message.GetPayloadArray<uint>();
+        }
+
+        /// <summary>
+        /// Returns the timestamped payload data for <see cref="PlaySoundAtTime"/> register messages.
+        /// </summary>
+        /// <param name="message">A <see cref="HarpMessage"/> object representing the register message.</param>
+        /// <returns>A value representing the timestamped message payload.</returns>
+        public static Timestamped<uint[]> GetTimestampedPayload(HarpMessage message)
+        {
+            return message.GetTimestampedPayloadArray<uint>();
+        }
+
+        /// <summary>
+        /// Returns a Harp message for the <see cref="PlaySoundAtTime"/> register.
+        /// </summary>
+        /// <param name="messageType">The type of the Harp message.</param>
+        /// <param name="value">The value to be stored in the message payload.</param>
+        /// <returns>
+        /// A <see cref="HarpMessage"/> object for the <see cref="PlaySoundAtTime"/> register
+        /// with the specified message type and payload.
+        /// </returns>
+        public static HarpMessage FromPayload(MessageType messageType, uint[] value)
+        {
+            return HarpMessage.FromUInt32(Address, messageType, value);
+        }
+
+        /// <summary>
+        /// Returns a timestamped Harp message for the <see cref="PlaySoundAtTime"/>
+        /// register.
+        /// </summary>
+        /// <param name="timestamp">The timestamp of the message payload, in seconds.</param>
+        /// <param name="messageType">The type of the Harp message.</param>
+        /// <param name="value">The value to be stored in the message payload.</param>
+        /// <returns>
+        /// A <see cref="HarpMessage"/> object for the <see cref="PlaySoundAtTime"/> register
+        /// with the specified message type, timestamp, and payload.
+        /// </returns>
+        public static HarpMessage FromPayload(double timestamp, MessageType messageType, uint[] value)
+        {
+            return HarpMessage.FromUInt32(Address, timestamp, messageType, value);
+        }
+    }
+
+    /// <summary>
+    /// Provides methods for manipulating timestamped messages from the
+    /// PlaySoundAtTime register.
+    /// </summary>
+    /// <seealso cref="PlaySoundAtTime"/>
+    [Description("Filters and selects timestamped messages from the PlaySoundAtTime register.")]
+    public partial class TimestampedPlaySoundAtTime
+    {
+        /// <summary>
+        /// Represents the address of the <see cref="PlaySoundAtTime"/> register. This field is constant.
+        /// </summary>
+        public const int Address = PlaySoundAtTime.Address;
+
+        /// <summary>
+        /// Returns timestamped payload data for <see cref="PlaySoundAtTime"/> register messages.
+        /// </summary>
+        /// <param name="message">A <see cref="HarpMessage"/> object representing the register message.</param>
+        /// <returns>A value representing the timestamped message payload.</returns>
+        public static Timestamped<uint[]> GetPayload(HarpMessage message)
+        {
+            return PlaySoundAtTime.GetTimestampedPayload(message);
+        }
     }
 
     /// <summary>
@@ -3389,260 +3579,552 @@ namespace Harp.SoundCard
     }
 
     /// <summary>
-    /// Represents a register that reserved for future use.
+    /// Represents a register that plays a tone with an independent frequency, phase and attenuation on each channel.
     /// </summary>
-    [Description("Reserved for future use")]
-    internal partial class Reserved2
+    [Description("Plays a tone with an independent frequency, phase and attenuation on each channel")]
+    public partial class PlayStereoTone
     {
         /// <summary>
-        /// Represents the address of the <see cref="Reserved2"/> register. This field is constant.
+        /// Represents the address of the <see cref="PlayStereoTone"/> register. This field is constant.
         /// </summary>
         public const int Address = 62;
 
         /// <summary>
-        /// Represents the payload type of the <see cref="Reserved2"/> register. This field is constant.
-        /// </summary>
-        public const PayloadType RegisterType = PayloadType.U8;
-
-        /// <summary>
-        /// Represents the length of the <see cref="Reserved2"/> register. This field is constant.
+        /// Represents the payload type of the <see cref="PlayStereoTone"/> register. This field is constant.
         /// </summary>
-        public const int RegisterLength = 1;
-    }
-
-    /// <summary>
-    /// Represents a register that reserved for future use.
-    /// </summary>
-    [Description("Reserved for future use")]
-    internal partial class Reserved3
-    {
-        /// <summary>
-        /// Represents the address of the <see cref="Reserved3"/> register. This field is constant.
-        /// </summary>
-        public const int Address = 63;
-
-        /// <summary>
-        /// Represents the payload type of the <see cref="Reserved3"/> register. This field is constant.
-        /// </summary>
-        public const PayloadType RegisterType = PayloadType.U8;
-
-        /// <summary>
-        /// Represents the length of the <see cref="Reserved3"/> register. This field is constant.
-        /// </summary>
-        public const int RegisterLength = 1;
-    }
-
-    /// <summary>
-    /// Represents a register that reserved for future use.
-    /// </summary>
-    [Description("Reserved for future use")]
-    internal partial class Reserved4
-    {
-        /// <summary>
-        /// Represents the address of the <see cref="Reserved4"/> register. This field is constant.
-        /// </summary>
-        public const int Address = 64;
-
-        /// <summary>
-        /// Represents the payload type of the <see cref="Reserved4"/> register. This field is constant.
-        /// </summary>
-        public const PayloadType RegisterType = PayloadType.U8;
-
-        /// <summary>
-        /// Represents the length of the <see cref="Reserved4"/> register. This field is constant.
-        /// </summary>
-        public const int RegisterLength = 1;
-    }
+        public const PayloadType RegisterType = PayloadType.U32;
 
-    /// <summary>
-    /// Represents a register that configuration of the digital output 0 (DO0).
-    /// </summary>
-    [Description("Configuration of the digital output 0 (DO0)")]
-    public partial class ConfigureDO0
-    {
         /// <summary>
-        /// Represents the address of the <see cref="ConfigureDO0"/> register. This field is constant.
+        /// Represents the length of the <see cref="PlayStereoTone"/> register. This field is constant.
         /// </summary>
-        public const int Address = 65;
+        public const int RegisterLength = 5;
 
-        /// <summary>
-        /// Represents the payload type of the <see cref="ConfigureDO0"/> register. This field is constant.
-        /// </summary>
-        public const PayloadType RegisterType = PayloadType.U8;
+        static PlayStereoTonePayload ParsePayload(uint[] payload)
+        {
+            PlayStereoTonePayload result;
+            result.FrequencyLeft = payload[0];
+            result.FrequencyRight = payload[1];
+            result.PhaseLeft = payload[2];
+            result.AttenuationLeft = payload[3];
+            result.AttenuationRight = payload[4];
+            return result;
+        }
 
-        /// <summary>
-        /// Represents the length of the <see cref="ConfigureDO0"/> register. This field is constant.
-        /// </summary>
-        public const int RegisterLength = 1;
+        static uint[] FormatPayload(PlayStereoTonePayload value)
+        {
+            uint[] result;
+            result = new uint[5];
+            result[0] = value.FrequencyLeft;
+            result[1] = value.FrequencyRight;
+            result[2] = value.PhaseLeft;
+            result[3] = value.AttenuationLeft;
+            result[4] = value.AttenuationRight;
+            return result;
+        }
 
         /// <summary>
-        /// Returns the payload data for <see cref="ConfigureDO0"/> register messages.
+        /// Returns the payload data for <see cref="PlayStereoTone"/> register messages.
         /// </summary>
         /// <param name="message">A <see cref="HarpMessage"/> object representing the register message.</param>
         /// <returns>A value representing the message payload.</returns>
-        public static DigitalOutputConfiguration GetPayload(HarpMessage message)
+        public static PlayStereoTonePayload GetPayload(HarpMessage message)
         {
-            return (DigitalOutputConfiguration)message.GetPayloadByte();
+            return ParsePayload(message.GetPayloadArray<uint>());
         }
 
         /// <summary>
-        /// Returns the timestamped payload data for <see cref="ConfigureDO0"/> register messages.
+        /// Returns the timestamped payload data for <see cref="PlayStereoTone"/> register messages.
         /// </summary>
         /// <param name="message">A <see cref="HarpMessage"/> object representing the register message.</param>
         /// <returns>A value representing the timestamped message payload.</returns>
-        public static Timestamped<DigitalOutputConfiguration> GetTimestampedPayload(HarpMessage message)
+        public static Timestamped<PlayStereoTonePayload> GetTimestampedPayload(HarpMessage message)
         {
-            var payload = message.GetTimestampedPayloadByte();
-            return Timestamped.Create((DigitalOutputConfiguration)payload.Value, payload.Seconds);
+            var payload = message.GetTimestampedPayloadArray<uint>();
+            return Timestamped.Create(ParsePayload(payload.Value), payload.Seconds);
         }
 
         /// <summary>
-        /// Returns a Harp message for the <see cref="ConfigureDO0"/> register.
+        /// Returns a Harp message for the <see cref="PlayStereoTone"/> register.
         /// </summary>
         /// <param name="messageType">The type of the Harp message.</param>
         /// <param name="value">The value to be stored in the message payload.</param>
         /// <returns>
-        /// A <see cref="HarpMessage"/> object for the <see cref="ConfigureDO0"/> register
+        /// A <see cref="HarpMessage"/> object for the <see cref="PlayStereoTone"/> register
         /// with the specified message type and payload.
         /// </returns>
-        public static HarpMessage FromPayload(MessageType messageType, DigitalOutputConfiguration value)
+        public static HarpMessage FromPayload(MessageType messageType, PlayStereoTonePayload value)
         {
-            return HarpMessage.FromByte(Address, messageType, (byte)value);
+            return HarpMessage.FromUInt32(Address, messageType, FormatPayload(value));
         }
 
         /// <summary>
-        /// Returns a timestamped Harp message for the <see cref="ConfigureDO0"/>
+        /// Returns a timestamped Harp message for the <see cref="PlayStereoTone"/>
         /// register.
         /// </summary>
         /// <param name="timestamp">The timestamp of the message payload, in seconds.</param>
         /// <param name="messageType">The type of the Harp message.</param>
         /// <param name="value">The value to be stored in the message payload.</param>
         /// <returns>
-        /// A <see cref="HarpMessage"/> object for the <see cref="ConfigureDO0"/> register
+        /// A <see cref="HarpMessage"/> object for the <see cref="PlayStereoTone"/> register
         /// with the specified message type, timestamp, and payload.
         /// </returns>
-        public static HarpMessage FromPayload(double timestamp, MessageType messageType, DigitalOutputConfiguration value)
+        public static HarpMessage FromPayload(double timestamp, MessageType messageType, PlayStereoTonePayload value)
         {
-            return HarpMessage.FromByte(Address, timestamp, messageType, (byte)value);
+            return HarpMessage.FromUInt32(Address, timestamp, messageType, FormatPayload(value));
         }
     }
 
     /// <summary>
     /// Provides methods for manipulating timestamped messages from the
-    /// ConfigureDO0 register.
+    /// PlayStereoTone register.
     /// </summary>
-    /// <seealso cref="ConfigureDO0"/>
-    [Description("Filters and selects timestamped messages from the ConfigureDO0 register.")]
-    public partial class TimestampedConfigureDO0
+    /// <seealso cref="PlayStereoTone"/>
+    [Description("Filters and selects timestamped messages from the PlayStereoTone register.")]
+    public partial class TimestampedPlayStereoTone
     {
         /// <summary>
-        /// Represents the address of the <see cref="ConfigureDO0"/> register. This field is constant.
+        /// Represents the address of the <see cref="PlayStereoTone"/> register. This field is constant.
         /// </summary>
-        public const int Address = ConfigureDO0.Address;
+        public const int Address = PlayStereoTone.Address;
 
         /// <summary>
-        /// Returns timestamped payload data for <see cref="ConfigureDO0"/> register messages.
+        /// Returns timestamped payload data for <see cref="PlayStereoTone"/> register messages.
         /// </summary>
         /// <param name="message">A <see cref="HarpMessage"/> object representing the register message.</param>
         /// <returns>A value representing the timestamped message payload.</returns>
-        public static Timestamped<DigitalOutputConfiguration> GetPayload(HarpMessage message)
+        public static Timestamped<PlayStereoTonePayload> GetPayload(HarpMessage message)
         {
-            return ConfigureDO0.GetTimestampedPayload(message);
+            return PlayStereoTone.GetTimestampedPayload(message);
         }
     }
 
     /// <summary>
-    /// Represents a register that configuration of the digital output 1 (DO1).
+    /// Represents a register that plays a tone sweeping from a start to an end frequency on both channels.
     /// </summary>
-    [Description("Configuration of the digital output 1 (DO1)")]
-    public partial class ConfigureDO1
+    [Description("Plays a tone sweeping from a start to an end frequency on both channels")]
+    public partial class PlaySweep
     {
         /// <summary>
-        /// Represents the address of the <see cref="ConfigureDO1"/> register. This field is constant.
+        /// Represents the address of the <see cref="PlaySweep"/> register. This field is constant.
         /// </summary>
-        public const int Address = 66;
+        public const int Address = 63;
 
         /// <summary>
-        /// Represents the payload type of the <see cref="ConfigureDO1"/> register. This field is constant.
+        /// Represents the payload type of the <see cref="PlaySweep"/> register. This field is constant.
         /// </summary>
-        public const PayloadType RegisterType = PayloadType.U8;
+        public const PayloadType RegisterType = PayloadType.U32;
 
         /// <summary>
-        /// Represents the length of the <see cref="ConfigureDO1"/> register. This field is constant.
+        /// Represents the length of the <see cref="PlaySweep"/> register. This field is constant.
         /// </summary>
-        public const int RegisterLength = 1;
+        public const int RegisterLength = 6;
+
+        static PlaySweepPayload ParsePayload(uint[] payload)
+        {
+            PlaySweepPayload result;
+            result.FrequencyStart = payload[0];
+            result.FrequencyEnd = payload[1];
+            result.Duration = payload[2];
+            result.Mode = payload[3];
+            result.AttenuationLeft = payload[4];
+            result.AttenuationRight = payload[5];
+            return result;
+        }
+
+        static uint[] FormatPayload(PlaySweepPayload value)
+        {
+            uint[] result;
+            result = new uint[6];
+            result[0] = value.FrequencyStart;
+            result[1] = value.FrequencyEnd;
+            result[2] = value.Duration;
+            result[3] = value.Mode;
+            result[4] = value.AttenuationLeft;
+            result[5] = value.AttenuationRight;
+            return result;
+        }
 
         /// <summary>
-        /// Returns the payload data for <see cref="ConfigureDO1"/> register messages.
+        /// Returns the payload data for <see cref="PlaySweep"/> register messages.
         /// </summary>
         /// <param name="message">A <see cref="HarpMessage"/> object representing the register message.</param>
         /// <returns>A value representing the message payload.</returns>
-        public static DigitalOutputConfiguration GetPayload(HarpMessage message)
+        public static PlaySweepPayload GetPayload(HarpMessage message)
         {
-            return (DigitalOutputConfiguration)message.GetPayloadByte();
+            return ParsePayload(message.GetPayloadArray<uint>());
         }
 
         /// <summary>
-        /// Returns the timestamped payload data for <see cref="ConfigureDO1"/> register messages.
+        /// Returns the timestamped payload data for <see cref="PlaySweep"/> register messages.
         /// </summary>
         /// <param name="message">A <see cref="HarpMessage"/> object representing the register message.</param>
         /// <returns>A value representing the timestamped message payload.</returns>
-        public static Timestamped<DigitalOutputConfiguration> GetTimestampedPayload(HarpMessage message)
+        public static Timestamped<PlaySweepPayload> GetTimestampedPayload(HarpMessage message)
         {
-            var payload = message.GetTimestampedPayloadByte();
-            return Timestamped.Create((DigitalOutputConfiguration)payload.Value, payload.Seconds);
+            var payload = message.GetTimestampedPayloadArray<uint>();
+            return Timestamped.Create(ParsePayload(payload.Value), payload.Seconds);
         }
 
         /// <summary>
-        /// Returns a Harp message for the <see cref="ConfigureDO1"/> register.
+        /// Returns a Harp message for the <see cref="PlaySweep"/> register.
         /// </summary>
         /// <param name="messageType">The type of the Harp message.</param>
         /// <param name="value">The value to be stored in the message payload.</param>
         /// <returns>
-        /// A <see cref="HarpMessage"/> object for the <see cref="ConfigureDO1"/> register
+        /// A <see cref="HarpMessage"/> object for the <see cref="PlaySweep"/> register
         /// with the specified message type and payload.
         /// </returns>
-        public static HarpMessage FromPayload(MessageType messageType, DigitalOutputConfiguration value)
+        public static HarpMessage FromPayload(MessageType messageType, PlaySweepPayload value)
         {
-            return HarpMessage.FromByte(Address, messageType, (byte)value);
+            return HarpMessage.FromUInt32(Address, messageType, FormatPayload(value));
         }
 
         /// <summary>
-        /// Returns a timestamped Harp message for the <see cref="ConfigureDO1"/>
+        /// Returns a timestamped Harp message for the <see cref="PlaySweep"/>
         /// register.
         /// </summary>
         /// <param name="timestamp">The timestamp of the message payload, in seconds.</param>
         /// <param name="messageType">The type of the Harp message.</param>
         /// <param name="value">The value to be stored in the message payload.</param>
         /// <returns>
-        /// A <see cref="HarpMessage"/> object for the <see cref="ConfigureDO1"/> register
+        /// A <see cref="HarpMessage"/> object for the <see cref="PlaySweep"/> register
         /// with the specified message type, timestamp, and payload.
         /// </returns>
-        public static HarpMessage FromPayload(double timestamp, MessageType messageType, DigitalOutputConfiguration value)
+        public static HarpMessage FromPayload(double timestamp, MessageType messageType, PlaySweepPayload value)
         {
-            return HarpMessage.FromByte(Address, timestamp, messageType, (byte)value);
+            return HarpMessage.FromUInt32(Address, timestamp, messageType, FormatPayload(value));
         }
     }
 
     /// <summary>
     /// Provides methods for manipulating timestamped messages from the
-    /// ConfigureDO1 register.
+    /// PlaySweep register.
     /// </summary>
-    /// <seealso cref="ConfigureDO1"/>
-    [Description("Filters and selects timestamped messages from the ConfigureDO1 register.")]
-    public partial class TimestampedConfigureDO1
+    /// <seealso cref="PlaySweep"/>
+    [Description("Filters and selects timestamped messages from the PlaySweep register.")]
+    public partial class TimestampedPlaySweep
     {
         /// <summary>
-        /// Represents the address of the <see cref="ConfigureDO1"/> register. This field is constant.
+        /// Represents the address of the <see cref="PlaySweep"/> register. This field is constant.
         /// </summary>
-        public const int Address = ConfigureDO1.Address;
+        public const int Address = PlaySweep.Address;
 
         /// <summary>
-        /// Returns timestamped payload data for <see cref="ConfigureDO1"/> register messages.
+        /// Returns timestamped payload data for <see cref="PlaySweep"/> register messages.
         /// </summary>
         /// <param name="message">A <see cref="HarpMessage"/> object representing the register message.</param>
         /// <returns>A value representing the timestamped message payload.</returns>
-        public static Timestamped<DigitalOutputConfiguration> GetPayload(HarpMessage message)
+        public static Timestamped<PlaySweepPayload> GetPayload(HarpMessage message)
+        {
+            return PlaySweep.GetTimestampedPayload(message);
+        }
+    }
+
+    /// <summary>
+    /// Represents a register that configures the noises played with the indexes 40001 (white), 40002 (pink) and 40003 (band-pass).
+    /// </summary>
+    [Description("Configures the noises played with the indexes 40001 (white), 40002 (pink) and 40003 (band-pass)")]
+    public partial class NoiseSettings
+    {
+        /// <summary>
+        /// Represents the address of the <see cref="NoiseSettings"/> register. This field is constant.
+        /// </summary>
+        public const int Address = 64;
+
+        /// <summary>
+        /// Represents the payload type of the <see cref="NoiseSettings"/> register. This field is constant.
+        /// </summary>
+        public const PayloadType RegisterType = PayloadType.U32;
+
+        /// <summary>
+        /// Represents the length of the <see cref="NoiseSettings"/> register. This field is constant.
+        /// </summary>
+        public const int RegisterLength = 3;
+
+        static NoiseSettingsPayload ParsePayload(uint[] payload)
+        {
+            NoiseSettingsPayload result;
+            result.Seed = payload[0];
+            result.FrequencyLow = payload[1];
+            result.FrequencyHigh = payload[2];
+            return result;
+        }
+
+        static uint[] FormatPayload(NoiseSettingsPayload value)
+        {
+            uint[] result;
+            result = new uint[3];
+            result[0] = value.Seed;
+            result[1] = value.FrequencyLow;
+            result[2] = value.FrequencyHigh;
+            return result;
+        }
+
+        /// <summary>
+        /// Returns the payload data for <see cref="NoiseSettings"/> register messages.
+        /// </summary>
+        /// <param name="message">A <see cref="HarpMessage"/> object representing the register message.</param>
+        /// <returns>A value representing the message payload.</returns>
+        public static NoiseSettingsPayload GetPayload(HarpMessage message)
+        {
+            return ParsePayload(message.GetPayloadArray<uint>());
+        }
+
+        /// <summary>
+        /// Returns the timestamped payload data for <see cref="NoiseSettings"/> register messages.
+        /// </summary>
+        /// <param name="message">A <see cref="HarpMessage"/> object representing the register message.</param>
+        /// <returns>A value representing the timestamped message payload.</returns>
+        public static Timestamped<NoiseSettingsPayload> GetTimestampedPayload(HarpMessage message)
+        {
+            var payload = message.GetTimestampedPayloadArray<uint>();
+            return Timestamped.Create(ParsePayload(payload.Value), payload.Seconds);
+        }
+
+        /// <summary>
+        /// Returns a Harp message for the <see cref="NoiseSettings"/> register.
+        /// </summary>
+        /// <param name="messageType">The type of the Harp message.</param>
+        /// <param name="value">The value to be stored in the message payload.</param>
+        /// <returns>
+        /// A <see cref="HarpMessage"/> object for the <see cref="NoiseSettings"/> register
+        /// with the specified message type and payload.
+        /// </returns>
+        public static HarpMessage FromPayload(MessageType messageType, NoiseSettingsPayload value)
+        {
+            return HarpMessage.FromUInt32(Address, messageType, FormatPayload(value));
+        }
+
+        /// <summary>
+        /// Returns a timestamped Harp message for the <see cref="NoiseSettings"/>
+        /// register.
+        /// </summary>
+        /// <param name="timestamp">The timestamp of the message payload, in seconds.</param>
+        /// <param name="messageType">The type of the Harp message.</param>
+        /// <param name="value">The value to be stored in the message payload.</param>
+        /// <returns>
+        /// A <see cref="HarpMessage"/> object for the <see cref="NoiseSettings"/> register
+        /// with the specified message type, timestamp, and payload.
+        /// </returns>
+        public static HarpMessage FromPayload(double timestamp, MessageType messageType, NoiseSettingsPayload value)
+        {
+            return HarpMessage.FromUInt32(Address, timestamp, messageType, FormatPayload(value));
+        }
+    }
+
+    /// <summary>
+    /// Provides methods for manipulating timestamped messages from the
+    /// NoiseSettings register.
+    /// </summary>
+    /// <seealso cref="NoiseSettings"/>
+    [Description("Filters and selects timestamped messages from the NoiseSettings register.")]
+    public partial class TimestampedNoiseSettings
+    {
+        /// <summary>
+        /// Represents the address of the <see cref="NoiseSettings"/> register. This field is constant.
+        /// </summary>
+        public const int Address = NoiseSettings.Address;
+
+        /// <summary>
+        /// Returns timestamped payload data for <see cref="NoiseSettings"/> register messages.
+        /// </summary>
+        /// <param name="message">A <see cref="HarpMessage"/> object representing the register message.</param>
+        /// <returns>A value representing the timestamped message payload.</returns>
+        public static Timestamped<NoiseSettingsPayload> GetPayload(HarpMessage message)
+        {
+            return NoiseSettings.GetTimestampedPayload(message);
+        }
+    }
+
+    /// <summary>
+    /// Represents a register that configuration of the digital output 0 (DO0).
+    /// </summary>
+    [Description("Configuration of the digital output 0 (DO0)")]
+    public partial class ConfigureDO0
+    {
+        /// <summary>
+        /// Represents the address of the <see cref="ConfigureDO0"/> register. This field is constant.
+        /// </summary>
+        public const int Address = 65;
+
+        /// <summary>
+        /// Represents the payload type of the <see cref="ConfigureDO0"/> register. This field is constant.
+        /// </summary>
+        public const PayloadType RegisterType = PayloadType.U8;
+
+        /// <summary>
+        /// Represents the length of the <see cref="ConfigureDO0"/> register. This field is constant.
+        /// </summary>
+        public const int RegisterLength = 1;
+
+        /// <summary>
+        /// Returns the payload data for <see cref="ConfigureDO0"/> register messages.
+        /// </summary>
+        /// <param name="message">A <see cref="HarpMessage"/> object representing the register message.</param>
+        /// <returns>A value representing the message payload.</returns>
+        public static DigitalOutputConfiguration GetPayload(HarpMessage message)
+        {
+            return (DigitalOutputConfiguration)message.GetPayloadByte();
+        }
+
+        /// <summary>
+        /// Returns the timestamped payload data for <see cref="ConfigureDO0"/> register messages.
+        /// </summary>
+        /// <param name="message">A <see cref="HarpMessage"/> object representing the register message.</param>
+        /// <returns>A value representing the timestamped message payload.</returns>
+        public static Timestamped<DigitalOutputConfiguration> GetTimestampedPayload(HarpMessage message)
+        {
+            var payload = message.GetTimestampedPayloadByte();
+            return Timestamped.Create((DigitalOutputConfiguration)payload.Value, payload.Seconds);
+        }
+
+        /// <summary>
+        /// Returns a Harp message for the <see cref="ConfigureDO0"/> register.
+        /// </summary>
+        /// <param name="messageType">The type of the Harp message.</param>
+        /// <param name="value">The value to be stored in the message payload.</param>
+        /// <returns>
+        /// A <see cref="HarpMessage"/> object for the <see cref="ConfigureDO0"/> register
+        /// with the specified message type and payload.
+        /// </returns>
+        public static HarpMessage FromPayload(MessageType messageType, DigitalOutputConfiguration value)
+        {
+            return HarpMessage.FromByte(Address, messageType, (byte)value);
+        }
+
+        /// <summary>
+        /// Returns a timestamped Harp message for the <see cref="ConfigureDO0"/>
+        /// register.
+        /// </summary>
+        /// <param name="timestamp">The timestamp of the message payload, in seconds.</param>
+        /// <param name="messageType">The type of the Harp message.</param>
+        /// <param name="value">The value to be stored in the message payload.</param>
+        /// <returns>
+        /// A <see cref="HarpMessage"/> object for the <see cref="ConfigureDO0"/> register
+        /// with the specified message type, timestamp, and payload.
+        /// </returns>
+        public static HarpMessage FromPayload(double timestamp, MessageType messageType, DigitalOutputConfiguration value)
+        {
+            return HarpMessage.FromByte(Address, timestamp, messageType, (byte)value);
+        }
+    }
+
+    /// <summary>
+    /// Provides methods for manipulating timestamped messages from the
+    /// ConfigureDO0 register.
+    /// </summary>
+    /// <seealso cref="ConfigureDO0"/>
+    [Description("Filters and selects timestamped messages from the ConfigureDO0 register.")]
+    public partial class TimestampedConfigureDO0
+    {
+        /// <summary>
+        /// Represents the address of the <see cref="ConfigureDO0"/> register. This field is constant.
+        /// </summary>
+        public const int Address = ConfigureDO0.Address;
+
+        /// <summary>
+        /// Returns timestamped payload data for <see cref="ConfigureDO0"/> register messages.
+        /// </summary>
+        /// <param name="message">A <see cref="HarpMessage"/> object representing the register message.</param>
+        /// <returns>A value representing the timestamped message payload.</returns>
+        public static Timestamped<DigitalOutputConfiguration> GetPayload(HarpMessage message)
+        {
+            return ConfigureDO0.GetTimestampedPayload(message);
+        }
+    }
+
+    /// <summary>
+    /// Represents a register that configuration of the digital output 1 (DO1).
+    /// </summary>
+    [Description("Configuration of the digital output 1 (DO1)")]
+    public partial class ConfigureDO1
+    {
+        /// <summary>
+        /// Represents the address of the <see cref="ConfigureDO1"/> register. This field is constant.
+        /// </summary>
+        public const int Address = 66;
+
+        /// <summary>
+        /// Represents the payload type of the <see cref="ConfigureDO1"/> register. This field is constant.
+        /// </summary>
+        public const PayloadType RegisterType = PayloadType.U8;
+
+        /// <summary>
+        /// Represents the length of the <see cref="ConfigureDO1"/> register. This field is constant.
+        /// </summary>
+        public const int RegisterLength = 1;
+
+        /// <summary>
+        /// Returns the payload data for <see cref="ConfigureDO1"/> register messages.
+        /// </summary>
+        /// <param name="message">A <see cref="HarpMessage"/> object representing the register message.</param>
+        /// <returns>A value representing the message payload.</returns>
+        public static DigitalOutputConfiguration GetPayload(HarpMessage message)
+        {
+            return (DigitalOutputConfiguration)message.GetPayloadByte();
+        }
+
+        /// <summary>
+        /// Returns the timestamped payload data for <see cref="ConfigureDO1"/> register messages.
+        /// </summary>
+        /// <param name="message">A <see cref="HarpMessage"/> object representing the register message.</param>
+        /// <returns>A value representing the timestamped message payload.</returns>
+        public static Timestamped<DigitalOutputConfiguration> GetTimestampedPayload(HarpMessage message)
+        {
+            var payload = message.GetTimestampedPayloadByte();
+            return Timestamped.Create((DigitalOutputConfiguration)payload.Value, payload.Seconds);
+        }
+
+        /// <summary>
+        /// Returns a Harp message for the <see cref="ConfigureDO1"/> register.
+        /// </summary>
+        /// <param name="messageType">The type of the Harp message.</param>
+        /// <param name="value">The value to be stored in the message payload.</param>
+        /// <returns>
+        /// A <see cref="HarpMessage"/> object for the <see cref="ConfigureDO1"/> register
+        /// with the specified message type and payload.
+        /// </returns>
+        public static HarpMessage FromPayload(MessageType messageType, DigitalOutputConfiguration value)
+        {
+            return HarpMessage.FromByte(Address, messageType, (byte)value);
+        }
+
+        /// <summary>
+        /// Returns a timestamped Harp message for the <see cref="ConfigureDO1"/>
+        /// register.
+        /// </summary>
+        /// <param name="timestamp">The timestamp of the message payload, in seconds.</param>
+        /// <param name="messageType">The type of the Harp message.</param>
+        /// <param name="value">The value to be stored in the message payload.</param>
+        /// <returns>
+        /// A <see cref="HarpMessage"/> object for the <see cref="ConfigureDO1"/> register
+        /// with the specified message type, timestamp, and payload.
+        /// </returns>
+        public static HarpMessage FromPayload(double timestamp, MessageType messageType, DigitalOutputConfiguration value)
+        {
+            return HarpMessage.FromByte(Address, timestamp, messageType, (byte)value);
+        }
+    }
+
+    /// <summary>
+    /// Provides methods for manipulating timestamped messages from the
+    /// ConfigureDO1 register.
+    /// </summary>
+    /// <seealso cref="ConfigureDO1"/>
+    [Description("Filters and selects timestamped messages from the ConfigureDO1 register.")]
+    public partial class TimestampedConfigureDO1
+    {
+        /// <summary>
+        /// Represents the address of the <see cref="ConfigureDO1"/> register. This field is constant.
+        /// </summary>
+        public const int Address = ConfigureDO1.Address;
+
+        /// <summary>
+        /// Returns timestamped payload data for <see cref="ConfigureDO1"/> register messages.
+        /// </summary>
+        /// <param name="message">A <see cref="HarpMessage"/> object representing the register message.</param>
+        /// <returns>A value representing the timestamped message payload.</returns>
+        public static Timestamped<DigitalOutputConfiguration> GetPayload(HarpMessage message)
         {
             return ConfigureDO1.GetTimestampedPayload(message);
         }
@@ -4025,34 +4507,140 @@ namespace Harp.SoundCard
         /// <summary>
         /// Returns timestamped payload data for <see cref="PulseDO2"/> register messages.
         /// </summary>
-        /// <param name="message">A <see cref="HarpMessage"/> object representing the register message.</param>
-        /// <returns>A value representing the timestamped message payload.</returns>
-        public static Timestamped<byte> GetPayload(HarpMessage message)
+        /// <param name="message">A <see cref="HarpMessage"/> object representing the register message.</param>
+        /// <returns>A value representing the timestamped message payload.</returns>
+        public static Timestamped<byte> GetPayload(HarpMessage message)
+        {
+            return PulseDO2.GetTimestampedPayload(message);
+        }
+    }
+
+    /// <summary>
+    /// Represents a register that plays a train of tone pips, amplitude modulated tones or clicks on both channels.
+    /// </summary>
+    [Description("Plays a train of tone pips, amplitude modulated tones or clicks on both channels")]
+    public partial class PlayStimulus
+    {
+        /// <summary>
+        /// Represents the address of the <see cref="PlayStimulus"/> register. This field is constant.
+        /// </summary>
+        public const int Address = 71;
+
+        /// <summary>
+        /// Represents the payload type of the <see cref="PlayStimulus"/> register. This field is constant.
+        /// </summary>
+        public const PayloadType RegisterType = PayloadType.U32;
+
+        /// <summary>
+        /// Represents the length of the <see cref="PlayStimulus"/> register. This field is constant.
+        /// </summary>
+        public const int RegisterLength = 9;
+
+        static PlayStimulusPayload ParsePayload(uint[] payload)
+        {
+            PlayStimulusPayload result;
+            result.FrequencyCarrier = payload[0];
+            result.FrequencyModulation = payload[1];
+            result.Depth = payload[2];
+            result.Duration = payload[3];
+            result.Ramp = payload[4];
+            result.Period = payload[5];
+            result.Count = payload[6];
+            result.AttenuationLeft = payload[7];
+            result.AttenuationRight = payload[8];
+            return result;
+        }
+
+        static uint[] FormatPayload(PlayStimulusPayload value)
+        {
+            uint[] result;
+            result = new uint[9];
+            result[0] = value.FrequencyCarrier;
+            result[1] = value.FrequencyModulation;
+            result[2] = value.Depth;
+            result[3] = value.Duration;
+            result[4] = value.Ramp;
+            result[5] = value.Period;
+            result[6] = value.Count;
+            result[7] = value.AttenuationLeft;
+            result[8] = value.AttenuationRight;
+            return result;
+        }
+
+        /// <summary>
+        /// Returns the payload data for <see cref="PlayStimulus"/> register messages.
+        /// </summary>
+        /// <param name="message">A <see cref="HarpMessage"/> object representing the register message.</param>
+        /// <returns>A value representing the message payload.</returns>
+        public static PlayStimulusPayload GetPayload(HarpMessage message)
+        {
+            return ParsePayload(message.GetPayloadArray<uint>());
+        }
+
+        /// <summary>
+        /// Returns the timestamped payload data for <see cref="PlayStimulus"/> register messages.
+        /// </summary>
+        /// <param name="message">A <see cref="HarpMessage"/> object representing the register message.</param>
+        /// <returns>A value representing the timestamped message payload.</returns>
+        public static Timestamped<PlayStimulusPayload> GetTimestampedPayload(HarpMessage message)
+        {
+            var payload = message.GetTimestampedPayloadArray<uint>();
+            return Timestamped.Create(ParsePayload(payload.Value), payload.Seconds);
+        }
+
+        /// <summary>
+        /// Returns a Harp message for the <see cref="PlayStimulus"/> register.
+        /// </summary>
+        /// <param name="messageType">The type of the Harp message.</param>
+        /// <param name="value">The value to be stored in the message payload.</param>
+        /// <returns>
+        /// A <see cref="HarpMessage"/> object for the <see cref="PlayStimulus"/> register
+        /// with the specified message type and payload.
+        /// </returns>
+        public static HarpMessage FromPayload(MessageType messageType, PlayStimulusPayload value)
+        {
+            return HarpMessage.FromUInt32(Address, messageType, FormatPayload(value));
+        }
+
+        /// <summary>
+        /// Returns a timestamped Harp message for the <see cref="PlayStimulus"/>
+        /// register.
+        /// </summary>
+        /// <param name="timestamp">The timestamp of the message payload, in seconds.</param>
+        /// <param name="messageType">The type of the Harp message.</param>
+        /// <param name="value">The value to be stored in the message payload.</param>
+        /// <returns>
+        /// A <see cref="HarpMessage"/> object for the <see cref="PlayStimulus"/> register
+        /// with the specified message type, timestamp, and payload.
+        /// </returns>
+        public static HarpMessage FromPayload(double timestamp, MessageType messageType, PlayStimulusPayload value)
         {
-            return PulseDO2.GetTimestampedPayload(message);
+            return HarpMessage.FromUInt32(Address, timestamp, messageType, FormatPayload(value));
         }
     }
 
     /// <summary>
-    /// Represents a register that reserved for future use.
+    /// Provides methods for manipulating timestamped messages from the
+    /// PlayStimulus register.
     /// </summary>
-    [Description("Reserved for future use")]
-    internal partial class Reserved5
+    /// <seealso cref="PlayStimulus"/>
+    [Description("Filters and selects timestamped messages from the PlayStimulus register.")]
+    public partial class TimestampedPlayStimulus
     {
         /// <summary>
-        /// Represents the address of the <see cref="Reserved5"/> register. This field is constant.
-        /// </summary>
-        public const int Address = 71;
-
-        /// <summary>
-        /// Represents the payload type of the <see cref="Reserved5"/> register. This field is constant.
+        /// Represents the address of the <see cref="PlayStimulus"/> register. This field is constant.
         /// </summary>
-        public const PayloadType RegisterType = PayloadType.U8;
+        public const int Address = PlayStimulus.Address;
 
         /// <summary>
-        /// Represents the length of the <see cref="Reserved5"/> register. This field is constant.
+        /// Returns timestamped payload data for <see cref="PlayStimulus"/> register messages.
         /// </summary>
-        public const int RegisterLength = 1;
+        /// <param name="message">A <see cref="HarpMessage"/> object representing the register message.</param>
+        /// <returns>A value representing the timestamped message payload.</returns>
+        public static Timestamped<PlayStimulusPayload> GetPayload(HarpMessage message)
+        {
+            return PlayStimulus.GetTimestampedPayload(message);
+        }
     }
 
     /// <summary>
@@ -5018,6 +5606,8 @@ namespace Harp.SoundCard
     /// <seealso cref="CreateAttenuationRightPayload"/>
     /// <seealso cref="CreateAttenuationBothPayload"/>
     /// <seealso cref="CreateAttenuationAndPlaySoundOrFreqPayload"/>
+    /// <seealso cref="CreateAttenuationAndMixSoundPayload"/>
+    /// <seealso cref="CreatePlaySoundAtTimePayload"/>
     /// <seealso cref="CreateInputStatePayload"/>
     /// <seealso cref="CreateConfigureDI0Payload"/>
     /// <seealso cref="CreateConfigureDI1Payload"/>
@@ -5040,12 +5630,16 @@ namespace Harp.SoundCard
     /// <seealso cref="CreateAttenuationAndFrequencyDI0Payload"/>
     /// <seealso cref="CreateAttenuationAndFrequencyDI1Payload"/>
     /// <seealso cref="CreateAttenuationAndFrequencyDI2Payload"/>
+    /// <seealso cref="CreatePlayStereoTonePayload"/>
+    /// <seealso cref="CreatePlaySweepPayload"/>
+    /// <seealso cref="CreateNoiseSettingsPayload"/>
     /// <seealso cref="CreateConfigureDO0Payload"/>
     /// <seealso cref="CreateConfigureDO1Payload"/>
     /// <seealso cref="CreateConfigureDO2Payload"/>
     /// <seealso cref="CreatePulseDO0Payload"/>
     /// <seealso cref="CreatePulseDO1Payload"/>
     /// <seealso cref="CreatePulseDO2Payload"/>
+    /// <seealso cref="CreatePlayStimulusPayload"/>
     /// <seealso cref="CreateOutputSetPayload"/>
     /// <seealso cref="CreateOutputClearPayload"/>
     /// <seealso cref="CreateOutputTogglePayload"/>
@@ -5060,6 +5654,8 @@ namespace Harp.SoundCard
     [XmlInclude(typeof(CreateAttenuationRightPayload))]
     [XmlInclude(typeof(CreateAttenuationBothPayload))]
     [XmlInclude(typeof(CreateAttenuationAndPlaySoundOrFreqPayload))]
+    [XmlInclude(typeof(CreateAttenuationAndMixSoundPayload))]
+    [XmlInclude(typeof(CreatePlaySoundAtTimePayload))]
     [XmlInclude(typeof(CreateInputStatePayload))]
     [XmlInclude(typeof(CreateConfigureDI0Payload))]
     [XmlInclude(typeof(CreateConfigureDI1Payload))]
@@ -5082,12 +5678,16 @@ namespace Harp.SoundCard
     [XmlInclude(typeof(CreateAttenuationAndFrequencyDI0Payload))]
     [XmlInclude(typeof(CreateAttenuationAndFrequencyDI1Payload))]
     [XmlInclude(typeof(CreateAttenuationAndFrequencyDI2Payload))]
+    [XmlInclude(typeof(CreatePlayStereoTonePayload))]
+    [XmlInclude(typeof(CreatePlaySweepPayload))]
+    [XmlInclude(typeof(CreateNoiseSettingsPayload))]
     [XmlInclude(typeof(CreateConfigureDO0Payload))]
     [XmlInclude(typeof(CreateConfigureDO1Payload))]
     [XmlInclude(typeof(CreateConfigureDO2Payload))]
     [XmlInclude(typeof(CreatePulseDO0Payload))]
     [XmlInclude(typeof(CreatePulseDO1Payload))]
     [XmlInclude(typeof(CreatePulseDO2Payload))]
+    [XmlInclude(typeof(CreatePlayStimulusPayload))]
     [XmlInclude(typeof(CreateOutputSetPayload))]
     [XmlInclude(typeof(CreateOutputClearPayload))]
     [XmlInclude(typeof(CreateOutputTogglePayload))]
@@ -5102,6 +5702,8 @@ namespace Harp.SoundCard
     [XmlInclude(typeof(CreateTimestampedAttenuationRightPayload))]
     [XmlInclude(typeof(CreateTimestampedAttenuationBothPayload))]
     [XmlInclude(typeof(CreateTimestampedAttenuationAndPlaySoundOrFreqPayload))]
+    [XmlInclude(typeof(CreateTimestampedAttenuationAndMixSoundPayload))]
+    [XmlInclude(typeof(CreateTimestampedPlaySoundAtTimePayload))]
     [XmlInclude(typeof(CreateTimestampedInputStatePayload))]
     [XmlInclude(typeof(CreateTimestampedConfigureDI0Payload))]
     [XmlInclude(typeof(CreateTimestampedConfigureDI1Payload))]
@@ -5124,12 +5726,16 @@ namespace Harp.SoundCard
     [XmlInclude(typeof(CreateTimestampedAttenuationAndFrequencyDI0Payload))]
     [XmlInclude(typeof(CreateTimestampedAttenuationAndFrequencyDI1Payload))]
     [XmlInclude(typeof(CreateTimestampedAttenuationAndFrequencyDI2Payload))]
+    [XmlInclude(typeof(CreateTimestampedPlayStereoTonePayload))]
+    [XmlInclude(typeof(CreateTimestampedPlaySweepPayload))]
+    [XmlInclude(typeof(CreateTimestampedNoiseSettingsPayload))]
     [XmlInclude(typeof(CreateTimestampedConfigureDO0Payload))]
     [XmlInclude(typeof(CreateTimestampedConfigureDO1Payload))]
     [XmlInclude(typeof(CreateTimestampedConfigureDO2Payload))]
     [XmlInclude(typeof(CreateTimestampedPulseDO0Payload))]
     [XmlInclude(typeof(CreateTimestampedPulseDO1Payload))]
     [XmlInclude(typeof(CreateTimestampedPulseDO2Payload))]
+    [XmlInclude(typeof(CreateTimestampedPlayStimulusPayload))]
     [XmlInclude(typeof(CreateTimestampedOutputSetPayload))]
     [XmlInclude(typeof(CreateTimestampedOutputClearPayload))]
     [XmlInclude(typeof(CreateTimestampedOutputTogglePayload))]
@@ -5154,16 +5760,16 @@ namespace Harp.SoundCard
 
     /// <summary>
     /// Represents an operator that creates a message payload
-    /// that starts the sound index (if less than 32) or frequency (if greater or equal than 32).
+    /// that starts the sound index (if less than 32, or 64 on the 4 Gb memory), frequency (if greater or equal) or noise (40001 to 40003).
     /// </summary>
     [DisplayName("PlaySoundOrFrequencyPayload")]
-    [Description("Creates a message payload that starts the sound index (if less than 32) or frequency (if greater or equal than 32).")]
+    [Description("Creates a message payload that starts the sound index (if less than 32, or 64 on the 4 Gb memory), frequency (if greater or equal) or noise (40001 to 40003).")]
     public partial class CreatePlaySoundOrFrequencyPayload
     {
         /// <summary>
-        /// Gets or sets the value that starts the sound index (if less than 32) or frequency (if greater or equal than 32).
+        /// Gets or sets the value that starts the sound index (if less than 32, or 64 on the 4 Gb memory), frequency (if greater or equal) or noise (40001 to 40003).
         /// </summary>
-        [Description("The value that starts the sound index (if less than 32) or frequency (if greater or equal than 32).")]
+        [Description("The value that starts the sound index (if less than 32, or 64 on the 4 Gb memory), frequency (if greater or equal) or noise (40001 to 40003).")]
         public ushort PlaySoundOrFrequency { get; set; }
 
         /// <summary>
@@ -5176,7 +5782,7 @@ namespace Harp.SoundCard
         }
 
         /// <summary>
-        /// Creates a message that starts the sound index (if less than 32) or frequency (if greater or equal than 32).
+        /// Creates a message that starts the sound index (if less than 32, or 64 on the 4 Gb memory), frequency (if greater or equal) or noise (40001 to 40003).
         /// </summary>
         /// <param name="messageType">Specifies the type of the created message.</param>
         /// <returns>A new message for the PlaySoundOrFrequency register.</returns>
@@ -5188,14 +5794,14 @@ namespace Harp.SoundCard
 
     /// <summary>
     /// Represents an operator that creates a timestamped message payload
-    /// that starts the sound index (if less than 32) or frequency (if greater or equal than 32).
+    /// that starts the sound index (if less than 32, or 64 on the 4 Gb memory), frequency (if greater or equal) or noise (40001 to 40003).
     /// </summary>
     [DisplayName("TimestampedPlaySoundOrFrequencyPayload")]
-    [Description("Creates a timestamped message payload that starts the sound index (if less than 32) or frequency (if greater or equal than 32).")]
+    [Description("Creates a timestamped message payload that starts the sound index (if less than 32, or 64 on the 4 Gb memory), frequency (if greater or equal) or noise (40001 to 40003).")]
     public partial class CreateTimestampedPlaySoundOrFrequencyPayload : CreatePlaySoundOrFrequencyPayload
     {
         /// <summary>
-        /// Creates a timestamped message that starts the sound index (if less than 32) or frequency (if greater or equal than 32).
+        /// Creates a timestamped message that starts the sound index (if less than 32, or 64 on the 4 Gb memory), frequency (if greater or equal) or noise (40001 to 40003).
         /// </summary>
         /// <param name="timestamp">The timestamp of the message payload, in seconds.</param>
         /// <param name="messageType">Specifies the type of the created message.</param>
@@ -5476,6 +6082,114 @@ namespace Harp.SoundCard
         }
     }
 
+    /// <summary>
+    /// Represents an operator that creates a message payload
+    /// that configures attenuation and mixes sound index with the current sound [Index] [Att L] [Att R].
+    /// </summary>
+    [DisplayName("AttenuationAndMixSoundPayload")]
+    [Description("Creates a message payload that configures attenuation and mixes sound index with the current sound [Index] [Att L] [Att R].")]
+    public partial class CreateAttenuationAndMixSoundPayload
+    {
+        /// <summary>
+        /// Gets or sets the value that configures attenuation and mixes sound index with the current sound [Index] [Att L] [Att R].
+        /// </summary>
+        [Description("The value that configures attenuation and mixes sound index with the current sound [Index] [Att L] [Att R].")]
+        public ushort[] AttenuationAndMixSound { get; set; }
+
+        /// <summary>
+        /// Creates a message payload for the AttenuationAndMixSound register.
+        /// </summary>
+        /// <returns>The created message payload value.</returns>
+        public ushort[] GetPayload()
+        {
+            return AttenuationAndMixSound;
+        }
+
+        /// <summary>
+        /// Creates a message that configures attenuation and mixes sound index with the current sound [Index] [Att L] [Att R].
+        /// </summary>
+        /// <param name="messageType">Specifies the type of the created message.</param>
+        /// <returns>A new message for the AttenuationAndMixSound register.</returns>
+        public HarpMessage GetMessage(MessageType messageType)
+        {
+            return Harp.SoundCard.AttenuationAndMixSound.FromPayload(messageType, GetPayload());
+        }
+    }
+
+    /// <summary>
+    /// Represents an operator that creates a timestamped message payload
+    /// that configures attenuation and mixes sound index with the current sound [Index] [Att L] [Att R].
+    /// </summary>
+    [DisplayName("TimestampedAttenuationAndMixSoundPayload")]
+    [Description("Creates a timestamped message payload that configures attenuation and mixes sound index with the current sound [Index] [Att L] [Att R].")]
+    public partial class CreateTimestampedAttenuationAndMixSoundPayload : CreateAttenuationAndMixSoundPayload
+    {
+        /// <summary>
+        /// Creates a timestamped message that configures attenuation and mixes sound index with the current sound [Index] [Att L] [Att R].
+        /// </summary>
+        /// <param name="timestamp">The timestamp of the message payload, in seconds.</param>
+        /// <param name="messageType">Specifies the type of the created message.</param>
+        /// <returns>A new timestamped message for the AttenuationAndMixSound register.</returns>
+        public HarpMessage GetMessage(double timestamp, MessageType messageType)
+        {
+            return Harp.SoundCard.AttenuationAndMixSound.FromPayload(timestamp, messageType, GetPayload());
+        }
+    }
+
+    /// <summary>
+    /// Represents an operator that creates a message payload
+    /// that plays sound index at a Harp timestamp with the current attenuation [Index] [Seconds] [Microseconds].
+    /// </summary>
+    [DisplayName("PlaySoundAtTimePayload")]
+    [Description("Creates a message payload that plays sound index at a Harp timestamp with the current attenuation [Index] [Seconds] [Microseconds].")]
+    public partial class CreatePlaySoundAtTimePayload
+    {
+        /// <summary>
+        /// Gets or sets the value that plays sound index at a Harp timestamp with the current attenuation [Index] [Seconds] [Microseconds].
+        /// </summary>
+        [Description("The value that plays sound index at a Harp timestamp with the current attenuation [Index] [Seconds] [Microseconds].")]
+        public uint[] PlaySoundAtTime { get; set; }
+
+        /// <summary>
+        /// Creates a message payload for the PlaySoundAtTime register.
+        /// </summary>
+        /// <returns>The created message payload value.</returns>
+        public uint[] GetPayload()
+        {
+            return PlaySoundAtTime;
+        }
+
+        /// <summary>
+        /// Creates a message that plays sound index at a Harp timestamp with the current attenuation [Index] [Seconds] [Microseconds].
+        /// </summary>
+        /// <param name="messageType">Specifies the type of the created message.</param>
+        /// <returns>A new message for the PlaySoundAtTime register.</returns>
+        public HarpMessage GetMessage(MessageType messageType)
+        {
+            return Harp.SoundCard.PlaySoundAtTime.FromPayload(messageType, GetPayload());
+        }
+    }
+
+    /// <summary>
+    /// Represents an operator that creates a timestamped message payload
+    /// that plays sound index at a Harp timestamp with the current attenuation [Index] [Seconds] [Microseconds].
+    /// </summary>
+    [DisplayName("TimestampedPlaySoundAtTimePayload")]
+    [Description("Creates a timestamped message payload that plays sound index at a Harp timestamp with the current attenuation [Index] [Seconds] [Microseconds].")]
+    public partial class CreateTimestampedPlaySoundAtTimePayload : CreatePlaySoundAtTimePayload
+    {
+        /// <summary>
+        /// Creates a timestamped message that plays sound index at a Harp timestamp with the current attenuation [Index] [Seconds] [Microseconds].
+        /// </summary>
+        /// <param name="timestamp">The timestamp of the message payload, in seconds.</param>
+        /// <param name="messageType">Specifies the type of the created message.</param>
+        /// <returns>A new timestamped message for the PlaySoundAtTime register.</returns>
+        public HarpMessage GetMessage(double timestamp, MessageType messageType)
+        {
+            return Harp.SoundCard.PlaySoundAtTime.FromPayload(timestamp, messageType, GetPayload());
+        }
+    }
+
     /// <summary>
     /// Represents an operator that creates a message payload
     /// that state of the digital inputs.
@@ -6580,87 +7294,332 @@ namespace Harp.SoundCard
         }
 
         /// <summary>
-        /// Creates a message that sound index and attenuation to be played when triggering DI1 [Att BOTH] [Frequency].
+        /// Creates a message that sound index and attenuation to be played when triggering DI1 [Att BOTH] [Frequency].
+        /// </summary>
+        /// <param name="messageType">Specifies the type of the created message.</param>
+        /// <returns>A new message for the AttenuationAndFrequencyDI1 register.</returns>
+        public HarpMessage GetMessage(MessageType messageType)
+        {
+            return Harp.SoundCard.AttenuationAndFrequencyDI1.FromPayload(messageType, GetPayload());
+        }
+    }
+
+    /// <summary>
+    /// Represents an operator that creates a timestamped message payload
+    /// that sound index and attenuation to be played when triggering DI1 [Att BOTH] [Frequency].
+    /// </summary>
+    [DisplayName("TimestampedAttenuationAndFrequencyDI1Payload")]
+    [Description("Creates a timestamped message payload that sound index and attenuation to be played when triggering DI1 [Att BOTH] [Frequency].")]
+    public partial class CreateTimestampedAttenuationAndFrequencyDI1Payload : CreateAttenuationAndFrequencyDI1Payload
+    {
+        /// <summary>
+        /// Creates a timestamped message that sound index and attenuation to be played when triggering DI1 [Att BOTH] [Frequency].
+        /// </summary>
+        /// <param name="timestamp">The timestamp of the message payload, in seconds.</param>
+        /// <param name="messageType">Specifies the type of the created message.</param>
+        /// <returns>A new timestamped message for the AttenuationAndFrequencyDI1 register.</returns>
+        public HarpMessage GetMessage(double timestamp, MessageType messageType)
+        {
+            return Harp.SoundCard.AttenuationAndFrequencyDI1.FromPayload(timestamp, messageType, GetPayload());
+        }
+    }
+
+    /// <summary>
+    /// Represents an operator that creates a message payload
+    /// that sound index and attenuation to be played when triggering DI2 [Att BOTH] [Frequency].
+    /// </summary>
+    [DisplayName("AttenuationAndFrequencyDI2Payload")]
+    [Description("Creates a message payload that sound index and attenuation to be played when triggering DI2 [Att BOTH] [Frequency].")]
+    public partial class CreateAttenuationAndFrequencyDI2Payload
+    {
+        /// <summary>
+        /// Gets or sets the value that sound index and attenuation to be played when triggering DI2 [Att BOTH] [Frequency].
+        /// </summary>
+        [Description("The value that sound index and attenuation to be played when triggering DI2 [Att BOTH] [Frequency].")]
+        public ushort[] AttenuationAndFrequencyDI2 { get; set; }
+
+        /// <summary>
+        /// Creates a message payload for the AttenuationAndFrequencyDI2 register.
+        /// </summary>
+        /// <returns>The created message payload value.</returns>
+        public ushort[] GetPayload()
+        {
+            return AttenuationAndFrequencyDI2;
+        }
+
+        /// <summary>
+        /// Creates a message that sound index and attenuation to be played when triggering DI2 [Att BOTH] [Frequency].
+        /// </summary>
+        /// <param name="messageType">Specifies the type of the created message.</param>
+        /// <returns>A new message for the AttenuationAndFrequencyDI2 register.</returns>
+        public HarpMessage GetMessage(MessageType messageType)
+        {
+            return Harp.SoundCard.AttenuationAndFrequencyDI2.FromPayload(messageType, GetPayload());
+        }
+    }
+
+    /// <summary>
+    /// Represents an operator that creates a timestamped message payload
+    /// that sound index and attenuation to be played when triggering DI2 [Att BOTH] [Frequency].
+    /// </summary>
+    [DisplayName("TimestampedAttenuationAndFrequencyDI2Payload")]
+    [Description("Creates a timestamped message payload that sound index and attenuation to be played when triggering DI2 [Att BOTH] [Frequency].")]
+    public partial class CreateTimestampedAttenuationAndFrequencyDI2Payload : CreateAttenuationAndFrequencyDI2Payload
+    {
+        /// <summary>
+        /// Creates a timestamped message that sound index and attenuation to be played when triggering DI2 [Att BOTH] [Frequency].
+        /// </summary>
+        /// <param name="timestamp">The timestamp of the message payload, in seconds.</param>
+        /// <param name="messageType">Specifies the type of the created message.</param>
+        /// <returns>A new timestamped message for the AttenuationAndFrequencyDI2 register.</returns>
+        public HarpMessage GetMessage(double timestamp, MessageType messageType)
+        {
+            return Harp.SoundCard.AttenuationAndFrequencyDI2.FromPayload(timestamp, messageType, GetPayload());
+        }
+    }
+
+    /// <summary>
+    /// Represents an operator that creates a message payload
+    /// that plays a tone with an independent frequency, phase and attenuation on each channel.
+    /// </summary>
+    [DisplayName("PlayStereoTonePayload")]
+    [Description("Creates a message payload that plays a tone with an independent frequency, phase and attenuation on each channel.")]
+    public partial class CreatePlayStereoTonePayload
+    {
+        /// <summary>
+        /// Gets or sets a value that the frequency of the left channel in mHz, or zero to keep it silent.
+        /// </summary>
+        [Description("The frequency of the left channel in mHz, or zero to keep it silent.")]
+        public uint FrequencyLeft { get; set; }
+
+        /// <summary>
+        /// Gets or sets a value that the frequency of the right channel in mHz, or zero to keep it silent.
+        /// </summary>
+        [Description("The frequency of the right channel in mHz, or zero to keep it silent.")]
+        public uint FrequencyRight { get; set; }
+
+        /// <summary>
+        /// Gets or sets a value that the phase offset of the left channel to the right channel (1 LSB is 0.01 degrees).
+        /// </summary>
+        [Description("The phase offset of the left channel to the right channel (1 LSB is 0.01 degrees).")]
+        public uint PhaseLeft { get; set; }
+
+        /// <summary>
+        /// Gets or sets a value that the attenuation of the left channel (1 LSB is 0.1dB).
+        /// </summary>
+        [Description("The attenuation of the left channel (1 LSB is 0.1dB).")]
+        public uint AttenuationLeft { get; set; }
+
+        /// <summary>
+        /// Gets or sets a value that the attenuation of the right channel (1 LSB is 0.1dB).
+        /// </summary>
+        [Description("The attenuation of the right channel (1 LSB is 0.1dB).")]
+        public uint AttenuationRight { get; set; }
+
+        /// <summary>
+        /// Creates a message payload for the PlayStereoTone register.
+        /// </summary>
+        /// <returns>The created message payload value.</returns>
+        public PlayStereoTonePayload GetPayload()
+        {
+            PlayStereoTonePayload value;
+            value.FrequencyLeft = FrequencyLeft;
+            value.FrequencyRight = FrequencyRight;
+            value.PhaseLeft = PhaseLeft;
+            value.AttenuationLeft = AttenuationLeft;
+            value.AttenuationRight = AttenuationRight;
+            return value;
+        }
+
+        /// <summary>
+        /// Creates a message that plays a tone with an independent frequency, phase and attenuation on each channel.
+        /// </summary>
+        /// <param name="messageType">Specifies the type of the created message.</param>
+        /// <returns>A new message for the PlayStereoTone register.</returns>
+        public HarpMessage GetMessage(MessageType messageType)
+        {
+            return Harp.SoundCard.PlayStereoTone.FromPayload(messageType, GetPayload());
+        }
+    }
+
+    /// <summary>
+    /// Represents an operator that creates a timestamped message payload
+    /// that plays a tone with an independent frequency, phase and attenuation on each channel.
+    /// </summary>
+    [DisplayName("TimestampedPlayStereoTonePayload")]
+    [Description("Creates a timestamped message payload that plays a tone with an independent frequency, phase and attenuation on each channel.")]
+    public partial class CreateTimestampedPlayStereoTonePayload : CreatePlayStereoTonePayload
+    {
+        /// <summary>
+        /// Creates a timestamped message that plays a tone with an independent frequency, phase and attenuation on each channel.
+        /// </summary>
+        /// <param name="timestamp">The timestamp of the message payload, in seconds.</param>
+        /// <param name="messageType">Specifies the type of the created message.</param>
+        /// <returns>A new timestamped message for the PlayStereoTone register.</returns>
+        public HarpMessage GetMessage(double timestamp, MessageType messageType)
+        {
+            return Harp.SoundCard.PlayStereoTone.FromPayload(timestamp, messageType, GetPayload());
+        }
+    }
+
+    /// <summary>
+    /// Represents an operator that creates a message payload
+    /// that plays a tone sweeping from a start to an end frequency on both channels.
+    /// </summary>
+    [DisplayName("PlaySweepPayload")]
+    [Description("Creates a message payload that plays a tone sweeping from a start to an end frequency on both channels.")]
+    public partial class CreatePlaySweepPayload
+    {
+        /// <summary>
+        /// Gets or sets a value that the start frequency in mHz.
+        /// </summary>
+        [Description("The start frequency in mHz.")]
+        public uint FrequencyStart { get; set; }
+
+        /// <summary>
+        /// Gets or sets a value that the end frequency in mHz.
+        /// </summary>
+        [Description("The end frequency in mHz.")]
+        public uint FrequencyEnd { get; set; }
+
+        /// <summary>
+        /// Gets or sets a value that the duration of the sweep in ms.
+        /// </summary>
+        [Description("The duration of the sweep in ms.")]
+        public uint Duration { get; set; }
+
+        /// <summary>
+        /// Gets or sets a value that the sweep mode, linear (0) or logarithmic (1), plus 2 to hold the end frequency instead of stopping.
+        /// </summary>
+        [Description("The sweep mode, linear (0) or logarithmic (1), plus 2 to hold the end frequency instead of stopping.")]
+        public uint Mode { get; set; }
+
+        /// <summary>
+        /// Gets or sets a value that the attenuation of the left channel (1 LSB is 0.1dB).
+        /// </summary>
+        [Description("The attenuation of the left channel (1 LSB is 0.1dB).")]
+        public uint AttenuationLeft { get; set; }
+
+        /// <summary>
+        /// Gets or sets a value that the attenuation of the right channel (1 LSB is 0.1dB).
+        /// </summary>
+        [Description("The attenuation of the right channel (1 LSB is 0.1dB).")]
+        public uint AttenuationRight { get; set; }
+
+        /// <summary>
+        /// Creates a message payload for the PlaySweep register.
+        /// </summary>
+        /// <returns>The created message payload value.</returns>
+        public PlaySweepPayload GetPayload()
+        {
+            PlaySweepPayload value;
+            value.FrequencyStart = FrequencyStart;
+            value.FrequencyEnd = FrequencyEnd;
+            value.Duration = Duration;
+            value.Mode = Mode;
+            value.AttenuationLeft = AttenuationLeft;
+            value.AttenuationRight = AttenuationRight;
+            return value;
+        }
+
+        /// <summary>
+        /// Creates a message that plays a tone sweeping from a start to an end frequency on both channels.
         /// </summary>
         /// <param name="messageType">Specifies the type of the created message.</param>
-        /// <returns>A new message for the AttenuationAndFrequencyDI1 register.</returns>
+        /// <returns>A new message for the PlaySweep register.</returns>
         public HarpMessage GetMessage(MessageType messageType)
         {
-            return Harp.SoundCard.AttenuationAndFrequencyDI1.FromPayload(messageType, GetPayload());
+            return Harp.SoundCard.PlaySweep.FromPayload(messageType, GetPayload());
         }
     }
 
     /// <summary>
     /// Represents an operator that creates a timestamped message payload
-    /// that sound index and attenuation to be played when triggering DI1 [Att BOTH] [Frequency].
+    /// that plays a tone sweeping from a start to an end frequency on both channels.
     /// </summary>
-    [DisplayName("TimestampedAttenuationAndFrequencyDI1Payload")]
-    [Description("Creates a timestamped message payload that sound index and attenuation to be played when triggering DI1 [Att BOTH] [Frequency].")]
-    public partial class CreateTimestampedAttenuationAndFrequencyDI1Payload : CreateAttenuationAndFrequencyDI1Payload
+    [DisplayName("TimestampedPlaySweepPayload")]
+    [Description("Creates a timestamped message payload that plays a tone sweeping from a start to an end frequency on both channels.")]
+    public partial class CreateTimestampedPlaySweepPayload : CreatePlaySweepPayload
     {
         /// <summary>
-        /// Creates a timestamped message that sound index and attenuation to be played when triggering DI1 [Att BOTH] [Frequency].
+        /// Creates a timestamped message that plays a tone sweeping from a start to an end frequency on both channels.
         /// </summary>
         /// <param name="timestamp">The timestamp of the message payload, in seconds.</param>
         /// <param name="messageType">Specifies the type of the created message.</param>
-        /// <returns>A new timestamped message for the AttenuationAndFrequencyDI1 register.</returns>
+        /// <returns>A new timestamped message for the PlaySweep register.</returns>
         public HarpMessage GetMessage(double timestamp, MessageType messageType)
         {
-            return Harp.SoundCard.AttenuationAndFrequencyDI1.FromPayload(timestamp, messageType, GetPayload());
+            return Harp.SoundCard.PlaySweep.FromPayload(timestamp, messageType, GetPayload());
         }
     }
 
     /// <summary>
     /// Represents an operator that creates a message payload
-    /// that sound index and attenuation to be played when triggering DI2 [Att BOTH] [Frequency].
+    /// that configures the noises played with the indexes 40001 (white), 40002 (pink) and 40003 (band-pass).
     /// </summary>
-    [DisplayName("AttenuationAndFrequencyDI2Payload")]
-    [Description("Creates a message payload that sound index and attenuation to be played when triggering DI2 [Att BOTH] [Frequency].")]
-    public partial class CreateAttenuationAndFrequencyDI2Payload
+    [DisplayName("NoiseSettingsPayload")]
+    [Description("Creates a message payload that configures the noises played with the indexes 40001 (white), 40002 (pink) and 40003 (band-pass).")]
+    public partial class CreateNoiseSettingsPayload
     {
         /// <summary>
-        /// Gets or sets the value that sound index and attenuation to be played when triggering DI2 [Att BOTH] [Frequency].
+        /// Gets or sets a value that the seed of the noise generator, the same seed plays the same noise.
         /// </summary>
-        [Description("The value that sound index and attenuation to be played when triggering DI2 [Att BOTH] [Frequency].")]
-        public ushort[] AttenuationAndFrequencyDI2 { get; set; }
+        [Description("The seed of the noise generator, the same seed plays the same noise.")]
+        public uint Seed { get; set; }
 
         /// <summary>
-        /// Creates a message payload for the AttenuationAndFrequencyDI2 register.
+        /// Gets or sets a value that the low edge of the band-pass noise in Hz, 0 for no high-pass.
+        /// </summary>
+        [Description("The low edge of the band-pass noise in Hz, 0 for no high-pass.")]
+        public uint FrequencyLow { get; set; }
+
+        /// <summary>
+        /// Gets or sets a value that the high edge of the band-pass noise in Hz, 0 for no low-pass.
+        /// </summary>
+        [Description("The high edge of the band-pass noise in Hz, 0 for no low-pass.")]
+        public uint FrequencyHigh { get; set; }
+
+        /// <summary>
+        /// Creates a message payload for the NoiseSettings register.
         /// </summary>
         /// <returns>The created message payload value.</returns>
-        public ushort[] GetPayload()
+        public NoiseSettingsPayload GetPayload()
         {
-            return AttenuationAndFrequencyDI2;
+            NoiseSettingsPayload value;
+            value.Seed = Seed;
+            value.FrequencyLow = FrequencyLow;
+            value.FrequencyHigh = FrequencyHigh;
+            return value;
         }
 
         /// <summary>
-        /// Creates a message that sound index and attenuation to be played when triggering DI2 [Att BOTH] [Frequency].
+        /// Creates a message that configures the noises played with the indexes 40001 (white), 40002 (pink) and 40003 (band-pass).
         /// </summary>
         /// <param name="messageType">Specifies the type of the created message.</param>
-        /// <returns>A new message for the AttenuationAndFrequencyDI2 register.</returns>
+        /// <returns>A new message for the NoiseSettings register.</returns>
         public HarpMessage GetMessage(MessageType messageType)
         {
-            return Harp.SoundCard.AttenuationAndFrequencyDI2.FromPayload(messageType, GetPayload());
+            return Harp.SoundCard.NoiseSettings.FromPayload(messageType, GetPayload());
         }
     }
 
     /// <summary>
     /// Represents an operator that creates a timestamped message payload
-    /// that sound index and attenuation to be played when triggering DI2 [Att BOTH] [Frequency].
+    /// that configures the noises played with the indexes 40001 (white), 40002 (pink) and 40003 (band-pass).
     /// </summary>
-    [DisplayName("TimestampedAttenuationAndFrequencyDI2Payload")]
-    [Description("Creates a timestamped message payload that sound index and attenuation to be played when triggering DI2 [Att BOTH] [Frequency].")]
-    public partial class CreateTimestampedAttenuationAndFrequencyDI2Payload : CreateAttenuationAndFrequencyDI2Payload
+    [DisplayName("TimestampedNoiseSettingsPayload")]
+    [Description("Creates a timestamped message payload that configures the noises played with the indexes 40001 (white), 40002 (pink) and 40003 (band-pass).")]
+    public partial class CreateTimestampedNoiseSettingsPayload : CreateNoiseSettingsPayload
     {
         /// <summary>
-        /// Creates a timestamped message that sound index and attenuation to be played when triggering DI2 [Att BOTH] [Frequency].
+        /// Creates a timestamped message that configures the noises played with the indexes 40001 (white), 40002 (pink) and 40003 (band-pass).
         /// </summary>
         /// <param name="timestamp">The timestamp of the message payload, in seconds.</param>
         /// <param name="messageType">Specifies the type of the created message.</param>
-        /// <returns>A new timestamped message for the AttenuationAndFrequencyDI2 register.</returns>
+        /// <returns>A new timestamped message for the NoiseSettings register.</returns>
         public HarpMessage GetMessage(double timestamp, MessageType messageType)
         {
-            return Harp.SoundCard.AttenuationAndFrequencyDI2.FromPayload(timestamp, messageType, GetPayload());
+            return Harp.SoundCard.NoiseSettings.FromPayload(timestamp, messageType, GetPayload());
         }
     }
 
@@ -6994,6 +7953,118 @@ namespace Harp.SoundCard
         }
     }
 
+    /// <summary>
+    /// Represents an operator that creates a message payload
+    /// that plays a train of tone pips, amplitude modulated tones or clicks on both channels.
+    /// </summary>
+    [DisplayName("PlayStimulusPayload")]
+    [Description("Creates a message payload that plays a train of tone pips, amplitude modulated tones or clicks on both channels.")]
+    public partial class CreatePlayStimulusPayload
+    {
+        /// <summary>
+        /// Gets or sets a value that the carrier frequency in mHz, 0 to play clicks.
+        /// </summary>
+        [Description("The carrier frequency in mHz, 0 to play clicks.")]
+        public uint FrequencyCarrier { get; set; }
+
+        /// <summary>
+        /// Gets or sets a value that the amplitude modulation frequency in mHz.
+        /// </summary>
+        [Description("The amplitude modulation frequency in mHz.")]
+        public uint FrequencyModulation { get; set; }
+
+        /// <summary>
+        /// Gets or sets a value that the amplitude modulation depth in 0.1%, 0 for no modulation.
+        /// </summary>
+        [Description("The amplitude modulation depth in 0.1%, 0 for no modulation.")]
+        public uint Depth { get; set; }
+
+        /// <summary>
+        /// Gets or sets a value that the duration of each burst in us.
+        /// </summary>
+        [Description("The duration of each burst in us.")]
+        public uint Duration { get; set; }
+
+        /// <summary>
+        /// Gets or sets a value that the rise and fall time of each burst in us, up to half the duration.
+        /// </summary>
+        [Description("The rise and fall time of each burst in us, up to half the duration.")]
+        public uint Ramp { get; set; }
+
+        /// <summary>
+        /// Gets or sets a value that the time between the onsets of the bursts in us.
+        /// </summary>
+        [Description("The time between the onsets of the bursts in us.")]
+        public uint Period { get; set; }
+
+        /// <summary>
+        /// Gets or sets a value that the number of bursts, 0 to play until stopped.
+        /// </summary>
+        [Description("The number of bursts, 0 to play until stopped.")]
+        public uint Count { get; set; }
+
+        /// <summary>
+        /// Gets or sets a value that the attenuation of the left channel (1 LSB is 0.1dB).
+        /// </summary>
+        [Description("The attenuation of the left channel (1 LSB is 0.1dB).")]
+        public uint AttenuationLeft { get; set; }
+
+        /// <summary>
+        /// Gets or sets a value that the attenuation of the right channel (1 LSB is 0.1dB).
+        /// </summary>
+        [Description("The attenuation of the right channel (1 LSB is 0.1dB).")]
+        public uint AttenuationRight { get; set; }
+
+        /// <summary>
+        /// Creates a message payload for the PlayStimulus register.
+        /// </summary>
+        /// <returns>The created message payload value.</returns>
+        public PlayStimulusPayload GetPayload()
+        {
+            PlayStimulusPayload value;
+            value.FrequencyCarrier = FrequencyCarrier;
+            value.FrequencyModulation = FrequencyModulation;
+            value.Depth = Depth;
+            value.Duration = Duration;
+            value.Ramp = Ramp;
+            value.Period = Period;
+            value.Count = Count;
+            value.AttenuationLeft = AttenuationLeft;
+            value.AttenuationRight = AttenuationRight;
+            return value;
+        }
+
+        /// <summary>
+        /// Creates a message that plays a train of tone pips, amplitude modulated tones or clicks on both channels.
+        /// </summary>
+        /// <param name="messageType">Specifies the type of the created message.</param>
+        /// <returns>A new message for the PlayStimulus register.</returns>
+        public HarpMessage GetMessage(MessageType messageType)
+        {
+            return Harp.SoundCard.PlayStimulus.FromPayload(messageType, GetPayload());
+        }
+    }
+
+    /// <summary>
+    /// Represents an operator that creates a timestamped message payload
+    /// that plays a train of tone pips, amplitude modulated tones or clicks on both channels.
+    /// </summary>
+    [DisplayName("TimestampedPlayStimulusPayload")]
+    [Description("Creates a timestamped message payload that plays a train of tone pips, amplitude modulated tones or clicks on both channels.")]
+    public partial class CreateTimestampedPlayStimulusPayload : CreatePlayStimulusPayload
+    {
+        /// <summary>
+        /// Creates a timestamped message that plays a train of tone pips, amplitude modulated tones or clicks on both channels.
+        /// </summary>
+        /// <param name="timestamp">The timestamp of the message payload, in seconds.</param>
+        /// <param name="messageType">Specifies the type of the created message.</param>
+        /// <returns>A new timestamped message for the PlayStimulus register.</returns>
+        public HarpMessage GetMessage(double timestamp, MessageType messageType)
+        {
+            return Harp.SoundCard.PlayStimulus.FromPayload(timestamp, messageType, GetPayload());
+        }
+    }
+
     /// <summary>
     /// Represents an operator that creates a message payload
     /// that set the specified digital output lines.
@@ -7456,6 +8527,321 @@ namespace Harp.SoundCard
         }
     }
 
+    /// <summary>
+    /// Represents the payload of the PlayStereoTone register.
+    /// </summary>
+    public struct PlayStereoTonePayload
+    {
+        /// <summary>
+        /// Initializes a new instance of the <see cref="PlayStereoTonePayload"/> structure.
+        /// </summary>
+        /// <param name="frequencyLeft">The frequency of the left channel in mHz, or zero to keep it silent.</param>
+        /// <param name="frequencyRight">The frequency of the right channel in mHz, or zero to keep it silent.</param>
+        /// <param name="phaseLeft">The phase offset of the left channel to the right channel (1 LSB is 0.01 degrees).</param>
+        /// <param name="attenuationLeft">The attenuation of the left channel (1 LSB is 0.1dB).</param>
+        /// <param name="attenuationRight">The attenuation of the right channel (1 LSB is 0.1dB).</param>
+        public PlayStereoTonePayload(
+            uint frequencyLeft,
+            uint frequencyRight,
+            uint phaseLeft,
+            uint attenuationLeft,
+            uint attenuationRight)
+        {
+            FrequencyLeft = frequencyLeft;
+            FrequencyRight = frequencyRight;
+            PhaseLeft = phaseLeft;
+            AttenuationLeft = attenuationLeft;
+            AttenuationRight = attenuationRight;
+        }
+
+        /// <summary>
+        /// The frequency of the left channel in mHz, or zero to keep it silent.
+        /// </summary>
+        public uint FrequencyLeft;
+
+        /// <summary>
+        /// The frequency of the right channel in mHz, or zero to keep it silent.
+        /// </summary>
+        public uint FrequencyRight;
+
+        /// <summary>
+        /// The phase offset of the left channel to the right channel (1 LSB is 0.01 degrees).
+        /// </summary>
+        public uint PhaseLeft;
+
+        /// <summary>
+        /// The attenuation of the left channel (1 LSB is 0.1dB).
+        /// </summary>
+        public uint AttenuationLeft;
+
+        /// <summary>
+        /// The attenuation of the right channel (1 LSB is 0.1dB).
+        /// </summary>
+        public uint AttenuationRight;
+
+        /// <summary>
+        /// Returns a <see cref="string"/> that represents the payload of
+        /// the PlayStereoTone register.
+        /// </summary>
+        /// <returns>
+        /// A <see cref="string"/> that represents the payload of the
+        /// PlayStereoTone register.
+        /// </returns>
+        public override string ToString()
+        {
+            return "PlayStereoTonePayload { " +
+                "FrequencyLeft = " + FrequencyLeft + ", " +
+                "FrequencyRight = " + FrequencyRight + ", " +
+                "PhaseLeft = " + PhaseLeft + ", " +
+                "AttenuationLeft = " + AttenuationLeft + ", " +
+                "AttenuationRight = " + AttenuationRight + " " +
+            "}";
+        }
+    }
+
+    /// <summary>
+    /// Represents the payload of the PlaySweep register.
+    /// </summary>
+    public struct PlaySweepPayload
+    {
+        /// <summary>
+        /// Initializes a new instance of the <see cref="PlaySweepPayload"/> structure.
+        /// </summary>
+        /// <param name="frequencyStart">The start frequency in mHz.</param>
+        /// <param name="frequencyEnd">The end frequency in mHz.</param>
+        /// <param name="duration">The duration of the sweep in ms.</param>
+        /// <param name="mode">The sweep mode, linear (0) or logarithmic (1), plus 2 to hold the end frequency instead of stopping.</param>
+        /// <param name="attenuationLeft">The attenuation of the left channel (1 LSB is 0.1dB).</param>
+        /// <param name="attenuationRight">The attenuation of the right channel (1 LSB is 0.1dB).</param>
+        public PlaySweepPayload(
+            uint frequencyStart,
+            uint frequencyEnd,
+            uint duration,
+            uint mode,
+            uint attenuationLeft,
+            uint attenuationRight)
+        {
+            FrequencyStart = frequencyStart;
+            FrequencyEnd = frequencyEnd;
+            Duration = duration;
+            Mode = mode;
+            AttenuationLeft = attenuationLeft;
+            AttenuationRight = attenuationRight;
+        }
+
+        /// <summary>
+        /// The start frequency in mHz.
+        /// </summary>
+        public uint FrequencyStart;
+
+        /// <summary>
+        /// The end frequency in mHz.
+        /// </summary>
+        public uint FrequencyEnd;
+
+        /// <summary>
+        /// The duration of the sweep in ms.
+        /// </summary>
+        public uint Duration;
+
+        /// <summary>
+        /// The sweep mode, linear (0) or logarithmic (1), plus 2 to hold the end frequency instead of stopping.
+        /// </summary>
+        public uint Mode;
+
+        /// <summary>
+        /// The attenuation of the left channel (1 LSB is 0.1dB).
+        /// </summary>
+        public uint AttenuationLeft;
+
+        /// <summary>
+        /// The attenuation of the right channel (1 LSB is 0.1dB).
+        /// </summary>
+        public uint AttenuationRight;
+
+        /// <summary>
+        /// Returns a <see cref="string"/> that represents the payload of
+        /// the PlaySweep register.
+        /// </summary>
+        /// <returns>
+        /// A <see cref="string"/> that represents the payload of the
+        /// PlaySweep register.
+        /// </returns>
+        public override string ToString()
+        {
+            return "PlaySweepPayload { " +
+                "FrequencyStart = " + FrequencyStart + ", " +
+                "FrequencyEnd = " + FrequencyEnd + ", " +
+                "Duration = " + Duration + ", " +
+                "Mode = " + Mode + ", " +
+                "AttenuationLeft = " + AttenuationLeft + ", " +
+                "AttenuationRight = " + AttenuationRight + " " +
+            "}";
+        }
+    }
+
+    /// <summary>
+    /// Represents the payload of the NoiseSettings register.
+    /// </summary>
+    public struct NoiseSettingsPayload
+    {
+        /// <summary>
+        /// Initializes a new instance of the <see cref="NoiseSettingsPayload"/> structure.
+        /// </summary>
+        /// <param name="seed">The seed of the noise generator, the same seed plays the same noise.</param>
+        /// <param name="frequencyLow">The low edge of the band-pass noise in Hz, 0 for no high-pass.</param>
+        /// <param name="frequencyHigh">The high edge of the band-pass noise in Hz, 0 for no low-pass.</param>
+        public NoiseSettingsPayload(
+            uint seed,
+            uint frequencyLow,
+            uint frequencyHigh)
+        {
+            Seed = seed;
+            FrequencyLow = frequencyLow;
+            FrequencyHigh = frequencyHigh;
+        }
+
+        /// <summary>
+        /// The seed of the noise generator, the same seed plays the same noise.
+        /// </summary>
+        public uint Seed;
+
+        /// <summary>
+        /// The low edge of the band-pass noise in Hz, 0 for no high-pass.
+        /// </summary>
+        public uint FrequencyLow;
+
+        /// <summary>
+        /// The high edge of the band-pass noise in Hz, 0 for no low-pass.
+        /// </summary>
+        public uint FrequencyHigh;
+
+        /// <summary>
+        /// Returns a <see cref="string"/> that represents the payload of
+        /// the NoiseSettings register.
+        /// </summary>
+        /// <returns>
+        /// A <see cref="string"/> that represents the payload of the
+        /// NoiseSettings register.
+        /// </returns>
+        public override string ToString()
+        {
+            return "NoiseSettingsPayload { " +
+                "Seed = " + Seed + ", " +
+                "FrequencyLow = " + FrequencyLow + ", " +
+                "FrequencyHigh = " + FrequencyHigh + " " +
+            "}";
+        }
+    }
+
+    /// <summary>
+    /// Represents the payload of the PlayStimulus register.
+    /// </summary>
+    public struct PlayStimulusPayload
+    {
+        /// <summary>
+        /// Initializes a new instance of the <see cref="PlayStimulusPayload"/> structure.
+        /// </summary>
+        /// <param name="frequencyCarrier">The carrier frequency in mHz, 0 to play clicks.</param>
+        /// <param name="frequencyModulation">The amplitude modulation frequency in mHz.</param>
+        /// <param name="depth">The amplitude modulation depth in 0.1%, 0 for no modulation.</param>
+        /// <param name="duration">The duration of each burst in us.</param>
+        /// <param name="ramp">The rise and fall time of each burst in us, up to half the duration.</param>
+        /// <param name="period">The time between the onsets of the bursts in us.</param>
+        /// <param name="count">The number of bursts, 0 to play until stopped.</param>
+        /// <param name="attenuationLeft">The attenuation of the left channel (1 LSB is 0.1dB).</param>
+        /// <param name="attenuationRight">The attenuation of the right channel (1 LSB is 0.1dB).</param>
+        public PlayStimulusPayload(
+            uint frequencyCarrier,
+            uint frequencyModulation,
+            uint depth,
+            uint duration,
+            uint ramp,
+            uint period,
+            uint count,
+            uint attenuationLeft,
+            uint attenuationRight)
+        {
+            FrequencyCarrier = frequencyCarrier;
+            FrequencyModulation = frequencyModulation;
+            Depth = depth;
+            Duration = duration;
+            Ramp = ramp;
+            Period = period;
+            Count = count;
+            AttenuationLeft = attenuationLeft;
+            AttenuationRight = attenuationRight;
+        }
+
+        /// <summary>
+        /// The carrier frequency in mHz, 0 to play clicks.
+        /// </summary>
+        public uint FrequencyCarrier;
+
+        /// <summary>
+        /// The amplitude modulation frequency in mHz.
+        /// </summary>
+        public uint FrequencyModulation;
+
+        /// <summary>
+        /// The amplitude modulation depth in 0.1%, 0 for no modulation.
+        /// </summary>
+        public uint Depth;
+
+        /// <summary>
+        /// The duration of each burst in us.
+        /// </summary>
+        public uint Duration;
+
+        /// <summary>
+        /// The rise and fall time of each burst in us, up to half the duration.
+        /// </summary>
+        public uint Ramp;
+
+        /// <summary>
+        /// The time between the onsets of the bursts in us.
+        /// </summary>
+        public uint Period;
+
+        /// <summary>
+        /// The number of bursts, 0 to play until stopped.
+        /// </summary>
+        public uint Count;
+
+        /// <summary>
+        /// The attenuation of the left channel (1 LSB is 0.1dB).
+        /// </summary>
+        public uint AttenuationLeft;
+
+        /// <summary>
+        /// The attenuation of the right channel (1 LSB is 0.1dB).
+        /// </summary>
+        public uint AttenuationRight;
+
+        /// <summary>
+        /// Returns a <see cref="string"/> that represents the payload of
+        /// the PlayStimulus register.
+        /// </summary>
+        /// <returns>
+        /// A <see cref="string"/> that represents the payload of the
+        /// PlayStimulus register.
+        /// </returns>
+        public override string ToString()
+        {
+            return "PlayStimulusPayload { " +
+                "FrequencyCarrier = " + FrequencyCarrier + ", " +
+                "FrequencyModulation = " + FrequencyModulation + ", " +
+                "Depth = " + Depth + ", " +
+                "Duration = " + Duration + ", " +
+                "Ramp = " + Ramp + ", " +
+                "Period = " + Period + ", " +
+                "Count = " + Count + ", " +
+                "AttenuationLeft = " + AttenuationLeft + ", " +
+                "AttenuationRight = " + AttenuationRight + " " +
+            "}";
+        }
+    }
+
     /// <summary>
     /// Represents the payload of the AnalogData register.
     /// </summary>
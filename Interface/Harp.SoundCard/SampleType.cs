@@ -1,8 +1,25 @@
 ﻿namespace Harp.SoundCard
 {
-    internal enum SampleType : int
+    /// <summary>
+    /// Specifies the format of the sound samples sent to the device.
+    /// </summary>
+    public enum SampleType : int
     {
+        /// <summary>
+        /// Specifies 32-bit integer samples, played as they are.
+        /// </summary>
         Int32 = 0,
-        Float32 = 1
+
+        /// <summary>
+        /// Specifies 32-bit floating-point samples, with full scale at 1.0, which
+        /// are converted to 24-bit samples by the device.
+        /// </summary>
+        Float32 = 1,
+
+        /// <summary>
+        /// Specifies 32-bit integer samples compressed by the host without losing the
+        /// 24 bits played by the device, which decodes them while playing.
+        /// </summary>
+        Compressed = 2
     }
 }
@@ -16,6 +16,9 @@
         NotAbleToSendReadMetadata,
         NotAbleToReadReadMetadataCommandRepply,
         ReadMetadataCommandReplyNotCorrect,
+        NotAbleToSendStream,
+        NotAbleToReadStreamCommandReply,
+        StreamCommandReplyNotCorrect,
 
         BadSoundIndex = -1020,
         BadSoundLength,
@@ -23,9 +26,11 @@
         BadDataType,
         DataTypeDoNotMatch,
         BadDataIndex,
+        MemoryWriteFailed,
 
         ProducingSound = -1030,
         StartedProducingSound,
+        StreamNotStarted,
 
         NotAbleToOpenFile = -1040
     }
@@ -42,8 +47,8 @@
                 case SoundCardErrorCode.BadUserInput:
                     throw new SoundCardException(
                         "User input not correct. The format should be \"filename\" [index] [type] [sample rate] \n" +
-                        " -> [index] from 0 to 31\n" +
-                        " -> [type] 0: Int32, 1: Float32\n" +
+                        " -> [index] from 0 to 63\n" +
+                        " -> [type] 0: Int32, 1: Float32, 2: Compressed\n" +
                         " -> [sample rate] 96000 or 192000");
 
                 case SoundCardErrorCode.HarpSoundCardNotDetected:
@@ -67,17 +72,26 @@
                 case SoundCardErrorCode.DataCommandReplyNotCorrect:
                     throw new SoundCardException("Data command reply received is not correct.");
 
+                case SoundCardErrorCode.NotAbleToSendStream:
+                    throw new SoundCardException("Not able to start comunication and send stream data.");
+
+                case SoundCardErrorCode.NotAbleToReadStreamCommandReply:
+                    throw new SoundCardException("Stream command reply not received.");
+
+                case SoundCardErrorCode.StreamCommandReplyNotCorrect:
+                    throw new SoundCardException("Stream command reply received is not correct.");
+
                 case SoundCardErrorCode.BadSoundIndex:
-                    throw new SoundCardException("Sound index not correct. Must be beween 0 and 32.");
+                    throw new SoundCardException("Sound index not correct. Must be between 2 and 63, or 2 and 31 on the 2 Gb memory.");
 
                 case SoundCardErrorCode.BadSoundLength:
-                    throw new SoundCardException("Sound length not correct.");
+                    throw new SoundCardException("Sound length or fade length not correct.");
 
                 case SoundCardErrorCode.BadSampleRate:
                     throw new SoundCardException("Sample rate not correct or Harp Sound Card is not compatible. Available options are 96 and 192.");
 
                 case SoundCardErrorCode.BadDataType:
-                    throw new SoundCardException("Data type not correct. Available options are 0 (for integer with 32 bits) and 1 (for float with 32 bits).");
+                    throw new SoundCardException("Data type not correct. Available options are 0 (for integer with 32 bits), 1 (for float with 32 bits) and 2 (for compressed integer).");
 
                 case SoundCardErrorCode.DataTypeDoNotMatch:
                     throw new SoundCardException("Data type don't match with selected sound index.");
@@ -85,12 +99,18 @@
                 case SoundCardErrorCode.BadDataIndex:
                     throw new SoundCardException("Attempt to write outside memory boundaries.");
 
+                case SoundCardErrorCode.MemoryWriteFailed:
+                    throw new SoundCardException("The memory failed to program the sound, which was removed. Write it again.");
+
                 case SoundCardErrorCode.ProducingSound:
                     throw new SoundCardException("The Sound Board is producing a sound and is not able to receive the new sound.");
 
                 case SoundCardErrorCode.StartedProducingSound:
                     throw new SoundCardException("The Sound Board started producing a sound which makes it not able to receive the new sound.");
 
+                case SoundCardErrorCode.StreamNotStarted:
+                    throw new SoundCardException("The Sound Board stream was stopped or not started.");
+
                 case SoundCardErrorCode.NotAbleToOpenFile:
                     throw new SoundCardException("File doesn't exist or is empty.");
             }
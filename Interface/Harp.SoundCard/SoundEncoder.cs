@@ -0,0 +1,205 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+
+namespace Harp.SoundCard
+{
+    /// <summary>
+    /// Compresses sound waveforms without losing the 24 bits played by the device.
+    /// </summary>
+    /// <remarks>
+    /// The stream starts with an index, a header followed by the page and byte offset
+    /// of each frame. Each frame holds 256 stereo samples, encoded per channel with the
+    /// best fixed predictor of order 0 to 3 and Rice coded residuals, or verbatim if
+    /// that is smaller. Frames never cross a page, so the device decodes any page of
+    /// the sound reading the index and a single page.
+    /// </remarks>
+    internal static class SoundEncoder
+    {
+        const uint Magic = 0x5A435348;
+        const int PageSize = 2048;
+        const int HeaderSize = 16;
+        const int FrameLength = 256;
+        const int MaxRiceParameter = 24;
+        const int VerbatimMode = 4;
+
+        static readonly int[][] FixedPredictors =
+        {
+            new[] { 0, 0, 0 },
+            new[] { 1, 0, 0 },
+            new[] { 2, -1, 0 },
+            new[] { 3, -3, 1 }
+        };
+
+        public static byte[] Encode(byte[] soundWaveform)
+        {
+            var soundLength = soundWaveform.Length / sizeof(int);
+            var numberOfFrames = (soundLength / 2 + FrameLength - 1) / FrameLength;
+            var indexLength = HeaderSize + numberOfFrames * sizeof(int);
+            var indexPages = (indexLength + PageSize - 1) / PageSize;
+
+            var index = new uint[numberOfFrames];
+            var frames = new MemoryStream();
+            var left = new int[FrameLength];
+            var right = new int[FrameLength];
+
+            var page = indexPages;
+            var pageOffset = 0;
+            for (int i = 0; i < numberOfFrames; i++)
+            {
+                for (int j = 0; j < FrameLength; j++)
+                {
+                    var sample = (i * FrameLength + j) * 2;
+                    left[j] = sample < soundLength ? BitConverter.ToInt32(soundWaveform, sample * sizeof(int)) >> 8 : 0;
+                    right[j] = sample + 1 < soundLength ? BitConverter.ToInt32(soundWaveform, (sample + 1) * sizeof(int)) >> 8 : 0;
+                }
+
+                var frame = EncodeFrame(left, right);
+                if (pageOffset + frame.Length > PageSize)
+                {
+                    frames.Write(new byte[PageSize - pageOffset], 0, PageSize - pageOffset);
+                    page++;
+                    pageOffset = 0;
+                }
+
+                index[i] = (uint)(page << 11 | pageOffset);
+                frames.Write(frame, 0, frame.Length);
+                pageOffset += frame.Length;
+            }
+
+            // The device reads the sound length as a multiple of 4 samples
+            var streamLength = indexPages * PageSize + (int)frames.Length;
+            var stream = new byte[(streamLength + 15) / 16 * 16];
+            BitConverter.GetBytes(Magic).CopyTo(stream, 0);
+            BitConverter.GetBytes(soundLength).CopyTo(stream, 4);
+            BitConverter.GetBytes(numberOfFrames).CopyTo(stream, 8);
+            Buffer.BlockCopy(index, 0, stream, HeaderSize, index.Length * sizeof(uint));
+            frames.Position = 0;
+            frames.Read(stream, indexPages * PageSize, (int)frames.Length);
+            return stream;
+        }
+
+        static byte[] EncodeFrame(int[] left, int[] right)
+        {
+            var writer = new BitWriter();
+            var leftMode = SelectMode(left, out int leftParameter);
+            var rightMode = SelectMode(right, out int rightParameter);
+            EncodeChannel(writer, left, leftMode, leftParameter);
+            EncodeChannel(writer, right, rightMode, rightParameter);
+
+            var bits = writer.ToArray();
+            var frame = new byte[(4 + bits.Length + 3) / 4 * 4];
+            frame[0] = (byte)leftMode;
+            frame[1] = (byte)leftParameter;
+            frame[2] = (byte)rightMode;
+            frame[3] = (byte)rightParameter;
+            bits.CopyTo(frame, 4);
+            return frame;
+        }
+
+        static uint GetResidual(int[] samples, int[] predictor, int i)
+        {
+            var prediction = predictor[0] * samples[i - 1];
+            if (i > 1) prediction += predictor[1] * samples[i - 2];
+            if (i > 2) prediction += predictor[2] * samples[i - 3];
+            var residual = samples[i] - prediction;
+            return (uint)((residual << 1) ^ (residual >> 31));
+        }
+
+        static int SelectMode(int[] samples, out int parameter)
+        {
+            var mode = VerbatimMode;
+            var bestLength = (long)FrameLength * 24;
+            parameter = 0;
+
+            var residuals = new uint[FrameLength];
+            for (int order = 0; order < FixedPredictors.Length; order++)
+            {
+                for (int i = order; i < FrameLength; i++)
+                {
+                    residuals[i] = order > 0 ? GetResidual(samples, FixedPredictors[order], i) : (uint)((samples[i] << 1) ^ (samples[i] >> 31));
+                }
+
+                for (int k = 0; k <= MaxRiceParameter; k++)
+                {
+                    long length = order * 24;
+                    for (int i = order; i < FrameLength; i++)
+                    {
+                        length += (residuals[i] >> k) + 1 + k;
+                    }
+
+                    if (length < bestLength)
+                    {
+                        bestLength = length;
+                        mode = order;
+                        parameter = k;
+                    }
+                }
+            }
+
+            return mode;
+        }
+
+        static void EncodeChannel(BitWriter writer, int[] samples, int mode, int parameter)
+        {
+            if (mode == VerbatimMode)
+            {
+                for (int i = 0; i < FrameLength; i++)
+                {
+                    writer.Write((uint)samples[i] & 0xFFFFFF, 24);
+                }
+                return;
+            }
+
+            for (int i = 0; i < mode; i++)
+            {
+                writer.Write((uint)samples[i] & 0xFFFFFF, 24);
+            }
+
+            for (int i = mode; i < FrameLength; i++)
+            {
+                var residual = mode > 0 ? GetResidual(samples, FixedPredictors[mode], i) : (uint)((samples[i] << 1) ^ (samples[i] >> 31));
+                for (var q = residual >> parameter; q > 0; q--)
+                {
+                    writer.Write(0, 1);
+                }
+
+                writer.Write(1, 1);
+                writer.Write(residual & ((1u << parameter) - 1), parameter);
+            }
+        }
+
+        class BitWriter
+        {
+            readonly List<byte> bytes = new();
+            uint bits;
+            int numberOfBits;
+
+            public void Write(uint value, int length)
+            {
+                for (int i = length - 1; i >= 0; i--)
+                {
+                    bits = bits << 1 | ((value >> i) & 1);
+                    if (++numberOfBits == 8)
+                    {
+                        bytes.Add((byte)bits);
+                        bits = 0;
+                        numberOfBits = 0;
+                    }
+                }
+            }
+
+            public byte[] ToArray()
+            {
+                if (numberOfBits > 0)
+                {
+                    bytes.Add((byte)(bits << (8 - numberOfBits)));
+                    bits = 0;
+                    numberOfBits = 0;
+                }
+
+                return bytes.ToArray();
+            }
+        }
+    }
+}
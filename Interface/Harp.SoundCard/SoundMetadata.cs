@@ -5,19 +5,28 @@ namespace Harp.SoundCard
     [StructLayout(LayoutKind.Sequential)]
     internal struct SoundMetadata
     {
+        public const int MaxFadeLength = 32768;
+
         public int SoundIndex;
         public int SoundLength;
         public SampleRate SampleRate;
-        public SampleType SampleType;
+        public short DataType;
+        public ushort FadeLength;
+
+        public SampleType SampleType
+        {
+            readonly get => (SampleType)DataType;
+            set => DataType = (short)value;
+        }
 
         internal readonly SoundCardErrorCode Validate()
         {
-            if (SoundIndex < 2 || SoundIndex > 32)
+            if (SoundIndex < 2 || SoundIndex > 63)
             {
                 return SoundCardErrorCode.BadSoundIndex;
             }
 
-            if (SoundLength < 16)
+            if (SoundLength < 16 || FadeLength > MaxFadeLength)
             {
                 return SoundCardErrorCode.BadSoundLength;
             }
@@ -27,7 +36,7 @@ namespace Harp.SoundCard
                 return SoundCardErrorCode.BadSampleRate;
             }
 
-            if (SampleType != SampleType.Int32 && SampleType != SampleType.Float32)
+            if (SampleType != SampleType.Int32 && SampleType != SampleType.Float32 && SampleType != SampleType.Compressed)
             {
                 return SoundCardErrorCode.BadDataType;
             }
@@ -42,11 +51,6 @@ namespace Harp.SoundCard
                 return SoundCardErrorCode.DataTypeDoNotMatch;
             }
 
-            if (SoundIndex > 1 && SampleType != SampleType.Int32)
-            {
-                return SoundCardErrorCode.DataTypeDoNotMatch;
-            }
-
             return SoundCardErrorCode.Ok;
         }
     }
@@ -0,0 +1,72 @@
+﻿using System;
+using System.ComponentModel;
+using System.Reactive.Linq;
+using Bonsai;
+using OpenCV.Net;
+
+namespace Harp.SoundCard
+{
+    /// <summary>
+    /// Represents an operator that streams each of the sample buffers in the sequence
+    /// to the SoundCard device, which plays them without storing them in memory.
+    /// </summary>
+    [Description("Streams each of the sample buffers in the sequence to the SoundCard device, which plays them without storing them in memory.")]
+    public class StreamSoundWaveform : Sink<byte[]>
+    {
+        /// <summary>
+        /// Gets or sets the index of the SoundCard device to stream to. If no index
+        /// is specified, the first SoundCard will be used.
+        /// </summary>
+        [Description("The index of the SoundCard device to stream to. If no index is specified, the first SoundCard will be used.")]
+        public int? DeviceIndex { get; set; }
+
+        /// <summary>
+        /// Gets or sets a value specifying the sample rate used to play the stream.
+        /// </summary>
+        [Description("Specifies the sample rate used to play the stream.")]
+        public SampleRate SampleRate { get; set; }
+
+        /// <summary>
+        /// Streams each of the sample buffers in an observable sequence to the
+        /// SoundCard device.
+        /// </summary>
+        /// <param name="source">
+        /// A sequence of binary array objects representing consecutive interleaved
+        /// stereo samples of the sound waveform. The device starts playing when its
+        /// buffer is full and stops when the sequence completes.
+        /// </param>
+        /// <returns>
+        /// An observable sequence that is identical to the <paramref name="source"/> sequence
+        /// but where there is an additional side effect of streaming each of the sample
+        /// buffers to the SoundCard device. Each notification is only emitted after the
+        /// device has room to receive the samples.
+        /// </returns>
+        public override IObservable<byte[]> Process(IObservable<byte[]> source)
+        {
+            return Observable.Using(
+                () => WaveformStream.Open(DeviceIndex, SampleRate),
+                stream => source.Do(stream.Write, stream.Close));
+        }
+
+        /// <summary>
+        /// Streams each of the sample buffers in an observable sequence to the
+        /// SoundCard device.
+        /// </summary>
+        /// <param name="source">
+        /// A sequence of <see cref="Mat"/> objects representing consecutive raw samples
+        /// of the sound waveform. Both mono or stereo waveforms are supported, where
+        /// channels are rows.
+        /// </param>
+        /// <returns>
+        /// An observable sequence that is identical to the <paramref name="source"/> sequence
+        /// but where there is an additional side effect of streaming each of the sample
+        /// buffers to the SoundCard device.
+        /// </returns>
+        public IObservable<Mat> Process(IObservable<Mat> source)
+        {
+            return Observable.Using(
+                () => WaveformStream.Open(DeviceIndex, SampleRate),
+                stream => source.Do(value => stream.Write(WaveformHelper.GetSoundWaveform(value)), stream.Close));
+        }
+    }
+}
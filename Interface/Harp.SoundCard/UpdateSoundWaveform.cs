@@ -23,7 +23,7 @@ namespace Harp.SoundCard
         /// <summary>
         /// Gets or sets the index of the sound to update.
         /// </summary>
-        [Range(2, 31)]
+        [Range(2, 63)]
         [Editor(DesignTypes.NumericUpDownEditor, DesignTypes.UITypeEditor)]
         [Description("The index of the sound to update.")]
         public int SoundIndex { get; set; } = 2;
@@ -42,13 +42,30 @@ namespace Harp.SoundCard
         [Description("Specifies the sample rate used to playback the sound waveform.")]
         public SampleRate SampleRate { get; set; }
 
+        /// <summary>
+        /// Gets or sets a value specifying the format of the samples sent to the device.
+        /// Float32 samples have full scale at 1.0 and are converted by the device.
+        /// Compressed samples are integers compressed before the upload.
+        /// </summary>
+        [Description("Specifies the format of the samples sent to the device. Float32 samples have full scale at 1.0 and are converted by the device. Compressed samples are integers compressed before the upload.")]
+        public SampleType SampleType { get; set; }
+
+        /// <summary>
+        /// Gets or sets the number of samples per channel of the fade in and fade out
+        /// applied by the device when the sound is played, up to 32768.
+        /// </summary>
+        [Range(0, 32768)]
+        [Editor(DesignTypes.NumericUpDownEditor, DesignTypes.UITypeEditor)]
+        [Description("The number of samples per channel of the fade in and fade out applied by the device when the sound is played, up to 32768.")]
+        public int FadeLength { get; set; }
+
         /// <summary>
         /// Replaces the specified sound waveform in the SoundCard device with each
         /// of the sample buffers in an observable sequence.
         /// </summary>
         /// <param name="source">
         /// A sequence of binary array objects representing all the raw samples of
-        /// the sound waveform. Continuous streaming is not supported.
+        /// the sound waveform. Use <see cref="StreamSoundWaveform"/> for continuous streaming.
         /// </param>
         /// <returns>
         /// An observable sequence that is identical to the <paramref name="source"/> sequence
@@ -59,7 +76,7 @@ namespace Harp.SoundCard
         {
             return source.Do(value =>
             {
-                UpdateWaveform(DeviceIndex, SoundIndex, SampleRate, SampleType.Int32, value, SoundName);
+                UpdateWaveform(DeviceIndex, SoundIndex, SampleRate, SampleType, value, SoundName, FadeLength);
             });
         }
 
@@ -70,7 +87,8 @@ namespace Harp.SoundCard
         /// <param name="source">
         /// A sequence of <see cref="Mat"/> objects representing the raw samples of the
         /// the sound waveform. Both mono or stereo waveforms are supported, where channels are
-        /// rows. Continuous streaming is not supported so the full waveform should be sent.
+        /// rows. The full waveform should be sent, use <see cref="StreamSoundWaveform"/>
+        /// for continuous streaming.
         /// </param>
         /// <returns>
         /// An observable sequence that is identical to the <paramref name="source"/> sequence
@@ -81,33 +99,8 @@ namespace Harp.SoundCard
         {
             return source.Do(value =>
             {
-                if (value.Rows > 2 || value.Channels != 1)
-                {
-                    throw new InvalidOperationException("Sound waveforms must be either mono or stereo.");
-                }
-
-                var sampleDepth = Depth.S32;
-                if (value.Depth != sampleDepth)
-                {
-                    var temp = new Mat(value.Rows, value.Cols, sampleDepth, value.Channels);
-                    CV.Convert(value, temp);
-                    value = temp;
-                }
-
-                var soundWaveform = new byte[sizeof(int) * value.Cols * 2];
-                using (var waveformHeader = Mat.CreateMatHeader(soundWaveform, rows: value.Cols, cols: 2, sampleDepth, channels: 1))
-                {
-                    if (value.Rows == 1)
-                    {
-                        using var channel0 = waveformHeader.GetCol(0);
-                        using var channel1 = waveformHeader.GetCol(1);
-                        CV.Transpose(value, channel0);
-                        CV.Transpose(value, channel1);
-                    }
-                    else CV.Transpose(value, waveformHeader);
-                }
-
-                UpdateWaveform(DeviceIndex, SoundIndex, SampleRate, SampleType.Int32, soundWaveform, SoundName);
+                var soundWaveform = WaveformHelper.GetSoundWaveform(value, SampleType);
+                UpdateWaveform(DeviceIndex, SoundIndex, SampleRate, SampleType, soundWaveform, SoundName, FadeLength);
             });
         }
 
@@ -117,9 +110,10 @@ namespace Harp.SoundCard
             SampleRate sampleRate,
             SampleType sampleType,
             byte[] soundWaveform,
-            string soundName = null)
+            string soundName = null,
+            int fadeLength = 0)
         {
-            var errorCode = WaveformHelper.WriteSoundWaveform(deviceIndex, soundIndex, sampleRate, sampleType, soundWaveform, soundName);
+            var errorCode = WaveformHelper.WriteSoundWaveform(deviceIndex, soundIndex, sampleRate, sampleType, soundWaveform, soundName, fadeLength);
             if (errorCode != SoundCardErrorCode.Ok)
             {
                 SoundCardErrorHelper.ThrowExceptionForErrorCode(errorCode);
@@ -1,9 +1,11 @@
 ﻿using System;
+using System.Collections.Generic;
 using System.IO;
 using System.Runtime.InteropServices;
 using System.Text;
 using LibUsbDotNet;
 using LibUsbDotNet.Main;
+using OpenCV.Net;
 
 namespace Harp.SoundCard
 {
@@ -11,13 +13,45 @@ namespace Harp.SoundCard
     {
         public static UsbDeviceFinder UsbFinder = new(0x04D8, 0xEE6A);
 
+        public static byte[] GetSoundWaveform(Mat value, SampleType sampleType = SampleType.Int32)
+        {
+            if (value.Rows > 2 || value.Channels != 1)
+            {
+                throw new InvalidOperationException("Sound waveforms must be either mono or stereo.");
+            }
+
+            var sampleDepth = sampleType == SampleType.Float32 ? Depth.F32 : Depth.S32;
+            if (value.Depth != sampleDepth)
+            {
+                var temp = new Mat(value.Rows, value.Cols, sampleDepth, value.Channels);
+                CV.Convert(value, temp);
+                value = temp;
+            }
+
+            var soundWaveform = new byte[sizeof(int) * value.Cols * 2];
+            using (var waveformHeader = Mat.CreateMatHeader(soundWaveform, rows: value.Cols, cols: 2, sampleDepth, channels: 1))
+            {
+                if (value.Rows == 1)
+                {
+                    using var channel0 = waveformHeader.GetCol(0);
+                    using var channel1 = waveformHeader.GetCol(1);
+                    CV.Transpose(value, channel0);
+                    CV.Transpose(value, channel1);
+                }
+                else CV.Transpose(value, waveformHeader);
+            }
+
+            return soundWaveform;
+        }
+
         public static unsafe SoundCardErrorCode WriteSoundWaveform(
             int? deviceIndex,
             int soundIndex,
             SampleRate sampleRate,
             SampleType sampleType,
             byte[] soundWaveform,
-            string soundName = null)
+            string soundName = null,
+            int fadeLength = 0)
         {
             const int MetadataSize = 2048;
             const int MaxBufferSize = 32768;
@@ -71,14 +105,23 @@ namespace Harp.SoundCard
                     Buffer.BlockCopy(Encoding.ASCII.GetBytes(soundName), 0, userMetadata, 0, soundName.Length);
                 }
 
+                /*************************************
+                 * Compress sound waveform
+                 ************************************/
+                if (sampleType == SampleType.Compressed)
+                {
+                    soundWaveform = SoundEncoder.Encode(soundWaveform);
+                }
+
                 /*************************************
                  * Build sound header
                  ************************************/
-                SoundMetadata soundMetadata;
+                SoundMetadata soundMetadata = default;
                 soundMetadata.SoundIndex = soundIndex;
                 soundMetadata.SoundLength = soundWaveform.Length / 4;
                 soundMetadata.SampleRate = sampleRate;
                 soundMetadata.SampleType = sampleType;
+                soundMetadata.FadeLength = (ushort)Math.Min(Math.Max(fadeLength, 0), ushort.MaxValue);
 
                 /*************************************
                  * Create auxiliary parameters
@@ -191,26 +234,38 @@ namespace Harp.SoundCard
                 /*************************************
                  * Send data commands and receive replies
                  ************************************/
+                /* The device acknowledges a data command as soon as it is copied, so the next */
+                /* one is sent before reading the reply and its transfer overlaps the programming */
+                /* of the previous one. The reply to the last command is sent once it is programmed. */
+                const int MaxDataCommandsInFlight = 2;
+                var randomsInFlight = new Queue<int>(MaxDataCommandsInFlight);
+                int dataCommandsToBeSent = commandsToBeSent - 1;
                 int dataIndex = 0;
-                int bytesFromFile;
-                while (--commandsToBeSent > 0)
+                while (dataIndex < dataCommandsToBeSent || randomsInFlight.Count > 0)
                 {
-                    randomSent = randomInt.Next();
-                    Buffer.BlockCopy(BitConverter.GetBytes(randomSent), 0, dataCmd, 4, sizeof(int));
-                    Buffer.BlockCopy(BitConverter.GetBytes(++dataIndex), 0, dataCmd, 8, sizeof(int));
-                    bytesFromFile = soundFileStream.Read(dataCmd, dataCmdDataIndex, MaxBufferSize);
+                    if (dataIndex < dataCommandsToBeSent && randomsInFlight.Count < MaxDataCommandsInFlight)
+                    {
+                        randomSent = randomInt.Next();
+                        Buffer.BlockCopy(BitConverter.GetBytes(randomSent), 0, dataCmd, 4, sizeof(int));
+                        Buffer.BlockCopy(BitConverter.GetBytes(++dataIndex), 0, dataCmd, 8, sizeof(int));
+                        soundFileStream.Read(dataCmd, dataCmdDataIndex, MaxBufferSize);
 
-                    ec = writer.Write(dataCmd, 0, dataCmd.Length, writeTimeout, out bytesSent);
-                    if (ec != 0) return SoundCardErrorCode.NotAbleToSendData;
+                        ec = writer.Write(dataCmd, 0, dataCmd.Length, writeTimeout, out bytesSent);
+                        if (ec != 0) return SoundCardErrorCode.NotAbleToSendData;
+
+                        randomsInFlight.Enqueue(randomSent);
+                        continue;
+                    }
 
                     ec = reader.Read(commandReply, readTimeout, out bytesRead);
                     if (ec != 0) return SoundCardErrorCode.NotAbleToReadDataCommandReply;
 
+                    randomSent = randomsInFlight.Dequeue();
                     randomReceived = BitConverter.ToInt32(commandReply, 4);
                     errorReceived = BitConverter.ToInt32(commandReply, 8);
                     if (randomSent != randomReceived) return SoundCardErrorCode.DataCommandReplyNotCorrect;
 
-                    for (int i = 0; i < 8; i++)
+                    for (int i = 0; i < 4; i++)
                     {
                         if (dataCmd[i] != commandReply[i])
                         {
@@ -0,0 +1,194 @@
+﻿using System;
+using LibUsbDotNet;
+using LibUsbDotNet.Main;
+
+namespace Harp.SoundCard
+{
+    internal class WaveformStream : IDisposable
+    {
+        const int MaxBufferSize = 32768;
+        const int WriteTimeout = 2000;
+
+        // The device holds the reply to a stream command until the chunk fits
+        // in its FIFO, and a stored sound may be played in the meantime.
+        const int ReadTimeout = 10000;
+
+        /* Stream start command lenght: 'c' 'm' 'd' '0x83' + random + sampleRate               + 'f' */
+        /* Stream data command lenght:  'c' 'm' 'd' '0x82' + random + numberOfSamples + 32768 + 'f' */
+        const byte StartCmdHeader = 0x83;
+        const byte DataCmdHeader = 0x82;
+        const int DataCmdDataIndex = 4 + sizeof(int) + sizeof(int);
+
+        readonly UsbDevice usbDevice;
+        readonly UsbEndpointReader reader;
+        readonly UsbEndpointWriter writer;
+        readonly Random randomInt = new();
+        readonly byte[] dataCmd = new byte[4 + sizeof(int) + sizeof(int) + MaxBufferSize + 1];
+        int dataCmdCount;
+        bool ended;
+
+        WaveformStream(UsbDevice device)
+        {
+            usbDevice = device;
+
+            // If this is a "whole" usb device (libusb-win32, linux libusb)
+            // it must select the configuration and claim the interface first.
+            if (usbDevice is IUsbDevice wholeUsbDevice)
+            {
+                wholeUsbDevice.SetConfiguration(1);
+                wholeUsbDevice.ClaimInterface(0);
+            }
+
+            reader = usbDevice.OpenEndpointReader(ReadEndpointID.Ep01);
+            writer = usbDevice.OpenEndpointWriter(WriteEndpointID.Ep01);
+
+            dataCmd[0] = Convert.ToByte('c');
+            dataCmd[1] = Convert.ToByte('m');
+            dataCmd[2] = Convert.ToByte('d');
+            dataCmd[3] = DataCmdHeader;
+            dataCmd[dataCmd.Length - 1] = Convert.ToByte('f');
+        }
+
+        /// <summary>
+        /// Gets the number of buffers of silence played by the device because
+        /// the stream data arrived too late.
+        /// </summary>
+        public uint Underruns { get; private set; }
+
+        public static WaveformStream Open(int? deviceIndex, SampleRate sampleRate)
+        {
+            var usbDeviceIndex = deviceIndex.GetValueOrDefault();
+            var usbDevices = UsbDevice.AllDevices.FindAll(WaveformHelper.UsbFinder);
+            if (usbDevices.Count <= usbDeviceIndex)
+            {
+                SoundCardErrorHelper.ThrowExceptionForErrorCode(SoundCardErrorCode.HarpSoundCardNotDetected);
+            }
+
+            var usbDevice = usbDevices[usbDeviceIndex].Device;
+            if (usbDevice == null)
+            {
+                SoundCardErrorHelper.ThrowExceptionForErrorCode(SoundCardErrorCode.HarpSoundCardNotDetected);
+            }
+
+            var stream = new WaveformStream(usbDevice);
+            try
+            {
+                if (sampleRate != SampleRate.SampleRate96000Hz && sampleRate != SampleRate.SampleRate192000Hz)
+                {
+                    SoundCardErrorHelper.ThrowExceptionForErrorCode(SoundCardErrorCode.BadSampleRate);
+                }
+
+                var startCmd = new byte[4 + sizeof(int) + sizeof(int) + 1];
+                startCmd[0] = Convert.ToByte('c');
+                startCmd[1] = Convert.ToByte('m');
+                startCmd[2] = Convert.ToByte('d');
+                startCmd[3] = StartCmdHeader;
+                Buffer.BlockCopy(BitConverter.GetBytes((int)sampleRate), 0, startCmd, 8, sizeof(int));
+                startCmd[startCmd.Length - 1] = Convert.ToByte('f');
+
+                stream.reader.Flush();
+                SoundCardErrorHelper.ThrowExceptionForErrorCode(stream.SendCommand(startCmd, startCmd.Length));
+                return stream;
+            }
+            catch
+            {
+                stream.Dispose();
+                throw;
+            }
+        }
+
+        /// <summary>
+        /// Appends interleaved stereo samples to the stream. Full chunks are sent
+        /// as soon as they are filled, blocking while the device FIFO is full.
+        /// </summary>
+        public void Write(byte[] soundWaveform)
+        {
+            if (ended)
+            {
+                throw new InvalidOperationException("The stream has already ended.");
+            }
+
+            var offset = 0;
+            while (offset < soundWaveform.Length)
+            {
+                var count = Math.Min(MaxBufferSize - dataCmdCount, soundWaveform.Length - offset);
+                Buffer.BlockCopy(soundWaveform, offset, dataCmd, DataCmdDataIndex + dataCmdCount, count);
+                dataCmdCount += count;
+                offset += count;
+
+                if (dataCmdCount == MaxBufferSize)
+                {
+                    SendDataCommand();
+                }
+            }
+        }
+
+        /// <summary>
+        /// Sends the remaining samples and ends the stream, so the device plays
+        /// the data left in its FIFO and stops.
+        /// </summary>
+        public void Close()
+        {
+            if (ended) return;
+
+            // The device takes multiples of 4 samples and ends the stream
+            // with the first chunk shorter than the maximum buffer size
+            dataCmdCount -= dataCmdCount % (4 * sizeof(int));
+            SendDataCommand();
+            ended = true;
+        }
+
+        void SendDataCommand()
+        {
+            Buffer.BlockCopy(BitConverter.GetBytes(dataCmdCount / sizeof(int)), 0, dataCmd, 8, sizeof(int));
+            SoundCardErrorHelper.ThrowExceptionForErrorCode(SendCommand(dataCmd, dataCmd.Length));
+            dataCmdCount = 0;
+        }
+
+        SoundCardErrorCode SendCommand(byte[] command, int length)
+        {
+            /* Stream start command reply: 'c' 'm' 'd' '0x83' + random + error                        */
+            /* Stream data command reply:  'c' 'm' 'd' '0x82' + random + error + freeChunks + underruns */
+            var commandReply = new byte[4 + sizeof(int) + sizeof(int) + sizeof(int) + sizeof(int)];
+            var randomSent = randomInt.Next();
+            Buffer.BlockCopy(BitConverter.GetBytes(randomSent), 0, command, 4, sizeof(int));
+
+            var ec = writer.Write(command, 0, length, WriteTimeout, out _);
+            if (ec != 0) return SoundCardErrorCode.NotAbleToSendStream;
+
+            ec = reader.Read(commandReply, ReadTimeout, out int bytesRead);
+            if (ec != 0) return SoundCardErrorCode.NotAbleToReadStreamCommandReply;
+
+            var randomReceived = BitConverter.ToInt32(commandReply, 4);
+            var errorReceived = BitConverter.ToInt32(commandReply, 8);
+            if (randomSent != randomReceived) return SoundCardErrorCode.StreamCommandReplyNotCorrect;
+
+            for (int i = 0; i < 8; i++)
+            {
+                if (command[i] != commandReply[i])
+                {
+                    return SoundCardErrorCode.StreamCommandReplyNotCorrect;
+                }
+            }
+
+            if (command[3] == DataCmdHeader && bytesRead >= commandReply.Length)
+            {
+                Underruns = BitConverter.ToUInt32(commandReply, 16);
+            }
+
+            return (SoundCardErrorCode)errorReceived;
+        }
+
+        public void Dispose()
+        {
+            reader?.Dispose();
+            writer?.Dispose();
+            if (usbDevice is IUsbDevice wholeUsbDevice)
+            {
+                // Release interface #0.
+                wholeUsbDevice.ReleaseInterface(0);
+            }
+            usbDevice.Dispose();
+        }
+    }
+}
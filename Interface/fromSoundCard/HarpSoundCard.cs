@@ -28,7 +28,7 @@ namespace HarpSoundCard
             int index,
             Array metadataArray,
             ref string description,
-            ref UInt32 bitMask,
+            ref UInt64 bitMask,
             ref int soundLength,
             ref int dataType,
             ref int sampleRate,
@@ -60,8 +60,8 @@ namespace HarpSoundCard
             /*************************************
              * Create byte array to receive replies
              ************************************/
-            /* Read metadata command reply: 'c' 'm' 'd' '0x84' + random + error + availableBitMask + soundLength + dataType + sampleRate + 2048 */
-            byte[] readMetadataReply = new byte[4 + 6 * sizeof(int) + 2048];
+            /* Read metadata command reply: 'c' 'm' 'd' '0x84' + random + error + availableBitMask + soundLength + dataType + sampleRate + 2048 + availableBitMaskHigh */
+            byte[] readMetadataReply = new byte[4 + 6 * sizeof(int) + 2048 + sizeof(int)];
 
             /*************************************
             * Send read metadata command and receive reply
@@ -97,9 +97,9 @@ namespace HarpSoundCard
                 throw new Exception("Error: " + (SoundCardErrorCode)errorReceived);
             }
 
-            bitMask = BitConverter.ToUInt32(readMetadataReply, 12);
+            bitMask = BitConverter.ToUInt32(readMetadataReply, 12) | ((UInt64)BitConverter.ToUInt32(readMetadataReply, 28 + 2048) << 32);
 
-            if ((bitMask & ((UInt32) 1 << index)) != ((UInt32)1 << index))
+            if ((bitMask & ((UInt64) 1 << index)) != ((UInt64)1 << index))
             {
                 hasSound = false;
                 return;
@@ -111,7 +111,7 @@ namespace HarpSoundCard
 
             soundLength = BitConverter.ToInt32(readMetadataReply, 16);
             sampleRate = BitConverter.ToInt32(readMetadataReply, 20);
-            dataType = BitConverter.ToInt32(readMetadataReply, 24);
+            dataType = BitConverter.ToInt16(readMetadataReply, 24);
             soundFilename = System.Text.Encoding.Default.GetString(readMetadataReply, 28, 170).TrimEnd((char)0);
 
             if (readMetadataReply[28 + 170] != 0)
@@ -145,7 +145,7 @@ namespace HarpSoundCard
         #endregion
 
         #region static void SaveToFiles
-        public static UInt32 SaveToFiles(
+        public static UInt64 SaveToFiles(
             UsbEndpointWriter writer,
             UsbEndpointReader reader,
             int soundIndex,
@@ -156,7 +156,7 @@ namespace HarpSoundCard
         {
             var metadataArray = new byte[1024];
             string description = String.Empty;
-            UInt32 bitMask = 0;
+            UInt64 bitMask = 0;
             int soundLength = 0;
             int dataType = 0;
             int sampleRate = 0;
@@ -379,12 +379,12 @@ namespace HarpSoundCard
                     Console.WriteLine("                    -description");
                     Console.WriteLine("                    -sound               -- not implemented yet");
                     Console.WriteLine("                    -all");
-                    Console.WriteLine("  -> [index]        from 0 to 31         -- 0 and 1 not implemented yet");
+                    Console.WriteLine("  -> [index]        from 0 to 63         -- 0 and 1 not implemented yet");
                     Console.WriteLine("  -> [option]       -deleteAll (deletes all files in the folder \\fromSoundCard)");
                     return (int) SoundCardErrorCode.BadUserInput;
                 }
 
-                if (soundIndex < 2 || soundIndex > 31)
+                if (soundIndex < 2 || soundIndex > 63)
                 {
                     Console.WriteLine("Error: " + SoundCardErrorCode.BadSoundIndex);
                     return (int)SoundCardErrorCode.BadSoundIndex;
@@ -417,14 +417,14 @@ namespace HarpSoundCard
                 /*************************************
                  * Read metadata
                  ************************************/
-                UInt32 bitMask;
+                UInt64 bitMask;
 
                 if (isAll)
                 {
                     bitMask = SaveToFiles(writer, reader, 2, isMetadata, isDescription, isSound, fromDirectory);
 
-                    for (int i = 3; i < 32; i++)
-                        if ((bitMask & ((UInt32)1 << i)) == ((UInt32)1 << i))
+                    for (int i = 3; i < 64; i++)
+                        if ((bitMask & ((UInt64)1 << i)) == ((UInt64)1 << i))
                             SaveToFiles(writer, reader, i, isMetadata, isDescription, isSound, fromDirectory);
                 }
                 else
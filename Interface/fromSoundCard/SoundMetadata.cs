@@ -62,9 +62,9 @@ namespace HarpSoundCard
 
         public SoundCardErrorCode CheckData()
         {
-            if (this.soundIndex < 2 || this.soundIndex > 32)
+            if (this.soundIndex < 2 || this.soundIndex > 63)
             {
-                //Console.WriteLine("Sound index is too big. Must be beween 0 and 32.");
+                //Console.WriteLine("Sound index is too big. Must be beween 0 and 63.");
                 return SoundCardErrorCode.BadSoundIndex;
             }
 
@@ -1,4 +1,5 @@
 ﻿using System;
+using System.Collections.Generic;
 using System.Diagnostics;
 using System.IO;
 using System.Reflection;
@@ -122,8 +123,8 @@ namespace HarpSoundCard
                     Console.WriteLine("  toSOundCard \"sound_filename\" [index] [type] [sample rate] -description \"description_filename\"");
                     Console.WriteLine("  toSOundCard \"sound_filename\" [index] [type] [sample rate] -metadata \"metadata_filename\" -description \"description_filename\"");
                     Console.WriteLine("");
-                    Console.WriteLine("  -> [index]        from 0 to 31             -- 0 and 1 not implemented yet");
-                    Console.WriteLine("  -> [type]         0: Int32, 1: Float32     -- Float32 not implemented yet");
+                    Console.WriteLine("  -> [index]        from 0 to 63             -- 0 and 1 not implemented yet");
+                    Console.WriteLine("  -> [type]         0: Int32, 1: Float32     -- Float32 full scale is 1.0");
                     Console.WriteLine("  -> [sample rate]  96000 or 192000");
                     Console.WriteLine("");
                     Console.WriteLine("  Note: It's recommended that \"filenames\" should have an extension.");
@@ -426,41 +427,43 @@ namespace HarpSoundCard
                 /*************************************
                  * Send data commands and receive replies
                  ************************************/
+                /* The device acknowledges a data command as soon as it is copied, so the next */
+                /* one is sent before reading the reply and its transfer overlaps the programming */
+                /* of the previous one. The reply to the last command is sent once it is programmed. */
+                const int maxDataCommandsInFlight = 2;
+                Queue<int> randomsInFlight = new Queue<int>(maxDataCommandsInFlight);
+                int dataCommandsToBeSent = commandsToBeSent - 1;
                 int dataIndex = 0;
                 int bytesFromFile;
-                while (--commandsToBeSent > 0)
+                while (dataIndex < dataCommandsToBeSent || randomsInFlight.Count > 0)
                 {
-                    randomSent = randomInt.Next();
-                    System.Buffer.BlockCopy(BitConverter.GetBytes(randomSent), 0, dataCmd, 4, sizeof(int));
+                    if (dataIndex < dataCommandsToBeSent && randomsInFlight.Count < maxDataCommandsInFlight)
+                    {
+                        randomSent = randomInt.Next();
+                        System.Buffer.BlockCopy(BitConverter.GetBytes(randomSent), 0, dataCmd, 4, sizeof(int));
 
-                    System.Buffer.BlockCopy(BitConverter.GetBytes(++dataIndex), 0, dataCmd, 8, sizeof(int));
+                        System.Buffer.BlockCopy(BitConverter.GetBytes(++dataIndex), 0, dataCmd, 8, sizeof(int));
 
-                    //stopwatch.Reset();
-                    bytesFromFile = soundFileStream.Read(dataCmd, dataCmdDataIndex, 32768);
-                    //Console.WriteLine("Elapsed time (get 32KB from the file): " + stopwatch.ElapsedMilliseconds + " ms");
+                        bytesFromFile = soundFileStream.Read(dataCmd, dataCmdDataIndex, 32768);
 
-                    /* NOT NEEDED -- THE DEVICE MUST HANDLE THIS
-                    if (bytesFromFile != 32768)
-                    {
-                        // This code was not tested yet
-                        for (int i = 0; i < 32768 - bytesFromFile; i++)
-                            dataCmd[dataCmdDataIndex + 32768 - bytesFromFile + i] = 0;
-                    }
-                    */
+                        ec = writer.Write(dataCmd, 0, dataCmd.Length, writeTimeout, out bytesSent);
+                        if (ec != ErrorCode.None) throw new Exception("NotAbleToSendData");
+                        if (debug) Console.WriteLine("Sound data sent (" + bytesSent + " bytes sent). Random sent: " + randomSent);
 
-                    ec = writer.Write(dataCmd, 0, dataCmd.Length, writeTimeout, out bytesSent);
-                    if (ec != ErrorCode.None) throw new Exception("NotAbleToSendData");
-                    if (debug) Console.WriteLine("Sound data sent (" + bytesSent + " bytes sent). Random sent: " + randomSent);
+                        randomsInFlight.Enqueue(randomSent);
+                        continue;
+                    }
 
                     ec = reader.Read(commandReply, readTimeout, out bytesRead);
                     if (ec != ErrorCode.None) throw new Exception("NotAbleToReadDataCommandReply");
 
+                    randomSent = randomsInFlight.Dequeue();
                     randomReceived = BitConverter.ToInt32(commandReply, 4);
                     errorReceived = BitConverter.ToInt32(commandReply, 8);
                     if (debug) Console.WriteLine("Sound data reply received (" + bytesRead + " bytes read). Error received: " + errorReceived + " Random received: " + randomReceived);
 
                     if (randomSent != randomReceived) throw new Exception("DataCommandReplyNotCorrect");
-                    for (int i = 0; i < 8; i++)
+                    for (int i = 0; i < 4; i++)
                         if (dataCmd[i] != commandReply[i]) throw new Exception("DataCommandReplyNotCorrect");
 
                     if ((SoundCardErrorCode)errorReceived != SoundCardErrorCode.Ok)
@@ -484,12 +487,10 @@ namespace HarpSoundCard
                 /*************************************
                  * All data was sent
                  ************************************/
-                //double bandwidth_MBps = (fileSizeInSamples *  4.0) / (stopwatch.ElapsedMilliseconds / 1000.0) / 1024 / 1024;
-                double bandwidth_Mbps = (soundFileSizeInSamples * 32.0) / (stopwatch.ElapsedMilliseconds / 1000.0) / 1024 / 1024;
+                double bandwidth_MBps = (soundFileSizeInSamples * 4.0) / (stopwatch.ElapsedMilliseconds / 1000.0) / 1024 / 1024;
                 //Console.WriteLine("Ticks: " + stopwatch.ElapsedTicks);
                 Console.WriteLine("Elapsed time: " + stopwatch.ElapsedMilliseconds + " ms");
-                //Console.WriteLine("Bandwidth: " + bandwidth_MBps.ToString("0.000") + " MB/s");
-                Console.WriteLine("Bandwidth: " + bandwidth_Mbps.ToString("0.0") + " Mb/s");
+                Console.WriteLine("Bandwidth: " + bandwidth_MBps.ToString("0.000") + " MB/s");
             }
             catch (Exception ex)
             {
@@ -25,6 +25,7 @@ namespace HarpSoundCard
         BadDataType,
         DataTypeDoNotMatch,
         BadDataIndex,
+        MemoryWriteFailed,
 
         ProducingSound = -1030,
         StartedProducingSound,
@@ -43,7 +44,7 @@ namespace HarpSoundCard
                     return 0;
 
                 case SoundCardErrorCode.BadUserInput:
-                    if (writeToConsole) Console.WriteLine("User input not correct. The format should be \"filename\" [index] [type] [sample rate] \n -> [index] from 0 to 31\n -> [type] 0: Int32, 1: Float32\n -> [sample rate] 96000 or 192000");
+                    if (writeToConsole) Console.WriteLine("User input not correct. The format should be \"filename\" [index] [type] [sample rate] \n -> [index] from 0 to 63\n -> [type] 0: Int32, 1: Float32\n -> [sample rate] 96000 or 192000");
                     return (int)code;
 
                 case SoundCardErrorCode.HarpSoundCardNotDetected:
@@ -75,7 +76,7 @@ namespace HarpSoundCard
                     return (int)code;
 
                 case SoundCardErrorCode.BadSoundIndex:
-                    if (writeToConsole) Console.WriteLine("Sound index not correct. Must be beween 0 and 32.");
+                    if (writeToConsole) Console.WriteLine("Sound index not correct. Must be between 0 and 63.");
                     return (int)code;
 
                 case SoundCardErrorCode.BadSoundLength:
@@ -98,6 +99,10 @@ namespace HarpSoundCard
                     if (writeToConsole) Console.WriteLine("Attempt to write outside memory boundaries.");
                     return (int)code;
 
+                case SoundCardErrorCode.MemoryWriteFailed:
+                    if (writeToConsole) Console.WriteLine("The memory failed to program the sound, which was removed. Write it again.");
+                    return (int)code;
+
                 case SoundCardErrorCode.ProducingSound:
                     if (writeToConsole) Console.WriteLine("The Sound Board is producing a sound and is not able to receive the new sound.");
                     return (int)code;
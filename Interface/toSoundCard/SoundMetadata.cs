@@ -60,9 +60,9 @@ namespace HarpSoundCard
 
         public SoundCardErrorCode CheckData()
         {
-            if (this.soundIndex < 2 || this.soundIndex > 32)
+            if (this.soundIndex < 2 || this.soundIndex > 63)
             {
-                //Console.WriteLine("Sound index is too big. Must be beween 0 and 32.");
+                //Console.WriteLine("Sound index is too big. Must be beween 0 and 63.");
                 return SoundCardErrorCode.BadSoundIndex;
             }
 
@@ -95,12 +95,6 @@ namespace HarpSoundCard
                 return SoundCardErrorCode.DataTypeDoNotMatch;
             }
 
-            if (this.soundIndex > 1 && this.dataType != DataType.Int32)
-            {
-                //Console.WriteLine("Data type of sound index above 1 must be integer.");
-                return SoundCardErrorCode.DataTypeDoNotMatch;
-            }
-
             return 0;
 
         }